@@ -90,11 +90,28 @@ void ParsedText::layoutAndExtractLines(const GfxRenderer& renderer, const int fo
   } else {
     lineBreakIndices = computeLineBreaks(renderer, fontId, pageWidth, spaceWidth, wordWidths, continuesVec);
   }
-  const size_t lineCount = includeLastLine ? lineBreakIndices.size() : lineBreakIndices.size() - 1;
+  size_t lineCount = lineBreakIndices.size();
+  if (!includeLastLine) {
+    lineCount = lineCount > STREAMING_LOOKAHEAD_LINES ? lineCount - STREAMING_LOOKAHEAD_LINES : 0;
+  }
 
   for (size_t i = 0; i < lineCount; ++i) {
     extractLine(i, pageWidth, spaceWidth, wordWidths, continuesVec, lineBreakIndices, processLine);
   }
+  if (lineCount > 0) {
+    linesEmitted = true;
+  }
+}
+
+// Indent of the paragraph's first line (only for left/justified text without extra paragraph spacing). Once a
+// streaming pass has emitted that line, the words still buffered all belong to continuation lines.
+int ParsedText::computeFirstLineIndent() const {
+  if (linesEmitted || blockStyle.textIndent <= 0 || extraParagraphSpacing) {
+    return 0;
+  }
+  return blockStyle.alignment == CssTextAlign::Justify || blockStyle.alignment == CssTextAlign::Left
+             ? blockStyle.textIndent
+             : 0;
 }
 
 std::vector<uint16_t> ParsedText::calculateWordWidths(const GfxRenderer& renderer, const int fontId) {
@@ -123,12 +140,7 @@ std::vector<size_t> ParsedText::computeLineBreaks(const GfxRenderer& renderer, c
     return {};
   }
 
-  // Calculate first line indent (only for left/justified text without extra paragraph spacing)
-  const int firstLineIndent =
-      blockStyle.textIndent > 0 && !extraParagraphSpacing &&
-              (blockStyle.alignment == CssTextAlign::Justify || blockStyle.alignment == CssTextAlign::Left)
-          ? blockStyle.textIndent
-          : 0;
+  const int firstLineIndent = computeFirstLineIndent();
 
   // Ensure any word that would overflow even as the first entry on a line is split using fallback hyphenation.
   for (size_t i = 0; i < wordWidths.size(); ++i) {
@@ -229,9 +241,10 @@ std::vector<size_t> ParsedText::computeLineBreaks(const GfxRenderer& renderer, c
 }
 
 void ParsedText::applyParagraphIndent() {
-  if (extraParagraphSpacing || words.empty()) {
+  if (indentApplied || extraParagraphSpacing || words.empty()) {
     return;
   }
+  indentApplied = true;
 
   if (blockStyle.textIndentDefined) {
     // CSS text-indent is explicitly set (even if 0) - don't use fallback EmSpace
@@ -247,12 +260,7 @@ std::vector<size_t> ParsedText::computeHyphenatedLineBreaks(const GfxRenderer& r
                                                             const int pageWidth, const int spaceWidth,
                                                             std::vector<uint16_t>& wordWidths,
                                                             std::vector<bool>& continuesVec) {
-  // Calculate first line indent (only for left/justified text without extra paragraph spacing)
-  const int firstLineIndent =
-      blockStyle.textIndent > 0 && !extraParagraphSpacing &&
-              (blockStyle.alignment == CssTextAlign::Justify || blockStyle.alignment == CssTextAlign::Left)
-          ? blockStyle.textIndent
-          : 0;
+  const int firstLineIndent = computeFirstLineIndent();
 
   std::vector<size_t> lineBreakIndices;
   size_t currentIndex = 0;
@@ -407,13 +415,7 @@ void ParsedText::extractLine(const size_t breakIndex, const int pageWidth, const
   const size_t lastBreakAt = breakIndex > 0 ? lineBreakIndices[breakIndex - 1] : 0;
   const size_t lineWordCount = lineBreak - lastBreakAt;
 
-  // Calculate first line indent (only for left/justified text without extra paragraph spacing)
-  const bool isFirstLine = breakIndex == 0;
-  const int firstLineIndent =
-      isFirstLine && blockStyle.textIndent > 0 && !extraParagraphSpacing &&
-              (blockStyle.alignment == CssTextAlign::Justify || blockStyle.alignment == CssTextAlign::Left)
-          ? blockStyle.textIndent
-          : 0;
+  const int firstLineIndent = breakIndex == 0 ? computeFirstLineIndent() : 0;
 
   // Calculate total word width for this line and count actual word gaps
   // (continuation words attach to previous word with no gap)
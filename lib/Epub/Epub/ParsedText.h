@@ -20,8 +20,11 @@ class ParsedText {
   BlockStyle blockStyle;
   bool extraParagraphSpacing;
   bool hyphenationEnabled;
+  bool indentApplied = false;
+  bool linesEmitted = false;  // the paragraph's first line has already been extracted
 
   void applyParagraphIndent();
+  int computeFirstLineIndent() const;
   std::vector<size_t> computeLineBreaks(const GfxRenderer& renderer, int fontId, int pageWidth, int spaceWidth,
                                         std::vector<uint16_t>& wordWidths, std::vector<bool>& continuesVec);
   std::vector<size_t> computeHyphenatedLineBreaks(const GfxRenderer& renderer, int fontId, int pageWidth,
@@ -36,6 +39,14 @@ class ParsedText {
   std::vector<uint16_t> calculateWordWidths(const GfxRenderer& renderer, int fontId);
 
  public:
+  // Giant paragraphs (chapters without <p> tags, one huge <div>) are laid out as a sliding window: once more than
+  // STREAMING_WORD_THRESHOLD words are buffered, every line except the last STREAMING_LOOKAHEAD_LINES is emitted and
+  // its words are freed. Paragraphs up to the threshold (the old 750 word flush point) are laid out in one pass exactly
+  // as before; without hyphenation the breaks of a streamed paragraph can differ from a one-pass layout, since the DP
+  // only sees the buffered window.
+  static constexpr size_t STREAMING_WORD_THRESHOLD = 750;
+  static constexpr size_t STREAMING_LOOKAHEAD_LINES = 3;
+
   explicit ParsedText(const bool extraParagraphSpacing, const bool hyphenationEnabled = false,
                       const BlockStyle& blockStyle = BlockStyle())
       : blockStyle(blockStyle), extraParagraphSpacing(extraParagraphSpacing), hyphenationEnabled(hyphenationEnabled) {}
@@ -46,6 +57,8 @@ class ParsedText {
   BlockStyle& getBlockStyle() { return blockStyle; }
   size_t size() const { return words.size(); }
   bool isEmpty() const { return words.empty(); }
+  bool needsStreamingLayout() const { return words.size() > STREAMING_WORD_THRESHOLD; }
+  // includeLastLine = false holds back the look-ahead lines so more words can still be appended to the paragraph
   void layoutAndExtractLines(const GfxRenderer& renderer, int fontId, uint16_t viewportWidth,
                              const std::function<void(std::shared_ptr<TextBlock>)>& processLine,
                              bool includeLastLine = true);
@@ -9,10 +9,10 @@
 #include "parsers/ChapterHtmlSlimParser.h"
 
 namespace {
-constexpr uint8_t SECTION_FILE_VERSION = 13;
+constexpr uint8_t SECTION_FILE_VERSION = 15;
 constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + sizeof(int) + sizeof(float) + sizeof(bool) + sizeof(uint8_t) +
                                  sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(bool) + sizeof(bool) +
-                                 sizeof(uint32_t);
+                                 sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t);
 }  // namespace
 
 uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
@@ -22,7 +22,7 @@ uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
   }
 
   const uint32_t position = file.position();
-  if (!page->serialize(file)) {
+  if (!page->serialize(file, wordTable.get())) {
     LOG_ERR("SCT", "Failed to serialize page %d", pageCount);
     return 0;
   }
@@ -43,7 +43,7 @@ void Section::writeSectionFileHeader(const int fontId, const float lineCompressi
   static_assert(HEADER_SIZE == sizeof(SECTION_FILE_VERSION) + sizeof(fontId) + sizeof(lineCompression) +
                                    sizeof(extraParagraphSpacing) + sizeof(paragraphAlignment) + sizeof(viewportWidth) +
                                    sizeof(viewportHeight) + sizeof(pageCount) + sizeof(hyphenationEnabled) +
-                                   sizeof(embeddedStyle) + sizeof(uint32_t),
+                                   sizeof(embeddedStyle) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint32_t),
                 "Header size mismatch");
   serialization::writePod(file, SECTION_FILE_VERSION);
   serialization::writePod(file, fontId);
@@ -55,12 +55,15 @@ void Section::writeSectionFileHeader(const int fontId, const float lineCompressi
   serialization::writePod(file, hyphenationEnabled);
   serialization::writePod(file, embeddedStyle);
   serialization::writePod(file, pageCount);  // Placeholder for page count (will be initially 0 when written)
+  serialization::writePod(file, static_cast<uint32_t>(0));  // Placeholder for word table offset (0 = no table)
   serialization::writePod(file, static_cast<uint32_t>(0));  // Placeholder for LUT offset
+  serialization::writePod(file, static_cast<uint32_t>(0));  // Placeholder for position table offset
 }
 
 bool Section::loadSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
                               const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                               const uint16_t viewportHeight, const bool hyphenationEnabled, const bool embeddedStyle) {
+  wordTable.reset();
   if (!Storage.openFileForRead("SCT", filePath, file)) {
     return false;
   }
@@ -174,13 +177,6 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
 
   LOG_DBG("SCT", "Streamed temp HTML to %s (%d bytes)", tmpHtmlPath.c_str(), fileSize);
 
-  if (!Storage.openFileForWrite("SCT", filePath, file)) {
-    return false;
-  }
-  writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
-                         viewportHeight, hyphenationEnabled, embeddedStyle);
-  std::vector<uint32_t> lut = {};
-
   // Derive the content base directory and image cache path prefix for the parser
   size_t lastSlash = localPath.find_last_of('/');
   std::string contentBase = (lastSlash != std::string::npos) ? localPath.substr(0, lastSlash + 1) : "";
@@ -196,25 +192,76 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     }
   }
 
-  ChapterHtmlSlimParser visitor(
-      epub, tmpHtmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
-      viewportHeight, hyphenationEnabled,
-      [this, &lut](std::unique_ptr<Page> page) { lut.emplace_back(this->onPageComplete(std::move(page))); },
-      embeddedStyle, contentBase, imageBasePath, popupFn, cssParser);
+  // Only anchors the table of contents points into this chapter at are worth a table entry
+  SectionPositionTable anchorTargets;
+  for (int i = 0; i < epub->getTocItemsCount(); i++) {
+    const auto tocItem = epub->getTocItem(i);
+    if (tocItem.spineIndex == spineIndex) {
+      anchorTargets.addAnchorTarget(tocItem.anchor);
+    }
+  }
+
   Hyphenator::setPreferredLanguage(epub->getLanguage());
-  success = visitor.parseAndBuildPages();
+  std::vector<uint32_t> lut = {};
+  SectionPositionTable positions;
+  bool useTokenizer = xhtmlTokenizerEnabled;
+  while (true) {
+    if (!Storage.openFileForWrite("SCT", filePath, file)) {
+      Storage.remove(tmpHtmlPath.c_str());
+      return false;
+    }
+    pageCount = 0;
+    lut.clear();
+    positions = anchorTargets;
+    wordTable.reset(wordTableEnabled ? new SectionWordTable() : nullptr);
+    writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+                           viewportHeight, hyphenationEnabled, embeddedStyle);
+
+    ChapterHtmlSlimParser visitor(
+        epub, tmpHtmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment,
+        viewportWidth, viewportHeight, hyphenationEnabled,
+        [this, &lut](std::unique_ptr<Page> page) { lut.emplace_back(this->onPageComplete(std::move(page))); },
+        embeddedStyle, contentBase, imageBasePath, popupFn, cssParser);
+    visitor.setXhtmlTokenizerEnabled(useTokenizer);
+    visitor.setPositionTable(&positions);
+    success = visitor.parseAndBuildPages();
+    if (success || useTokenizer) {
+      break;
+    }
+
+    // Sloppy EPUBs are often not well-formed XML; rather than dropping the chapter, rebuild it leniently
+    LOG_ERR("SCT", "Expat rejected %s, retrying with XhtmlTokenizer", localPath.c_str());
+    file.close();
+    useTokenizer = true;
+  }
 
   Storage.remove(tmpHtmlPath.c_str());
   if (!success) {
     LOG_ERR("SCT", "Failed to parse XML and build pages");
     file.close();
     Storage.remove(filePath.c_str());
+    wordTable.reset();
     if (cssParser) {
       cssParser->clear();
     }
     return false;
   }
 
+  // Word table goes after the last page so ids could be assigned while pages were streamed out
+  uint32_t wordTableOffset = 0;
+  if (wordTable) {
+    wordTable->finishBuilding();
+    wordTableOffset = file.position();
+    if (!wordTable->serialize(file)) {
+      LOG_ERR("SCT", "Failed to write word table");
+      file.close();
+      Storage.remove(filePath.c_str());
+      wordTable.reset();
+      return false;
+    }
+    LOG_DBG("SCT", "Word table: %u words", wordTable->size());
+  }
+
   const uint32_t lutOffset = file.position();
   bool hasFailedLutRecords = false;
   // Write LUT
@@ -230,13 +277,26 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     LOG_ERR("SCT", "Failed to write LUT due to invalid page positions");
     file.close();
     Storage.remove(filePath.c_str());
+    wordTable.reset();
     return false;
   }
 
-  // Go back and write LUT offset
-  file.seek(HEADER_SIZE - sizeof(uint32_t) - sizeof(pageCount));
+  const uint32_t positionTableOffset = file.position();
+  if (!positions.serialize(file)) {
+    LOG_ERR("SCT", "Failed to write position table");
+    file.close();
+    Storage.remove(filePath.c_str());
+    wordTable.reset();
+    return false;
+  }
+  LOG_DBG("SCT", "Position table: %u anchors, %u element paths", positions.anchorCount(), positions.pathCount());
+
+  // Go back and write word table, LUT and position table offsets
+  file.seek(HEADER_SIZE - 3 * sizeof(uint32_t) - sizeof(pageCount));
   serialization::writePod(file, pageCount);
+  serialization::writePod(file, wordTableOffset);
   serialization::writePod(file, lutOffset);
+  serialization::writePod(file, positionTableOffset);
   file.close();
   if (cssParser) {
     cssParser->clear();
@@ -244,20 +304,67 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
   return true;
 }
 
-std::unique_ptr<Page> Section::loadPageFromSectionFile() {
+std::unique_ptr<Page> Section::loadPageFromSectionFile(const int pageIndex) {
   if (!Storage.openFileForRead("SCT", filePath, file)) {
     return nullptr;
   }
 
-  file.seek(HEADER_SIZE - sizeof(uint32_t));
+  file.seek(HEADER_SIZE - 3 * sizeof(uint32_t));
+  uint32_t wordTableOffset;
   uint32_t lutOffset;
+  serialization::readPod(file, wordTableOffset);
   serialization::readPod(file, lutOffset);
-  file.seek(lutOffset + sizeof(uint32_t) * currentPage);
+
+  // The table stays in RAM for the lifetime of this Section, so only the first page read pays for it
+  if (wordTableOffset != 0 && !wordTable) {
+    file.seek(wordTableOffset);
+    wordTable.reset(new SectionWordTable());
+    if (!wordTable->deserialize(file)) {
+      wordTable.reset();
+      file.close();
+      return nullptr;
+    }
+  }
+
+  file.seek(lutOffset + sizeof(uint32_t) * pageIndex);
   uint32_t pagePos;
   serialization::readPod(file, pagePos);
   file.seek(pagePos);
 
-  auto page = Page::deserialize(file);
+  auto page = Page::deserialize(file, wordTableOffset != 0 ? wordTable.get() : nullptr);
   file.close();
   return page;
 }
+
+bool Section::loadPositionTable(SectionPositionTable& table) {
+  if (!Storage.openFileForRead("SCT", filePath, file)) {
+    return false;
+  }
+
+  file.seek(HEADER_SIZE - sizeof(uint32_t));
+  uint32_t positionTableOffset;
+  serialization::readPod(file, positionTableOffset);
+  bool loaded = false;
+  if (positionTableOffset != 0) {
+    file.seek(positionTableOffset);
+    loaded = table.deserialize(file);
+  }
+  file.close();
+  return loaded;
+}
+
+// The table is only read for the odd jump or sync, so it is not kept in RAM next to the pages
+int Section::getPageForAnchor(const std::string& anchor) {
+  SectionPositionTable table;
+  return loadPositionTable(table) ? table.getPageForAnchor(anchor) : -1;
+}
+
+int Section::getPageForElementPath(const std::string& path) {
+  SectionPositionTable table;
+  return loadPositionTable(table) ? table.getPageForPath(path) : -1;
+}
+
+std::string Section::getElementPathForPage(const int pageIndex) {
+  SectionPositionTable table;
+  return loadPositionTable(table) ? table.getPathForPage(pageIndex) : "";
+}
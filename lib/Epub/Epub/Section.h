@@ -3,6 +3,8 @@
 #include <memory>
 
 #include "Epub.h"
+#include "SectionPositionTable.h"
+#include "SectionWordTable.h"
 
 class Page;
 class GfxRenderer;
@@ -13,11 +15,16 @@ class Section {
   GfxRenderer& renderer;
   std::string filePath;
   FsFile file;
+  bool wordTableEnabled = true;
+  bool xhtmlTokenizerEnabled = false;
+  // Word dictionary of the open section file; built while writing, loaded on the first page read
+  std::unique_ptr<SectionWordTable> wordTable;
 
   void writeSectionFileHeader(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                               uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled,
                               bool embeddedStyle);
   uint32_t onPageComplete(std::unique_ptr<Page> page);
+  bool loadPositionTable(SectionPositionTable& table);
 
  public:
   uint16_t pageCount = 0;
@@ -32,8 +39,20 @@ class Section {
   bool loadSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                        uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle);
   bool clearCache() const;
+  const std::string& getFilePath() const { return filePath; }
+  // Write new section files with a word table (default) or with plain inline strings. Both formats load.
+  void setWordTableEnabled(const bool enabled) { wordTableEnabled = enabled; }
+  // Parse chapters with XhtmlTokenizer instead of expat. Chapters expat rejects are always retried with it.
+  void setXhtmlTokenizerEnabled(const bool enabled) { xhtmlTokenizerEnabled = enabled; }
   bool createSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                          uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle,
                          const std::function<void()>& popupFn = nullptr);
-  std::unique_ptr<Page> loadPageFromSectionFile();
+  std::unique_ptr<Page> loadPageFromSectionFile() { return loadPageFromSectionFile(currentPage); }
+  // Any page of the section, e.g. to read the next one ahead while the current one is on its way to the panel
+  std::unique_ptr<Page> loadPageFromSectionFile(int pageIndex);
+  // Positions recorded when the file was built, -1 or empty if unknown. Anchors are the fragments of TOC entries,
+  // element paths are KOReader style paths below the chapter's <html>, e.g. "/body/div[2]/p[7]".
+  int getPageForAnchor(const std::string& anchor);
+  int getPageForElementPath(const std::string& path);
+  std::string getElementPathForPage(int pageIndex);
 };
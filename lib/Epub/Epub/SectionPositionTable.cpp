@@ -0,0 +1,233 @@
+#include "SectionPositionTable.h"
+
+#include <Logging.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <string_view>
+
+namespace {
+// Where a recorded element lies relative to the one looked up
+enum class Order : uint8_t { Before, Inside, After, Unknown };
+
+// Index of a "name[index]" step, 1 without brackets
+uint32_t stepIndex(const std::string_view step, const size_t bracket) {
+  if (bracket == std::string_view::npos) {
+    return 1;
+  }
+  uint32_t index = 0;
+  for (size_t i = bracket + 1; i < step.size() && step[i] >= '0' && step[i] <= '9'; i++) {
+    index = index * 10 + (step[i] - '0');
+  }
+  return index;
+}
+
+// Splits the next "/name[index]" step off a normalised path
+bool nextStep(std::string_view& path, std::string_view& name, uint32_t& index) {
+  if (path.empty()) {
+    return false;
+  }
+  path.remove_prefix(1);  // '/'
+  const size_t end = std::min(path.find('/'), path.size());
+  const std::string_view step = path.substr(0, end);
+  path.remove_prefix(end);
+
+  const size_t bracket = step.find('[');
+  name = step.substr(0, bracket);
+  index = stepIndex(step, bracket);
+  return true;
+}
+
+// Sibling steps with different names cannot be ordered without the document, those entries are skipped
+Order compare(std::string_view entry, std::string_view target) {
+  std::string_view entryName, targetName;
+  uint32_t entryIndex, targetIndex;
+  while (true) {
+    const bool entryStep = nextStep(entry, entryName, entryIndex);
+    const bool targetStep = nextStep(target, targetName, targetIndex);
+    if (!targetStep) {
+      return Order::Inside;
+    }
+    if (!entryStep) {
+      return Order::Before;  // an ancestor starts before its children
+    }
+    if (entryName != targetName) {
+      return Order::Unknown;
+    }
+    if (entryIndex != targetIndex) {
+      return entryIndex < targetIndex ? Order::Before : Order::After;
+    }
+  }
+}
+}  // namespace
+
+void SectionPositionTable::addAnchorTarget(const std::string& id) {
+  if (!id.empty() && anchorTargets.size() < MAX_ANCHORS && !isAnchorTarget(id)) {
+    anchorTargets.push_back(id);
+  }
+}
+
+bool SectionPositionTable::isAnchorTarget(const std::string& id) const {
+  return std::find(anchorTargets.begin(), anchorTargets.end(), id) != anchorTargets.end();
+}
+
+void SectionPositionTable::addAnchor(const std::string& id, const uint16_t page) {
+  if (anchors.size() >= MAX_ANCHORS || getPageForAnchor(id) >= 0) {
+    return;
+  }
+  anchors.push_back({id, page});
+}
+
+void SectionPositionTable::addPath(const std::string& path, const uint16_t page) {
+  if (path.empty() || (!paths.empty() && paths.back().key == path)) {
+    return;
+  }
+  if (pathsOffered++ % pathStride != 0) {
+    return;
+  }
+  if (paths.size() >= MAX_PATHS) {
+    // Keep every other entry and record every other block from now on
+    for (size_t i = 1; 2 * i < paths.size(); i++) {
+      paths[i] = std::move(paths[2 * i]);
+    }
+    paths.resize((paths.size() + 1) / 2);
+    pathStride *= 2;
+    if ((pathsOffered - 1) % pathStride != 0) {
+      return;
+    }
+  }
+  paths.push_back({path, page});
+}
+
+int SectionPositionTable::getPageForAnchor(const std::string& id) const {
+  for (const auto& entry : anchors) {
+    if (entry.key == id) {
+      return entry.page;
+    }
+  }
+  return -1;
+}
+
+int SectionPositionTable::getPageForPath(const std::string& path) const {
+  const std::string target = normalisePath(path);
+  if (target.empty()) {
+    return -1;
+  }
+
+  int page = -1;
+  for (const auto& entry : paths) {
+    switch (compare(entry.key, target)) {
+      case Order::Inside:
+        return entry.page;
+      case Order::Before:
+        page = entry.page;
+        break;
+      case Order::After:
+        // Entries are in document order, nothing further on can come before the target
+        return page >= 0 ? page : 0;
+      case Order::Unknown:
+        break;
+    }
+  }
+  return page;
+}
+
+std::string SectionPositionTable::getPathForPage(const int page) const {
+  const Entry* continued = nullptr;
+  for (const auto& entry : paths) {
+    if (entry.page == page) {
+      return entry.key;
+    }
+    if (entry.page > page) {
+      break;
+    }
+    continued = &entry;
+  }
+  return continued ? continued->key : "";
+}
+
+std::string SectionPositionTable::normalisePath(const std::string& path) {
+  std::string out;
+  std::string_view rest(path);
+  uint8_t steps = 0;
+  while (!rest.empty() && steps < MAX_PATH_STEPS) {
+    if (rest.front() == '/') {
+      rest.remove_prefix(1);
+      continue;
+    }
+    const size_t end = std::min(rest.find('/'), rest.size());
+    std::string_view step = rest.substr(0, end);
+    rest.remove_prefix(end);
+
+    // Text nodes are below the elements paths go down to
+    if (step.compare(0, 6, "text()") == 0) {
+      break;
+    }
+    // Character offset of an element position, e.g. "p[3].0"
+    const size_t dot = step.rfind('.');
+    if (rest.empty() && dot != std::string_view::npos &&
+        step.find_first_not_of("0123456789", dot + 1) == std::string_view::npos) {
+      step = step.substr(0, dot);
+    }
+
+    const size_t bracket = step.find('[');
+    const std::string_view name = step.substr(0, bracket);
+    if (name.empty()) {
+      break;
+    }
+    const uint32_t index = stepIndex(step, bracket);
+
+    out += '/';
+    out.append(name.data(), name.size());
+    if (index > 1) {
+      out += '[' + std::to_string(index) + ']';
+    }
+    steps++;
+  }
+  return out;
+}
+
+bool SectionPositionTable::serialize(FsFile& file) const {
+  const uint32_t start = file.position();
+  uint32_t expected = 2 * sizeof(uint16_t);
+  serialization::writePod(file, anchorCount());
+  for (const auto& entry : anchors) {
+    serialization::writeString(file, entry.key);
+    serialization::writePod(file, entry.page);
+    expected += sizeof(uint32_t) + entry.key.size() + sizeof(uint16_t);
+  }
+  serialization::writePod(file, pathCount());
+  for (const auto& entry : paths) {
+    serialization::writeString(file, entry.key);
+    serialization::writePod(file, entry.page);
+    expected += sizeof(uint32_t) + entry.key.size() + sizeof(uint16_t);
+  }
+  return file.position() - start == expected;
+}
+
+bool SectionPositionTable::deserialize(FsFile& file) {
+  anchors.clear();
+  paths.clear();
+
+  const auto readEntries = [&file](std::vector<Entry>& entries, const uint16_t max) {
+    uint16_t count;
+    serialization::readPod(file, count);
+    if (count > max) {
+      return false;
+    }
+    entries.resize(count);
+    for (auto& entry : entries) {
+      serialization::readString(file, entry.key);
+      serialization::readPod(file, entry.page);
+    }
+    return true;
+  };
+
+  if (!readEntries(anchors, MAX_ANCHORS) || !readEntries(paths, MAX_PATHS)) {
+    LOG_ERR("SPT", "Deserialization failed: table too large");
+    anchors.clear();
+    paths.clear();
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <HalStorage.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where positions inside a chapter ended up when its section file was built: the page of every anchor the table of
+// contents points at, and the page each element of the chapter body starts on. The table is appended to the section
+// file, so a TOC jump or a KOReader position lands on the right page instead of at the start of the chapter.
+//
+// Element paths are the XPath steps below <html>, the way KOReader writes them after its DocFragment step, with "[1]"
+// left out: "/body/div[2]/p[7]". They are coarse: cut off after MAX_PATH_STEPS steps, and once MAX_PATHS are stored
+// every other one is dropped and only every other block is recorded from then on, which bounds the table on giant
+// chapters.
+class SectionPositionTable {
+ public:
+  static constexpr uint16_t MAX_PATHS = 256;
+  static constexpr uint16_t MAX_ANCHORS = 256;
+  static constexpr uint8_t MAX_PATH_STEPS = 8;
+
+  // Build side. Only ids passed to addAnchorTarget() are recorded, paths must come in document order.
+  void addAnchorTarget(const std::string& id);
+  bool isAnchorTarget(const std::string& id) const;
+  void addAnchor(const std::string& id, uint16_t page);
+  void addPath(const std::string& path, uint16_t page);
+
+  // Read side, -1 if the table cannot tell
+  int getPageForAnchor(const std::string& id) const;
+  // Any element path, e.g. from a KOReader xpointer: the page of the closest recorded element at or before it
+  int getPageForPath(const std::string& path) const;
+  // Path of the first element starting on the page, or of the one the page continues; empty if none is recorded
+  std::string getPathForPage(int page) const;
+
+  uint16_t anchorCount() const { return static_cast<uint16_t>(anchors.size()); }
+  uint16_t pathCount() const { return static_cast<uint16_t>(paths.size()); }
+
+  bool serialize(FsFile& file) const;
+  bool deserialize(FsFile& file);
+
+  // "/body/div[1]/p[3]/text().5" -> "/body/div/p[3]", cut off after MAX_PATH_STEPS steps
+  static std::string normalisePath(const std::string& path);
+
+ private:
+  struct Entry {
+    std::string key;
+    uint16_t page;
+  };
+
+  std::vector<std::string> anchorTargets;  // build only
+  std::vector<Entry> anchors;
+  std::vector<Entry> paths;  // document order
+  uint32_t pathStride = 1;
+  uint32_t pathsOffered = 0;
+};
@@ -0,0 +1,117 @@
+#include "SectionWordTable.h"
+
+#include <Logging.h>
+#include <Serialization.h>
+
+uint32_t SectionWordTable::hash(const std::string& word) {
+  uint32_t h = 2166136261u;
+  for (const char c : word) {
+    h ^= static_cast<uint8_t>(c);
+    h *= 16777619u;
+  }
+  return h;
+}
+
+int SectionWordTable::intern(const std::string& word) {
+  if (word.empty() || word.size() > MAX_WORD_LENGTH) {
+    return -1;
+  }
+  if (slots.empty()) {
+    slots.assign(SLOT_COUNT, EMPTY_SLOT);
+    seen.assign(SEEN_BITS / 8, 0);
+    offsets.assign(1, 0);
+  }
+
+  const uint32_t h = hash(word);
+  uint32_t slot = h & (SLOT_COUNT - 1);
+  while (slots[slot] != EMPTY_SLOT) {
+    const uint16_t id = slots[slot];
+    const uint16_t len = offsets[id + 1] - offsets[id];
+    if (len == word.size() && pool.compare(offsets[id], len, word) == 0) {
+      return id;
+    }
+    slot = (slot + 1) & (SLOT_COUNT - 1);
+  }
+
+  // First sighting only marks the word; it is interned if it comes up again
+  const uint32_t bit = (h >> 11) % SEEN_BITS;
+  if ((seen[bit / 8] & (1 << (bit % 8))) == 0) {
+    seen[bit / 8] |= 1 << (bit % 8);
+    return -1;
+  }
+
+  if (size() >= MAX_WORDS || pool.size() + word.size() > MAX_POOL_BYTES) {
+    return -1;
+  }
+
+  const uint16_t id = size();
+  pool += word;
+  offsets.push_back(static_cast<uint16_t>(pool.size()));
+  slots[slot] = id;
+  return id;
+}
+
+void SectionWordTable::finishBuilding() {
+  slots.clear();
+  slots.shrink_to_fit();
+  seen.clear();
+  seen.shrink_to_fit();
+  pool.shrink_to_fit();
+  offsets.shrink_to_fit();
+}
+
+bool SectionWordTable::getWord(const uint32_t id, std::string& out) const {
+  if (id >= size()) {
+    return false;
+  }
+  out.assign(pool, offsets[id], offsets[id + 1] - offsets[id]);
+  return true;
+}
+
+bool SectionWordTable::serialize(FsFile& file) const {
+  const uint16_t count = size();
+  serialization::writePod(file, count);
+  serialization::writePod(file, static_cast<uint16_t>(pool.size()));
+  for (uint16_t i = 0; i < count; i++) {
+    serialization::writePod(file, static_cast<uint8_t>(offsets[i + 1] - offsets[i]));
+  }
+  return file.write(reinterpret_cast<const uint8_t*>(pool.data()), pool.size()) == pool.size();
+}
+
+bool SectionWordTable::deserialize(FsFile& file) {
+  uint16_t count;
+  uint16_t poolSize;
+  serialization::readPod(file, count);
+  serialization::readPod(file, poolSize);
+  if (count > MAX_WORDS || poolSize > MAX_POOL_BYTES) {
+    LOG_ERR("SWT", "Deserialization failed: table too large (%u words, %u bytes)", count, poolSize);
+    return false;
+  }
+
+  std::vector<uint8_t> lengths(count);
+  if (file.read(lengths.data(), count) != count) {
+    LOG_ERR("SWT", "Deserialization failed: truncated word lengths");
+    return false;
+  }
+  offsets.assign(1, 0);
+  offsets.reserve(count + 1);
+  uint32_t total = 0;
+  for (const uint8_t len : lengths) {
+    total += len;
+    offsets.push_back(static_cast<uint16_t>(total));
+  }
+  if (total != poolSize) {
+    LOG_ERR("SWT", "Deserialization failed: word lengths do not match pool size");
+    offsets.clear();
+    return false;
+  }
+
+  pool.resize(poolSize);
+  if (file.read(&pool[0], poolSize) != poolSize) {
+    LOG_ERR("SWT", "Deserialization failed: truncated word pool");
+    offsets.clear();
+    pool.clear();
+    return false;
+  }
+  return true;
+}
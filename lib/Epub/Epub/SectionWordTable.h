@@ -0,0 +1,42 @@
+#pragma once
+#include <HalStorage.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Per-section dictionary of repeated words. While a section file is built, TextBlocks reference interned words by
+// id instead of repeating the string; the table is appended to the section file and kept in RAM while it is read.
+//
+// The table is bounded (MAX_WORDS entries, MAX_POOL_BYTES of text) so it fits next to the parser on device. A word
+// is only interned the second time it is seen, which keeps one-off words from filling the table early in a chapter.
+class SectionWordTable {
+ public:
+  static constexpr uint16_t MAX_WORDS = 1024;
+  static constexpr uint16_t MAX_POOL_BYTES = 8192;
+  static constexpr uint8_t MAX_WORD_LENGTH = 255;
+
+  // Build side: id of the word, or -1 if it has to be stored inline
+  int intern(const std::string& word);
+  // Drop the lookup structures only needed while building
+  void finishBuilding();
+
+  // Read side
+  bool getWord(uint32_t id, std::string& out) const;
+  uint16_t size() const { return offsets.empty() ? 0 : static_cast<uint16_t>(offsets.size() - 1); }
+
+  bool serialize(FsFile& file) const;
+  bool deserialize(FsFile& file);
+
+ private:
+  static constexpr uint16_t SLOT_COUNT = 2048;  // power of two, at most half full
+  static constexpr uint16_t EMPTY_SLOT = 0xFFFF;
+  static constexpr uint16_t SEEN_BITS = 8192;
+
+  std::string pool;
+  std::vector<uint16_t> offsets;  // offsets[i]..offsets[i + 1] is word i in pool
+  std::vector<uint16_t> slots;    // open addressing hash of word ids, build only
+  std::vector<uint8_t> seen;      // hash bitset of words seen once, build only
+
+  static uint32_t hash(const std::string& word);
+};
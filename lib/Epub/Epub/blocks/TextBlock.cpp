@@ -4,6 +4,40 @@
 #include <Logging.h>
 #include <Serialization.h>
 
+#include "Epub/SectionWordTable.h"
+
+namespace {
+void writeBlockStyle(FsFile& file, const BlockStyle& blockStyle) {
+  serialization::writePod(file, blockStyle.alignment);
+  serialization::writePod(file, blockStyle.textAlignDefined);
+  serialization::writePod(file, blockStyle.marginTop);
+  serialization::writePod(file, blockStyle.marginBottom);
+  serialization::writePod(file, blockStyle.marginLeft);
+  serialization::writePod(file, blockStyle.marginRight);
+  serialization::writePod(file, blockStyle.paddingTop);
+  serialization::writePod(file, blockStyle.paddingBottom);
+  serialization::writePod(file, blockStyle.paddingLeft);
+  serialization::writePod(file, blockStyle.paddingRight);
+  serialization::writePod(file, blockStyle.textIndent);
+  serialization::writePod(file, blockStyle.textIndentDefined);
+}
+
+void readBlockStyle(FsFile& file, BlockStyle& blockStyle) {
+  serialization::readPod(file, blockStyle.alignment);
+  serialization::readPod(file, blockStyle.textAlignDefined);
+  serialization::readPod(file, blockStyle.marginTop);
+  serialization::readPod(file, blockStyle.marginBottom);
+  serialization::readPod(file, blockStyle.marginLeft);
+  serialization::readPod(file, blockStyle.marginRight);
+  serialization::readPod(file, blockStyle.paddingTop);
+  serialization::readPod(file, blockStyle.paddingBottom);
+  serialization::readPod(file, blockStyle.paddingLeft);
+  serialization::readPod(file, blockStyle.paddingRight);
+  serialization::readPod(file, blockStyle.textIndent);
+  serialization::readPod(file, blockStyle.textIndentDefined);
+}
+}  // namespace
+
 void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int x, const int y) const {
   // Validate iterator bounds before rendering
   if (words.size() != wordXpos.size() || words.size() != wordStyles.size()) {
@@ -48,45 +82,75 @@ void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int
   }
 }
 
-bool TextBlock::serialize(FsFile& file) const {
+bool TextBlock::serialize(FsFile& file, SectionWordTable* wordTable) const {
   if (words.size() != wordXpos.size() || words.size() != wordStyles.size()) {
     LOG_ERR("TXB", "Serialization failed: size mismatch (words=%u, xpos=%u, styles=%u)\n", words.size(),
             wordXpos.size(), wordStyles.size());
     return false;
   }
 
-  // Word data
-  serialization::writePod(file, static_cast<uint16_t>(words.size()));
-  for (const auto& w : words) serialization::writeString(file, w);
-  for (auto x : wordXpos) serialization::writePod(file, x);
-  for (auto s : wordStyles) serialization::writePod(file, s);
+  if (!wordTable) {
+    // Word data
+    serialization::writePod(file, static_cast<uint16_t>(words.size()));
+    for (const auto& w : words) serialization::writeString(file, w);
+    for (auto x : wordXpos) serialization::writePod(file, x);
+    for (auto s : wordStyles) serialization::writePod(file, s);
+  } else {
+    // Word references: 0 = inline string follows, otherwise table id + 1
+    serialization::writeVarUint(file, words.size());
+    for (const auto& w : words) {
+      const int id = wordTable->intern(w);
+      if (id >= 0) {
+        serialization::writeVarUint(file, id + 1);
+      } else {
+        serialization::writeVarUint(file, 0);
+        serialization::writeVarUint(file, w.size());
+        file.write(reinterpret_cast<const uint8_t*>(w.data()), w.size());
+      }
+    }
+
+    // X positions as deltas from the previous word
+    int32_t prevX = 0;
+    for (auto x : wordXpos) {
+      serialization::writeVarInt(file, static_cast<int32_t>(x) - prevX);
+      prevX = x;
+    }
+
+    // Styles as (run length, style) pairs; most lines use a single style throughout
+    auto styleIt = wordStyles.begin();
+    while (styleIt != wordStyles.end()) {
+      const EpdFontFamily::Style style = *styleIt;
+      uint32_t run = 0;
+      while (styleIt != wordStyles.end() && *styleIt == style) {
+        ++run;
+        ++styleIt;
+      }
+      serialization::writeVarUint(file, run);
+      serialization::writePod(file, style);
+    }
+  }
 
   // Style (alignment + margins/padding/indent)
-  serialization::writePod(file, blockStyle.alignment);
-  serialization::writePod(file, blockStyle.textAlignDefined);
-  serialization::writePod(file, blockStyle.marginTop);
-  serialization::writePod(file, blockStyle.marginBottom);
-  serialization::writePod(file, blockStyle.marginLeft);
-  serialization::writePod(file, blockStyle.marginRight);
-  serialization::writePod(file, blockStyle.paddingTop);
-  serialization::writePod(file, blockStyle.paddingBottom);
-  serialization::writePod(file, blockStyle.paddingLeft);
-  serialization::writePod(file, blockStyle.paddingRight);
-  serialization::writePod(file, blockStyle.textIndent);
-  serialization::writePod(file, blockStyle.textIndentDefined);
+  writeBlockStyle(file, blockStyle);
 
   return true;
 }
 
-std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
-  uint16_t wc;
+std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file, const SectionWordTable* wordTable) {
+  uint32_t wc;
   std::list<std::string> words;
   std::list<uint16_t> wordXpos;
   std::list<EpdFontFamily::Style> wordStyles;
   BlockStyle blockStyle;
 
   // Word count
-  serialization::readPod(file, wc);
+  if (!wordTable) {
+    uint16_t wc16;
+    serialization::readPod(file, wc16);
+    wc = wc16;
+  } else {
+    wc = serialization::readVarUint(file);
+  }
 
   // Sanity check: prevent allocation of unreasonably large lists (max 10000 words per block)
   if (wc > 10000) {
@@ -98,23 +162,52 @@ std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
   words.resize(wc);
   wordXpos.resize(wc);
   wordStyles.resize(wc);
-  for (auto& w : words) serialization::readString(file, w);
-  for (auto& x : wordXpos) serialization::readPod(file, x);
-  for (auto& s : wordStyles) serialization::readPod(file, s);
+  if (!wordTable) {
+    for (auto& w : words) serialization::readString(file, w);
+    for (auto& x : wordXpos) serialization::readPod(file, x);
+    for (auto& s : wordStyles) serialization::readPod(file, s);
+  } else {
+    for (auto& w : words) {
+      const uint32_t ref = serialization::readVarUint(file);
+      if (ref == 0) {
+        const uint32_t len = serialization::readVarUint(file);
+        if (len > 0xFFFF) {
+          LOG_ERR("TXB", "Deserialization failed: inline word length %u", len);
+          return nullptr;
+        }
+        w.resize(len);
+        file.read(&w[0], len);
+      } else if (!wordTable->getWord(ref - 1, w)) {
+        LOG_ERR("TXB", "Deserialization failed: unknown word id %u", ref - 1);
+        return nullptr;
+      }
+    }
+
+    int32_t x = 0;
+    for (auto& xpos : wordXpos) {
+      x += serialization::readVarInt(file);
+      xpos = static_cast<uint16_t>(x);
+    }
+
+    auto styleIt = wordStyles.begin();
+    uint32_t remaining = wc;
+    while (remaining > 0) {
+      const uint32_t run = serialization::readVarUint(file);
+      EpdFontFamily::Style style;
+      serialization::readPod(file, style);
+      if (run == 0 || run > remaining) {
+        LOG_ERR("TXB", "Deserialization failed: style run %u exceeds %u remaining words", run, remaining);
+        return nullptr;
+      }
+      for (uint32_t i = 0; i < run; i++, ++styleIt) {
+        *styleIt = style;
+      }
+      remaining -= run;
+    }
+  }
 
   // Style (alignment + margins/padding/indent)
-  serialization::readPod(file, blockStyle.alignment);
-  serialization::readPod(file, blockStyle.textAlignDefined);
-  serialization::readPod(file, blockStyle.marginTop);
-  serialization::readPod(file, blockStyle.marginBottom);
-  serialization::readPod(file, blockStyle.marginLeft);
-  serialization::readPod(file, blockStyle.marginRight);
-  serialization::readPod(file, blockStyle.paddingTop);
-  serialization::readPod(file, blockStyle.paddingBottom);
-  serialization::readPod(file, blockStyle.paddingLeft);
-  serialization::readPod(file, blockStyle.paddingRight);
-  serialization::readPod(file, blockStyle.textIndent);
-  serialization::readPod(file, blockStyle.textIndentDefined);
+  readBlockStyle(file, blockStyle);
 
   return std::unique_ptr<TextBlock>(
       new TextBlock(std::move(words), std::move(wordXpos), std::move(wordStyles), blockStyle));
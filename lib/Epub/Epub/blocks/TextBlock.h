@@ -9,6 +9,8 @@
 #include "Block.h"
 #include "BlockStyle.h"
 
+class SectionWordTable;
+
 // Represents a line of text on a page
 class TextBlock final : public Block {
  private:
@@ -31,6 +33,7 @@ class TextBlock final : public Block {
   // given a renderer works out where to break the words into lines
   void render(const GfxRenderer& renderer, int fontId, int x, int y) const;
   BlockType getType() override { return TEXT_BLOCK; }
-  bool serialize(FsFile& file) const;
-  static std::unique_ptr<TextBlock> deserialize(FsFile& file);
+  // With a word table, words are written as table ids and positions/styles are delta/run-length encoded
+  bool serialize(FsFile& file, SectionWordTable* wordTable = nullptr) const;
+  static std::unique_ptr<TextBlock> deserialize(FsFile& file, const SectionWordTable* wordTable = nullptr);
 };
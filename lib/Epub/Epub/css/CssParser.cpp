@@ -361,15 +361,8 @@ void CssParser::processRuleBlockWithStyle(const std::string& selectorGroup, cons
 
 // Main parsing entry point
 
-bool CssParser::loadFromStream(FsFile& source) {
-  if (!source) {
-    LOG_ERR("CSS", "Cannot read from invalid file");
-    return false;
-  }
-
-  size_t totalRead = 0;
-
-  // Use stack-allocated buffers for parsing to avoid heap reallocations
+// Tokenizer state carried across the chunks of one stylesheet
+struct CssParser::ParseState {
   StackBuffer selector;
   StackBuffer declBuffer;
   // Keep these as std::string since they're passed by reference to parseDeclarationIntoStyle
@@ -387,123 +380,159 @@ bool CssParser::loadFromStream(FsFile& source) {
   bool skippingRule = false;
   CssStyle currentStyle;
 
-  auto handleChar = [&](const char c) {
-    if (inAtRule) {
-      if (c == '{') {
-        ++atDepth;
-      } else if (c == '}') {
-        if (atDepth > 0) --atDepth;
-        if (atDepth == 0) inAtRule = false;
-      } else if (c == ';' && atDepth == 0) {
-        inAtRule = false;
-      }
-      return;
+  size_t totalRead = 0;
+};
+
+CssParser::CssParser(std::string cachePath) : cachePath(std::move(cachePath)) {}
+
+CssParser::~CssParser() = default;
+
+void CssParser::handleChar(ParseState& st, const char c) {
+  if (st.inAtRule) {
+    if (c == '{') {
+      ++st.atDepth;
+    } else if (c == '}') {
+      if (st.atDepth > 0) --st.atDepth;
+      if (st.atDepth == 0) st.inAtRule = false;
+    } else if (c == ';' && st.atDepth == 0) {
+      st.inAtRule = false;
     }
+    return;
+  }
 
-    if (bodyDepth == 0) {
-      if (selector.empty() && isCssWhitespace(c)) {
-        return;
-      }
-      if (c == '@' && selector.empty()) {
-        inAtRule = true;
-        atDepth = 0;
-        return;
-      }
-      if (c == '{') {
-        bodyDepth = 1;
-        currentStyle = CssStyle{};
-        declBuffer.clear();
-        if (selector.size() > MAX_SELECTOR_LENGTH * 4) {
-          skippingRule = true;
-        }
-        return;
-      }
-      selector.push_back(c);
+  if (st.bodyDepth == 0) {
+    if (st.selector.empty() && isCssWhitespace(c)) {
       return;
     }
-
-    // bodyDepth > 0
-    if (c == '{') {
-      ++bodyDepth;
+    if (c == '@' && st.selector.empty()) {
+      st.inAtRule = true;
+      st.atDepth = 0;
       return;
     }
-    if (c == '}') {
-      --bodyDepth;
-      if (bodyDepth == 0) {
-        if (!skippingRule && !declBuffer.empty()) {
-          parseDeclarationIntoStyle(declBuffer.str(), currentStyle, propNameBuf, propValueBuf);
-        }
-        if (!skippingRule) {
-          processRuleBlockWithStyle(selector.str(), currentStyle);
-        }
-        selector.clear();
-        declBuffer.clear();
-        skippingRule = false;
-        return;
+    if (c == '{') {
+      st.bodyDepth = 1;
+      st.currentStyle = CssStyle{};
+      st.declBuffer.clear();
+      if (st.selector.size() > MAX_SELECTOR_LENGTH * 4) {
+        st.skippingRule = true;
       }
       return;
     }
-    if (bodyDepth > 1) {
+    st.selector.push_back(c);
+    return;
+  }
+
+  // bodyDepth > 0
+  if (c == '{') {
+    ++st.bodyDepth;
+    return;
+  }
+  if (c == '}') {
+    --st.bodyDepth;
+    if (st.bodyDepth == 0) {
+      if (!st.skippingRule && !st.declBuffer.empty()) {
+        parseDeclarationIntoStyle(st.declBuffer.str(), st.currentStyle, st.propNameBuf, st.propValueBuf);
+      }
+      if (!st.skippingRule) {
+        processRuleBlockWithStyle(st.selector.str(), st.currentStyle);
+      }
+      st.selector.clear();
+      st.declBuffer.clear();
+      st.skippingRule = false;
       return;
     }
-    if (!skippingRule) {
-      if (c == ';') {
-        if (!declBuffer.empty()) {
-          parseDeclarationIntoStyle(declBuffer.str(), currentStyle, propNameBuf, propValueBuf);
-          declBuffer.clear();
-        }
-      } else {
-        declBuffer.push_back(c);
+    return;
+  }
+  if (st.bodyDepth > 1) {
+    return;
+  }
+  if (!st.skippingRule) {
+    if (c == ';') {
+      if (!st.declBuffer.empty()) {
+        parseDeclarationIntoStyle(st.declBuffer.str(), st.currentStyle, st.propNameBuf, st.propValueBuf);
+        st.declBuffer.clear();
       }
+    } else {
+      st.declBuffer.push_back(c);
     }
-  };
+  }
+}
 
-  char buffer[READ_BUFFER_SIZE];
-  while (source.available()) {
-    int bytesRead = source.read(buffer, sizeof(buffer));
-    if (bytesRead <= 0) break;
+void CssParser::beginParse() { parseState.reset(new ParseState()); }
 
-    totalRead += static_cast<size_t>(bytesRead);
+void CssParser::parseChunk(const char* data, const size_t length) {
+  if (!parseState) {
+    return;
+  }
+  ParseState& st = *parseState;
+  st.totalRead += length;
 
-    for (int i = 0; i < bytesRead; ++i) {
-      const char c = buffer[i];
+  for (size_t i = 0; i < length; ++i) {
+    const char c = data[i];
 
-      if (inComment) {
-        if (prevStar && c == '/') {
-          inComment = false;
-          prevStar = false;
-          continue;
-        }
-        prevStar = c == '*';
+    if (st.inComment) {
+      if (st.prevStar && c == '/') {
+        st.inComment = false;
+        st.prevStar = false;
         continue;
       }
+      st.prevStar = c == '*';
+      continue;
+    }
 
-      if (maybeSlash) {
-        if (c == '*') {
-          inComment = true;
-          maybeSlash = false;
-          prevStar = false;
-          continue;
-        }
-        handleChar('/');
-        maybeSlash = false;
-        // fall through to process current char
-      }
-
-      if (c == '/') {
-        maybeSlash = true;
+    if (st.maybeSlash) {
+      if (c == '*') {
+        st.inComment = true;
+        st.maybeSlash = false;
+        st.prevStar = false;
         continue;
       }
+      handleChar(st, '/');
+      st.maybeSlash = false;
+      // fall through to process current char
+    }
 
-      handleChar(c);
+    if (c == '/') {
+      st.maybeSlash = true;
+      continue;
     }
+
+    handleChar(st, c);
+  }
+}
+
+void CssParser::endParse() {
+  if (!parseState) {
+    return;
   }
+  if (parseState->maybeSlash) {
+    handleChar(*parseState, '/');
+  }
+  LOG_DBG("CSS", "Parsed %zu rules from %zu bytes", rulesBySelector_.size(), parseState->totalRead);
+  parseState.reset();
+}
+
+size_t CssParser::write(const uint8_t c) { return write(&c, 1); }
+
+size_t CssParser::write(const uint8_t* buffer, const size_t size) {
+  parseChunk(reinterpret_cast<const char*>(buffer), size);
+  return size;
+}
 
-  if (maybeSlash) {
-    handleChar('/');
+bool CssParser::loadFromStream(FsFile& source) {
+  if (!source) {
+    LOG_ERR("CSS", "Cannot read from invalid file");
+    return false;
   }
 
-  LOG_DBG("CSS", "Parsed %zu rules from %zu bytes", rulesBySelector_.size(), totalRead);
+  beginParse();
+  char buffer[READ_BUFFER_SIZE];
+  while (source.available()) {
+    const int bytesRead = source.read(buffer, sizeof(buffer));
+    if (bytesRead <= 0) break;
+    parseChunk(buffer, static_cast<size_t>(bytesRead));
+  }
+  endParse();
   return true;
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <HalStorage.h>
+#include <Print.h>
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -28,10 +30,10 @@
  *   - Media queries (content is skipped)
  *   - @import, @font-face, etc.
  */
-class CssParser {
+class CssParser final : public Print {
  public:
-  explicit CssParser(std::string cachePath) : cachePath(std::move(cachePath)) {}
-  ~CssParser() = default;
+  explicit CssParser(std::string cachePath);
+  ~CssParser() override;
 
   // Non-copyable
   CssParser(const CssParser&) = delete;
@@ -45,6 +47,16 @@ class CssParser {
    */
   bool loadFromStream(FsFile& source);
 
+  /**
+   * Parse a stylesheet written to this parser in chunks as it arrives, e.g. inflated straight out of the EPUB.
+   * Data written between beginParse() and endParse() goes through the same tokenizer as loadFromStream; comments and
+   * rules may span chunks.
+   */
+  void beginParse();
+  void endParse();
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+
   /**
    * Look up the style for an HTML element, considering tag name and class attributes.
    * Applies CSS cascade: element style < class style < element.class style
@@ -101,7 +113,13 @@ class CssParser {
 
   std::string cachePath;
 
+  struct ParseState;
+  // Only allocated while a stylesheet is being parsed
+  std::unique_ptr<ParseState> parseState;
+
   // Internal parsing helpers
+  void handleChar(ParseState& st, char c);
+  void parseChunk(const char* data, size_t length);
   void processRuleBlockWithStyle(const std::string& selectorGroup, const CssStyle& style);
   static CssStyle parseDeclarations(const std::string& declBlock);
   static void parseDeclarationIntoStyle(const std::string& decl, CssStyle& style, std::string& propNameBuf,
@@ -0,0 +1,97 @@
+#include "HyphenationPack.h"
+
+#include <HalStorage.h>
+#include <Logging.h>
+#include <Serialization.h>
+
+#include <cstring>
+#include <new>
+
+#include "HyphenationCommon.h"
+
+namespace {
+constexpr char PACK_MAGIC[4] = {'H', 'Y', 'P', 'H'};
+constexpr uint8_t PACK_FILE_VERSION = 1;
+
+enum class PackScript : uint8_t { LATIN = 0, CYRILLIC = 1 };
+}  // namespace
+
+std::string HyphenationPack::pathFor(const std::string& primaryTag) {
+  return std::string(DIRECTORY) + "/" + primaryTag + ".hyph";
+}
+
+bool HyphenationPack::load(const std::string& path) {
+  languageHyphenator.reset();
+  tables.clear();
+  trie.reset();
+
+  FsFile file;
+  if (!Storage.openFileForRead("HYP", path, file)) {
+    return false;
+  }
+
+  char magic[sizeof(PACK_MAGIC)];
+  uint8_t version = 0, script = 0, minPrefix = 0, minSuffix = 0, tableCount = 0;
+  uint32_t rootOffset = 0, trieSize = 0;
+  const bool headerRead = file.read(magic, sizeof(magic)) == sizeof(magic);
+  serialization::readPod(file, version);
+  if (!headerRead || memcmp(magic, PACK_MAGIC, sizeof(magic)) != 0 || version != PACK_FILE_VERSION) {
+    LOG_ERR("HYP", "Deserialization failed: %s is not a version %u pattern pack", path.c_str(), PACK_FILE_VERSION);
+    file.close();
+    return false;
+  }
+  serialization::readPod(file, script);
+  serialization::readPod(file, minPrefix);
+  serialization::readPod(file, minSuffix);
+  serialization::readPod(file, rootOffset);
+  serialization::readPod(file, trieSize);
+  serialization::readPod(file, tableCount);
+  if (script > static_cast<uint8_t>(PackScript::CYRILLIC) || trieSize == 0 || rootOffset >= trieSize ||
+      tableCount > MAX_DISPATCH_TABLES) {
+    LOG_ERR("HYP", "Pattern pack %s is corrupt", path.c_str());
+    file.close();
+    return false;
+  }
+  if (trieSize > MAX_TRIE_SIZE) {
+    LOG_ERR("HYP", "Pattern pack %s is too large (%u bytes)", path.c_str(), trieSize);
+    file.close();
+    return false;
+  }
+
+  tables.resize(tableCount);
+  bool ok = true;
+  for (auto& table : tables) {
+    ok = ok && file.read(reinterpret_cast<uint8_t*>(&table.node), sizeof(table.node)) == sizeof(table.node) &&
+         file.read(reinterpret_cast<uint8_t*>(table.targets), sizeof(table.targets)) == sizeof(table.targets);
+    for (const uint32_t target : table.targets) {
+      ok = ok && (target == LiangDispatchTable::kNoChild || target < trieSize);
+    }
+  }
+  // The first table has to be the root's, liangBreakIndexes looks tables up by node address
+  ok = ok && (tables.empty() || tables.front().node == rootOffset);
+
+  trie.reset(new (std::nothrow) uint8_t[trieSize]);
+  if (!trie) {
+    LOG_ERR("HYP", "Failed to allocate %u bytes for pattern pack %s", trieSize, path.c_str());
+    tables.clear();
+    file.close();
+    return false;
+  }
+  ok = ok && file.read(trie.get(), trieSize) == static_cast<int>(trieSize);
+  file.close();
+  if (!ok) {
+    LOG_ERR("HYP", "Pattern pack %s is corrupt", path.c_str());
+    tables.clear();
+    trie.reset();
+    return false;
+  }
+
+  patterns = SerializedHyphenationPatterns{rootOffset, trie.get(), trieSize};
+  if (static_cast<PackScript>(script) == PackScript::CYRILLIC) {
+    languageHyphenator.reset(new LanguageHyphenator(patterns, isCyrillicLetter, toLowerCyrillic, minPrefix, minSuffix));
+  } else {
+    languageHyphenator.reset(new LanguageHyphenator(patterns, isLatinLetter, toLowerLatin, minPrefix, minSuffix));
+  }
+  LOG_DBG("HYP", "Loaded pattern pack %s (%u bytes, %u dispatch tables)", path.c_str(), trieSize, tableCount);
+  return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LanguageHyphenator.h"
+
+/**
+ * Liang patterns for a language that is not compiled into the firmware, loaded from a pattern pack on the SD card.
+ * Packs are written by scripts/generate_hyphenation_trie.py and live in DIRECTORY as <primary language tag>.hyph.
+ *
+ * File layout (little endian):
+ * - "HYPH", u8 version
+ * - u8 script (0: Latin, 1: Cyrillic), u8 minimum prefix, u8 minimum suffix
+ * - u32 root offset, u32 trie size
+ * - u8 dispatch table count, then per table: u32 node address, 256 x u32 child address (see LiangDispatchTable)
+ * - the trie, in the same format as the generated hyph-*.trie.h headers
+ *
+ * The trie is held in RAM while the pack is loaded, so packs larger than MAX_TRIE_SIZE are rejected.
+ */
+class HyphenationPack {
+ public:
+  static constexpr char DIRECTORY[] = "/hyphenation";
+  static constexpr size_t MAX_TRIE_SIZE = 64 * 1024;
+  static constexpr size_t MAX_DISPATCH_TABLES = 8;
+
+  HyphenationPack() = default;
+  HyphenationPack(const HyphenationPack&) = delete;
+  HyphenationPack& operator=(const HyphenationPack&) = delete;
+
+  // Path of the pack for a primary language tag such as "nl"
+  static std::string pathFor(const std::string& primaryTag);
+
+  bool load(const std::string& path);
+
+  // nullptr until load() succeeded
+  const LanguageHyphenator* hyphenator() const { return languageHyphenator.get(); }
+  const std::vector<LiangDispatchTable>& dispatchTables() const { return tables; }
+
+ private:
+  std::unique_ptr<uint8_t[]> trie;
+  SerializedHyphenationPatterns patterns{};
+  std::vector<LiangDispatchTable> tables;
+  std::unique_ptr<LanguageHyphenator> languageHyphenator;
+};
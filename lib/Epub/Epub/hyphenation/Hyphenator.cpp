@@ -1,19 +1,23 @@
 #include "Hyphenator.h"
 
+#include <HalStorage.h>
+
 #include <vector>
 
 #include "HyphenationCommon.h"
+#include "HyphenationPack.h"
 #include "LanguageRegistry.h"
 
 const LanguageHyphenator* Hyphenator::cachedHyphenator_ = nullptr;
+std::string Hyphenator::cachedLanguage_;
+std::unique_ptr<HyphenationPack> Hyphenator::pack_;
+std::vector<LiangDispatchTable> Hyphenator::builtinDispatch_;
+const std::vector<LiangDispatchTable>* Hyphenator::cachedDispatch_ = nullptr;
 
 namespace {
 
-// Maps a BCP-47 language tag to a language-specific hyphenator.
-const LanguageHyphenator* hyphenatorForLanguage(const std::string& langTag) {
-  if (langTag.empty()) return nullptr;
-
-  // Extract primary subtag and normalize to lowercase (e.g., "en-US" -> "en").
+// Extracts the primary subtag of a BCP-47 language tag, normalized to lowercase (e.g., "en-US" -> "en").
+std::string primaryLanguageTag(const std::string& langTag) {
   std::string primary;
   primary.reserve(langTag.size());
   for (char c : langTag) {
@@ -21,9 +25,7 @@ const LanguageHyphenator* hyphenatorForLanguage(const std::string& langTag) {
     if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
     primary.push_back(c);
   }
-  if (primary.empty()) return nullptr;
-
-  return getLanguageHyphenatorForPrimaryTag(primary);
+  return primary;
 }
 
 // Maps a codepoint index back to its byte offset inside the source word.
@@ -69,7 +71,7 @@ std::vector<Hyphenator::BreakInfo> Hyphenator::breakOffsets(const std::string& w
   // Ask language hyphenator for legal break points.
   std::vector<size_t> indexes;
   if (hyphenator) {
-    indexes = hyphenator->breakIndexes(cps);
+    indexes = hyphenator->breakIndexes(cps, cachedDispatch_);
   }
 
   // Only add fallback breaks if needed
@@ -94,4 +96,37 @@ std::vector<Hyphenator::BreakInfo> Hyphenator::breakOffsets(const std::string& w
   return breaks;
 }
 
-void Hyphenator::setPreferredLanguage(const std::string& lang) { cachedHyphenator_ = hyphenatorForLanguage(lang); }
+void Hyphenator::setPreferredLanguage(const std::string& lang) {
+  const std::string primary = primaryLanguageTag(lang);
+  if (primary == cachedLanguage_) {
+    return;  // Called for every section, the patterns of the book's language are usually ready
+  }
+  cachedLanguage_ = primary;
+  cachedHyphenator_ = nullptr;
+  cachedDispatch_ = nullptr;
+  builtinDispatch_.clear();
+  builtinDispatch_.shrink_to_fit();
+  pack_.reset();
+  if (primary.empty()) {
+    return;
+  }
+
+  if (const auto* builtin = getLanguageHyphenatorForPrimaryTag(primary)) {
+    cachedHyphenator_ = builtin;
+    builtinDispatch_ = buildLiangDispatchTables(builtin->patterns(), kBuiltinHotNodes);
+    cachedDispatch_ = &builtinDispatch_;
+    return;
+  }
+
+  const std::string path = HyphenationPack::pathFor(primary);
+  if (!Storage.exists(path.c_str())) {
+    return;
+  }
+  pack_.reset(new HyphenationPack());
+  if (!pack_->load(path)) {
+    pack_.reset();
+    return;
+  }
+  cachedHyphenator_ = pack_->hyphenator();
+  cachedDispatch_ = &pack_->dispatchTables();
+}
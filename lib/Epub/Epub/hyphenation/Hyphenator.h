@@ -1,9 +1,13 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "SerializedHyphenationTrie.h"
+
+class HyphenationPack;
 class LanguageHyphenator;
 
 class Hyphenator {
@@ -16,9 +20,17 @@ class Hyphenator {
   // minimum prefix/suffix constraints are returned even if no language-specific rule matches.
   static std::vector<BreakInfo> breakOffsets(const std::string& word, bool includeFallback);
 
-  // Provide a publication-level language hint (e.g. "en", "en-US", "ru") used to select hyphenation rules.
+  // Provide a publication-level language hint (e.g. "en", "en-US", "ru") used to select hyphenation rules. Languages
+  // that are not built in are loaded from a pattern pack on the SD card (see HyphenationPack) if there is one.
   static void setPreferredLanguage(const std::string& lang);
 
+  // Dispatch tables built for the root and this many first-level nodes of a built-in trie, 1 KB each
+  static constexpr size_t kBuiltinHotNodes = 2;
+
  private:
   static const LanguageHyphenator* cachedHyphenator_;
+  static std::string cachedLanguage_;
+  static std::unique_ptr<HyphenationPack> pack_;
+  static std::vector<LiangDispatchTable> builtinDispatch_;
+  static const std::vector<LiangDispatchTable>* cachedDispatch_;
 };
\ No newline at end of file
@@ -10,10 +10,12 @@ class LanguageHyphenator {
                      size_t minSuffix = LiangWordConfig::kDefaultMinSuffix)
       : patterns_(patterns), config_(isLetterFn, toLowerFn, minPrefix, minSuffix) {}
 
-  std::vector<size_t> breakIndexes(const std::vector<CodepointInfo>& cps) const {
-    return liangBreakIndexes(cps, patterns_, config_);
+  std::vector<size_t> breakIndexes(const std::vector<CodepointInfo>& cps,
+                                   const std::vector<LiangDispatchTable>* dispatch = nullptr) const {
+    return liangBreakIndexes(cps, patterns_, config_, dispatch);
   }
 
+  const SerializedHyphenationPatterns& patterns() const { return patterns_; }
   size_t minPrefix() const { return config_.minPrefix; }
   size_t minSuffix() const { return config_.minSuffix; }
 
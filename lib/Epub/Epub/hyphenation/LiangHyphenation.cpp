@@ -1,6 +1,7 @@
 #include "LiangHyphenation.h"
 
 #include <algorithm>
+#include <iterator>
 #include <vector>
 
 /*
@@ -24,8 +25,9 @@
  *       nodes, and an optional pointer into a shared "levels" list. We parse
  *       that layout lazily via decodeState/transition, keeping everything in
  *       flash memory; no heap allocations besides the stack-local AutomatonState
- *       structs. getAutomaton caches parseAutomaton results per blob pointer so
- *       multiple words hitting the same language only pay the cost once.
+ *       structs. The root and the busiest first-level nodes are visited for
+ *       nearly every byte, so when dispatch tables are supplied those steps
+ *       are a single table lookup instead of a scan of the child list.
  *
  * 3.  Pattern application
  *     - We walk the augmented bytes left-to-right. For each starting byte we
@@ -253,6 +255,39 @@ bool transition(const EmbeddedAutomaton& automaton, const AutomatonState& state,
   return false;
 }
 
+// Dispatch table for the node reached after `depth` bytes of a match, if one was built. Matches start at the root,
+// whose table comes first; the others belong to first-level nodes, so deeper nodes never have one.
+const LiangDispatchTable* findDispatchTable(const std::vector<LiangDispatchTable>* dispatch, const size_t depth,
+                                            const size_t addr) {
+  if (!dispatch || dispatch->empty() || depth > 1) {
+    return nullptr;
+  }
+  if (depth == 0) {
+    return &dispatch->front();
+  }
+  for (auto table = dispatch->begin() + 1; table != dispatch->end(); ++table) {
+    if (table->node == addr) {
+      return &*table;
+    }
+  }
+  return nullptr;
+}
+
+// Fills table with the children of state, returning false if a child lies outside the blob.
+bool fillDispatchTable(const EmbeddedAutomaton& automaton, const AutomatonState& state, LiangDispatchTable& table) {
+  table.node = static_cast<uint32_t>(state.addr);
+  std::fill(std::begin(table.targets), std::end(table.targets), LiangDispatchTable::kNoChild);
+  for (size_t idx = 0; idx < state.childCount; ++idx) {
+    const int64_t nextAddr =
+        static_cast<int64_t>(state.addr) + decodeDelta(state.targets + idx * state.stride, state.stride);
+    if (nextAddr < 0 || static_cast<size_t>(nextAddr) >= automaton.size) {
+      return false;
+    }
+    table.targets[state.transitions[idx]] = static_cast<uint32_t>(nextAddr);
+  }
+  return true;
+}
+
 // Converts odd score positions back into codepoint indexes, honoring min prefix/suffix constraints.
 // Each break corresponds to scores[breakIndex + 1] because of the leading '.' sentinel.
 // Convert odd score entries into hyphen positions while honoring prefix/suffix limits.
@@ -291,7 +326,8 @@ std::vector<size_t> collectBreakIndexes(const std::vector<CodepointInfo>& cps, c
 
 // Entry point that runs the full Liang pipeline for a single word.
 std::vector<size_t> liangBreakIndexes(const std::vector<CodepointInfo>& cps,
-                                      const SerializedHyphenationPatterns& patterns, const LiangWordConfig& config) {
+                                      const SerializedHyphenationPatterns& patterns, const LiangWordConfig& config,
+                                      const std::vector<LiangDispatchTable>* dispatch) {
   const auto augmented = buildAugmentedWord(cps, config);
   if (augmented.empty()) {
     return {};
@@ -314,7 +350,17 @@ std::vector<size_t> liangBreakIndexes(const std::vector<CodepointInfo>& cps,
 
     for (size_t cursor = byteStart; cursor < augmented.bytes.size(); ++cursor) {
       AutomatonState next;
-      if (!transition(automaton, state, augmented.bytes[cursor], next)) {
+      const LiangDispatchTable* table = findDispatchTable(dispatch, cursor - byteStart, state.addr);
+      if (table) {
+        const uint32_t target = table->targets[augmented.bytes[cursor]];
+        if (target == LiangDispatchTable::kNoChild) {
+          break;
+        }
+        next = decodeState(automaton, target);
+        if (!next.valid()) {
+          break;
+        }
+      } else if (!transition(automaton, state, augmented.bytes[cursor], next)) {
         break;  // No more matches for this prefix.
       }
       state = next;
@@ -353,3 +399,44 @@ std::vector<size_t> liangBreakIndexes(const std::vector<CodepointInfo>& cps,
 
   return collectBreakIndexes(cps, scores, config.minPrefix, config.minSuffix);
 }
+
+std::vector<LiangDispatchTable> buildLiangDispatchTables(const SerializedHyphenationPatterns& patterns,
+                                                         const size_t hotNodes) {
+  std::vector<LiangDispatchTable> tables;
+  const AutomatonState root = decodeState(patterns, patterns.rootOffset);
+  if (!root.valid()) {
+    return tables;
+  }
+  tables.reserve(hotNodes + 1);
+  tables.emplace_back();
+  if (!fillDispatchTable(patterns, root, tables.back())) {
+    tables.clear();
+    return tables;
+  }
+
+  std::vector<AutomatonState> children;
+  for (const uint32_t target : tables.front().targets) {
+    if (target == LiangDispatchTable::kNoChild) {
+      continue;
+    }
+    const AutomatonState child = decodeState(patterns, target);
+    if (child.valid() && child.childCount > 0) {
+      children.push_back(child);
+    }
+  }
+  std::sort(children.begin(), children.end(), [](const AutomatonState& a, const AutomatonState& b) {
+    return a.childCount != b.childCount ? a.childCount > b.childCount : a.addr < b.addr;
+  });
+  // The trie is a minimized automaton, several bytes can lead to the same node
+  children.erase(std::unique(children.begin(), children.end(),
+                             [](const AutomatonState& a, const AutomatonState& b) { return a.addr == b.addr; }),
+                 children.end());
+
+  for (size_t i = 0; i < children.size() && i < hotNodes; ++i) {
+    tables.emplace_back();
+    if (!fillDispatchTable(patterns, children[i], tables.back())) {
+      tables.pop_back();
+    }
+  }
+  return tables;
+}
@@ -33,6 +33,13 @@ struct LiangWordConfig {
       : isLetter(letterFn), toLower(lowerFn), minPrefix(prefix), minSuffix(suffix) {}
 };
 
-// Shared Liang pattern evaluator used by every language-specific hyphenator.
+// Shared Liang pattern evaluator used by every language-specific hyphenator. dispatch optionally holds tables for the
+// root (first entry) and first-level nodes, as built by buildLiangDispatchTables.
 std::vector<size_t> liangBreakIndexes(const std::vector<CodepointInfo>& cps,
-                                      const SerializedHyphenationPatterns& patterns, const LiangWordConfig& config);
+                                      const SerializedHyphenationPatterns& patterns, const LiangWordConfig& config,
+                                      const std::vector<LiangDispatchTable>* dispatch = nullptr);
+
+// Builds the dispatch table of the root plus those of the hotNodes first-level nodes with the most children (ties go
+// to the lower address). scripts/generate_hyphenation_trie.py makes the same choice for pattern packs.
+std::vector<LiangDispatchTable> buildLiangDispatchTables(const SerializedHyphenationPatterns& patterns,
+                                                         size_t hotNodes);
@@ -3,9 +3,20 @@
 #include <cstddef>
 #include <cstdint>
 
-// Lightweight descriptor that points at a serialized Liang hyphenation trie stored in flash.
+// Lightweight descriptor that points at a serialized Liang hyphenation trie stored in flash (or in RAM for a pattern
+// pack loaded from the SD card).
 struct SerializedHyphenationPatterns {
   size_t rootOffset;
   const std::uint8_t* data;
   size_t size;
 };
+
+// Transition table for a single trie node: the address of the child reached by every input byte. Every match starts
+// at the root and most continue through one of a few busy first-level nodes, so those are looked up here instead of
+// scanning their packed child lists.
+struct LiangDispatchTable {
+  static constexpr std::uint32_t kNoChild = 0xFFFFFFFFu;
+
+  std::uint32_t node;
+  std::uint32_t targets[256];
+};
@@ -6,11 +6,15 @@
 #include <Logging.h>
 #include <expat.h>
 
+#include <algorithm>
+
 #include "../../Epub.h"
 #include "../Page.h"
+#include "../SectionPositionTable.h"
 #include "../converters/ImageDecoderFactory.h"
 #include "../converters/ImageToFramebufferDecoder.h"
 #include "../htmlEntities.h"
+#include "XhtmlTokenizer.h"
 
 const char* HEADER_TAGS[] = {"h1", "h2", "h3", "h4", "h5", "h6"};
 constexpr int NUM_HEADER_TAGS = sizeof(HEADER_TAGS) / sizeof(HEADER_TAGS[0]);
@@ -74,6 +78,43 @@ void ChapterHtmlSlimParser::updateEffectiveInlineStyle() {
   }
 }
 
+void ChapterHtmlSlimParser::completePage() {
+  completePageFn(std::move(currentPage));
+  completedPages++;
+}
+
+// Track the element path of a new element: its tag name and index among the siblings of the same name
+void ChapterHtmlSlimParser::enterElement(const char* name) {
+  OpenElement element;
+  element.depth = depth;
+  // The root element is not part of the path, KOReader paths start at <body>
+  if (!openElements.empty()) {
+    auto& counts = openElements.back().childCounts;
+    const auto it = std::find_if(counts.begin(), counts.end(),
+                                 [name](const std::pair<std::string, uint16_t>& count) { return count.first == name; });
+    uint16_t index = 1;
+    if (it == counts.end()) {
+      counts.emplace_back(name, 1);
+    } else {
+      index = ++it->second;
+    }
+    element.step = std::string("/") + name;
+    if (index > 1) {
+      element.step += '[' + std::to_string(index) + ']';
+    }
+  }
+  openElements.push_back(std::move(element));
+}
+
+std::string ChapterHtmlSlimParser::currentElementPath(const bool includeInnermost) const {
+  std::string path;
+  const size_t count = includeInnermost || openElements.empty() ? openElements.size() : openElements.size() - 1;
+  for (size_t i = 0; i < count && i <= SectionPositionTable::MAX_PATH_STEPS; i++) {
+    path += openElements[i].step;
+  }
+  return path;
+}
+
 // flush the contents of partWordBuffer to currentTextBlock
 void ChapterHtmlSlimParser::flushPartWordBuffer() {
   // Determine font style from depth-based tracking and CSS effective style
@@ -93,11 +134,24 @@ void ChapterHtmlSlimParser::flushPartWordBuffer() {
     fontStyle = static_cast<EpdFontFamily::Style>(fontStyle | EpdFontFamily::UNDERLINE);
   }
 
+  // Anchors seen since the last word point at this one; they get the page of the next line the block emits
+  if (!pendingAnchors.empty()) {
+    blockAnchors.insert(blockAnchors.end(), pendingAnchors.begin(), pendingAnchors.end());
+    pendingAnchors.clear();
+  }
+
   // flush the buffer
   partWordBuffer[partWordBufferIndex] = '\0';
   currentTextBlock->addWord(partWordBuffer, fontStyle, false, nextWordContinues);
   partWordBufferIndex = 0;
   nextWordContinues = false;
+
+  // Lay out giant paragraphs as they stream in rather than buffering every word of the paragraph. Checked per word
+  // so the result does not depend on how the text happened to be chunked.
+  // Spotted when reading Intermezzo, there are some really long text blocks in there.
+  if (currentTextBlock->needsStreamingLayout()) {
+    layoutCurrentTextBlock(false);
+  }
 }
 
 // start a new text block if needed
@@ -110,12 +164,20 @@ void ChapterHtmlSlimParser::startNewTextBlock(const BlockStyle& blockStyle) {
       // This handles cases like <div style="margin-bottom:2em"><h1>text</h1></div> where the
       // div's margin should be preserved, even though it has no direct text content.
       currentTextBlock->setBlockStyle(currentTextBlock->getBlockStyle().getCombinedBlockStyle(blockStyle));
+      if (positionTable) {
+        blockPath = currentElementPath();
+      }
       return;
     }
 
     makePages();
   }
   currentTextBlock.reset(new ParsedText(extraParagraphSpacing, hyphenationEnabled, blockStyle));
+  currentTextBlockStarted = false;
+  if (positionTable) {
+    blockPath = currentElementPath();
+    blockPathRecorded = false;
+  }
 }
 
 void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char* name, const XML_Char** atts) {
@@ -127,7 +189,11 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
     return;
   }
 
-  // Extract class and style attributes for CSS processing
+  if (self->positionTable) {
+    self->enterElement(name);
+  }
+
+  // Extract class and style attributes for CSS processing, and ids the table of contents points at
   std::string classAttr;
   std::string styleAttr;
   if (atts != nullptr) {
@@ -136,6 +202,9 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
         classAttr = atts[i + 1];
       } else if (strcmp(atts[i], "style") == 0) {
         styleAttr = atts[i + 1];
+      } else if ((strcmp(atts[i], "id") == 0 || strcmp(atts[i], "name") == 0) && self->positionTable &&
+                 self->positionTable->isAnchorTarget(atts[i + 1])) {
+        self->pendingAnchors.emplace_back(atts[i + 1]);
       }
     }
   }
@@ -219,7 +288,7 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
               // Create page for image - only break if image won't fit remaining space
               if (self->currentPage && !self->currentPage->elements.empty() &&
                   (self->currentPageNextY + displayHeight > self->viewportHeight)) {
-                self->completePageFn(std::move(self->currentPage));
+                self->completePage();
                 self->currentPage.reset(new Page());
                 if (!self->currentPage) {
                   LOG_ERR("EHP", "Failed to create new page");
@@ -250,6 +319,15 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
               self->currentPage->elements.push_back(pageImage);
               self->currentPageNextY += displayHeight;
 
+              if (self->positionTable) {
+                const auto page = static_cast<uint16_t>(self->completedPages);
+                self->positionTable->addPath(self->currentElementPath(), page);
+                for (const auto& id : self->pendingAnchors) {
+                  self->positionTable->addAnchor(id, page);
+                }
+                self->pendingAnchors.clear();
+              }
+
               self->depth += 1;
               return;
             } else {
@@ -333,6 +411,10 @@ void XMLCALL ChapterHtmlSlimParser::startElement(void* userData, const XML_Char*
         self->flushPartWordBuffer();
       }
       self->startNewTextBlock(self->currentTextBlock->getBlockStyle());
+      if (self->positionTable) {
+        // Text after a line break belongs to the element around the <br>
+        self->blockPath = self->currentElementPath(false);
+      }
     } else {
       self->currentCssStyle = cssStyle;
       self->startNewTextBlock(userAlignmentBlockStyle);
@@ -502,17 +584,6 @@ void XMLCALL ChapterHtmlSlimParser::characterData(void* userData, const XML_Char
 
     self->partWordBuffer[self->partWordBufferIndex++] = s[i];
   }
-
-  // If we have > 750 words buffered up, perform the layout and consume out all but the last line
-  // There should be enough here to build out 1-2 full pages and doing this will free up a lot of
-  // memory.
-  // Spotted when reading Intermezzo, there are some really long text blocks in there.
-  if (self->currentTextBlock->size() > 750) {
-    LOG_DBG("EHP", "Text block too long, splitting into multiple pages");
-    self->currentTextBlock->layoutAndExtractLines(
-        self->renderer, self->fontId, self->viewportWidth,
-        [self](const std::shared_ptr<TextBlock>& textBlock) { self->addLineToPage(textBlock); }, false);
-  }
 }
 
 void XMLCALL ChapterHtmlSlimParser::defaultHandlerExpand(void* userData, const XML_Char* s, const int len) {
@@ -567,6 +638,10 @@ void XMLCALL ChapterHtmlSlimParser::endElement(void* userData, const XML_Char* n
 
   self->depth -= 1;
 
+  if (!self->openElements.empty() && self->openElements.back().depth == self->depth) {
+    self->openElements.pop_back();
+  }
+
   // Leaving skip
   if (self->skipUntilDepth == self->depth) {
     self->skipUntilDepth = INT_MAX;
@@ -611,6 +686,47 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   paragraphAlignmentBlockStyle.alignment = align;
   startNewTextBlock(paragraphAlignmentBlockStyle);
 
+  FsFile file;
+  if (!Storage.openFileForRead("EHP", filepath, file)) {
+    return false;
+  }
+
+  // Get file size to decide whether to show indexing popup.
+  if (popupFn && file.size() >= MIN_SIZE_FOR_POPUP) {
+    popupFn();
+  }
+
+  const bool parsed = useXhtmlTokenizer ? parseWithTokenizer(file) : parseWithExpat(file);
+  file.close();
+  if (!parsed) {
+    return false;
+  }
+
+  // Process last page if there is still text
+  if (currentTextBlock) {
+    makePages();
+    completePage();
+    currentPage.reset();
+    currentTextBlock.reset();
+  }
+
+  // Anchors with no content after them point at the end of the chapter
+  if (positionTable) {
+    const auto lastPage = static_cast<uint16_t>(std::max(0, completedPages - 1));
+    for (const auto& id : blockAnchors) {
+      positionTable->addAnchor(id, lastPage);
+    }
+    for (const auto& id : pendingAnchors) {
+      positionTable->addAnchor(id, lastPage);
+    }
+    blockAnchors.clear();
+    pendingAnchors.clear();
+  }
+
+  return true;
+}
+
+bool ChapterHtmlSlimParser::parseWithExpat(FsFile& file) {
   const XML_Parser parser = XML_ParserCreate(nullptr);
   int done;
 
@@ -623,17 +739,6 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   // Using DefaultHandlerExpand preserves normal entity expansion from DOCTYPE
   XML_SetDefaultHandlerExpand(parser, defaultHandlerExpand);
 
-  FsFile file;
-  if (!Storage.openFileForRead("EHP", filepath, file)) {
-    XML_ParserFree(parser);
-    return false;
-  }
-
-  // Get file size to decide whether to show indexing popup.
-  if (popupFn && file.size() >= MIN_SIZE_FOR_POPUP) {
-    popupFn();
-  }
-
   XML_SetUserData(parser, this);
   XML_SetElementHandler(parser, startElement, endElement);
   XML_SetCharacterDataHandler(parser, characterData);
@@ -646,7 +751,6 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
       XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
       XML_SetCharacterDataHandler(parser, nullptr);
       XML_ParserFree(parser);
-      file.close();
       return false;
     }
 
@@ -658,7 +762,6 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
       XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
       XML_SetCharacterDataHandler(parser, nullptr);
       XML_ParserFree(parser);
-      file.close();
       return false;
     }
 
@@ -671,7 +774,6 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
       XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
       XML_SetCharacterDataHandler(parser, nullptr);
       XML_ParserFree(parser);
-      file.close();
       return false;
     }
   } while (!done);
@@ -680,15 +782,33 @@ bool ChapterHtmlSlimParser::parseAndBuildPages() {
   XML_SetElementHandler(parser, nullptr, nullptr);  // Clear callbacks
   XML_SetCharacterDataHandler(parser, nullptr);
   XML_ParserFree(parser);
-  file.close();
+  return true;
+}
 
-  // Process last page if there is still text
-  if (currentTextBlock) {
-    makePages();
-    completePageFn(std::move(currentPage));
-    currentPage.reset();
-    currentTextBlock.reset();
-  }
+bool ChapterHtmlSlimParser::parseWithTokenizer(FsFile& file) {
+  XhtmlTokenizer tokenizer;
+  tokenizer.setUserData(this);
+  tokenizer.setElementHandler(startElement, endElement);
+  tokenizer.setCharacterDataHandler(characterData);
+
+  bool done;
+  do {
+    const size_t space = std::min<size_t>(1024, tokenizer.getBufferSpace());
+    char* const buf = tokenizer.getBuffer(space);
+    if (!buf) {
+      LOG_ERR("EHP", "Couldn't allocate memory for buffer");
+      return false;
+    }
+
+    const size_t len = file.read(buf, space);
+    if (len == 0 && file.available() > 0) {
+      LOG_ERR("EHP", "File read error");
+      return false;
+    }
+
+    done = file.available() == 0;
+    tokenizer.parseBuffer(len, done);
+  } while (!done);
 
   return true;
 }
@@ -697,37 +817,47 @@ void ChapterHtmlSlimParser::addLineToPage(std::shared_ptr<TextBlock> line) {
   const int lineHeight = renderer.getLineHeight(fontId) * lineCompression;
 
   if (currentPageNextY + lineHeight > viewportHeight) {
-    completePageFn(std::move(currentPage));
+    completePage();
     currentPage.reset(new Page());
     currentPageNextY = 0;
   }
 
+  if (positionTable) {
+    const auto page = static_cast<uint16_t>(completedPages);
+    if (!blockPathRecorded) {
+      positionTable->addPath(blockPath, page);
+      blockPathRecorded = true;
+    }
+    for (const auto& id : blockAnchors) {
+      positionTable->addAnchor(id, page);
+    }
+    blockAnchors.clear();
+  }
+
   // Apply horizontal left inset (margin + padding) as x position offset
   const int16_t xOffset = line->getBlockStyle().leftInset();
   currentPage->elements.push_back(std::make_shared<PageLine>(line, xOffset, currentPageNextY));
   currentPageNextY += lineHeight;
 }
 
-void ChapterHtmlSlimParser::makePages() {
-  if (!currentTextBlock) {
-    LOG_ERR("EHP", "!! No text block to make pages for !!");
-    return;
-  }
-
+// Emit the lines of the current text block. Top spacing is applied once, before the block's first line, even when
+// a giant paragraph is laid out over several streaming passes.
+void ChapterHtmlSlimParser::layoutCurrentTextBlock(const bool includeLastLine) {
   if (!currentPage) {
     currentPage.reset(new Page());
     currentPageNextY = 0;
   }
 
-  const int lineHeight = renderer.getLineHeight(fontId) * lineCompression;
-
   // Apply top spacing before the paragraph (stored in pixels)
   const BlockStyle& blockStyle = currentTextBlock->getBlockStyle();
-  if (blockStyle.marginTop > 0) {
-    currentPageNextY += blockStyle.marginTop;
-  }
-  if (blockStyle.paddingTop > 0) {
-    currentPageNextY += blockStyle.paddingTop;
+  if (!currentTextBlockStarted) {
+    if (blockStyle.marginTop > 0) {
+      currentPageNextY += blockStyle.marginTop;
+    }
+    if (blockStyle.paddingTop > 0) {
+      currentPageNextY += blockStyle.paddingTop;
+    }
+    currentTextBlockStarted = true;
   }
 
   // Calculate effective width accounting for horizontal margins/padding
@@ -737,7 +867,19 @@ void ChapterHtmlSlimParser::makePages() {
 
   currentTextBlock->layoutAndExtractLines(
       renderer, fontId, effectiveWidth,
-      [this](const std::shared_ptr<TextBlock>& textBlock) { addLineToPage(textBlock); });
+      [this](const std::shared_ptr<TextBlock>& textBlock) { addLineToPage(textBlock); }, includeLastLine);
+}
+
+void ChapterHtmlSlimParser::makePages() {
+  if (!currentTextBlock) {
+    LOG_ERR("EHP", "!! No text block to make pages for !!");
+    return;
+  }
+
+  layoutCurrentTextBlock(true);
+
+  const int lineHeight = renderer.getLineHeight(fontId) * lineCompression;
+  const BlockStyle& blockStyle = currentTextBlock->getBlockStyle();
 
   // Apply bottom spacing after the paragraph (stored in pixels)
   if (blockStyle.marginBottom > 0) {
@@ -15,6 +15,7 @@
 class Page;
 class GfxRenderer;
 class Epub;
+class SectionPositionTable;
 
 #define MAX_WORD_SIZE 200
 
@@ -35,6 +36,7 @@ class ChapterHtmlSlimParser {
   int partWordBufferIndex = 0;
   bool nextWordContinues = false;  // true when next flushed word attaches to previous (inline element boundary)
   std::unique_ptr<ParsedText> currentTextBlock = nullptr;
+  bool currentTextBlockStarted = false;  // top spacing applied and first lines emitted by a streaming pass
   std::unique_ptr<Page> currentPage = nullptr;
   int16_t currentPageNextY = 0;
   int fontId;
@@ -49,6 +51,7 @@ class ChapterHtmlSlimParser {
   std::string contentBase;
   std::string imageBasePath;
   int imageCounter = 0;
+  bool useXhtmlTokenizer = false;
 
   // Style tracking (replaces depth-based approach)
   struct StyleStackEntry {
@@ -63,11 +66,31 @@ class ChapterHtmlSlimParser {
   bool effectiveItalic = false;
   bool effectiveUnderline = false;
 
+  // Position tracking for the section's position table, only done when a table is set
+  struct OpenElement {
+    int depth = 0;
+    std::string step;                                            // "/name[index]", empty for the root element
+    std::vector<std::pair<std::string, uint16_t>> childCounts;  // children seen so far per tag name
+  };
+  SectionPositionTable* positionTable = nullptr;
+  std::vector<OpenElement> openElements;
+  int completedPages = 0;
+  std::string blockPath;  // element path of the current text block
+  bool blockPathRecorded = true;
+  std::vector<std::string> pendingAnchors;  // seen, waiting for the next word or image
+  std::vector<std::string> blockAnchors;    // bound to the current text block, waiting for its next line
+
+  void completePage();
+  void enterElement(const char* name);
+  std::string currentElementPath(bool includeInnermost = true) const;
   void updateEffectiveInlineStyle();
   void startNewTextBlock(const BlockStyle& blockStyle);
   void flushPartWordBuffer();
+  void layoutCurrentTextBlock(bool includeLastLine);
   void makePages();
-  // XML callbacks
+  bool parseWithExpat(FsFile& file);
+  bool parseWithTokenizer(FsFile& file);
+  // XML callbacks (also used by XhtmlTokenizer)
   static void XMLCALL startElement(void* userData, const XML_Char* name, const XML_Char** atts);
   static void XMLCALL characterData(void* userData, const XML_Char* s, int len);
   static void XMLCALL defaultHandlerExpand(void* userData, const XML_Char* s, int len);
@@ -101,6 +124,10 @@ class ChapterHtmlSlimParser {
         imageBasePath(imageBasePath) {}
 
   ~ChapterHtmlSlimParser() = default;
+  // Parse with the lenient XhtmlTokenizer instead of expat
+  void setXhtmlTokenizerEnabled(const bool enabled) { useXhtmlTokenizer = enabled; }
+  // Record the page of the table's anchor targets and of the chapter's elements while building
+  void setPositionTable(SectionPositionTable* table) { positionTable = table; }
   bool parseAndBuildPages();
   void addLineToPage(std::shared_ptr<TextBlock> line);
 };
@@ -10,6 +10,10 @@ namespace {
 constexpr char MEDIA_TYPE_NCX[] = "application/x-dtbncx+xml";
 constexpr char MEDIA_TYPE_CSS[] = "text/css";
 constexpr char itemCacheFile[] = "/.items.bin";
+
+bool itemIndexLess(const uint32_t aHash, const uint16_t aLen, const uint32_t bHash, const uint16_t bLen) {
+  return aHash < bHash || (aHash == bHash && aLen < bLen);
+}
 }  // namespace
 
 bool ContentOpfParser::setup() {
@@ -41,7 +45,28 @@ ContentOpfParser::~ContentOpfParser() {
   }
   itemIndex.clear();
   itemIndex.shrink_to_fit();
-  useItemIndex = false;
+}
+
+bool ContentOpfParser::findItemHref(const std::string& idref, std::string& href) {
+  const uint32_t targetHash = fnvHash(idref);
+  const auto targetLen = static_cast<uint16_t>(idref.size());
+  auto it = std::lower_bound(itemIndex.begin(), itemIndex.end(), ItemIndexEntry{targetHash, targetLen, 0},
+                             [](const ItemIndexEntry& a, const ItemIndexEntry& b) {
+                               return itemIndexLess(a.idHash, a.idLen, b.idHash, b.idLen);
+                             });
+
+  // Entries with the same hash and length are told apart by the id stored in front of the href
+  for (; it != itemIndex.end() && it->idHash == targetHash && it->idLen == targetLen; ++it) {
+    if (!tempItemStore.seek(it->fileOffset)) {
+      return false;
+    }
+    serialization::readString(tempItemStore, lookupId);
+    if (lookupId == idref) {
+      serialization::readString(tempItemStore, href);
+      return true;
+    }
+  }
+  return false;
 }
 
 size_t ContentOpfParser::write(const uint8_t data) { return write(&data, 1); }
@@ -130,14 +155,10 @@ void XMLCALL ContentOpfParser::startElement(void* userData, const XML_Char* name
       LOG_ERR("COF", "Couldn't open temp items file for reading. This is probably going to be a fatal error.");
     }
 
-    // Sort item index for binary search if we have enough items
-    if (self->itemIndex.size() >= LARGE_SPINE_THRESHOLD) {
-      std::sort(self->itemIndex.begin(), self->itemIndex.end(), [](const ItemIndexEntry& a, const ItemIndexEntry& b) {
-        return a.idHash < b.idHash || (a.idHash == b.idHash && a.idLen < b.idLen);
-      });
-      self->useItemIndex = true;
-      LOG_DBG("COF", "Using fast index for %zu manifest items", self->itemIndex.size());
-    }
+    std::sort(self->itemIndex.begin(), self->itemIndex.end(), [](const ItemIndexEntry& a, const ItemIndexEntry& b) {
+      return itemIndexLess(a.idHash, a.idLen, b.idHash, b.idLen);
+    });
+    LOG_DBG("COF", "Indexed %zu manifest items", self->itemIndex.size());
     return;
   }
 
@@ -244,49 +265,10 @@ void XMLCALL ContentOpfParser::startElement(void* userData, const XML_Char* name
         if (strcmp(atts[i], "idref") == 0) {
           const std::string idref = atts[i + 1];
           std::string href;
-          bool found = false;
-
-          if (self->useItemIndex) {
-            // Fast path: binary search
-            uint32_t targetHash = fnvHash(idref);
-            uint16_t targetLen = static_cast<uint16_t>(idref.size());
-
-            auto it = std::lower_bound(self->itemIndex.begin(), self->itemIndex.end(),
-                                       ItemIndexEntry{targetHash, targetLen, 0},
-                                       [](const ItemIndexEntry& a, const ItemIndexEntry& b) {
-                                         return a.idHash < b.idHash || (a.idHash == b.idHash && a.idLen < b.idLen);
-                                       });
-
-            // Check for match (may need to check a few due to hash collisions)
-            while (it != self->itemIndex.end() && it->idHash == targetHash) {
-              self->tempItemStore.seek(it->fileOffset);
-              std::string itemId;
-              serialization::readString(self->tempItemStore, itemId);
-              if (itemId == idref) {
-                serialization::readString(self->tempItemStore, href);
-                found = true;
-                break;
-              }
-              ++it;
-            }
-          } else {
-            // Slow path: linear scan (for small manifests, keeps original behavior)
-            // TODO: This lookup is slow as need to scan through all items each time.
-            //       It can take up to 200ms per item when getting to 1500 items.
-            self->tempItemStore.seek(0);
-            std::string itemId;
-            while (self->tempItemStore.available()) {
-              serialization::readString(self->tempItemStore, itemId);
-              serialization::readString(self->tempItemStore, href);
-              if (itemId == idref) {
-                found = true;
-                break;
-              }
-            }
-          }
-
-          if (found && self->cache) {
+          if (self->findItemHref(idref, href)) {
             self->cache->createSpineEntry(href);
+          } else {
+            LOG_DBG("COF", "Spine itemref %s not in manifest", idref.c_str());
           }
         }
       }
@@ -31,16 +31,16 @@ class ContentOpfParser final : public Print {
   FsFile tempItemStore;
   std::string coverItemId;
 
-  // Index for fast idref→href lookup (used only for large EPUBs)
+  // idref→href lookup for the spine: manifest items are written to .items.bin and indexed here, sorted by hash once
+  // the spine starts, so each itemref costs a binary search and one seek
   struct ItemIndexEntry {
     uint32_t idHash;      // FNV-1a hash of itemId
     uint16_t idLen;       // length for collision reduction
     uint32_t fileOffset;  // offset in .items.bin
   };
   std::vector<ItemIndexEntry> itemIndex;
-  bool useItemIndex = false;
-
-  static constexpr uint16_t LARGE_SPINE_THRESHOLD = 400;
+  // Reused by findItemHref so lookups don't allocate per itemref
+  std::string lookupId;
 
   // FNV-1a hash function
   static uint32_t fnvHash(const std::string& s) {
@@ -52,6 +52,8 @@ class ContentOpfParser final : public Print {
     return hash;
   }
 
+  bool findItemHref(const std::string& idref, std::string& href);
+
   static void startElement(void* userData, const XML_Char* name, const XML_Char** atts);
   static void characterData(void* userData, const XML_Char* s, int len);
   static void endElement(void* userData, const XML_Char* name);
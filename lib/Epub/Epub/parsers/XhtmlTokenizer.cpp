@@ -0,0 +1,481 @@
+#include "XhtmlTokenizer.h"
+
+#include <Logging.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "../htmlEntities.h"
+
+namespace {
+// Longest entity reference we try to resolve, including '&' and ';'
+constexpr size_t MAX_ENTITY_LENGTH = 32;
+
+const char* const VOID_ELEMENTS[] = {"area", "base", "br",   "col",   "embed",  "hr",    "img",
+                                     "input", "link", "meta", "param", "source", "track", "wbr"};
+
+const char EMPTY_VALUE[] = "";
+
+bool isSpace(const char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f'; }
+
+bool isNameStart(const char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':'; }
+
+char toLower(const char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+bool isVoidElement(const char* name) {
+  for (const char* voidName : VOID_ELEMENTS) {
+    if (strcmp(name, voidName) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+char* findSequence(char* from, char* end, const char* sequence) {
+  const size_t len = strlen(sequence);
+  for (char* p = from; p + len <= end; p++) {
+    if (*p == sequence[0] && memcmp(p, sequence, len) == 0) {
+      return p;
+    }
+  }
+  return nullptr;
+}
+
+// '>' that ends a start tag, skipping over quoted attribute values
+char* findTagEnd(char* from, char* end) {
+  char quote = 0;
+  char previous = 0;
+  for (char* p = from; p < end; p++) {
+    const char c = *p;
+    if (quote) {
+      if (c == quote) {
+        quote = 0;
+        previous = c;
+      }
+      continue;
+    }
+    if ((c == '"' || c == '\'') && previous == '=') {
+      quote = c;
+      continue;
+    }
+    if (c == '>') {
+      return p;
+    }
+    if (!isSpace(c)) {
+      previous = c;
+    }
+  }
+  return nullptr;
+}
+
+size_t encodeUtf8(const uint32_t cp, char* out) {
+  if (cp < 0x80) {
+    out[0] = static_cast<char>(cp);
+    return 1;
+  }
+  if (cp < 0x800) {
+    out[0] = static_cast<char>(0xC0 | (cp >> 6));
+    out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 2;
+  }
+  if (cp < 0x10000) {
+    out[0] = static_cast<char>(0xE0 | (cp >> 12));
+    out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 3;
+  }
+  out[0] = static_cast<char>(0xF0 | (cp >> 18));
+  out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+  out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+  out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+  return 4;
+}
+
+// UTF-8 value of the entity reference s[0..len) (from '&' to ';'), written to out. Returns 0 if unknown.
+size_t resolveEntity(const char* s, const size_t len, char* out) {
+  if (len > 3 && s[1] == '#') {
+    const bool hex = s[2] == 'x' || s[2] == 'X';
+    uint32_t cp = 0;
+    for (size_t i = hex ? 3 : 2; i < len - 1; i++) {
+      const char c = s[i];
+      uint32_t digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (hex && toLower(c) >= 'a' && toLower(c) <= 'f') {
+        digit = toLower(c) - 'a' + 10;
+      } else {
+        return 0;
+      }
+      cp = cp * (hex ? 16 : 10) + digit;
+      if (cp > 0x10FFFF) {
+        return 0;
+      }
+    }
+    if (cp == 0 || (cp >= 0xD800 && cp <= 0xDFFF)) {
+      return 0;
+    }
+    return encodeUtf8(cp, out);
+  }
+
+  if (len == 6 && memcmp(s, "&apos;", 6) == 0) {
+    out[0] = '\'';
+    return 1;
+  }
+  const char* value = lookupHtmlEntity(s, static_cast<int>(len));
+  if (!value) {
+    return 0;
+  }
+  const size_t valueLen = strlen(value);
+  if (valueLen > len) {
+    return 0;  // Cannot be decoded in place; keep the reference as written
+  }
+  memcpy(out, value, valueLen);
+  return valueLen;
+}
+
+// Resolves entity references in place and returns the new length. Unknown references are kept verbatim.
+size_t decodeEntities(char* s, const size_t len) {
+  size_t out = 0;
+  size_t i = 0;
+  while (i < len) {
+    if (s[i] == '&') {
+      size_t semi = i + 1;
+      while (semi < len && semi - i < MAX_ENTITY_LENGTH && s[semi] != ';' && s[semi] != '&' && !isSpace(s[semi])) {
+        semi++;
+      }
+      if (semi < len && s[semi] == ';') {
+        char decoded[MAX_ENTITY_LENGTH];
+        const size_t decodedLen = resolveEntity(s + i, semi - i + 1, decoded);
+        if (decodedLen > 0) {
+          memcpy(s + out, decoded, decodedLen);
+          out += decodedLen;
+          i = semi + 1;
+          continue;
+        }
+      }
+    }
+    s[out++] = s[i++];
+  }
+  return out;
+}
+
+// End of the text in [start, end) that can be emitted before more input arrives: a trailing '&' that may start an
+// entity and a trailing partial UTF-8 sequence are held back.
+char* safeTextEnd(char* start, char* end) {
+  char* safe = end;
+  const size_t lookBack = std::min<size_t>(end - start, MAX_ENTITY_LENGTH);
+  for (char* p = end - 1; p >= end - lookBack; p--) {
+    if (*p == ';' || isSpace(*p)) {
+      break;
+    }
+    if (*p == '&') {
+      safe = p;
+      break;
+    }
+  }
+
+  char* p = safe;
+  size_t continuation = 0;
+  while (p > start && continuation < 3 && (static_cast<uint8_t>(p[-1]) & 0xC0) == 0x80) {
+    p--;
+    continuation++;
+  }
+  if (p > start) {
+    const auto lead = static_cast<uint8_t>(p[-1]);
+    const size_t needed = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+    if (needed > continuation) {
+      safe = p - 1;
+    }
+  }
+  return safe;
+}
+}  // namespace
+
+XhtmlTokenizer::XhtmlTokenizer() : window(new char[WINDOW_SIZE + 1]) {}
+
+char* XhtmlTokenizer::getBuffer(const size_t len) {
+  if (!window || filled + len > WINDOW_SIZE) {
+    return nullptr;
+  }
+  return window.get() + filled;
+}
+
+void XhtmlTokenizer::parseBuffer(const size_t len, const bool isFinal) {
+  filled += len;
+  peakWindowUsage = std::max(peakWindowUsage, filled);
+
+  const size_t consumed = tokenize(isFinal);
+  if (consumed < filled) {
+    memmove(window.get(), window.get() + consumed, filled - consumed);
+  }
+  filled -= consumed;
+
+  if (isFinal) {
+    filled = 0;
+    closeElementsFrom(0);
+  }
+}
+
+// Handles every complete token in the window and returns how many bytes were consumed
+size_t XhtmlTokenizer::tokenize(const bool isFinal) {
+  char* const buf = window.get();
+  char* const end = buf + filled;
+  size_t pos = 0;
+
+  if (atStart) {
+    if (filled < 3 && !isFinal) {
+      return 0;
+    }
+    atStart = false;
+    if (filled >= 3 && memcmp(buf, "\xEF\xBB\xBF", 3) == 0) {
+      pos = 3;
+    }
+  }
+
+  if (discardUntil) {
+    char* hit = findSequence(buf, end, discardUntil);
+    const size_t terminatorLen = strlen(discardUntil);
+    if (!hit) {
+      // Keep enough bytes to recognise a terminator split across reads
+      return isFinal ? filled : filled - std::min(filled, terminatorLen - 1);
+    }
+    pos = hit - buf + terminatorLen;
+    discardUntil = nullptr;
+  }
+
+  while (pos < filled) {
+    char* const start = buf + pos;
+
+    if (*start != '<') {
+      auto* lt = static_cast<char*>(memchr(start, '<', end - start));
+      char* textEnd = lt ? lt : isFinal ? end : safeTextEnd(start, end);
+      if (textEnd > start) {
+        emitText(start, textEnd - start, true);
+      }
+      pos = textEnd - buf;
+      if (!lt && !isFinal) {
+        break;
+      }
+      continue;
+    }
+
+    const size_t remaining = end - start;
+    // "<![CDATA[" is the longest prefix needed to tell markup kinds apart
+    if (remaining < 9 && !isFinal) {
+      break;
+    }
+    const char next = remaining > 1 ? start[1] : '\0';
+
+    char* body;
+    const char* terminator;
+    enum { SKIP, CDATA, END_TAG, START_TAG } kind;
+    if (next == '!' && remaining >= 4 && memcmp(start, "<!--", 4) == 0) {
+      kind = SKIP;
+      body = start + 4;
+      terminator = "-->";
+    } else if (next == '!' && remaining >= 9 && memcmp(start, "<![CDATA[", 9) == 0) {
+      kind = CDATA;
+      body = start + 9;
+      terminator = "]]>";
+    } else if (next == '!' || next == '?') {
+      kind = SKIP;  // DOCTYPE, XML declaration and processing instructions
+      body = start + 2;
+      terminator = next == '?' ? "?>" : ">";
+    } else if (next == '/') {
+      kind = END_TAG;
+      body = start + 2;
+      terminator = ">";
+    } else if (isNameStart(next)) {
+      kind = START_TAG;
+      body = start + 1;
+      terminator = ">";
+    } else {
+      // A bare '<' in text
+      emitText(start, 1, false);
+      pos++;
+      continue;
+    }
+
+    char* close = kind == START_TAG ? findTagEnd(body, end) : findSequence(body, end, terminator);
+    if (!close) {
+      if (isFinal) {
+        pos = filled;  // Unterminated markup at the end of the chapter is dropped
+        break;
+      }
+      if (pos == 0 && filled == WINDOW_SIZE) {
+        LOG_ERR("XHT", "Markup longer than %u bytes skipped", static_cast<unsigned>(WINDOW_SIZE));
+        discardUntil = terminator;
+        return filled - (strlen(terminator) - 1);
+      }
+      break;
+    }
+
+    switch (kind) {
+      case SKIP:
+        break;
+      case CDATA:
+        emitText(body, close - body, false);
+        break;
+      case END_TAG:
+        handleEndTag(body, close);
+        break;
+      case START_TAG:
+        handleStartTag(body, close);
+        break;
+    }
+    pos = close - buf + strlen(terminator);
+  }
+
+  return pos;
+}
+
+void XhtmlTokenizer::emitText(char* start, size_t len, const bool decode) {
+  if (decode) {
+    len = decodeEntities(start, len);
+  }
+  if (len > 0 && textHandler) {
+    textHandler(userData, start, static_cast<int>(len));
+  }
+}
+
+// p points at the first character of the tag name, end at the closing '>'
+void XhtmlTokenizer::handleStartTag(char* p, char* end) {
+  char* const name = p;
+  while (p < end && !isSpace(*p) && *p != '/') {
+    *p = toLower(*p);
+    p++;
+  }
+
+  char* attributesEnd = end;
+  while (attributesEnd > p && isSpace(attributesEnd[-1])) {
+    attributesEnd--;
+  }
+  const bool selfClosing = attributesEnd > p && attributesEnd[-1] == '/';
+  if (selfClosing) {
+    attributesEnd--;
+  }
+
+  const bool nameEndsTag = p >= attributesEnd;
+  *p = '\0';
+  if (!nameEndsTag) {
+    p++;
+  }
+
+  const char* atts[MAX_ATTRIBUTES * 2 + 1];
+  size_t count = 0;
+  while (p < attributesEnd) {
+    while (p < attributesEnd && (isSpace(*p) || *p == '/')) {
+      p++;
+    }
+    if (p >= attributesEnd) {
+      break;
+    }
+
+    char* const attrName = p;
+    while (p < attributesEnd && !isSpace(*p) && *p != '=') {
+      *p = toLower(*p);
+      p++;
+    }
+    char* const attrNameEnd = p;
+    if (attrNameEnd == attrName) {
+      p++;  // Stray '='
+      continue;
+    }
+    while (p < attributesEnd && isSpace(*p)) {
+      p++;
+    }
+
+    const char* value = EMPTY_VALUE;
+    if (p < attributesEnd && *p == '=') {
+      p++;
+      while (p < attributesEnd && isSpace(*p)) {
+        p++;
+      }
+      char* const valueStart = p;
+      char* valueEnd;
+      if (p < attributesEnd && (*p == '"' || *p == '\'')) {
+        const char quote = *p;
+        char* const quoted = p + 1;
+        p = quoted;
+        while (p < end && *p != quote) {
+          p++;
+        }
+        valueEnd = p;
+        if (p < end) {
+          p++;
+        }
+        // Shift the value left over its opening quote so it can be terminated in place
+        memmove(valueStart, quoted, valueEnd - quoted);
+        valueEnd = valueStart + (valueEnd - quoted);
+      } else {
+        while (p < attributesEnd && !isSpace(*p)) {
+          p++;
+        }
+        valueEnd = p;
+        if (p < attributesEnd) {
+          p++;  // The separating whitespace is overwritten by the terminator below
+        }
+      }
+
+      // Attribute value normalisation as in XML: literal whitespace characters become spaces
+      for (char* c = valueStart; c < valueEnd; c++) {
+        if (isSpace(*c)) {
+          *c = ' ';
+        }
+      }
+      const size_t valueLen = decodeEntities(valueStart, valueEnd - valueStart);
+      valueStart[valueLen] = '\0';
+      value = valueStart;
+    }
+    *attrNameEnd = '\0';
+
+    if (count < MAX_ATTRIBUTES) {
+      atts[count * 2] = attrName;
+      atts[count * 2 + 1] = value;
+      count++;
+    }
+  }
+  atts[count * 2] = nullptr;
+
+  if (startHandler) {
+    startHandler(userData, name, atts);
+  }
+  if (selfClosing || isVoidElement(name)) {
+    if (endHandler) {
+      endHandler(userData, name);
+    }
+    return;
+  }
+  openElements.emplace_back(name);
+}
+
+void XhtmlTokenizer::handleEndTag(char* p, char* end) {
+  char* const name = p;
+  while (p < end && !isSpace(*p)) {
+    *p = toLower(*p);
+    p++;
+  }
+  *p = '\0';
+  if (*name == '\0') {
+    return;
+  }
+
+  // Close the innermost matching element along with anything left open inside it; unmatched end tags are dropped
+  for (size_t i = openElements.size(); i > 0; i--) {
+    if (openElements[i - 1] == name) {
+      closeElementsFrom(i - 1);
+      return;
+    }
+  }
+}
+
+void XhtmlTokenizer::closeElementsFrom(const size_t index) {
+  while (openElements.size() > index) {
+    const std::string name = std::move(openElements.back());
+    openElements.pop_back();
+    if (endHandler) {
+      endHandler(userData, name.c_str());
+    }
+  }
+}
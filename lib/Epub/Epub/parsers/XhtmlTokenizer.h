@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Streaming tokenizer for EPUB chapter XHTML, usable in place of expat by ChapterHtmlSlimParser.
+//
+// Input is read straight into the tokenizer's window (getBuffer()/parseBuffer(), like XML_GetBuffer and
+// XML_ParseBuffer). Tokens are resolved in place: tag and attribute names are lowercased and NUL-terminated inside
+// the window, entities are decoded in place, and text is handed out as (pointer, length) spans. Only the names of
+// open elements are copied, so end tags can still be reported after the window has moved on. Callbacks use expat's
+// signatures so the same handlers serve both parsers.
+//
+// It never rejects a chapter. HTML-isms are recovered from instead:
+// - unquoted and valueless attributes are accepted;
+// - void elements (<br>, <img>, <hr>, ...) close themselves;
+// - end tags close any unclosed children, and stray end tags are dropped;
+// - a '<' or '&' that does not start markup or a known entity is kept as text;
+// - elements still open at the end of input are closed.
+class XhtmlTokenizer {
+ public:
+  using StartElementHandler = void (*)(void* userData, const char* name, const char** atts);
+  using EndElementHandler = void (*)(void* userData, const char* name);
+  using CharacterDataHandler = void (*)(void* userData, const char* s, int len);
+
+  static constexpr size_t WINDOW_SIZE = 4096;
+  static constexpr size_t MAX_ATTRIBUTES = 16;
+
+  XhtmlTokenizer();
+
+  void setUserData(void* data) { userData = data; }
+  void setElementHandler(StartElementHandler start, EndElementHandler end) {
+    startHandler = start;
+    endHandler = end;
+  }
+  void setCharacterDataHandler(CharacterDataHandler handler) { textHandler = handler; }
+
+  // Free space at the end of the window for up to len bytes, nullptr if the window cannot take that much
+  char* getBuffer(size_t len);
+  size_t getBufferSpace() const { return WINDOW_SIZE - filled; }
+  // Tokenize len bytes that were written to getBuffer(). With isFinal, pending text is flushed and every element
+  // that is still open gets its end callback.
+  void parseBuffer(size_t len, bool isFinal);
+
+  // Largest number of bytes held in the window at once, including an unfinished token carried between reads
+  size_t getPeakWindowUsage() const { return peakWindowUsage; }
+
+ private:
+  std::unique_ptr<char[]> window;
+  size_t filled = 0;
+  size_t peakWindowUsage = 0;
+  bool atStart = true;
+  // Markup that outgrew the window is skipped up to this terminator
+  const char* discardUntil = nullptr;
+  std::vector<std::string> openElements;
+
+  void* userData = nullptr;
+  StartElementHandler startHandler = nullptr;
+  EndElementHandler endHandler = nullptr;
+  CharacterDataHandler textHandler = nullptr;
+
+  size_t tokenize(bool isFinal);
+  void emitText(char* start, size_t len, bool decode);
+  void handleStartTag(char* start, char* end);
+  void handleEndTag(char* start, char* end);
+  void closeElementsFrom(size_t index);
+};
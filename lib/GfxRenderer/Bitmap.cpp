@@ -158,7 +158,24 @@ BmpReaderError Bitmap::readNextRow(uint8_t* data, uint8_t* rowBuffer) const {
   // Note: rowBuffer should be pre-allocated by the caller to size 'rowBytes'
   if (file.read(rowBuffer, rowBytes) != rowBytes) return BmpReaderError::ShortReadRow;
 
-  prevRowY += 1;
+  decodeRow(rowBuffer, data, prevRowY + 1);
+  return BmpReaderError::Ok;
+}
+
+BmpReaderError Bitmap::readRawRows(const int fileRow, const int count, uint8_t* buffer) const {
+  const uint64_t pos = bfOffBits + static_cast<uint64_t>(fileRow) * rowBytes;
+  if (file.position() != pos && !file.seek(pos)) {
+    return BmpReaderError::SeekPixelDataFailed;
+  }
+  const int bytes = count * rowBytes;
+  if (file.read(buffer, bytes) != bytes) {
+    return BmpReaderError::ShortReadRow;
+  }
+  return BmpReaderError::Ok;
+}
+
+void Bitmap::decodeRow(const uint8_t* rowBuffer, uint8_t* data, const int fileRow) const {
+  prevRowY = fileRow;
 
   uint8_t* outPtr = data;
   uint8_t currentOutByte = 0;
@@ -237,7 +254,8 @@ BmpReaderError Bitmap::readNextRow(uint8_t* data, uint8_t* rowBuffer) const {
       break;
     }
     default:
-      return BmpReaderError::UnsupportedBpp;
+      // parseHeaders only accepts the depths above
+      return;
   }
 
   if (atkinsonDitherer)
@@ -247,8 +265,6 @@ BmpReaderError Bitmap::readNextRow(uint8_t* data, uint8_t* rowBuffer) const {
 
   // Flush remaining bits if width is not a multiple of 4
   if (bitShift != 6) *outPtr = currentOutByte;
-
-  return BmpReaderError::Ok;
 }
 
 BmpReaderError Bitmap::rewindToData() const {
@@ -256,7 +272,9 @@ BmpReaderError Bitmap::rewindToData() const {
     return BmpReaderError::SeekPixelDataFailed;
   }
 
-  // Reset dithering when rewinding
+  // Reset dithering when rewinding, including the row the noise pattern is keyed on, so every pass over the image
+  // (one per render mode) quantizes each pixel the same way
+  prevRowY = -1;
   if (fsDitherer) fsDitherer->reset();
   if (atkinsonDitherer) atkinsonDitherer->reset();
 
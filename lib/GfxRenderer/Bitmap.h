@@ -36,6 +36,12 @@ class Bitmap {
   ~Bitmap();
   BmpReaderError parseHeaders();
   BmpReaderError readNextRow(uint8_t* data, uint8_t* rowBuffer) const;
+  // Read count consecutive rows of raw pixel data, in file order starting at fileRow, into buffer (count rows of
+  // getRowBytes()). Only seeks if the file is not already there, so reading chunk after chunk stays sequential.
+  BmpReaderError readRawRows(int fileRow, int count, uint8_t* buffer) const;
+  // Convert one raw row to packed 2bpp like readNextRow. Rows may be skipped, but have to come in file order for the
+  // dithering to carry over.
+  void decodeRow(const uint8_t* rowBuffer, uint8_t* data, int fileRow) const;
   BmpReaderError rewindToData() const;
   int getWidth() const { return width; }
   int getHeight() const { return height; }
@@ -50,6 +50,9 @@ static inline void rotateCoordinates(const GfxRenderer::Orientation orientation,
 // IMPORTANT: This function is in critical rendering path and is called for every pixel. Please keep it as simple and
 // efficient as possible.
 void GfxRenderer::drawPixel(const int x, const int y, const bool state) const {
+#ifdef GFX_DRAW_PIXEL_STATS
+  drawPixelCalls++;
+#endif
   int phyX = 0;
   int phyY = 0;
 
@@ -433,143 +436,149 @@ void GfxRenderer::drawBitmap(const Bitmap& bitmap, const int x, const int y, con
   }
   LOG_DBG("GFX", "Scaling by %f - %s", scale, isScaled ? "scaled" : "not scaled");
 
-  // Calculate output row size (2 bits per pixel, packed into bytes)
-  // IMPORTANT: Use int, not uint8_t, to avoid overflow for images > 1020 pixels wide
-  const int outputRowSize = (bitmap.getWidth() + 3) / 4;
-  auto* outputRow = static_cast<uint8_t*>(malloc(outputRowSize));
-  auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
-
-  if (!outputRow || !rowBytes) {
-    LOG_ERR("GFX", "!! Failed to allocate BMP row buffers");
-    free(outputRow);
-    free(rowBytes);
-    return;
-  }
-
-  for (int bmpY = 0; bmpY < (bitmap.getHeight() - cropPixY); bmpY++) {
-    // The BMP's (0, 0) is the bottom-left corner (if the height is positive, top-left if negative).
-    // Screen's (0, 0) is the top-left corner.
-    int screenY = -cropPixY + (bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY);
-    if (isScaled) {
-      screenY = std::floor(screenY * scale);
-    }
-    screenY += y;  // the offset should not be scaled
-    if (screenY >= getScreenHeight()) {
-      break;
-    }
-
-    if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
-      LOG_ERR("GFX", "Failed to read row %d from bitmap", bmpY);
-      free(outputRow);
-      free(rowBytes);
-      return;
-    }
-
-    if (screenY < 0) {
-      continue;
-    }
-
-    if (bmpY < cropPixY) {
-      // Skip the row if it's outside the crop area
-      continue;
-    }
-
-    for (int bmpX = cropPixX; bmpX < bitmap.getWidth() - cropPixX; bmpX++) {
-      int screenX = bmpX - cropPixX;
-      if (isScaled) {
-        screenX = std::floor(screenX * scale);
-      }
-      screenX += x;  // the offset should not be scaled
-      if (screenX >= getScreenWidth()) {
-        break;
-      }
-      if (screenX < 0) {
-        continue;
-      }
-
-      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
-
-      if (renderMode == BW && val < 3) {
-        drawPixel(screenX, screenY);
-      } else if (renderMode == GRAYSCALE_MSB && (val == 1 || val == 2)) {
-        drawPixel(screenX, screenY, false);
-      } else if (renderMode == GRAYSCALE_LSB && val == 1) {
-        drawPixel(screenX, screenY, false);
-      }
-    }
-  }
-
-  free(outputRow);
-  free(rowBytes);
+  blitBitmap(bitmap, x, y, cropPixX, cropPixY, isScaled ? scale : 1.0f, false);
 }
 
 void GfxRenderer::drawBitmap1Bit(const Bitmap& bitmap, const int x, const int y, const int maxWidth,
                                  const int maxHeight) const {
   float scale = 1.0f;
-  bool isScaled = false;
   if (maxWidth > 0 && bitmap.getWidth() > maxWidth) {
     scale = static_cast<float>(maxWidth) / static_cast<float>(bitmap.getWidth());
-    isScaled = true;
   }
   if (maxHeight > 0 && bitmap.getHeight() > maxHeight) {
     scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>(bitmap.getHeight()));
-    isScaled = true;
   }
 
-  // For 1-bit BMP, output is still 2-bit packed (for consistency with readNextRow)
-  const int outputRowSize = (bitmap.getWidth() + 3) / 4;
-  auto* outputRow = static_cast<uint8_t*>(malloc(outputRowSize));
-  auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
+  // For 1-bit source, readNextRow quantization gives 0 (black) or 3 (white); black is drawn in every render mode
+  blitBitmap(bitmap, x, y, 0, 0, scale, true);
+}
 
-  if (!outputRow || !rowBytes) {
-    LOG_ERR("GFX", "!! Failed to allocate 1-bit BMP row buffers");
-    free(outputRow);
-    free(rowBytes);
+void GfxRenderer::blitBitmap(const Bitmap& bitmap, const int x, const int y, const int cropPixX, const int cropPixY,
+                             const float scale, const bool oneBit) const {
+  const int srcWidth = bitmap.getWidth() - 2 * cropPixX;
+  const int srcHeight = bitmap.getHeight() - 2 * cropPixY;
+  if (srcWidth <= 0 || srcHeight <= 0) {
     return;
   }
+  // Same extent the source pixels covered when each was placed at floor(index * scale)
+  const int dstWidth = scale < 1.0f ? static_cast<int>(std::floor((srcWidth - 1) * scale)) + 1 : srcWidth;
+  const int dstHeight = scale < 1.0f ? static_cast<int>(std::floor((srcHeight - 1) * scale)) + 1 : srcHeight;
 
-  for (int bmpY = 0; bmpY < bitmap.getHeight(); bmpY++) {
-    // Read rows sequentially using readNextRow
-    if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
-      LOG_ERR("GFX", "Failed to read row %d from 1-bit bitmap", bmpY);
-      free(outputRow);
-      free(rowBytes);
-      return;
-    }
+  // Destination span that lands on the screen
+  const int firstCol = std::max(0, -x);
+  const int endCol = std::min(dstWidth, getScreenWidth() - x);
+  const int firstRow = std::max(0, -y);
+  const int endRow = std::min(dstHeight, getScreenHeight() - y);
+  if (firstCol >= endCol || firstRow >= endRow) {
+    return;
+  }
 
-    // Calculate screen Y based on whether BMP is top-down or bottom-up
-    const int bmpYOffset = bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY;
-    int screenY = y + (isScaled ? static_cast<int>(std::floor(bmpYOffset * scale)) : bmpYOffset);
-    if (screenY >= getScreenHeight()) {
-      continue;  // Continue reading to keep row counter in sync
-    }
-    if (screenY < 0) {
-      continue;
-    }
+  // Every destination pixel samples the source pixel under its centre, 16.16 fixed point. Without scaling this is the
+  // identity map.
+  const uint32_t stepX = (static_cast<uint32_t>(srcWidth) << 16) / dstWidth;
+  const uint32_t stepY = (static_cast<uint32_t>(srcHeight) << 16) / dstHeight;
+  const auto sourceCol = [&](const int col) {
+    return std::min(srcWidth - 1, static_cast<int>((col * stepX + stepX / 2) >> 16)) + cropPixX;
+  };
+  const auto sourceRow = [&](const int row) {
+    return std::min(srcHeight - 1, static_cast<int>((row * stepY + stepY / 2) >> 16)) + cropPixY;
+  };
+
+  const int rowBytes = bitmap.getRowBytes();
+  // Rows are fetched in chunks of up to BMP_CHUNK_BYTES; when scaling skips a whole chunk per row, one row at a time
+  const int rowsPerChunk = std::max(1, std::min(BMP_CHUNK_BYTES / rowBytes, srcHeight));
+  const int chunkRows = static_cast<int>(stepY >> 16) >= rowsPerChunk ? 1 : rowsPerChunk;
+  const int visibleCols = endCol - firstCol;
+  auto* chunk = static_cast<uint8_t*>(malloc(chunkRows * rowBytes));
+  auto* outputRow = static_cast<uint8_t*>(malloc((bitmap.getWidth() + 3) / 4));
+  auto* colMap = static_cast<uint16_t*>(malloc(visibleCols * sizeof(uint16_t)));
+  if (!chunk || !outputRow || !colMap) {
+    LOG_ERR("GFX", "!! Failed to allocate BMP row buffers");
+    free(chunk);
+    free(outputRow);
+    free(colMap);
+    return;
+  }
+  for (int col = firstCol; col < endCol; col++) {
+    colMap[col - firstCol] = static_cast<uint16_t>(sourceCol(col));
+  }
 
-    for (int bmpX = 0; bmpX < bitmap.getWidth(); bmpX++) {
-      int screenX = x + (isScaled ? static_cast<int>(std::floor(bmpX * scale)) : bmpX);
-      if (screenX >= getScreenWidth()) {
+  // Pixels of a logical row sit a fixed number of bits apart in the frame buffer, whatever the orientation
+  int bitStep = 1;
+  switch (orientation) {
+    case Portrait:
+      bitStep = -HalDisplay::DISPLAY_WIDTH;
+      break;
+    case PortraitInverted:
+      bitStep = HalDisplay::DISPLAY_WIDTH;
+      break;
+    case LandscapeClockwise:
+      bitStep = -1;
+      break;
+    case LandscapeCounterClockwise:
+      bitStep = 1;
+      break;
+  }
+  // Bit per 2bpp value (0 = black .. 3 = white) that gets drawn: black in BW, dark and light gray in the MSB plane,
+  // dark gray in the LSB plane. BW draws black, the gray planes set bits.
+  uint8_t drawValues = 0b0111;
+  bool black = true;
+  if (!oneBit && renderMode == GRAYSCALE_MSB) {
+    drawValues = 0b0110;
+    black = false;
+  } else if (!oneBit && renderMode == GRAYSCALE_LSB) {
+    drawValues = 0b0010;
+    black = false;
+  }
+
+  // The file stores the image bottom-up unless the height was negative; walk destination rows in file order so the
+  // reads stay sequential and the dithering sees rows in the order it expects
+  const bool topDown = bitmap.isTopDown();
+  const int height = bitmap.getHeight();
+  int chunkFirst = -1;
+  int chunkCount = 0;
+  for (int i = firstRow; i < endRow; i++) {
+    const int row = topDown ? i : endRow - 1 - (i - firstRow);
+    const int imageRow = sourceRow(row);
+    const int fileRow = topDown ? imageRow : height - 1 - imageRow;
+
+    if (fileRow < chunkFirst || fileRow >= chunkFirst + chunkCount) {
+      const int lastFileRow = topDown ? sourceRow(endRow - 1) : height - 1 - sourceRow(firstRow);
+      chunkFirst = fileRow;
+      chunkCount = std::min(chunkRows, lastFileRow - fileRow + 1);
+      if (bitmap.readRawRows(chunkFirst, chunkCount, chunk) != BmpReaderError::Ok) {
+        LOG_ERR("GFX", "Failed to read rows %d-%d from bitmap", chunkFirst, chunkFirst + chunkCount - 1);
         break;
       }
-      if (screenX < 0) {
-        continue;
+    }
+    bitmap.decodeRow(chunk + (fileRow - chunkFirst) * rowBytes, outputRow, fileRow);
+
+    int phyX = 0;
+    int phyY = 0;
+    rotateCoordinates(orientation, x + firstCol, y + row, &phyX, &phyY);
+    int bit = phyY * HalDisplay::DISPLAY_WIDTH + phyX;
+    if (black) {
+      for (int col = 0; col < visibleCols; col++, bit += bitStep) {
+        const int src = colMap[col];
+        const uint8_t val = outputRow[src >> 2] >> (6 - (src & 3) * 2) & 0x3;
+        if (drawValues >> val & 1) {
+          frameBuffer[bit >> 3] &= ~(0x80 >> (bit & 7));
+        }
       }
-
-      // Get 2-bit value (result of readNextRow quantization)
-      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
-
-      // For 1-bit source: 0 or 1 -> map to black (0,1,2) or white (3)
-      // val < 3 means black pixel (draw it)
-      if (val < 3) {
-        drawPixel(screenX, screenY, true);
+    } else {
+      for (int col = 0; col < visibleCols; col++, bit += bitStep) {
+        const int src = colMap[col];
+        const uint8_t val = outputRow[src >> 2] >> (6 - (src & 3) * 2) & 0x3;
+        if (drawValues >> val & 1) {
+          frameBuffer[bit >> 3] |= 0x80 >> (bit & 7);
+        }
       }
-      // White pixels (val == 3) are not drawn (leave background)
     }
   }
 
+  free(chunk);
   free(outputRow);
-  free(rowBytes);
+  free(colMap);
 }
 
 void GfxRenderer::fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state) const {
@@ -649,6 +658,7 @@ void GfxRenderer::clearScreen(const uint8_t color) const {
 }
 
 void GfxRenderer::invertScreen() const {
+  display.waitUntilIdle();
   for (int i = 0; i < HalDisplay::BUFFER_SIZE; i++) {
     frameBuffer[i] = ~frameBuffer[i];
   }
@@ -660,6 +670,12 @@ void GfxRenderer::displayBuffer(const HalDisplay::RefreshMode refreshMode) const
   display.displayBuffer(refreshMode, fadingFix);
 }
 
+void GfxRenderer::displayBufferAsync(const HalDisplay::RefreshMode refreshMode) const {
+  auto elapsed = millis() - start_ms;
+  LOG_DBG("GFX", "Time = %lu ms from clearScreen to displayBufferAsync", elapsed);
+  display.displayBufferAsync(refreshMode, fadingFix);
+}
+
 std::string GfxRenderer::truncatedText(const int fontId, const char* text, const int maxWidth,
                                        const EpdFontFamily::Style style) const {
   if (!text || maxWidth <= 0) return "";
@@ -901,6 +917,10 @@ bool GfxRenderer::storeBwBuffer() {
  * Uses chunked restoration to match chunked storage.
  */
 void GfxRenderer::restoreBwBuffer() {
+  // The grayscale refresh may still be reading the frame buffer. Callers write to it as soon as this returns, so wait
+  // even when there is nothing to restore.
+  display.waitUntilIdle();
+
   // Check if any all chunks are allocated
   bool missingChunks = false;
   for (const auto& bwBufferChunk : bwBufferChunks) {
@@ -1034,3 +1054,28 @@ void GfxRenderer::getOrientedViewableTRBL(int* outTop, int* outRight, int* outBo
       break;
   }
 }
+
+bool GfxRenderer::getPanelRect(const int x, const int y, const int width, const int height, int* phyX, int* phyY,
+                               int* phyWidth, int* phyHeight) const {
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+
+  int x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+  rotateCoordinates(orientation, x, y, &x1, &y1);
+  rotateCoordinates(orientation, x + width - 1, y + height - 1, &x2, &y2);
+
+  const int left = std::max(0, std::min(x1, x2));
+  const int top = std::max(0, std::min(y1, y2));
+  const int right = std::min(HalDisplay::DISPLAY_WIDTH - 1, std::max(x1, x2));
+  const int bottom = std::min(HalDisplay::DISPLAY_HEIGHT - 1, std::max(y1, y2));
+  if (left > right || top > bottom) {
+    return false;
+  }
+
+  *phyX = left;
+  *phyY = top;
+  *phyWidth = right - left + 1;
+  *phyHeight = bottom - top + 1;
+  return true;
+}
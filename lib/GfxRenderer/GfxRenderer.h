@@ -26,6 +26,7 @@ class GfxRenderer {
  private:
   static constexpr size_t BW_BUFFER_CHUNK_SIZE = 8000;  // 8KB chunks to allow for non-contiguous memory
   static constexpr size_t BW_BUFFER_NUM_CHUNKS = HalDisplay::BUFFER_SIZE / BW_BUFFER_CHUNK_SIZE;
+  static constexpr int BMP_CHUNK_BYTES = 8192;  // BMP rows read per SD access when drawing bitmaps
   static_assert(BW_BUFFER_CHUNK_SIZE * BW_BUFFER_NUM_CHUNKS == HalDisplay::BUFFER_SIZE,
                 "BW buffer chunking does not line up with display buffer size");
 
@@ -36,6 +37,9 @@ class GfxRenderer {
   uint8_t* frameBuffer = nullptr;
   uint8_t* bwBufferChunks[BW_BUFFER_NUM_CHUNKS] = {nullptr};
   std::map<int, EpdFontFamily> fontMap;
+#ifdef GFX_DRAW_PIXEL_STATS
+  mutable uint32_t drawPixelCalls = 0;
+#endif
   void renderChar(const EpdFontFamily& fontFamily, uint32_t cp, int* x, const int* y, bool pixelState,
                   EpdFontFamily::Style style) const;
   void freeBwBufferChunks();
@@ -43,6 +47,8 @@ class GfxRenderer {
   void drawPixelDither(int x, int y) const;
   template <Color color>
   void fillArc(int maxRadius, int cx, int cy, int xDir, int yDir) const;
+  // Nearest-neighbour blit of the uncropped part of a BMP at the given scale (at most 1)
+  void blitBitmap(const Bitmap& bitmap, int x, int y, int cropPixX, int cropPixY, float scale, bool oneBit) const;
 
  public:
   explicit GfxRenderer(HalDisplay& halDisplay)
@@ -69,11 +75,18 @@ class GfxRenderer {
   int getScreenWidth() const;
   int getScreenHeight() const;
   void displayBuffer(HalDisplay::RefreshMode refreshMode = HalDisplay::FAST_REFRESH) const;
+  // Returns as soon as the refresh has started. Work that does not draw (SD reads, layout) can run while the panel
+  // updates; drawing has to wait for waitForDisplay() or a clearScreen(), which waits itself.
+  void displayBufferAsync(HalDisplay::RefreshMode refreshMode = HalDisplay::FAST_REFRESH) const;
+  bool isDisplayBusy() const { return display.isBusy(); }
+  void waitForDisplay() const { display.waitUntilIdle(); }
   // EXPERIMENTAL: Windowed update - display only a rectangular region
   // void displayWindow(int x, int y, int width, int height) const;
   void invertScreen() const;
   void clearScreen(uint8_t color = 0xFF) const;
   void getOrientedViewableTRBL(int* outTop, int* outRight, int* outBottom, int* outLeft) const;
+  // Panel-native bounding box of a logical rectangle, clipped to the panel. Returns false if nothing is left.
+  bool getPanelRect(int x, int y, int width, int height, int* phyX, int* phyY, int* phyWidth, int* phyHeight) const;
 
   // Drawing
   void drawPixel(int x, int y, bool state = true) const;
@@ -128,4 +141,10 @@ class GfxRenderer {
   // Low level functions
   uint8_t* getFrameBuffer() const;
   static size_t getBufferSize();
+
+#ifdef GFX_DRAW_PIXEL_STATS
+  // Host benchmarks only: number of drawPixel() calls since the last reset
+  uint32_t getDrawPixelCalls() const { return drawPixelCalls; }
+  void resetDrawPixelCalls() const { drawPixelCalls = 0; }
+#endif
 };
@@ -145,7 +145,9 @@ enum class StrId : uint16_t {
   STR_SCREEN_MARGIN,
   STR_PARA_ALIGNMENT,
   STR_HYPHENATION,
+  STR_PAGE_BITMAP_CACHE,
   STR_TIME_TO_SLEEP,
+  STR_CACHE_BUDGET,
   STR_REFRESH_FREQ,
   STR_CALIBRE_SETTINGS,
   STR_KOREADER_SYNC,
@@ -229,6 +231,12 @@ enum class StrId : uint16_t {
   STR_PAGES_10,
   STR_PAGES_15,
   STR_PAGES_30,
+  STR_SIZE_64MB,
+  STR_SIZE_128MB,
+  STR_SIZE_256MB,
+  STR_SIZE_512MB,
+  STR_SIZE_1GB,
+  STR_UNLIMITED,
   STR_UPDATE,
   STR_CHECKING_UPDATE,
   STR_NEW_UPDATE,
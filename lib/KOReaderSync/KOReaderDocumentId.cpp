@@ -3,8 +3,12 @@
 #include <HalStorage.h>
 #include <Logging.h>
 #include <MD5Builder.h>
+#include <Serialization.h>
 
 namespace {
+constexpr uint8_t DOCUMENT_ID_FILE_VERSION = 1;
+constexpr char DOCUMENT_ID_FILE[] = "/koreader_id.bin";
+
 // Extract filename from path (everything after last '/')
 std::string getFilename(const std::string& path) {
   const size_t pos = path.rfind('/');
@@ -48,8 +52,14 @@ std::string KOReaderDocumentId::calculate(const std::string& filePath) {
     return "";
   }
 
+  LOG_DBG("KODoc", "Calculating hash for file: %s (size: %zu)", filePath.c_str(), static_cast<size_t>(file.fileSize()));
+  std::string result = calculate(file);
+  file.close();
+  return result;
+}
+
+std::string KOReaderDocumentId::calculate(FsFile& file) {
   const size_t fileSize = file.fileSize();
-  LOG_DBG("KODoc", "Calculating hash for file: %s (size: %zu)", filePath.c_str(), fileSize);
 
   // Initialize MD5 builder
   MD5Builder md5;
@@ -84,8 +94,6 @@ std::string KOReaderDocumentId::calculate(const std::string& filePath) {
     }
   }
 
-  file.close();
-
   // Calculate final hash
   md5.calculate();
   std::string result = md5.toString().c_str();
@@ -94,3 +102,51 @@ std::string KOReaderDocumentId::calculate(const std::string& filePath) {
 
   return result;
 }
+
+std::string KOReaderDocumentId::calculateCached(const std::string& filePath, const std::string& cacheDir,
+                                                const DocumentMatchMethod method) {
+  if (method == DocumentMatchMethod::FILENAME) {
+    return calculateFromFilename(filePath);
+  }
+
+  FsFile file;
+  if (!Storage.openFileForRead("KODoc", filePath, file)) {
+    LOG_DBG("KODoc", "Failed to open file: %s", filePath.c_str());
+    return "";
+  }
+  const auto fileSize = static_cast<uint32_t>(file.fileSize());
+  uint16_t date = 0, time = 0;
+  file.getModifyDateTime(&date, &time);
+  const uint32_t modified = static_cast<uint32_t>(date) << 16 | time;
+
+  const std::string cachePath = cacheDir + DOCUMENT_ID_FILE;
+  FsFile cache;
+  if (Storage.exists(cachePath.c_str()) && Storage.openFileForRead("KODoc", cachePath, cache)) {
+    uint8_t version;
+    uint32_t cachedSize, cachedModified;
+    std::string hash;
+    serialization::readPod(cache, version);
+    serialization::readPod(cache, cachedSize);
+    serialization::readPod(cache, cachedModified);
+    serialization::readString(cache, hash);
+    cache.close();
+    if (version == DOCUMENT_ID_FILE_VERSION && cachedSize == fileSize && cachedModified == modified &&
+        hash.size() == 32) {
+      file.close();
+      return hash;
+    }
+  }
+
+  LOG_DBG("KODoc", "Calculating hash for file: %s (size: %u)", filePath.c_str(), fileSize);
+  const std::string hash = calculate(file);
+  file.close();
+
+  if (Storage.openFileForWrite("KODoc", cachePath, cache)) {
+    serialization::writePod(cache, DOCUMENT_ID_FILE_VERSION);
+    serialization::writePod(cache, fileSize);
+    serialization::writePod(cache, modified);
+    serialization::writeString(cache, hash);
+    cache.close();
+  }
+  return hash;
+}
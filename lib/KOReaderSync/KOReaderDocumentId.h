@@ -1,6 +1,10 @@
 #pragma once
+#include <HalStorage.h>
+
 #include <string>
 
+#include "KOReaderCredentialStore.h"
+
 /**
  * Calculate KOReader document ID (partial MD5 hash).
  *
@@ -33,6 +37,15 @@ class KOReaderDocumentId {
    */
   static std::string calculateFromFilename(const std::string& filePath);
 
+  /**
+   * Document hash for the given match method. The content hash is kept in cacheDir (the book's cache directory)
+   * together with the size and write time of the file, so it is only calculated again once the file changes.
+   *
+   * @return 32-character lowercase hex string, or empty string on failure
+   */
+  static std::string calculateCached(const std::string& filePath, const std::string& cacheDir,
+                                     DocumentMatchMethod method);
+
  private:
   // Size of each chunk to read at each offset
   static constexpr size_t CHUNK_SIZE = 1024;
@@ -42,4 +55,6 @@ class KOReaderDocumentId {
 
   // Calculate offset for index i: 1024 << (2*i)
   static size_t getOffset(int i);
+
+  static std::string calculate(FsFile& file);
 };
@@ -0,0 +1,111 @@
+#include "KOReaderProgressQueue.h"
+
+#include <HalStorage.h>
+#include <Logging.h>
+#include <Serialization.h>
+
+#include <algorithm>
+
+// Initialize the static instance
+KOReaderProgressQueue KOReaderProgressQueue::instance;
+
+namespace {
+// File format version
+constexpr uint8_t QUEUE_FILE_VERSION = 1;
+
+// Pending progress file path
+constexpr char QUEUE_FILE[] = "/.crosspoint/koreader_queue.bin";
+}  // namespace
+
+bool KOReaderProgressQueue::saveToFile() const {
+  // Make sure the directory exists
+  Storage.mkdir("/.crosspoint");
+
+  FsFile file;
+  if (!Storage.openFileForWrite("KRQ", QUEUE_FILE, file)) {
+    return false;
+  }
+
+  serialization::writePod(file, QUEUE_FILE_VERSION);
+  serialization::writePod(file, static_cast<uint8_t>(entries.size()));
+  for (const auto& entry : entries) {
+    serialization::writeString(file, entry.document);
+    serialization::writeString(file, entry.progress);
+    serialization::writePod(file, entry.percentage);
+    serialization::writePod(file, entry.timestamp);
+  }
+
+  file.close();
+  LOG_DBG("KRQ", "Saved %zu pending progress updates", entries.size());
+  return true;
+}
+
+bool KOReaderProgressQueue::loadFromFile() {
+  entries.clear();
+  FsFile file;
+  if (!Storage.exists(QUEUE_FILE) || !Storage.openFileForRead("KRQ", QUEUE_FILE, file)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(file, version);
+  if (version != QUEUE_FILE_VERSION) {
+    LOG_DBG("KRQ", "Unknown file version: %u", version);
+    file.close();
+    return false;
+  }
+
+  uint8_t count;
+  serialization::readPod(file, count);
+  for (uint8_t i = 0; i < count && i < MAX_ENTRIES; i++) {
+    KOReaderProgress entry{};
+    serialization::readString(file, entry.document);
+    serialization::readString(file, entry.progress);
+    serialization::readPod(file, entry.percentage);
+    serialization::readPod(file, entry.timestamp);
+    entries.push_back(std::move(entry));
+  }
+
+  file.close();
+  LOG_DBG("KRQ", "Loaded %zu pending progress updates", entries.size());
+  return true;
+}
+
+void KOReaderProgressQueue::add(const KOReaderProgress& progress) {
+  const auto existing = std::find_if(entries.begin(), entries.end(), [&progress](const KOReaderProgress& entry) {
+    return entry.document == progress.document;
+  });
+  if (existing != entries.end()) {
+    if (existing->progress == progress.progress && existing->percentage == progress.percentage) {
+      return;
+    }
+    entries.erase(existing);
+  } else if (entries.size() >= MAX_ENTRIES) {
+    LOG_DBG("KRQ", "Queue full, dropping progress of %s", entries.front().document.c_str());
+    entries.erase(entries.begin());
+  }
+  entries.push_back(progress);
+  saveToFile();
+}
+
+void KOReaderProgressQueue::remove(const std::string& document) {
+  const auto existing = std::find_if(entries.begin(), entries.end(),
+                                     [&document](const KOReaderProgress& entry) { return entry.document == document; });
+  if (existing != entries.end()) {
+    entries.erase(existing);
+    saveToFile();
+  }
+}
+
+KOReaderSyncClient::Error KOReaderProgressQueue::flush(const Pusher& push) {
+  if (entries.empty()) {
+    return KOReaderSyncClient::OK;
+  }
+
+  size_t done = 0;
+  const auto result = push(entries, done);
+  done = std::min(done, entries.size());
+  entries.erase(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(done));
+  LOG_DBG("KRQ", "Pushed %zu pending progress updates, %zu left", done, entries.size());
+  return result;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "KOReaderSyncClient.h"
+
+/**
+ * Singleton queue of reading progress that still has to reach the KOReader sync server.
+ * The reader adds the position of a book when it is closed, without turning on WiFi; the queue is pushed in one go
+ * the next time the device is online. Only the latest position of each book is kept.
+ *
+ * Stored in /sd/.crosspoint/koreader_queue.bin.
+ */
+class KOReaderProgressQueue {
+ private:
+  static KOReaderProgressQueue instance;
+  std::vector<KOReaderProgress> entries;  // Oldest first
+
+  static constexpr size_t MAX_ENTRIES = 16;
+
+  // Private constructor for singleton
+  KOReaderProgressQueue() = default;
+
+ public:
+  /**
+   * Push pending in order over one connection. done must be set to the number of leading entries the server took
+   * (or that were skipped because the server already had newer progress), also when an error is returned.
+   */
+  using Pusher = std::function<KOReaderSyncClient::Error(const std::vector<KOReaderProgress>& pending, size_t& done)>;
+
+  // Delete copy constructor and assignment
+  KOReaderProgressQueue(const KOReaderProgressQueue&) = delete;
+  KOReaderProgressQueue& operator=(const KOReaderProgressQueue&) = delete;
+
+  // Get singleton instance
+  static KOReaderProgressQueue& getInstance() { return instance; }
+
+  // Save/load from SD card
+  bool saveToFile() const;
+  bool loadFromFile();
+
+  // Queue the progress of a book, replacing what was queued for it. Saves the file.
+  void add(const KOReaderProgress& progress);
+  // Drop the queued progress of a book, e.g. after it was synced interactively. Saves the file if anything changed.
+  void remove(const std::string& document);
+
+  bool empty() const { return entries.empty(); }
+  const std::vector<KOReaderProgress>& getEntries() const { return entries; }
+
+  /**
+   * Push the queue and drop the entries that went through. Does not write the file, so the network part can run
+   * outside the render lock; call saveToFile() afterwards.
+   * @return OK if the queue is now empty
+   */
+  KOReaderSyncClient::Error flush(const Pusher& push);
+};
+
+// Helper macro to access the progress queue
+#define KOREADER_QUEUE KOReaderProgressQueue::getInstance()
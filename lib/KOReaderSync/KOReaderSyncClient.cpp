@@ -6,9 +6,11 @@
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
 
+#include <algorithm>
 #include <ctime>
 
 #include "KOReaderCredentialStore.h"
+#include "KOReaderProgressQueue.h"
 
 namespace {
 // Device identifier for CrossPoint reader
@@ -26,6 +28,20 @@ void addAuthHeaders(HTTPClient& http) {
 }
 
 bool isHttpsUrl(const std::string& url) { return url.rfind("https://", 0) == 0; }
+
+// Build JSON body (timestamp not required per API spec)
+std::string progressBody(const KOReaderProgress& progress) {
+  JsonDocument doc;
+  doc["document"] = progress.document;
+  doc["progress"] = progress.progress;
+  doc["percentage"] = progress.percentage;
+  doc["device"] = DEVICE_NAME;
+  doc["device_id"] = DEVICE_ID;
+
+  std::string body;
+  serializeJson(doc, body);
+  return body;
+}
 }  // namespace
 
 KOReaderSyncClient::Error KOReaderSyncClient::authenticate() {
@@ -151,16 +167,7 @@ KOReaderSyncClient::Error KOReaderSyncClient::updateProgress(const KOReaderProgr
   addAuthHeaders(http);
   http.addHeader("Content-Type", "application/json");
 
-  // Build JSON body (timestamp not required per API spec)
-  JsonDocument doc;
-  doc["document"] = progress.document;
-  doc["progress"] = progress.progress;
-  doc["percentage"] = progress.percentage;
-  doc["device"] = DEVICE_NAME;
-  doc["device_id"] = DEVICE_ID;
-
-  std::string body;
-  serializeJson(doc, body);
+  const std::string body = progressBody(progress);
 
   LOG_DBG("KOSync", "Request body: %s", body.c_str());
 
@@ -179,6 +186,115 @@ KOReaderSyncClient::Error KOReaderSyncClient::updateProgress(const KOReaderProgr
   return SERVER_ERROR;
 }
 
+KOReaderSyncClient::Error KOReaderSyncClient::updateProgress(const std::vector<KOReaderProgress>& batch, size_t& done,
+                                                             const unsigned long timeBudgetMs) {
+  const unsigned long start = millis();
+  done = 0;
+  if (!KOREADER_STORE.hasCredentials()) {
+    LOG_DBG("KOSync", "No credentials configured");
+    return NO_CREDENTIALS;
+  }
+
+  const std::string baseUrl = KOREADER_STORE.getBaseUrl();
+  LOG_DBG("KOSync", "Updating progress of %zu documents: %s", batch.size(), baseUrl.c_str());
+
+  HTTPClient http;
+  std::unique_ptr<WiFiClientSecure> secureClient;
+  WiFiClient plainClient;
+
+  if (isHttpsUrl(baseUrl)) {
+    secureClient.reset(new WiFiClientSecure);
+    secureClient->setInsecure();
+  }
+  if (timeBudgetMs != 0) {
+    // The default timeouts alone could use up the budget several times over on an unreachable server
+    const auto requestTimeoutMs = static_cast<uint16_t>(std::min(timeBudgetMs / 2, 5000UL));
+    http.setConnectTimeout(requestTimeoutMs);
+    http.setTimeout(requestTimeoutMs);
+    if (secureClient) {
+      secureClient->setHandshakeTimeout(std::max(requestTimeoutMs / 1000, 1));
+    }
+  }
+  // Keep the connection, and with it the TLS session, open from one request to the next
+  http.setReuse(true);
+  const auto begin = [&](const std::string& url) {
+    if (secureClient) {
+      http.begin(*secureClient, url.c_str());
+    } else {
+      http.begin(plainClient, url.c_str());
+    }
+    addAuthHeaders(http);
+  };
+
+  for (const auto& progress : batch) {
+    if (timeBudgetMs != 0 && millis() - start >= timeBudgetMs) {
+      return TIMED_OUT;
+    }
+    begin(baseUrl + "/syncs/progress/" + progress.document);
+    const int getCode = http.GET();
+    bool keepRemote = false;
+    if (getCode == 200) {
+      JsonDocument doc;
+      if (!deserializeJson(doc, http.getString())) {
+        // Without a clock the update cannot be ordered against another device's, only our own is replaced
+        if (progress.timestamp != 0) {
+          keepRemote = doc["timestamp"].as<int64_t>() > progress.timestamp;
+        } else {
+          keepRemote = !doc["device_id"].isNull() && doc["device_id"].as<std::string>() != DEVICE_ID;
+        }
+      }
+    }
+    http.end();
+    if (getCode == 401) {
+      return AUTH_FAILED;
+    } else if (getCode < 0) {
+      return NETWORK_ERROR;
+    }
+    if (keepRemote) {
+      LOG_DBG("KOSync", "Server has newer progress for %s, not updating", progress.document.c_str());
+      done++;
+      continue;
+    }
+
+    begin(baseUrl + "/syncs/progress");
+    http.addHeader("Content-Type", "application/json");
+    const int httpCode = http.PUT(progressBody(progress).c_str());
+    http.end();
+
+    LOG_DBG("KOSync", "Update progress of %s response: %d", progress.document.c_str(), httpCode);
+
+    if (httpCode == 401) {
+      return AUTH_FAILED;
+    } else if (httpCode < 0) {
+      return NETWORK_ERROR;
+    } else if (httpCode != 200 && httpCode != 202) {
+      return SERVER_ERROR;
+    }
+    done++;
+  }
+  return OK;
+}
+
+KOReaderSyncClient::Error KOReaderSyncClient::pushQueuedProgress() {
+  if (KOREADER_QUEUE.empty() || !KOREADER_STORE.hasCredentials() || WiFi.status() != WL_CONNECTED) {
+    return OK;
+  }
+  // Called from onExit on the UI task, which stays frozen until this returns
+  constexpr unsigned long PUSH_TIME_BUDGET_MS = 4000;
+  const size_t queued = KOREADER_QUEUE.getEntries().size();
+  const Error result = KOREADER_QUEUE.flush([](const std::vector<KOReaderProgress>& pending, size_t& done) {
+    return updateProgress(pending, done, PUSH_TIME_BUDGET_MS);
+  });
+  KOREADER_QUEUE.saveToFile();
+  if (result == OK) {
+    LOG_INF("KOSync", "Pushed %zu queued progress updates", queued);
+  } else {
+    LOG_ERR("KOSync", "Pushing queued progress failed: %s, %zu of %zu left", errorString(result),
+            KOREADER_QUEUE.getEntries().size(), queued);
+  }
+  return result;
+}
+
 const char* KOReaderSyncClient::errorString(Error error) {
   switch (error) {
     case OK:
@@ -195,6 +311,8 @@ const char* KOReaderSyncClient::errorString(Error error) {
       return "JSON parse error";
     case NOT_FOUND:
       return "No progress found";
+    case TIMED_OUT:
+      return "Timed out";
     default:
       return "Unknown error";
   }
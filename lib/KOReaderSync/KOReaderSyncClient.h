@@ -1,5 +1,7 @@
 #pragma once
+#include <cstddef>
 #include <string>
+#include <vector>
 
 /**
  * Progress data from KOReader sync server.
@@ -10,7 +12,7 @@ struct KOReaderProgress {
   float percentage;      // Progress percentage (0.0 to 1.0)
   std::string device;    // Device name
   std::string deviceId;  // Device ID
-  int64_t timestamp;     // Unix timestamp of last update
+  int64_t timestamp;     // Unix timestamp of last update (local clock for queued progress, 0 if it was not set)
 };
 
 /**
@@ -29,7 +31,7 @@ struct KOReaderProgress {
  */
 class KOReaderSyncClient {
  public:
-  enum Error { OK = 0, NO_CREDENTIALS, NETWORK_ERROR, AUTH_FAILED, SERVER_ERROR, JSON_ERROR, NOT_FOUND };
+  enum Error { OK = 0, NO_CREDENTIALS, NETWORK_ERROR, AUTH_FAILED, SERVER_ERROR, JSON_ERROR, NOT_FOUND, TIMED_OUT };
 
   /**
    * Authenticate with the sync server (validate credentials).
@@ -52,6 +54,25 @@ class KOReaderSyncClient {
    */
   static Error updateProgress(const KOReaderProgress& progress);
 
+  /**
+   * Update the progress of several documents in order over one connection. An update with a timestamp is skipped
+   * when the server already has newer progress for its document, one without (the clock was not set) when the server
+   * has progress from another device, so reading done on another device meanwhile is kept.
+   * @param done Output: number of leading updates that were sent or skipped
+   * @param timeBudgetMs When non-zero, requests time out sooner and no new update is started once this much time has
+   * passed, the rest is left for the caller to retry
+   * @return OK once every update went through, TIMED_OUT when the budget ran out, otherwise the error that stopped
+   * the batch
+   */
+  static Error updateProgress(const std::vector<KOReaderProgress>& batch, size_t& done, unsigned long timeBudgetMs = 0);
+
+  /**
+   * Push the progress KOREADER_QUEUE collected while offline and save what is left of it. For the end of a WiFi
+   * session started for something else: nobody waits on the result, so it is logged. Runs on the caller's task, so it
+   * gives up after a few seconds and leaves the rest for the next session. Does nothing when offline.
+   */
+  static Error pushQueuedProgress();
+
   /**
    * Get human-readable error message.
    */
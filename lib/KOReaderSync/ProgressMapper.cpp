@@ -16,8 +16,8 @@ KOReaderPosition ProgressMapper::toKOReader(const std::shared_ptr<Epub>& epub, c
   // Calculate overall book progress (0.0-1.0)
   result.percentage = epub->calculateProgress(pos.spineIndex, intraSpineProgress);
 
-  // Generate XPath with estimated paragraph position based on page
-  result.xpath = generateXPath(pos.spineIndex, pos.pageNumber, pos.totalPages);
+  // Generate XPath pointing at the element the page starts in
+  result.xpath = generateXPath(pos.spineIndex, pos.elementPath);
 
   // Get chapter info for logging
   const int tocIndex = epub->getTocIndexForSpineIndex(pos.spineIndex);
@@ -45,8 +45,10 @@ CrossPointPosition ProgressMapper::toCrossPoint(const std::shared_ptr<Epub>& epu
   int xpathSpineIndex = parseDocFragmentIndex(koPos.xpath);
   if (xpathSpineIndex >= 0 && xpathSpineIndex < epub->getSpineItemsCount()) {
     result.spineIndex = xpathSpineIndex;
-    // When we have XPath, go to page 0 of the spine - byte-based page calculation is unreliable
+    // When we have XPath, go to page 0 of the spine - byte-based page calculation is unreliable. The element path
+    // narrows that down once the section file is loaded.
     result.pageNumber = 0;
+    result.elementPath = parseElementPath(koPos.xpath);
   } else {
     // Fall back to percentage-based lookup for both spine and page
     const size_t targetBytes = static_cast<size_t>(bookSize * koPos.percentage);
@@ -82,11 +84,11 @@ CrossPointPosition ProgressMapper::toCrossPoint(const std::shared_ptr<Epub>& epu
   return result;
 }
 
-std::string ProgressMapper::generateXPath(int spineIndex, int pageNumber, int totalPages) {
+std::string ProgressMapper::generateXPath(int spineIndex, const std::string& elementPath) {
   // KOReader uses 1-based DocFragment indices
-  // Use a simple xpath pointing to the DocFragment - KOReader will use the percentage for fine positioning
-  // Avoid specifying paragraph numbers as they may not exist in the target document
-  return "/body/DocFragment[" + std::to_string(spineIndex + 1) + "]/body";
+  // Without a recorded element, point to the DocFragment - KOReader will use the percentage for fine positioning
+  const std::string docFragment = "/body/DocFragment[" + std::to_string(spineIndex + 1) + "]";
+  return docFragment + (elementPath.empty() ? "/body" : elementPath);
 }
 
 int ProgressMapper::parseDocFragmentIndex(const std::string& xpath) {
@@ -110,3 +112,15 @@ int ProgressMapper::parseDocFragmentIndex(const std::string& xpath) {
     return -1;
   }
 }
+
+std::string ProgressMapper::parseElementPath(const std::string& xpath) {
+  const size_t start = xpath.find("DocFragment[");
+  if (start == std::string::npos) {
+    return "";
+  }
+  const size_t end = xpath.find(']', start);
+  if (end == std::string::npos) {
+    return "";
+  }
+  return xpath.substr(end + 1);
+}
@@ -11,6 +11,8 @@ struct CrossPointPosition {
   int spineIndex;  // Current spine item (chapter) index
   int pageNumber;  // Current page within the spine item
   int totalPages;  // Total pages in the current spine item
+  // Element the page starts in, a path below the chapter's <html> such as "/body/div[2]/p[7]"; empty if unknown
+  std::string elementPath;
 };
 
 /**
@@ -27,9 +29,9 @@ struct KOReaderPosition {
  * CrossPoint tracks position as (spineIndex, pageNumber).
  * KOReader uses XPath-like strings + percentage.
  *
- * Since CrossPoint discards HTML structure during parsing, we generate
- * synthetic XPath strings based on spine index, using percentage as the
- * primary sync mechanism.
+ * The XPath is the DocFragment of the spine item followed by the element path
+ * the section file recorded for the page. Without one it stops at the
+ * chapter's body and percentage is the primary sync mechanism.
  */
 class ProgressMapper {
  public:
@@ -46,7 +48,9 @@ class ProgressMapper {
    * Convert KOReader position to CrossPoint format.
    *
    * Note: The returned pageNumber may be approximate since different
-   * rendering settings produce different page counts.
+   * rendering settings produce different page counts. When the XPath points
+   * into the chapter, elementPath is set so the page can be looked up in the
+   * section file once it is loaded.
    *
    * @param epub The EPUB book
    * @param koPos KOReader position
@@ -59,14 +63,20 @@ class ProgressMapper {
  private:
   /**
    * Generate XPath for KOReader compatibility.
-   * Format: /body/DocFragment[spineIndex+1]/body/p[estimatedParagraph]
-   * Paragraph is estimated based on page position within the chapter.
+   * Format: /body/DocFragment[spineIndex+1]/body/div[2]/p[7], or /body/DocFragment[spineIndex+1]/body without
+   * an element path.
    */
-  static std::string generateXPath(int spineIndex, int pageNumber, int totalPages);
+  static std::string generateXPath(int spineIndex, const std::string& elementPath);
 
   /**
    * Parse DocFragment index from XPath string.
    * Returns -1 if not found.
    */
   static int parseDocFragmentIndex(const std::string& xpath);
+
+  /**
+   * The part of an XPath after its DocFragment step, e.g. "/body/div/p[3]/text().0".
+   * Returns an empty string if there is none.
+   */
+  static std::string parseElementPath(const std::string& xpath);
 };
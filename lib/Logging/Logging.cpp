@@ -1,5 +1,13 @@
 #include "Logging.h"
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
 // Since logging can take a large amount of flash, we want to make the format string as short as possible.
 // This logPrintf prepend the timestamp, level and origin to the user-provided message, so that the user only needs to
 // provide the format string for the message itself.
@@ -45,3 +53,164 @@ void logPrintf(const char* level, const char* origin, const char* format, ...) {
   va_end(args);
   logSerial.print(buf);
 }
+
+namespace {
+// Records are copied in and out under a critical section, they are only a few dozen bytes each
+portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t* ring = nullptr;
+size_t ringHead = 0;  // next byte to send
+size_t ringUsed = 0;
+uint32_t droppedRecords = 0;
+SemaphoreHandle_t drainWake = nullptr;
+// Held while a batch is written, so logBinaryPause() returns only once the port is free
+SemaphoreHandle_t drainLock = nullptr;
+std::atomic<bool> drainPaused{false};
+
+void drainTask(void*) {
+  while (true) {
+    xSemaphoreTake(drainWake, portMAX_DELAY);
+    if (logSerial) {
+      logBinaryDrain(logSerial);
+    }
+  }
+}
+}  // namespace
+
+binlog::Record::Record(const uint32_t id) {
+  data[len++] = 0;
+  data[len++] = 0;  // payload length, set by commit()
+  const uint32_t now = millis();
+  memcpy(data + len, &id, sizeof(id));
+  memcpy(data + len + sizeof(id), &now, sizeof(now));
+  len += sizeof(id) + sizeof(now);
+}
+
+void binlog::Record::put(const uint8_t tag, const void* value, const size_t size) {
+  // Once an argument does not fit, later ones are left out as well so the decoder cannot mix them up
+  if (full || len + 1 + size > sizeof(data)) {
+    full = true;
+    return;
+  }
+  data[len++] = tag;
+  memcpy(data + len, value, size);
+  len += size;
+}
+
+void binlog::Record::addString(const char* value) {
+  if (!value) {
+    value = "(null)";
+  }
+  if (full || len + 2 > sizeof(data)) {
+    full = true;
+    return;
+  }
+  // Long strings are cut to what is left of the record
+  const size_t size = std::min(strlen(value), sizeof(data) - len - 2);
+  data[len++] = ARG_STRING;
+  data[len++] = static_cast<uint8_t>(size);
+  memcpy(data + len, value, size);
+  len += size;
+}
+
+void binlog::Record::commit() {
+  data[1] = static_cast<uint8_t>(len - 2);
+  bool queued = false;
+  portENTER_CRITICAL(&ringMux);
+  if (ring && ringUsed + len <= RING_SIZE) {
+    const size_t tail = (ringHead + ringUsed) % RING_SIZE;
+    const size_t first = std::min(len, RING_SIZE - tail);
+    memcpy(ring + tail, data, first);
+    memcpy(ring, data + first, len - first);
+    ringUsed += len;
+    queued = true;
+  } else if (ring) {
+    droppedRecords++;
+  }
+  portEXIT_CRITICAL(&ringMux);
+  if (queued && drainWake) {
+    xSemaphoreGive(drainWake);
+  }
+}
+
+bool logBinaryBegin(const bool startTask) {
+  if (ring) {
+    return true;
+  }
+  auto* buffer = static_cast<uint8_t*>(malloc(binlog::RING_SIZE));
+  if (!buffer) {
+    return false;
+  }
+  if (startTask) {
+    drainWake = xSemaphoreCreateBinary();
+    drainLock = xSemaphoreCreateMutex();
+    if (!drainWake || !drainLock || xTaskCreate(&drainTask, "LogDrain", 2048, nullptr, 1, nullptr) != pdPASS) {
+      free(buffer);
+      return false;
+    }
+  }
+  portENTER_CRITICAL(&ringMux);
+  ring = buffer;
+  portEXIT_CRITICAL(&ringMux);
+  return true;
+}
+
+void logBinaryDrain(Print& out) {
+  // Whole records only, so text written to logSerial in between cannot land inside one
+  uint8_t chunk[2 * (2 + binlog::MAX_PAYLOAD)];
+  while (true) {
+    size_t size = 0;
+    uint32_t dropped = 0;
+    if (drainLock) {
+      xSemaphoreTake(drainLock, portMAX_DELAY);
+    }
+    if (drainPaused) {
+      if (drainLock) {
+        xSemaphoreGive(drainLock);
+      }
+      return;
+    }
+    portENTER_CRITICAL(&ringMux);
+    while (ring && ringUsed > 0) {
+      const size_t recordLen = 2 + ring[(ringHead + 1) % binlog::RING_SIZE];
+      if (size + recordLen > sizeof(chunk)) {
+        break;
+      }
+      const size_t first = std::min(recordLen, binlog::RING_SIZE - ringHead);
+      memcpy(chunk + size, ring + ringHead, first);
+      memcpy(chunk + size + first, ring, recordLen - first);
+      ringHead = (ringHead + recordLen) % binlog::RING_SIZE;
+      ringUsed -= recordLen;
+      size += recordLen;
+    }
+    if (size == 0) {
+      dropped = droppedRecords;
+      droppedRecords = 0;
+    }
+    portEXIT_CRITICAL(&ringMux);
+
+    if (size > 0) {
+      out.write(chunk, size);
+    }
+    if (drainLock) {
+      xSemaphoreGive(drainLock);
+    }
+    if (size == 0 && dropped > 0) {
+      binlog::send(binlog::DROPPED_ID, dropped);
+    } else if (size == 0) {
+      return;
+    }
+  }
+}
+
+void logBinaryPause(const bool paused) {
+  if (drainLock) {
+    xSemaphoreTake(drainLock, portMAX_DELAY);
+  }
+  drainPaused = paused;
+  if (drainLock) {
+    xSemaphoreGive(drainLock);
+  }
+  if (!paused && drainWake) {
+    xSemaphoreGive(drainWake);
+  }
+}
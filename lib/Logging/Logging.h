@@ -2,6 +2,10 @@
 
 #include <HardwareSerial.h>
 
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
 /*
 Define ENABLE_SERIAL_LOG to enable logging
 Can be set in platformio.ini build_flags or as a compile definition
@@ -19,6 +23,14 @@ special formatting), use the underlying logSerial object directly:
 
 The logSerial reference (defined below) points to the real Serial object and
 won't trigger deprecation warnings.
+
+Define LOG_BINARY as well to send compact binary records instead of text.
+The format string of every LOG_* call is reduced to a 32-bit id at compile
+time; only the id, a timestamp and the raw arguments are queued, and a
+background task sends them once Serial has been started. Nothing is
+formatted on the device. scripts/binary_log.py generates the id table from
+the sources and turns the records back into text:
+    python3 scripts/debugging_monitor.py --log-table .pio/build/binlog/log_table.json
 */
 
 #ifndef LOG_LEVEL
@@ -29,21 +41,107 @@ static HWCDC& logSerial = Serial;
 
 void logPrintf(const char* level, const char* origin, const char* format, ...);
 
+// Binary records are framed as 0x00, payload length, then the payload: u32 format id, u32 millis() and one tagged
+// value per argument. A NUL never appears in text output, so the decoder can pick records out of a mixed stream.
+namespace binlog {
+constexpr size_t MAX_PAYLOAD = 255;
+constexpr size_t RING_SIZE = 4096;
+// Reserved format id, carries the number of records dropped because the ring was full
+constexpr uint32_t DROPPED_ID = 0;
+
+enum ArgTag : uint8_t { ARG_32 = 1, ARG_64 = 2, ARG_DOUBLE = 3, ARG_STRING = 4 };
+
+// FNV-1a of level, origin and format separated by 0x1f; scripts/binary_log.py computes the same
+constexpr uint32_t formatId(const char* text) {
+  uint32_t hash = 2166136261u;
+  for (; *text; text++) {
+    hash ^= static_cast<uint8_t>(*text);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+class Record {
+  uint8_t data[2 + MAX_PAYLOAD];
+  size_t len = 0;
+  bool full = false;
+
+  void put(uint8_t tag, const void* value, size_t size);
+
+ public:
+  explicit Record(uint32_t id);
+
+  template <typename T>
+  void add(const T value) {
+    if constexpr (std::is_pointer_v<T> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char>) {
+      addString(value);
+    } else if constexpr (std::is_enum_v<T>) {
+      add(static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_integral_v<T> && sizeof(T) <= 4) {
+      const auto wide = static_cast<std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>>(value);
+      put(ARG_32, &wide, sizeof(wide));
+    } else if constexpr (std::is_integral_v<T>) {
+      const auto wide = static_cast<uint64_t>(value);
+      put(ARG_64, &wide, sizeof(wide));
+    } else if constexpr (std::is_floating_point_v<T>) {
+      const auto wide = static_cast<double>(value);
+      put(ARG_DOUBLE, &wide, sizeof(wide));
+    } else if constexpr (std::is_pointer_v<T>) {
+      const auto wide = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+      put(ARG_64, &wide, sizeof(wide));
+    } else {
+      static_assert(std::is_pointer_v<T>, "Unsupported LOG_* argument type");
+    }
+  }
+  void addString(const char* value);
+
+  // Queue the record for the drain task, dropped if logBinaryBegin() has not been called or the ring is full
+  void commit();
+};
+
+template <typename... Args>
+void send(const uint32_t id, const Args&... args) {
+  Record record(id);
+  (record.add(args), ...);
+  record.commit();
+}
+}  // namespace binlog
+
+/**
+ * Allocate the record ring. With startTask, a task sends queued records to logSerial; otherwise they stay queued
+ * until logBinaryDrain() is called.
+ */
+bool logBinaryBegin(bool startTask = true);
+// Send every queued record to out
+void logBinaryDrain(Print& out);
+// Hold back records while raw data (e.g. a screenshot) is written to logSerial
+void logBinaryPause(bool paused);
+
+#define LOG_RECORD(level, origin, format, ...) \
+  binlog::send(std::integral_constant<uint32_t, binlog::formatId(level "\x1f" origin "\x1f" format)>::value, \
+               ##__VA_ARGS__)
+
+#ifdef LOG_BINARY
+#define LOG_PRINTF(level, origin, format, ...) LOG_RECORD(level, origin, format, ##__VA_ARGS__)
+#else
+#define LOG_PRINTF(level, origin, format, ...) logPrintf("[" level "]", origin, format "\n", ##__VA_ARGS__)
+#endif
+
 #ifdef ENABLE_SERIAL_LOG
 #if LOG_LEVEL >= 0
-#define LOG_ERR(origin, format, ...) logPrintf("[ERR]", origin, format "\n", ##__VA_ARGS__)
+#define LOG_ERR(origin, format, ...) LOG_PRINTF("ERR", origin, format, ##__VA_ARGS__)
 #else
 #define LOG_ERR(origin, format, ...)
 #endif
 
 #if LOG_LEVEL >= 1
-#define LOG_INF(origin, format, ...) logPrintf("[INF]", origin, format "\n", ##__VA_ARGS__)
+#define LOG_INF(origin, format, ...) LOG_PRINTF("INF", origin, format, ##__VA_ARGS__)
 #else
 #define LOG_INF(origin, format, ...)
 #endif
 
 #if LOG_LEVEL >= 2
-#define LOG_DBG(origin, format, ...) logPrintf("[DBG]", origin, format "\n", ##__VA_ARGS__)
+#define LOG_DBG(origin, format, ...) LOG_PRINTF("DBG", origin, format, ##__VA_ARGS__)
 #else
 #define LOG_DBG(origin, format, ...)
 #endif
@@ -55,7 +153,12 @@ void logPrintf(const char* level, const char* origin, const char* format, ...);
 
 class MySerialImpl : public Print {
  public:
-  void begin(unsigned long baud) { logSerial.begin(baud); }
+  void begin(unsigned long baud) {
+    logSerial.begin(baud);
+#ifdef LOG_BINARY
+    logBinaryBegin();
+#endif
+  }
 
   // Support boolean conversion for compatibility with code like:
   //   if (Serial) or while (!Serial)
@@ -0,0 +1,277 @@
+#include "OpdsFeedCache.h"
+
+#include <HalStorage.h>
+#include <Logging.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "OpdsStream.h"
+
+namespace {
+constexpr uint8_t FEED_CACHE_FILE_VERSION = 1;
+
+std::string hashUrl(const std::string& url) {
+  uint32_t hash = 2166136261u;
+  for (const char c : url) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  char hex[9];
+  snprintf(hex, sizeof(hex), "%08x", static_cast<unsigned>(hash));
+  return hex;
+}
+}  // namespace
+
+bool OpdsFeedCache::loadMeta() {
+  FsFile file;
+  if (!Storage.exists((basePath + ".meta").c_str()) || !Storage.openFileForRead("OPDS", basePath + ".meta", file)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(file, version);
+  if (version != FEED_CACHE_FILE_VERSION) {
+    LOG_ERR("OPDS", "Deserialization failed: Unknown version %u", version);
+    file.close();
+    return false;
+  }
+
+  std::string cachedUrl;
+  serialization::readString(file, cachedUrl);
+  if (cachedUrl != url) {
+    // Hash collision, the slot belongs to another feed
+    file.close();
+    return false;
+  }
+  serialization::readString(file, validators.etag);
+  serialization::readString(file, validators.lastModified);
+  serialization::readString(file, nextHref);
+  serialization::readPod(file, entryCount);
+  serialization::readPod(file, dataSize);
+  file.close();
+  return true;
+}
+
+bool OpdsFeedCache::saveMeta() const {
+  FsFile file;
+  if (!Storage.openFileForWrite("OPDS", basePath + ".meta", file)) {
+    return false;
+  }
+  serialization::writePod(file, FEED_CACHE_FILE_VERSION);
+  serialization::writeString(file, url);
+  serialization::writeString(file, validators.etag);
+  serialization::writeString(file, validators.lastModified);
+  serialization::writeString(file, nextHref);
+  serialization::writePod(file, entryCount);
+  serialization::writePod(file, dataSize);
+  file.close();
+  return true;
+}
+
+void OpdsFeedCache::removeFiles() const {
+  for (const char* ext : {".meta", ".dat", ".idx"}) {
+    const std::string path = basePath + ext;
+    if (Storage.exists(path.c_str())) {
+      Storage.remove(path.c_str());
+    }
+  }
+}
+
+OpdsFeedCache::Result OpdsFeedCache::fetchPage(const std::string& pageUrl, const OpdsValidators& sent,
+                                               const bool append, const Fetcher& fetch,
+                                               OpdsFetchResult& fetchResult) {
+  // The store is only opened once the first entry arrives, so a 304 or a failed request leaves it untouched
+  FsFile data, index;
+  bool opened = false;
+  bool writeFailed = false;
+  uint32_t count = append ? entryCount : 0;
+  uint32_t size = append ? dataSize : 0;
+
+  const auto openFiles = [&] {
+    opened = true;
+    if (!append) {
+      // The old meta must not describe the new data if we get interrupted
+      Storage.remove((basePath + ".meta").c_str());
+    }
+    const oflag_t flags = append ? (O_RDWR | O_CREAT) : (O_RDWR | O_CREAT | O_TRUNC);
+    data = Storage.open((basePath + ".dat").c_str(), flags);
+    index = Storage.open((basePath + ".idx").c_str(), flags);
+    if (!data || !index) {
+      LOG_ERR("OPDS", "Failed to open feed cache %s", basePath.c_str());
+      return false;
+    }
+    // Anything past the committed size is left over from an interrupted page and gets overwritten
+    return data.seek(size) && index.seek(count * sizeof(uint32_t));
+  };
+
+  OpdsParser parser;
+  parser.setEntryCallback([&](const OpdsEntry& entry) {
+    if (writeFailed || (!opened && !openFiles())) {
+      writeFailed = true;
+      return;
+    }
+    serialization::writePod(index, size);
+    serialization::writePod(data, static_cast<uint8_t>(entry.type));
+    serialization::writeString(data, entry.title);
+    serialization::writeString(data, entry.author);
+    serialization::writeString(data, entry.href);
+    serialization::writeString(data, entry.id);
+    size = data.position();
+    count++;
+  });
+
+  OpdsValidators received;
+  {
+    OpdsParserStream stream{parser};
+    fetchResult = fetch(pageUrl, sent, received, stream);
+  }
+
+  if (fetchResult == OpdsFetchResult::OK && !parser) {
+    LOG_ERR("OPDS", "Failed to parse %s", pageUrl.c_str());
+  }
+  if (fetchResult != OpdsFetchResult::OK || !parser || writeFailed) {
+    data.close();
+    index.close();
+    if (opened && !append) {
+      removeFiles();
+    }
+    if (fetchResult == OpdsFetchResult::NOT_MODIFIED) {
+      return Result::OK;
+    }
+    return fetchResult == OpdsFetchResult::OK ? Result::PARSE_FAILED : Result::FETCH_FAILED;
+  }
+
+  if (!opened && !openFiles()) {
+    // Feed without entries, still gets empty files
+    writeFailed = true;
+  }
+  data.close();
+  index.close();
+  if (writeFailed) {
+    removeFiles();
+    return Result::PARSE_FAILED;
+  }
+
+  entryCount = count;
+  dataSize = size;
+  nextHref = parser.getNextHref() == pageUrl ? "" : parser.getNextHref();
+  if (!append) {
+    validators = received;
+  }
+  saveMeta();
+  return Result::OK;
+}
+
+OpdsFeedCache::Result OpdsFeedCache::open(const std::string& feedUrl, const bool revalidate, const Fetcher& fetch) {
+  url = feedUrl;
+  basePath = cacheDir + "/" + hashUrl(url);
+  const bool cached = loadMeta();
+  if (!cached) {
+    validators = OpdsValidators{};
+    nextHref.clear();
+    entryCount = 0;
+    dataSize = 0;
+  } else if (!revalidate) {
+    LOG_DBG("OPDS", "Using cached feed (%u entries): %s", entryCount, url.c_str());
+    return Result::OK;
+  }
+
+  Storage.mkdir(cacheDir.c_str());
+  OpdsFetchResult fetchResult;
+  const Result result = fetchPage(url, validators, false, fetch, fetchResult);
+  if (fetchResult == OpdsFetchResult::NOT_MODIFIED) {
+    LOG_DBG("OPDS", "Feed not modified (%u entries): %s", entryCount, url.c_str());
+    return cached ? Result::OK : Result::FETCH_FAILED;
+  }
+  if (result == Result::FETCH_FAILED && cached && loadMeta()) {
+    LOG_INF("OPDS", "Fetch failed, using cached feed: %s", url.c_str());
+    return Result::OK;
+  }
+  if (result != Result::OK) {
+    entryCount = 0;
+    dataSize = 0;
+    nextHref.clear();
+  }
+  return result;
+}
+
+OpdsFeedCache::Result OpdsFeedCache::loadMore(const Fetcher& fetch) {
+  if (nextHref.empty()) {
+    return Result::OK;
+  }
+  const std::string pageUrl = nextHref;
+  OpdsFetchResult fetchResult;
+  const Result result = fetchPage(pageUrl, OpdsValidators{}, true, fetch, fetchResult);
+  LOG_DBG("OPDS", "Feed has %u entries after %s", entryCount, pageUrl.c_str());
+  return result;
+}
+
+bool OpdsFeedCache::readEntries(const size_t first, size_t count, std::vector<OpdsEntry>& out) const {
+  out.clear();
+  if (first >= entryCount) {
+    return first == entryCount;
+  }
+  count = std::min<size_t>(count, entryCount - first);
+
+  FsFile index;
+  if (!Storage.openFileForRead("OPDS", basePath + ".idx", index)) {
+    return false;
+  }
+  uint32_t offset = 0;
+  const bool seeked = index.seek(first * sizeof(uint32_t));
+  serialization::readPod(index, offset);
+  index.close();
+  if (!seeked || offset >= dataSize) {
+    LOG_ERR("OPDS", "Feed cache index is corrupt");
+    return false;
+  }
+
+  // Records of consecutive entries are contiguous, only the first offset is needed
+  FsFile data;
+  if (!Storage.openFileForRead("OPDS", basePath + ".dat", data)) {
+    return false;
+  }
+  data.seek(offset);
+  out.reserve(count);
+  for (size_t i = 0; i < count && data.position() < dataSize; i++) {
+    uint8_t type;
+    OpdsEntry entry;
+    serialization::readPod(data, type);
+    entry.type = type == static_cast<uint8_t>(OpdsEntryType::BOOK) ? OpdsEntryType::BOOK : OpdsEntryType::NAVIGATION;
+    serialization::readString(data, entry.title);
+    serialization::readString(data, entry.author);
+    serialization::readString(data, entry.href);
+    serialization::readString(data, entry.id);
+    out.push_back(std::move(entry));
+  }
+  data.close();
+  return out.size() == count;
+}
+
+void OpdsFeedCache::trim(const std::string& cacheDir, const size_t maxFeeds) {
+  auto dir = Storage.open(cacheDir.c_str());
+  if (!dir || !dir.isDirectory()) {
+    if (dir) dir.close();
+    return;
+  }
+
+  size_t feeds = 0;
+  char name[64];
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    file.getName(name, sizeof(name));
+    const size_t len = strlen(name);
+    if (len > 5 && strcmp(name + len - 5, ".meta") == 0) {
+      feeds++;
+    }
+    file.close();
+  }
+  dir.close();
+
+  if (feeds > maxFeeds) {
+    LOG_DBG("OPDS", "Dropping feed cache (%u feeds)", static_cast<unsigned>(feeds));
+    Storage.removeDir(cacheDir.c_str());
+  }
+}
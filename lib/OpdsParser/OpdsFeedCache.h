@@ -0,0 +1,102 @@
+#pragma once
+#include <Stream.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "OpdsParser.h"
+
+enum class OpdsFetchResult {
+  OK,            // Body was written to the stream
+  NOT_MODIFIED,  // Server answered 304, the cached copy is current
+  FAILED
+};
+
+/**
+ * HTTP cache validators of a feed response.
+ */
+struct OpdsValidators {
+  std::string etag;
+  std::string lastModified;
+
+  bool empty() const { return etag.empty() && lastModified.empty(); }
+};
+
+/**
+ * Parsed OPDS feeds kept on the SD card, so browsing a large catalog never holds more than one screen of entries in
+ * RAM and going back a level does not touch the network.
+ *
+ * Each feed is stored under <cacheDir>/<url hash> as three files:
+ * - .meta: url, ETag/Last-Modified of the first page, href of the next page not fetched yet, entry count
+ * - .dat:  the entries, one record each
+ * - .idx:  u32 offset of every record in .dat
+ *
+ * Pages of a paginated feed (rel="next") are only fetched when loadMore() is called and are appended to the same
+ * store. Reopening a cached feed with revalidate sends the stored validators; a 304 keeps the store as it is.
+ *
+ * Usage:
+ *   OpdsFeedCache feed;
+ *   if (feed.open(url, true, fetcher) == OpdsFeedCache::Result::OK) {
+ *     std::vector<OpdsEntry> page;
+ *     feed.readEntries(0, 20, page);
+ *   }
+ */
+class OpdsFeedCache {
+ public:
+  /**
+   * Fetch url and stream the body into body. validators are those of the cached copy (empty when there is none or
+   * for continuation pages); on OK, received is set from the response headers.
+   */
+  using Fetcher = std::function<OpdsFetchResult(const std::string& url, const OpdsValidators& validators,
+                                                OpdsValidators& received, Stream& body)>;
+
+  enum class Result { OK, FETCH_FAILED, PARSE_FAILED };
+
+  static constexpr char DEFAULT_CACHE_DIR[] = "/.crosspoint/opds";
+  // More feeds than this and the whole cache directory is dropped by trim()
+  static constexpr size_t MAX_CACHED_FEEDS = 32;
+
+  explicit OpdsFeedCache(std::string cacheDir = DEFAULT_CACHE_DIR) : cacheDir(std::move(cacheDir)) {}
+
+  /**
+   * Make url the current feed. A cached copy is used as is unless revalidate is set, in which case the first page is
+   * fetched conditionally. If the fetch fails but a cached copy exists, the cached copy is used.
+   */
+  Result open(const std::string& url, bool revalidate, const Fetcher& fetch);
+
+  /**
+   * Fetch the next page of the current feed and append its entries. Does nothing if hasMore() is false.
+   */
+  Result loadMore(const Fetcher& fetch);
+
+  /**
+   * Read up to count entries starting at first into out (cleared first).
+   */
+  bool readEntries(size_t first, size_t count, std::vector<OpdsEntry>& out) const;
+
+  size_t getEntryCount() const { return entryCount; }
+  bool hasMore() const { return !nextHref.empty(); }
+  const std::string& getUrl() const { return url; }
+
+  /**
+   * Remove the cache directory if it holds more than maxFeeds feeds.
+   */
+  static void trim(const std::string& cacheDir = DEFAULT_CACHE_DIR, size_t maxFeeds = MAX_CACHED_FEEDS);
+
+ private:
+  std::string cacheDir;
+  std::string basePath;
+  std::string url;
+  OpdsValidators validators;
+  std::string nextHref;
+  uint32_t entryCount = 0;
+  uint32_t dataSize = 0;
+
+  bool loadMeta();
+  bool saveMeta() const;
+  void removeFiles() const;
+  Result fetchPage(const std::string& pageUrl, const OpdsValidators& sent, bool append, const Fetcher& fetch,
+                   OpdsFetchResult& fetchResult);
+};
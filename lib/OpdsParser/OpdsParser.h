@@ -2,6 +2,7 @@
 #include <Print.h>
 #include <expat.h>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,8 @@ using OpdsBook = OpdsEntry;
  */
 class OpdsParser final : public Print {
  public:
+  using EntryCallback = std::function<void(const OpdsEntry&)>;
+
   OpdsParser();
   ~OpdsParser();
 
@@ -74,6 +77,17 @@ class OpdsParser final : public Print {
    */
   std::vector<OpdsEntry> getBooks() const;
 
+  /**
+   * Hand every complete entry to callback instead of collecting it, so a large feed can be spilled to SD as it
+   * streams in. getEntries() stays empty while a callback is set.
+   */
+  void setEntryCallback(EntryCallback callback) { entryCallback = std::move(callback); }
+
+  /**
+   * Get the href of the feed's rel="next" link (the following page of a paginated feed), empty if there is none.
+   */
+  const std::string& getNextHref() const { return nextHref; }
+
   /**
    * Clear all parsed entries.
    */
@@ -90,6 +104,8 @@ class OpdsParser final : public Print {
 
   XML_Parser parser = nullptr;
   std::vector<OpdsEntry> entries;
+  EntryCallback entryCallback;
+  std::string nextHref;
   OpdsEntry currentEntry;
   std::string currentText;
 
@@ -0,0 +1,119 @@
+#include "PackBits.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace PackBits {
+
+void Writer::put(const uint8_t* data, const size_t len) {
+  if (used + len > sizeof(buffer)) {
+    flush();
+  }
+  memcpy(buffer + used, data, len);
+  used += len;
+}
+
+void Writer::encode(const uint8_t* data, const size_t size) {
+  size_t i = 0;
+  while (i < size) {
+    size_t run = 1;
+    while (i + run < size && run < 128 && data[i + run] == data[i]) {
+      run++;
+    }
+    if (run >= 3) {
+      const uint8_t packet[2] = {static_cast<uint8_t>(257 - run), data[i]};
+      put(packet, 2);
+      i += run;
+      continue;
+    }
+
+    // Literal packet up to the next run of three
+    size_t len = 0;
+    while (i + len < size && len < 128) {
+      if (i + len + 2 < size && data[i + len] == data[i + len + 1] && data[i + len] == data[i + len + 2]) {
+        break;
+      }
+      len++;
+    }
+    const auto header = static_cast<uint8_t>(len - 1);
+    put(&header, 1);
+    put(data + i, len);
+    i += len;
+  }
+}
+
+uint32_t Writer::flush() {
+  if (used > 0) {
+    file.write(buffer, used);
+    written += used;
+    used = 0;
+  }
+  return written;
+}
+
+size_t Decoder::decode(const uint8_t*& in, const uint8_t* inEnd, uint8_t* out, const size_t outSize) {
+  size_t written = 0;
+  while (written < outSize) {
+    if (literal > 0) {
+      const size_t n = std::min({static_cast<size_t>(literal), outSize - written, static_cast<size_t>(inEnd - in)});
+      if (n == 0) {
+        break;
+      }
+      memcpy(out + written, in, n);
+      in += n;
+      written += n;
+      literal -= n;
+    } else if (repeat > 0) {
+      if (!hasValue) {
+        if (in == inEnd) {
+          break;
+        }
+        value = *in++;
+        hasValue = true;
+      }
+      const size_t n = std::min(static_cast<size_t>(repeat), outSize - written);
+      memset(out + written, value, n);
+      written += n;
+      repeat -= n;
+      hasValue = repeat > 0;
+    } else {
+      if (in == inEnd) {
+        break;
+      }
+      const uint8_t header = *in++;
+      if (header < 128) {
+        literal = header + 1;
+      } else if (header > 128) {
+        repeat = 257 - header;
+      }
+    }
+  }
+  return written;
+}
+
+bool decode(FsFile& file, uint32_t compressedSize, uint8_t* out, const size_t outSize) {
+  Decoder decoder;
+  uint8_t buffer[512];
+  const uint8_t* cursor = buffer;
+  const uint8_t* end = buffer;
+  size_t o = 0;
+  while (o < outSize) {
+    if (cursor == end) {
+      if (compressedSize == 0) {
+        return false;
+      }
+      const size_t available = file.read(buffer, std::min<size_t>(sizeof(buffer), compressedSize));
+      if (available == 0) {
+        return false;
+      }
+      compressedSize -= available;
+      cursor = buffer;
+      end = buffer + available;
+    }
+    o += decoder.decode(cursor, end, out + o, outSize - o);
+  }
+  // A packet running past the end of out means the data was for a larger buffer
+  return decoder.atPacketBoundary();
+}
+
+}  // namespace PackBits
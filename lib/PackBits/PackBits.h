@@ -0,0 +1,65 @@
+#pragma once
+
+#include <HalStorage.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PackBits {
+
+/**
+ * Buffered PackBits encoder writing to a file: a header n < 128 is followed by n + 1 literal bytes, n > 128 by one
+ * byte repeated 257 - n times. Needs no state beyond its write buffer, so frame buffers can be saved at any time.
+ */
+class Writer {
+ public:
+  explicit Writer(FsFile& file) : file(file) {}
+
+  void encode(const uint8_t* data, size_t size);
+
+  /**
+   * Write out what is still buffered.
+   * @return Bytes written to the file so far
+   */
+  uint32_t flush();
+
+ private:
+  static constexpr size_t BUFFER_SIZE = 512;
+
+  FsFile& file;
+  uint8_t buffer[BUFFER_SIZE];
+  size_t used = 0;
+  uint32_t written = 0;
+
+  void put(const uint8_t* data, size_t len);
+};
+
+/**
+ * Incremental decoder. It keeps its state between calls, so packets may cross the boundaries of both the input and
+ * the output buffer, which lets callers decode through small fixed buffers.
+ */
+class Decoder {
+ public:
+  /**
+   * Decode from in until either in reaches inEnd or outSize bytes are written. in is advanced past what was consumed.
+   * @return Bytes written to out
+   */
+  size_t decode(const uint8_t*& in, const uint8_t* inEnd, uint8_t* out, size_t outSize);
+
+  // True between packets, false while a literal or repeat packet still has bytes to produce
+  bool atPacketBoundary() const { return literal == 0 && repeat == 0; }
+
+ private:
+  uint8_t literal = 0;  // literal bytes still to copy
+  uint8_t repeat = 0;   // repetitions of value still to write
+  uint8_t value = 0;
+  bool hasValue = false;
+};
+
+/**
+ * Decode compressedSize bytes from the current position of file into out.
+ * @return false if the data ends early or does not fill exactly outSize bytes
+ */
+bool decode(FsFile& file, uint32_t compressedSize, uint8_t* out, size_t outSize);
+
+}  // namespace PackBits
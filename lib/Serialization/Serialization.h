@@ -49,4 +49,41 @@ static void readString(FsFile& file, std::string& s) {
   s.resize(len);
   file.read(&s[0], len);
 }
+
+// LEB128-style unsigned varint: 7 bits per byte, high bit set on all but the last byte
+static void writeVarUint(FsFile& file, uint32_t value) {
+  uint8_t buf[5];
+  size_t n = 0;
+  while (value >= 0x80) {
+    buf[n++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  buf[n++] = static_cast<uint8_t>(value);
+  file.write(buf, n);
+}
+
+static uint32_t readVarUint(FsFile& file) {
+  uint32_t value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    const int b = file.read();
+    if (b < 0) {
+      break;
+    }
+    value |= static_cast<uint32_t>(b & 0x7F) << shift;
+    if ((b & 0x80) == 0) {
+      break;
+    }
+  }
+  return value;
+}
+
+// Signed values are zigzag mapped first so small negative numbers stay short
+static void writeVarInt(FsFile& file, const int32_t value) {
+  writeVarUint(file, (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+}
+
+static int32_t readVarInt(FsFile& file) {
+  const uint32_t raw = readVarUint(file);
+  return static_cast<int32_t>(raw >> 1) ^ -static_cast<int32_t>(raw & 1);
+}
 }  // namespace serialization
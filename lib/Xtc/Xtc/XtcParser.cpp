@@ -10,13 +10,23 @@
 #include <FsHelpers.h>
 #include <HalStorage.h>
 #include <Logging.h>
+#include <PackBits.h>
+#include <miniz.h>
 
+#include <algorithm>
 #include <cstring>
 
 namespace xtc {
 
+namespace {
+// Compressed payloads are read from the file in pieces of this size
+constexpr size_t PAYLOAD_READ_SIZE = 512;
+}  // namespace
+
 XtcParser::XtcParser()
     : m_isOpen(false),
+      m_pageWindowStart(0),
+      m_pageWindowCount(0),
       m_defaultWidth(DISPLAY_WIDTH),
       m_defaultHeight(DISPLAY_HEIGHT),
       m_bitDepth(1),
@@ -89,7 +99,8 @@ void XtcParser::close() {
     m_file.close();
     m_isOpen = false;
   }
-  m_pageTable.clear();
+  m_pageWindowStart = 0;
+  m_pageWindowCount = 0;
   m_chapters.clear();
   m_title.clear();
   m_hasChapters = false;
@@ -169,38 +180,60 @@ XtcError XtcParser::readPageTable() {
     return XtcError::CORRUPTED_HEADER;
   }
 
-  // Seek to page table
-  if (!m_file.seek(m_header.pageTableOffset)) {
-    LOG_DBG("XTC", "Failed to seek to page table at %llu", m_header.pageTableOffset);
+  // Entries are read on demand, only check that the whole table is there
+  const uint64_t tableSize = static_cast<uint64_t>(m_header.pageCount) * sizeof(PageTableEntry);
+  if (m_header.pageTableOffset + tableSize > m_file.size()) {
+    LOG_DBG("XTC", "Page table at %llu runs past end of file", m_header.pageTableOffset);
+    return XtcError::CORRUPTED_HEADER;
+  }
+
+  m_pageWindowCount = 0;
+  if (!loadPageWindow(0)) {
     return XtcError::READ_ERROR;
   }
 
-  m_pageTable.resize(m_header.pageCount);
+  // Default dimensions come from the first page
+  m_defaultWidth = m_pageWindow[0].width;
+  m_defaultHeight = m_pageWindow[0].height;
 
-  // Read page table entries
-  for (uint16_t i = 0; i < m_header.pageCount; i++) {
-    PageTableEntry entry;
-    size_t bytesRead = m_file.read(reinterpret_cast<uint8_t*>(&entry), sizeof(PageTableEntry));
-    if (bytesRead != sizeof(PageTableEntry)) {
-      LOG_DBG("XTC", "Failed to read page table entry %u", i);
-      return XtcError::READ_ERROR;
-    }
+  LOG_DBG("XTC", "Page table has %u entries", m_header.pageCount);
+  return XtcError::OK;
+}
+
+bool XtcParser::loadPageWindow(const uint32_t pageIndex) {
+  if (pageIndex >= m_pageWindowStart && pageIndex < m_pageWindowStart + m_pageWindowCount) {
+    return true;
+  }
 
-    m_pageTable[i].offset = static_cast<uint32_t>(entry.dataOffset);
-    m_pageTable[i].size = entry.dataSize;
-    m_pageTable[i].width = entry.width;
-    m_pageTable[i].height = entry.height;
-    m_pageTable[i].bitDepth = m_bitDepth;
+  // Start a quarter window before the requested page so turning back a few pages stays in the window too
+  const uint32_t start = pageIndex > PAGE_WINDOW_SIZE / 4 ? pageIndex - PAGE_WINDOW_SIZE / 4 : 0;
+  const uint16_t count = static_cast<uint16_t>(std::min<uint32_t>(PAGE_WINDOW_SIZE, m_header.pageCount - start));
+  m_pageWindowCount = 0;
 
-    // Update default dimensions from first page
-    if (i == 0) {
-      m_defaultWidth = entry.width;
-      m_defaultHeight = entry.height;
-    }
+  if (!m_file.seek(m_header.pageTableOffset + static_cast<uint64_t>(start) * sizeof(PageTableEntry))) {
+    LOG_DBG("XTC", "Failed to seek to page table entry %u", static_cast<unsigned>(start));
+    return false;
   }
 
-  LOG_DBG("XTC", "Read %u page table entries", m_header.pageCount);
-  return XtcError::OK;
+  PageTableEntry entries[PAGE_WINDOW_SIZE];
+  const int bytes = static_cast<int>(count * sizeof(PageTableEntry));
+  if (m_file.read(reinterpret_cast<uint8_t*>(entries), bytes) != bytes) {
+    LOG_DBG("XTC", "Failed to read page table entries %u-%u", static_cast<unsigned>(start),
+            static_cast<unsigned>(start + count - 1));
+    return false;
+  }
+
+  for (uint16_t i = 0; i < count; i++) {
+    m_pageWindow[i].offset = static_cast<uint32_t>(entries[i].dataOffset);
+    m_pageWindow[i].size = entries[i].dataSize;
+    m_pageWindow[i].width = entries[i].width;
+    m_pageWindow[i].height = entries[i].height;
+    m_pageWindow[i].bitDepth = m_bitDepth;
+    m_pageWindow[i].padding = 0;
+  }
+  m_pageWindowStart = start;
+  m_pageWindowCount = count;
+  return true;
 }
 
 XtcError XtcParser::readChapters() {
@@ -309,11 +342,11 @@ XtcError XtcParser::readChapters() {
   return XtcError::OK;
 }
 
-bool XtcParser::getPageInfo(uint32_t pageIndex, PageInfo& info) const {
-  if (pageIndex >= m_pageTable.size()) {
+bool XtcParser::getPageInfo(uint32_t pageIndex, PageInfo& info) {
+  if (!m_isOpen || pageIndex >= m_header.pageCount || !loadPageWindow(pageIndex)) {
     return false;
   }
-  info = m_pageTable[pageIndex];
+  info = m_pageWindow[pageIndex - m_pageWindowStart];
   return true;
 }
 
@@ -328,44 +361,13 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
     return 0;
   }
 
-  const PageInfo& page = m_pageTable[pageIndex];
-
-  // Seek to page data
-  if (!m_file.seek(page.offset)) {
-    LOG_DBG("XTC", "Failed to seek to page %u at offset %lu", pageIndex, page.offset);
-    m_lastError = XtcError::READ_ERROR;
-    return 0;
-  }
-
-  // Read page header (XTG for 1-bit, XTH for 2-bit - same structure)
   XtgPageHeader pageHeader;
-  size_t headerRead = m_file.read(reinterpret_cast<uint8_t*>(&pageHeader), sizeof(XtgPageHeader));
-  if (headerRead != sizeof(XtgPageHeader)) {
-    LOG_DBG("XTC", "Failed to read page header for page %u", pageIndex);
-    m_lastError = XtcError::READ_ERROR;
-    return 0;
-  }
-
-  // Verify page magic (XTG for 1-bit, XTH for 2-bit)
-  const uint32_t expectedMagic = (m_bitDepth == 2) ? XTH_MAGIC : XTG_MAGIC;
-  if (pageHeader.magic != expectedMagic) {
-    LOG_DBG("XTC", "Invalid page magic for page %u: 0x%08X (expected 0x%08X)", pageIndex, pageHeader.magic,
-            expectedMagic);
-    m_lastError = XtcError::INVALID_MAGIC;
+  size_t bitmapSize = 0;
+  m_lastError = readPageHeader(pageIndex, pageHeader, bitmapSize);
+  if (m_lastError != XtcError::OK) {
     return 0;
   }
 
-  // Calculate bitmap size based on bit depth
-  // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
-  // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
-  size_t bitmapSize;
-  if (m_bitDepth == 2) {
-    // XTH: two bit planes, each containing (width * height) bits rounded up to bytes
-    bitmapSize = ((static_cast<size_t>(pageHeader.width) * pageHeader.height + 7) / 8) * 2;
-  } else {
-    bitmapSize = ((pageHeader.width + 7) / 8) * pageHeader.height;
-  }
-
   // Check buffer size
   if (bufferSize < bitmapSize) {
     LOG_DBG("XTC", "Buffer too small: need %u, have %u", bitmapSize, bufferSize);
@@ -373,16 +375,13 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
     return 0;
   }
 
-  // Read bitmap data
-  size_t bytesRead = m_file.read(buffer, bitmapSize);
-  if (bytesRead != bitmapSize) {
-    LOG_DBG("XTC", "Page read error: expected %u, got %u", bitmapSize, bytesRead);
-    m_lastError = XtcError::READ_ERROR;
+  // Compressed pages are decoded straight into the caller's buffer
+  m_lastError = readBitmap(pageHeader, bitmapSize, buffer, bitmapSize, nullptr);
+  if (m_lastError != XtcError::OK) {
+    LOG_DBG("XTC", "Failed to read bitmap of page %u: %s", pageIndex, errorToString(m_lastError));
     return 0;
   }
-
-  m_lastError = XtcError::OK;
-  return bytesRead;
+  return bitmapSize;
 }
 
 XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
@@ -396,48 +395,187 @@ XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
     return XtcError::PAGE_OUT_OF_RANGE;
   }
 
-  const PageInfo& page = m_pageTable[pageIndex];
+  XtgPageHeader pageHeader;
+  size_t bitmapSize = 0;
+  const XtcError err = readPageHeader(pageIndex, pageHeader, bitmapSize);
+  if (err != XtcError::OK) {
+    return err;
+  }
+
+  // Read in chunks
+  std::vector<uint8_t> chunk(chunkSize);
+  return readBitmap(pageHeader, bitmapSize, chunk.data(), chunkSize, &callback);
+}
+
+XtcError XtcParser::readPageHeader(const uint32_t pageIndex, XtgPageHeader& pageHeader, size_t& bitmapSize) {
+  PageInfo page;
+  if (!getPageInfo(pageIndex, page)) {
+    return XtcError::READ_ERROR;
+  }
 
   // Seek to page data
   if (!m_file.seek(page.offset)) {
+    LOG_DBG("XTC", "Failed to seek to page %u at offset %lu", pageIndex, page.offset);
     return XtcError::READ_ERROR;
   }
 
-  // Read and skip page header (XTG for 1-bit, XTH for 2-bit)
-  XtgPageHeader pageHeader;
+  // Read page header (XTG for 1-bit, XTH for 2-bit - same structure)
   size_t headerRead = m_file.read(reinterpret_cast<uint8_t*>(&pageHeader), sizeof(XtgPageHeader));
-  const uint32_t expectedMagic = (m_bitDepth == 2) ? XTH_MAGIC : XTG_MAGIC;
-  if (headerRead != sizeof(XtgPageHeader) || pageHeader.magic != expectedMagic) {
+  if (headerRead != sizeof(XtgPageHeader)) {
+    LOG_DBG("XTC", "Failed to read page header for page %u", pageIndex);
     return XtcError::READ_ERROR;
   }
 
+  // Verify page magic (XTG for 1-bit, XTH for 2-bit)
+  const uint32_t expectedMagic = (m_bitDepth == 2) ? XTH_MAGIC : XTG_MAGIC;
+  if (pageHeader.magic != expectedMagic) {
+    LOG_DBG("XTC", "Invalid page magic for page %u: 0x%08X (expected 0x%08X)", pageIndex, pageHeader.magic,
+            expectedMagic);
+    return XtcError::INVALID_MAGIC;
+  }
+
+  if (pageHeader.compression > XTG_COMPRESSION_DEFLATE) {
+    LOG_DBG("XTC", "Unsupported compression %u on page %u", pageHeader.compression, pageIndex);
+    return XtcError::DECOMPRESSION_ERROR;
+  }
+
   // Calculate bitmap size based on bit depth
   // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
-  // XTH (2-bit): Two bit planes, ((width * height + 7) / 8) * 2 bytes
-  size_t bitmapSize;
+  // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
   if (m_bitDepth == 2) {
+    // XTH: two bit planes, each containing (width * height) bits rounded up to bytes
     bitmapSize = ((static_cast<size_t>(pageHeader.width) * pageHeader.height + 7) / 8) * 2;
   } else {
     bitmapSize = ((pageHeader.width + 7) / 8) * pageHeader.height;
   }
+  return XtcError::OK;
+}
 
-  // Read in chunks
-  std::vector<uint8_t> chunk(chunkSize);
-  size_t totalRead = 0;
+XtcError XtcParser::readBitmap(const XtgPageHeader& pageHeader, const size_t bitmapSize, uint8_t* out,
+                               const size_t outSize, const PageDataCallback* callback) {
+  if (pageHeader.compression == XTG_COMPRESSION_DEFLATE) {
+    return inflateBitmap(pageHeader.dataSize, bitmapSize, out, outSize, callback);
+  }
+
+  PackBits::Decoder packBits;
+  uint8_t input[PAYLOAD_READ_SIZE];
+  const uint8_t* inputCursor = input;
+  const uint8_t* inputEnd = input;
+  size_t payloadRemaining = pageHeader.dataSize;
+  size_t produced = 0;
+  size_t filled = 0;
+
+  while (produced < bitmapSize) {
+    const size_t space = std::min(outSize - filled, bitmapSize - produced);
+    size_t written;
+    if (pageHeader.compression == XTG_COMPRESSION_NONE) {
+      const int bytesRead = m_file.read(out + filled, space);
+      written = bytesRead > 0 ? bytesRead : 0;
+      if (written == 0) {
+        return XtcError::READ_ERROR;
+      }
+    } else {
+      if (inputCursor == inputEnd && payloadRemaining > 0) {
+        const int bytesRead = m_file.read(input, std::min(sizeof(input), payloadRemaining));
+        if (bytesRead <= 0) {
+          return XtcError::READ_ERROR;
+        }
+        inputCursor = input;
+        inputEnd = input + bytesRead;
+        payloadRemaining -= bytesRead;
+      }
+      written = packBits.decode(inputCursor, inputEnd, out + filled, space);
+      if (written == 0 && inputCursor == inputEnd && payloadRemaining == 0) {
+        // Payload ended before the bitmap did
+        return XtcError::DECOMPRESSION_ERROR;
+      }
+    }
+
+    filled += written;
+    produced += written;
+    if (callback && (filled == outSize || produced == bitmapSize)) {
+      (*callback)(out, filled, produced - filled);
+      filled = 0;
+    }
+  }
+  return XtcError::OK;
+}
 
-  while (totalRead < bitmapSize) {
-    size_t toRead = std::min(chunkSize, bitmapSize - totalRead);
-    size_t bytesRead = m_file.read(chunk.data(), toRead);
+XtcError XtcParser::inflateBitmap(const size_t payloadSize, const size_t bitmapSize, uint8_t* out,
+                                  const size_t outSize, const PageDataCallback* callback) {
+  const auto inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+  // Streaming needs the full LZ window to wrap around in, loadPage() inflates in place
+  uint8_t* dict = callback ? static_cast<uint8_t*>(malloc(TINFL_LZ_DICT_SIZE)) : nullptr;
+  if (!inflator || (callback && !dict)) {
+    LOG_ERR("XTC", "Failed to allocate memory for inflator");
+    free(inflator);
+    free(dict);
+    return XtcError::MEMORY_ERROR;
+  }
+  tinfl_init(inflator);
+
+  uint8_t input[PAYLOAD_READ_SIZE];
+  size_t inputCursor = 0;
+  size_t inputFilled = 0;
+  size_t payloadRemaining = payloadSize;
+  size_t produced = 0;
+  size_t dictCursor = 0;
+  XtcError result = XtcError::OK;
+
+  while (true) {
+    if (inputCursor == inputFilled && payloadRemaining > 0) {
+      const int bytesRead = m_file.read(input, std::min(sizeof(input), payloadRemaining));
+      if (bytesRead <= 0) {
+        result = XtcError::READ_ERROR;
+        break;
+      }
+      inputCursor = 0;
+      inputFilled = bytesRead;
+      payloadRemaining -= bytesRead;
+    }
 
-    if (bytesRead == 0) {
-      return XtcError::READ_ERROR;
+    size_t inBytes = inputFilled - inputCursor;
+    uint8_t* outStart = dict ? dict : out;
+    uint8_t* outNext = dict ? dict + dictCursor : out + produced;
+    size_t outBytes = dict ? TINFL_LZ_DICT_SIZE - dictCursor : bitmapSize - produced;
+    const tinfl_status status =
+        tinfl_decompress(inflator, input + inputCursor, &inBytes, outStart, outNext, &outBytes,
+                         (payloadRemaining > 0 ? TINFL_FLAG_HAS_MORE_INPUT : 0) |
+                             (dict ? 0 : TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF));
+    inputCursor += inBytes;
+
+    if (produced + outBytes > bitmapSize) {
+      result = XtcError::DECOMPRESSION_ERROR;
+      break;
     }
+    if (dict) {
+      // Hand the new part of the window over in pieces of at most outSize
+      for (size_t sent = 0; sent < outBytes;) {
+        const size_t piece = std::min(outSize, outBytes - sent);
+        (*callback)(dict + dictCursor + sent, piece, produced + sent);
+        sent += piece;
+      }
+      dictCursor = (dictCursor + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+    }
+    produced += outBytes;
 
-    callback(chunk.data(), bytesRead, totalRead);
-    totalRead += bytesRead;
+    if (status == TINFL_STATUS_DONE) {
+      result = produced == bitmapSize ? XtcError::OK : XtcError::DECOMPRESSION_ERROR;
+      break;
+    }
+    // Also stop on a stream that wants more input than the payload has, or more room than the bitmap
+    const bool inputExhausted = payloadRemaining == 0 && inputCursor == inputFilled;
+    if (status < 0 || (status == TINFL_STATUS_NEEDS_MORE_INPUT && inputExhausted) ||
+        (status == TINFL_STATUS_HAS_MORE_OUTPUT && produced == bitmapSize)) {
+      LOG_DBG("XTC", "tinfl_decompress() failed with status %d", status);
+      result = XtcError::DECOMPRESSION_ERROR;
+      break;
+    }
   }
 
-  return XtcError::OK;
+  free(inflator);
+  free(dict);
+  return result;
 }
 
 bool XtcParser::isValidXtcFile(const char* filepath) {
@@ -41,11 +41,12 @@ class XtcParser {
   uint16_t getHeight() const { return m_defaultHeight; }
   uint8_t getBitDepth() const { return m_bitDepth; }  // 1 = XTC/XTG, 2 = XTCH/XTH
 
-  // Page information
-  bool getPageInfo(uint32_t pageIndex, PageInfo& info) const;
+  // Page information, read through the page table window
+  bool getPageInfo(uint32_t pageIndex, PageInfo& info);
 
   /**
-   * Load page bitmap (raw 1-bit data, skipping XTG header)
+   * Load page bitmap (raw 1-bit data, skipping XTG header). PackBits and deflate compressed pages are decoded
+   * directly into buffer.
    *
    * @param pageIndex Page index (0-based)
    * @param buffer Output buffer (caller allocated)
@@ -56,7 +57,8 @@ class XtcParser {
 
   /**
    * Streaming page load
-   * Memory-efficient method that reads page data in chunks.
+   * Memory-efficient method that reads page data in chunks. Deflate compressed pages need a 32KB window for this,
+   * loadPage() does without.
    *
    * @param pageIndex Page index
    * @param callback Callback function to receive data chunks
@@ -81,10 +83,16 @@ class XtcParser {
   XtcError getLastError() const { return m_lastError; }
 
  private:
+  // Page table entries kept in RAM around the last page looked up. The table itself stays on the SD card, so opening
+  // a book costs the same whatever its page count.
+  static constexpr uint16_t PAGE_WINDOW_SIZE = 64;
+
   FsFile m_file;
   bool m_isOpen;
   XtcHeader m_header;
-  std::vector<PageInfo> m_pageTable;
+  PageInfo m_pageWindow[PAGE_WINDOW_SIZE];
+  uint32_t m_pageWindowStart;
+  uint16_t m_pageWindowCount;
   std::vector<ChapterInfo> m_chapters;
   std::string m_title;
   std::string m_author;
@@ -97,6 +105,17 @@ class XtcParser {
   // Internal helper functions
   XtcError readHeader();
   XtcError readPageTable();
+  bool loadPageWindow(uint32_t pageIndex);
+
+  using PageDataCallback = std::function<void(const uint8_t* data, size_t size, size_t offset)>;
+  // Seeks to a page, checks its header and leaves the file at the start of its payload
+  XtcError readPageHeader(uint32_t pageIndex, XtgPageHeader& pageHeader, size_t& bitmapSize);
+  // Reads and decodes the payload of a page. Without a callback the whole bitmap is written to out, with one out is a
+  // chunk buffer of outSize bytes that is passed to the callback whenever it fills up.
+  XtcError readBitmap(const XtgPageHeader& pageHeader, size_t bitmapSize, uint8_t* out, size_t outSize,
+                      const PageDataCallback* callback);
+  XtcError inflateBitmap(size_t payloadSize, size_t bitmapSize, uint8_t* out, size_t outSize,
+                         const PageDataCallback* callback);
   XtcError readTitle();
   XtcError readAuthor();
   XtcError readChapters();
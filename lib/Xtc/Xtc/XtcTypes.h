@@ -70,8 +70,8 @@ struct XtgPageHeader {
   uint16_t width;       // 0x04: Image width (pixels)
   uint16_t height;      // 0x06: Image height (pixels)
   uint8_t colorMode;    // 0x08: Color mode (0=monochrome)
-  uint8_t compression;  // 0x09: Compression (0=uncompressed)
-  uint32_t dataSize;    // 0x0A: Image data size (bytes)
+  uint8_t compression;  // 0x09: Compression (XTG_COMPRESSION_*)
+  uint32_t dataSize;    // 0x0A: Image data size (bytes), as stored in the file when compressed
   uint64_t md5;         // 0x0E: MD5 checksum (first 8 bytes, optional)
   // Followed by bitmap data at offset 0x16 (22)
   //
@@ -86,6 +86,13 @@ struct XtgPageHeader {
 };
 #pragma pack(pop)
 
+// XtgPageHeader::compression values. The decoded bitmap layout is the same for all of them.
+constexpr uint8_t XTG_COMPRESSION_NONE = 0;
+// PackBits: header byte n < 128 is followed by n + 1 literal bytes, n > 128 by one byte repeated 257 - n times
+constexpr uint8_t XTG_COMPRESSION_PACKBITS = 1;
+// Raw deflate stream (no zlib header), as in ZIP entries
+constexpr uint8_t XTG_COMPRESSION_DEFLATE = 2;
+
 // Page information (internal use, optimized for memory)
 struct PageInfo {
   uint32_t offset;   // File offset to page data (max 4GB file size)
@@ -1,18 +1,36 @@
 #include <HalDisplay.h>
 #include <HalGPIO.h>
+#include <HalSpiBus.h>
 
 #define SD_SPI_MISO 7
 
 HalDisplay::HalDisplay() : einkDisplay(EPD_SCLK, EPD_MOSI, EPD_CS, EPD_DC, EPD_RST, EPD_BUSY) {}
 
-HalDisplay::~HalDisplay() {}
+HalDisplay::~HalDisplay() {
+  if (refreshRequests) {
+    constexpr RefreshRequest stop{FAST_REFRESH, false, true};
+    waitUntilIdle();
+    busy = true;
+    xQueueSend(refreshRequests, &stop, portMAX_DELAY);
+    waitUntilIdle();
+    vQueueDelete(refreshRequests);
+    vSemaphoreDelete(refreshDone);
+  }
+}
 
-void HalDisplay::begin() { einkDisplay.begin(); }
+void HalDisplay::begin() {
+  SpiBusLock bus;
+  einkDisplay.begin();
+}
 
-void HalDisplay::clearScreen(uint8_t color) const { einkDisplay.clearScreen(color); }
+void HalDisplay::clearScreen(uint8_t color) const {
+  waitUntilIdle();
+  einkDisplay.clearScreen(color);
+}
 
 void HalDisplay::drawImage(const uint8_t* imageData, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                            bool fromProgmem) const {
+  waitUntilIdle();
   einkDisplay.drawImage(imageData, x, y, w, h, fromProgmem);
 }
 
@@ -29,25 +47,110 @@ EInkDisplay::RefreshMode convertRefreshMode(HalDisplay::RefreshMode mode) {
 }
 
 void HalDisplay::displayBuffer(HalDisplay::RefreshMode mode, bool turnOffScreen) {
+  waitUntilIdle();
+  SpiBusLock bus;
+  const auto start = micros();
   einkDisplay.displayBuffer(convertRefreshMode(mode), turnOffScreen);
+  refreshMicros += micros() - start;
+}
+
+bool HalDisplay::startRefreshTask() {
+  refreshRequests = xQueueCreate(1, sizeof(RefreshRequest));
+  refreshDone = xSemaphoreCreateBinary();
+  if (refreshRequests && refreshDone && xTaskCreate(&refreshTask, "DisplayRefresh", 4096, this, 2, nullptr) == pdPASS) {
+    return true;
+  }
+  if (refreshRequests) vQueueDelete(refreshRequests);
+  if (refreshDone) vSemaphoreDelete(refreshDone);
+  refreshRequests = nullptr;
+  refreshDone = nullptr;
+  return false;
+}
+
+void HalDisplay::refreshTask(void* param) {
+  auto* self = static_cast<HalDisplay*>(param);
+  RefreshRequest request;
+  while (xQueueReceive(self->refreshRequests, &request, portMAX_DELAY) == pdPASS) {
+    if (!request.stop) {
+      // The driver sends the frame buffer and then polls BUSY until the waveform is done, all of it off the caller.
+      // Both happen inside one driver call, so SD transfers wait for the whole refresh.
+      SpiBusLock bus;
+      const auto start = micros();
+      self->einkDisplay.displayBuffer(convertRefreshMode(request.mode), request.turnOffScreen);
+      self->refreshMicros += micros() - start;
+    }
+    self->busy = false;
+    xSemaphoreGive(self->refreshDone);
+    if (request.stop) {
+      break;
+    }
+  }
+  vTaskDelete(nullptr);
+}
+
+void HalDisplay::displayBufferAsync(HalDisplay::RefreshMode mode, bool turnOffScreen) {
+  waitUntilIdle();
+  if (!refreshRequests && !startRefreshTask()) {
+    SpiBusLock bus;
+    einkDisplay.displayBuffer(convertRefreshMode(mode), turnOffScreen);
+    return;
+  }
+  const RefreshRequest request{mode, turnOffScreen, false};
+  busy = true;
+  xQueueSend(refreshRequests, &request, portMAX_DELAY);
+}
+
+void HalDisplay::waitUntilIdle() const {
+  // Polled with a short timeout so any number of tasks can wait on the single completion signal
+  while (busy) {
+    xSemaphoreTake(refreshDone, pdMS_TO_TICKS(10));
+  }
 }
 
 void HalDisplay::refreshDisplay(HalDisplay::RefreshMode mode, bool turnOffScreen) {
+  waitUntilIdle();
+  SpiBusLock bus;
+  const auto start = micros();
   einkDisplay.refreshDisplay(convertRefreshMode(mode), turnOffScreen);
+  refreshMicros += micros() - start;
 }
 
-void HalDisplay::deepSleep() { einkDisplay.deepSleep(); }
+void HalDisplay::deepSleep() {
+  waitUntilIdle();
+  SpiBusLock bus;
+  einkDisplay.deepSleep();
+}
 
 uint8_t* HalDisplay::getFrameBuffer() const { return einkDisplay.getFrameBuffer(); }
 
 void HalDisplay::copyGrayscaleBuffers(const uint8_t* lsbBuffer, const uint8_t* msbBuffer) {
+  waitUntilIdle();
+  SpiBusLock bus;
   einkDisplay.copyGrayscaleBuffers(lsbBuffer, msbBuffer);
 }
 
-void HalDisplay::copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer) { einkDisplay.copyGrayscaleLsbBuffers(lsbBuffer); }
+void HalDisplay::copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer) {
+  waitUntilIdle();
+  SpiBusLock bus;
+  einkDisplay.copyGrayscaleLsbBuffers(lsbBuffer);
+}
 
-void HalDisplay::copyGrayscaleMsbBuffers(const uint8_t* msbBuffer) { einkDisplay.copyGrayscaleMsbBuffers(msbBuffer); }
+void HalDisplay::copyGrayscaleMsbBuffers(const uint8_t* msbBuffer) {
+  waitUntilIdle();
+  SpiBusLock bus;
+  einkDisplay.copyGrayscaleMsbBuffers(msbBuffer);
+}
 
-void HalDisplay::cleanupGrayscaleBuffers(const uint8_t* bwBuffer) { einkDisplay.cleanupGrayscaleBuffers(bwBuffer); }
+void HalDisplay::cleanupGrayscaleBuffers(const uint8_t* bwBuffer) {
+  waitUntilIdle();
+  SpiBusLock bus;
+  einkDisplay.cleanupGrayscaleBuffers(bwBuffer);
+}
 
-void HalDisplay::displayGrayBuffer(bool turnOffScreen) { einkDisplay.displayGrayBuffer(turnOffScreen); }
+void HalDisplay::displayGrayBuffer(bool turnOffScreen) {
+  waitUntilIdle();
+  SpiBusLock bus;
+  const auto start = micros();
+  einkDisplay.displayGrayBuffer(turnOffScreen);
+  refreshMicros += micros() - start;
+}
@@ -1,6 +1,12 @@
 #pragma once
 #include <Arduino.h>
 #include <EInkDisplay.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <atomic>
 
 class HalDisplay {
  public:
@@ -32,6 +38,14 @@ class HalDisplay {
                  bool fromProgmem = false) const;
 
   void displayBuffer(RefreshMode mode = RefreshMode::FAST_REFRESH, bool turnOffScreen = false);
+  // Start displayBuffer() on the display task and return right away. Until the panel is idle again the frame buffer
+  // must not be drawn into; every other call on this class waits for the refresh to finish first.
+  void displayBufferAsync(RefreshMode mode = RefreshMode::FAST_REFRESH, bool turnOffScreen = false);
+  // True from displayBufferAsync() until the waveform has finished
+  bool isBusy() const { return busy; }
+  void waitUntilIdle() const;
+  // Total time spent in refreshes, in microseconds (wraps, compare differences)
+  uint32_t getRefreshMicros() const { return refreshMicros; }
   void refreshDisplay(RefreshMode mode = RefreshMode::FAST_REFRESH, bool turnOffScreen = false);
 
   // Power management
@@ -48,5 +62,18 @@ class HalDisplay {
   void displayGrayBuffer(bool turnOffScreen = false);
 
  private:
+  struct RefreshRequest {
+    RefreshMode mode;
+    bool turnOffScreen;
+    bool stop;
+  };
+
   EInkDisplay einkDisplay;
+  QueueHandle_t refreshRequests = nullptr;
+  SemaphoreHandle_t refreshDone = nullptr;
+  std::atomic<bool> busy{false};
+  std::atomic<uint32_t> refreshMicros{0};
+
+  bool startRefreshTask();
+  static void refreshTask(void* param);
 };
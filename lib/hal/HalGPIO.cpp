@@ -1,5 +1,7 @@
 #include <HalGPIO.h>
+#include <Logging.h>
 #include <SPI.h>
+#include <esp_pm.h>
 #include <esp_sleep.h>
 
 void HalGPIO::begin() {
@@ -7,21 +9,97 @@ void HalGPIO::begin() {
   SPI.begin(EPD_SCLK, SPI_MISO, EPD_MOSI, EPD_CS);
   pinMode(BAT_GPIO0, INPUT);
   pinMode(UART0_RXD, INPUT);
+
+  // begin() runs on the Arduino loop task, which is the one that waits for input
+  inputTask = xTaskGetCurrentTaskHandle();
+  attachInterruptArg(digitalPinToInterrupt(InputManager::POWER_BUTTON_PIN), &onButtonEdge, this, CHANGE);
+}
+
+void IRAM_ATTR HalGPIO::onButtonEdge(void* arg) {
+  auto* self = static_cast<HalGPIO*>(arg);
+  self->edgeMicros = micros();
+  self->edgePending = true;
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
+  vTaskNotifyGiveFromISR(self->inputTask, &higherPriorityTaskWoken);
+  if (higherPriorityTaskWoken) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+void HalGPIO::update() {
+  inputMgr.update();
+
+  injectedPrevious = injectedCurrent;
+  injectedCurrent = injectedPending;
+  if (injectedCurrent & ~injectedPrevious) {
+    injectedPressStart = millis();
+  }
+  if (injectedPrevious & ~injectedCurrent) {
+    injectedReleaseAt = millis();
+  }
+
+  if (wasAnyPressed() || wasAnyReleased()) {
+    lastEventMicros = edgePending ? edgeMicros : micros();
+  }
+  edgePending = false;
+}
+
+void HalGPIO::injectButton(const uint8_t buttonIndex, const bool pressed) {
+  if (pressed) {
+    injectedPending |= 1 << buttonIndex;
+  } else {
+    injectedPending &= ~(1 << buttonIndex);
+  }
+}
+
+bool HalGPIO::isPressed(uint8_t buttonIndex) const {
+  return inputMgr.isPressed(buttonIndex) || (injectedCurrent & (1 << buttonIndex));
 }
 
-void HalGPIO::update() { inputMgr.update(); }
+bool HalGPIO::wasPressed(uint8_t buttonIndex) const {
+  return inputMgr.wasPressed(buttonIndex) || (injectedCurrent & ~injectedPrevious & (1 << buttonIndex));
+}
 
-bool HalGPIO::isPressed(uint8_t buttonIndex) const { return inputMgr.isPressed(buttonIndex); }
+bool HalGPIO::wasAnyPressed() const { return inputMgr.wasAnyPressed() || (injectedCurrent & ~injectedPrevious); }
 
-bool HalGPIO::wasPressed(uint8_t buttonIndex) const { return inputMgr.wasPressed(buttonIndex); }
+bool HalGPIO::wasReleased(uint8_t buttonIndex) const {
+  return inputMgr.wasReleased(buttonIndex) || (injectedPrevious & ~injectedCurrent & (1 << buttonIndex));
+}
 
-bool HalGPIO::wasAnyPressed() const { return inputMgr.wasAnyPressed(); }
+bool HalGPIO::wasAnyReleased() const { return inputMgr.wasAnyReleased() || (injectedPrevious & ~injectedCurrent); }
 
-bool HalGPIO::wasReleased(uint8_t buttonIndex) const { return inputMgr.wasReleased(buttonIndex); }
+unsigned long HalGPIO::getHeldTime() const {
+  if (injectedCurrent) {
+    return millis() - injectedPressStart;
+  }
+  if (injectedPrevious) {
+    // Just released: how long it was held, like the hardware buttons report on release
+    return injectedReleaseAt - injectedPressStart;
+  }
+  return inputMgr.getHeldTime();
+}
 
-bool HalGPIO::wasAnyReleased() const { return inputMgr.wasAnyReleased(); }
+void HalGPIO::waitForInput(const unsigned long timeoutMs) { ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs)); }
 
-unsigned long HalGPIO::getHeldTime() const { return inputMgr.getHeldTime(); }
+void HalGPIO::enablePowerSaving(const bool lightSleep) {
+  // APB, and with it the SPI clock of the display and SD card, stays at 80 MHz down to that CPU frequency
+  esp_pm_config_esp32c3_t config = {};
+  config.max_freq_mhz = 160;
+  config.min_freq_mhz = 80;
+  config.light_sleep_enable = lightSleep;
+  esp_err_t err = esp_pm_configure(&config);
+  if (err != ESP_OK && lightSleep) {
+    LOG_INF("GPIO", "Light sleep not available (%d), clocking down only", err);
+    config.light_sleep_enable = false;
+    err = esp_pm_configure(&config);
+  }
+  if (err != ESP_OK) {
+    LOG_ERR("GPIO", "Power management not available: %d", err);
+    lightSleepEnabled = false;
+    return;
+  }
+  lightSleepEnabled = config.light_sleep_enable;
+}
 
 void HalGPIO::startDeepSleep() {
   // Ensure that the power button has been released to avoid immediately turning back on if you're holding it
@@ -29,6 +107,7 @@ void HalGPIO::startDeepSleep() {
     delay(50);
     inputMgr.update();
   }
+  detachInterrupt(digitalPinToInterrupt(InputManager::POWER_BUTTON_PIN));
   // Arm the wakeup trigger *after* the button is released
   esp_deep_sleep_enable_gpio_wakeup(1ULL << InputManager::POWER_BUTTON_PIN, ESP_GPIO_WAKEUP_GPIO_LOW);
   // Enter Deep Sleep
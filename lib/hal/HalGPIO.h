@@ -3,6 +3,8 @@
 #include <Arduino.h>
 #include <BatteryMonitor.h>
 #include <InputManager.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 // Display SPI pins (custom pins for XteinkX4, not hardware SPI defaults)
 #define EPD_SCLK 8   // SPI Clock
@@ -22,6 +24,20 @@ class HalGPIO {
 #if CROSSPOINT_EMULATED == 0
   InputManager inputMgr;
 #endif
+  // Task blocked in waitForInput(), woken by the power button interrupt
+  TaskHandle_t inputTask = nullptr;
+  volatile unsigned long edgeMicros = 0;
+  volatile bool edgePending = false;
+  unsigned long lastEventMicros = 0;
+  bool lightSleepEnabled = false;
+  // Buttons pressed over the serial automation protocol, latched by update() like the hardware ones
+  uint8_t injectedPending = 0;
+  uint8_t injectedCurrent = 0;
+  uint8_t injectedPrevious = 0;
+  unsigned long injectedPressStart = 0;
+  unsigned long injectedReleaseAt = 0;
+
+  static void onButtonEdge(void* arg);
 
  public:
   HalGPIO() = default;
@@ -31,6 +47,14 @@ class HalGPIO {
 
   // Button input methods
   void update();
+  // Block the calling task until a button interrupt or timeoutMs, whichever comes first. Only the power button is a
+  // plain GPIO; the other buttons share resistor ladders on ADC pins and are only seen by the next update().
+  void waitForInput(unsigned long timeoutMs);
+  // micros() of the button edge reported by the last update(): the interrupt time for the power button, otherwise the
+  // time update() saw it
+  unsigned long getLastEventMicros() const { return lastEventMicros; }
+  // Press or release a button as if it was the physical one, from the next update() on
+  void injectButton(uint8_t buttonIndex, bool pressed);
   bool isPressed(uint8_t buttonIndex) const;
   bool wasPressed(uint8_t buttonIndex) const;
   bool wasAnyPressed() const;
@@ -38,6 +62,11 @@ class HalGPIO {
   bool wasAnyReleased() const;
   unsigned long getHeldTime() const;
 
+  // Let the CPU clock down while idle, and light sleep between wakeups if lightSleep is set and the SDK was built with
+  // tickless idle. Light sleep drops the USB serial connection, so it is only used on battery.
+  void enablePowerSaving(bool lightSleep);
+  bool isLightSleepEnabled() const { return lightSleepEnabled; }
+
   // Setup wake up GPIO and enter deep sleep
   void startDeepSleep();
 
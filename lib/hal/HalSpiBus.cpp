@@ -0,0 +1,15 @@
+#include "HalSpiBus.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+namespace {
+SemaphoreHandle_t busMutex() {
+  static const SemaphoreHandle_t mutex = xSemaphoreCreateRecursiveMutex();
+  return mutex;
+}
+}  // namespace
+
+SpiBusLock::SpiBusLock() { xSemaphoreTakeRecursive(busMutex(), portMAX_DELAY); }
+
+SpiBusLock::~SpiBusLock() { xSemaphoreGiveRecursive(busMutex()); }
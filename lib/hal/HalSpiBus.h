@@ -0,0 +1,12 @@
+#pragma once
+
+// The display and the SD card share one SPI bus (set up in HalGPIO::begin). Display refreshes run on their own task,
+// so every transfer on the bus, display or SD, is made while holding this lock. It is recursive, so code holding it
+// can still go through Storage, but it must not call into the display: the refresh task may be waiting for the bus.
+class SpiBusLock {
+ public:
+  SpiBusLock();
+  SpiBusLock(const SpiBusLock&) = delete;
+  SpiBusLock& operator=(const SpiBusLock&) = delete;
+  ~SpiBusLock();
+};
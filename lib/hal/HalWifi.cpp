@@ -0,0 +1,80 @@
+#include "HalWifi.h"
+
+#include <WiFi.h>
+#include <esp_netif.h>
+#include <esp_netif_net_stack.h>
+#include <lwip/dhcp.h>
+
+#include <ctime>
+
+HalWifi HalWifi::instance;
+
+namespace {
+// Before this (2020) the clock was never set, by NTP or otherwise
+constexpr time_t CLOCK_SET_AFTER = 1600000000;
+
+// Lease time of the station's DHCP binding, 0 if it has none
+uint32_t dhcpLeaseSeconds() {
+  esp_netif_t* station = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+  auto* lwip = station ? static_cast<struct netif*>(esp_netif_get_netif_impl(station)) : nullptr;
+  const struct dhcp* dhcp = lwip ? netif_dhcp_data(lwip) : nullptr;
+  return dhcp && dhcp->state == DHCP_STATE_BOUND ? dhcp->offered_t0_lease : 0;
+}
+}  // namespace
+
+void HalWifi::connect(const char* ssid, const char* password, const WifiLink* link) {
+  WiFi.mode(WIFI_STA);
+
+  const WifiLease* lease = link && link->isKnown() && link->lease.ip != 0 ? &link->lease : nullptr;
+  configured = lease ? *lease : WifiLease{};
+  if (lease) {
+    WiFi.config(IPAddress(lease->ip), IPAddress(lease->gateway), IPAddress(lease->subnet), IPAddress(lease->dns));
+  } else {
+    // Back to DHCP in case an earlier attempt configured a lease
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+  }
+
+  const char* passphrase = password && password[0] ? password : nullptr;
+  if (link && link->isKnown()) {
+    WiFi.begin(ssid, passphrase, link->channel, link->bssid);
+  } else {
+    WiFi.begin(ssid, passphrase);
+  }
+}
+
+WifiDriver::Status HalWifi::status() {
+  switch (WiFi.status()) {
+    case WL_CONNECTED:
+      return Status::Connected;
+    case WL_CONNECT_FAILED:
+      return Status::Failed;
+    case WL_NO_SSID_AVAIL:
+      return Status::NoNetwork;
+    default:
+      return Status::Connecting;
+  }
+}
+
+void HalWifi::disconnect() { WiFi.disconnect(); }
+
+bool HalWifi::getLink(WifiLink& link) {
+  const uint8_t* bssid = WiFi.BSSID();
+  if (WiFi.status() != WL_CONNECTED || !bssid) {
+    return false;
+  }
+  memcpy(link.bssid, bssid, sizeof(link.bssid));
+  link.channel = static_cast<uint8_t>(WiFi.channel());
+  if (configured.ip != 0) {
+    // Not renewed by this connection, it still runs out when the one DHCP granted does
+    link.lease = configured;
+    return true;
+  }
+  link.lease.ip = WiFi.localIP();
+  link.lease.gateway = WiFi.gatewayIP();
+  link.lease.subnet = WiFi.subnetMask();
+  link.lease.dns = WiFi.dnsIP();
+  link.lease.seconds = dhcpLeaseSeconds();
+  const time_t now = time(nullptr);
+  link.lease.obtainedAt = now > CLOCK_SET_AFTER ? static_cast<uint32_t>(now) : 0;
+  return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// IPv4 settings of a station connection, addresses as IPAddress stores them. ip 0: use DHCP.
+struct WifiLease {
+  uint32_t ip = 0;
+  uint32_t gateway = 0;
+  uint32_t subnet = 0;
+  uint32_t dns = 0;
+  uint32_t seconds = 0;     // Lease time the DHCP server granted, 0 if unknown
+  uint32_t obtainedAt = 0;  // Wall clock time it was granted, 0 if the clock was not set then
+
+  // Whether the address may still be used without asking DHCP: only until the point a DHCP client would renew it
+  // (half the lease), and never when its age cannot be told
+  bool isCurrent(const uint32_t now) const {
+    return ip != 0 && seconds != 0 && obtainedAt != 0 && now >= obtainedAt && now - obtainedAt < seconds / 2;
+  }
+};
+
+// Where a network was last reached: the access point, its channel and the lease it handed out. channel 0: unknown.
+struct WifiLink {
+  uint8_t bssid[6] = {};
+  uint8_t channel = 0;
+  WifiLease lease;
+
+  bool isKnown() const { return channel != 0; }
+  bool sameAccessPoint(const WifiLink& other) const {
+    return channel == other.channel && memcmp(bssid, other.bssid, sizeof(bssid)) == 0;
+  }
+};
+
+// Station side of the radio as the connection logic sees it, so that logic can run against a fake radio on the host
+class WifiDriver {
+ public:
+  enum class Status : uint8_t { Connecting, Connected, Failed, NoNetwork };
+
+  virtual ~WifiDriver() = default;
+
+  /**
+   * Start joining ssid. With a known link the radio only probes that access point on that channel and, if the link
+   * has a lease, configures it instead of asking DHCP. Without one it scans every channel first. Whether the lease is
+   * still current is up to the caller.
+   * @param password Empty for open networks
+   */
+  virtual void connect(const char* ssid, const char* password, const WifiLink* link) = 0;
+  virtual Status status() = 0;
+  virtual void disconnect() = 0;
+  // Access point, channel and lease of the current connection. A lease configured by connect() is reported as it
+  // was passed in, with the time it was originally granted.
+  virtual bool getLink(WifiLink& link) = 0;
+};
+
+class HalWifi final : public WifiDriver {
+ public:
+  void connect(const char* ssid, const char* password, const WifiLink* link) override;
+  Status status() override;
+  void disconnect() override;
+  bool getLink(WifiLink& link) override;
+
+  static HalWifi& getInstance() { return instance; }
+
+ private:
+  static HalWifi instance;
+
+  WifiLease configured;  // Lease the current connection was configured with, ip 0 if it came from DHCP
+
+  HalWifi() = default;
+};
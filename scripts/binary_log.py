@@ -0,0 +1,289 @@
+#!/usr/bin/env python3
+"""
+String table and decoder for binary log builds (-DLOG_BINARY).
+
+In a binary log build every LOG_ERR/LOG_INF/LOG_DBG call sends its format id (FNV-1a of level, origin and format,
+computed at compile time by binlog::formatId in lib/Logging/Logging.h) and its raw arguments instead of text. This
+script scans the sources for those calls to build the id -> format table, and rebuilds the text lines from a stream
+that mixes records with plain text (command replies, screenshots framing).
+
+Usage:
+    python binary_log.py table <output.json> [source dirs...]     (default: src lib)
+    python binary_log.py decode <table.json> <capture.bin>
+
+When run by PlatformIO as a pre-build script, the table is written to the build directory of binary log builds
+(e.g. .pio/build/binlog/log_table.json).
+"""
+
+from __future__ import annotations
+
+import json
+import os
+import re
+import struct
+import sys
+from pathlib import Path
+
+SOURCE_SUFFIXES = (".c", ".cpp", ".h", ".hpp")
+DROPPED_ID = 0
+
+# LOG_ERR("ORIGIN", "format" "more format" — adjacent literals may span lines
+LOG_CALL_RE = re.compile(
+    r'\bLOG_(ERR|INF|DBG|RECORD)\(\s*(?:"(ERR|INF|DBG)"\s*,\s*)?'  # macro, level of LOG_RECORD
+    r'"([^"]*)"\s*,\s*'  # origin
+    r'((?:"(?:[^"\\]|\\.)*"\s*)+)'  # format literals
+)
+LITERAL_RE = re.compile(r'"((?:[^"\\]|\\.)*)"')
+C_ESCAPE_RE = re.compile(r'\\(x[0-9a-fA-F]+|[0-7]{1,3}|.)')
+C_SPEC_RE = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t|L)?([diouxXeEfFgGcsp%])")
+
+SIMPLE_ESCAPES = {
+    "n": "\n",
+    "t": "\t",
+    "r": "\r",
+    "0": "\0",
+    "\\": "\\",
+    '"': '"',
+    "'": "'",
+    "a": "\a",
+    "b": "\b",
+    "f": "\f",
+    "v": "\v",
+    "?": "?",
+}
+
+
+def fnv1a(data: bytes) -> int:
+    """
+    Same hash as binlog::formatId.
+    """
+    value = 2166136261
+    for byte in data:
+        value = ((value ^ byte) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def unescape_c(text: str) -> str:
+    """
+    Resolves the escape sequences of a C string literal.
+    """
+
+    def replace(match: re.Match) -> str:
+        esc = match.group(1)
+        if esc[0] == "x":
+            return chr(int(esc[1:], 16))
+        if esc[0].isdigit() and esc != "0":
+            return chr(int(esc, 8))
+        return SIMPLE_ESCAPES.get(esc, esc)
+
+    return C_ESCAPE_RE.sub(replace, text)
+
+
+def scan_sources(dirs: list[str]) -> dict[int, tuple[str, str, str]]:
+    """
+    Returns {format id: (level, origin, format)} for every LOG_* call with literal arguments under dirs.
+    """
+    table: dict[int, tuple[str, str, str]] = {}
+    for directory in dirs:
+        for root, _, files in os.walk(directory):
+            for name in files:
+                if not name.endswith(SOURCE_SUFFIXES):
+                    continue
+                path = os.path.join(root, name)
+                with open(path, encoding="utf-8", errors="replace") as f:
+                    text = f.read()
+                for match in LOG_CALL_RE.finditer(text):
+                    level = match.group(2) if match.group(1) == "RECORD" else match.group(1)
+                    if level is None:
+                        continue
+                    origin = unescape_c(match.group(3))
+                    fmt = unescape_c("".join(LITERAL_RE.findall(match.group(4))))
+                    key = f"{level}\x1f{origin}\x1f{fmt}".encode("utf-8")
+                    entry = (level, origin, fmt)
+                    format_id = fnv1a(key)
+                    if table.get(format_id, entry) != entry:
+                        print(f"Warning: log format id collision in {path}: {fmt!r}", file=sys.stderr)
+                    table[format_id] = entry
+    return table
+
+
+def write_table(path: str, dirs: list[str]) -> int:
+    table = scan_sources(dirs)
+    Path(path).parent.mkdir(parents=True, exist_ok=True)
+    with open(path, "w", encoding="utf-8") as f:
+        json.dump({f"{k:08x}": list(v) for k, v in sorted(table.items())}, f, indent=0, ensure_ascii=False)
+    return len(table)
+
+
+def load_table(path: str) -> dict[int, tuple[str, str, str]]:
+    with open(path, encoding="utf-8") as f:
+        return {int(k, 16): tuple(v) for k, v in json.load(f).items()}
+
+
+def parse_args(payload: bytes) -> list:
+    """
+    Unpacks the tagged arguments of a record: 1 = 32 bit, 2 = 64 bit, 3 = double, 4 = string.
+    Integers are kept unsigned, format_c() applies the signedness of the conversion.
+    """
+    args: list = []
+    pos = 0
+    while pos < len(payload):
+        tag = payload[pos]
+        pos += 1
+        if tag == 1 and pos + 4 <= len(payload):
+            args.append((32, struct.unpack_from("<I", payload, pos)[0]))
+            pos += 4
+        elif tag == 2 and pos + 8 <= len(payload):
+            args.append((64, struct.unpack_from("<Q", payload, pos)[0]))
+            pos += 8
+        elif tag == 3 and pos + 8 <= len(payload):
+            args.append(struct.unpack_from("<d", payload, pos)[0])
+            pos += 8
+        elif tag == 4 and pos < len(payload):
+            size = payload[pos]
+            args.append(payload[pos + 1 : pos + 1 + size].decode("utf-8", errors="replace"))
+            pos += 1 + size
+        else:
+            break
+    return args
+
+
+def format_c(fmt: str, args: list) -> str:
+    """
+    printf-style formatting of fmt with unpacked record arguments. Missing arguments show as '?'.
+    """
+    remaining = iter(args)
+
+    def next_int(signed: bool) -> int | None:
+        arg = next(remaining, None)
+        if not isinstance(arg, tuple):
+            return None
+        bits, value = arg
+        if signed and value >= 1 << (bits - 1):
+            value -= 1 << bits
+        return value
+
+    def replace(match: re.Match) -> str:
+        flags, width, precision, _, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(next_int(True) or 0)
+        if precision == "*":
+            precision = str(next_int(True) or 0)
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+        if conv in "diuoxXcp":
+            value = next_int(conv in "di")
+            if value is None:
+                return "?"
+            if conv == "c":
+                return (spec + "c") % chr(value & 0xFF)
+            if conv == "p":
+                return "0x%x" % value
+            return (spec + ("d" if conv in "diu" else conv)) % value
+        arg = next(remaining, None)
+        if conv == "s":
+            return (spec + "s") % (arg if isinstance(arg, str) else "?")
+        if not isinstance(arg, float):
+            return "?"
+        return (spec + conv) % arg
+
+    return C_SPEC_RE.sub(replace, fmt)
+
+
+def decode_record(table: dict[int, tuple[str, str, str]], payload: bytes) -> str:
+    """
+    Formats one record payload the way logPrintf formats a text log line (without the newline).
+    """
+    if len(payload) < 8:
+        return "[BINLOG] Truncated record"
+    format_id, millis = struct.unpack_from("<II", payload)
+    args = parse_args(payload[8:])
+    if format_id == DROPPED_ID:
+        count = args[0][1] if args and isinstance(args[0], tuple) else 0
+        return f"[{millis}] [ERR] [LOG] {count} records dropped, log ring was full"
+    entry = table.get(format_id)
+    if entry is None:
+        return f"[{millis}] [???] [LOG] Unknown format id {format_id:08x}, is the log table up to date?"
+    level, origin, fmt = entry
+    return f"[{millis}] [{level}] [{origin}] {format_c(fmt, args).rstrip(chr(10))}"
+
+
+class BinaryLogReader:
+    """
+    Splits a serial byte stream into lines, decoding binary records (0x00, length, payload) on the way.
+    """
+
+    def __init__(self, table: dict[int, tuple[str, str, str]]):
+        self.table = table
+        self.buffer = bytearray()
+        self.text = bytearray()
+
+    def feed(self, data: bytes) -> None:
+        self.buffer += data
+
+    def next_line(self) -> str | None:
+        """
+        Returns the next complete line, or None if more data is needed.
+        """
+        while self.buffer:
+            if self.buffer[0] == 0:
+                if len(self.buffer) < 2 or len(self.buffer) < 2 + self.buffer[1]:
+                    return None
+                payload = bytes(self.buffer[2 : 2 + self.buffer[1]])
+                del self.buffer[: 2 + len(payload)]
+                return decode_record(self.table, payload)
+            end = len(self.buffer)
+            for stop in (b"\n", b"\0"):
+                found = self.buffer.find(stop)
+                if found != -1:
+                    end = min(end, found)
+            self.text += self.buffer[:end]
+            if end < len(self.buffer) and self.buffer[end] == ord("\n"):
+                del self.buffer[: end + 1]
+                line = self.text.decode("utf-8", errors="replace").rstrip("\r")
+                self.text.clear()
+                return line
+            del self.buffer[:end]
+        return None
+
+    def take_raw(self, size: int) -> bytes:
+        """
+        Removes up to size bytes that follow the last returned line without decoding them (screenshot data).
+        """
+        data = bytes(self.buffer[:size])
+        del self.buffer[:size]
+        return data
+
+
+def decode_file(table_path: str, capture_path: str) -> None:
+    reader = BinaryLogReader(load_table(table_path))
+    with open(capture_path, "rb") as f:
+        reader.feed(f.read())
+    reader.feed(b"\n")
+    while (line := reader.next_line()) is not None:
+        if line:
+            print(line)
+
+
+def main() -> None:
+    if len(sys.argv) >= 3 and sys.argv[1] == "table":
+        count = write_table(sys.argv[2], sys.argv[3:] or ["src", "lib"])
+        print(f"Wrote {count} log formats to {sys.argv[2]}")
+    elif len(sys.argv) == 4 and sys.argv[1] == "decode":
+        decode_file(sys.argv[2], sys.argv[3])
+    else:
+        print(__doc__)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
+else:
+    try:
+        Import("env")
+        if "LOG_BINARY" in " ".join(env.GetProjectOption("build_flags", [])):
+            table_path = os.path.join(env.subst("$BUILD_DIR"), "log_table.json")
+            print(f"Wrote {write_table(table_path, ['src', 'lib'])} log formats to {table_path}")
+    except NameError:
+        pass
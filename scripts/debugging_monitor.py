@@ -14,9 +14,12 @@ Features:
 - Graceful shutdown handling with Ctrl-C signal processing
 - Configurable filtering and suppression of log messages
 - Thread-safe operation with coordinated shutdown events
+- Replay of scripted button presses with a CSV latency report (--replay)
+- Decoding of binary log builds (-DLOG_BINARY) with the generated string table (--log-table)
 
 Usage:
     python debugging_monitor.py [port] [options]
+    python debugging_monitor.py [port] --replay script.txt --report latency.csv
 
 The script will open a matplotlib window showing memory usage over time and provide
 an interactive command prompt for sending commands to the device. Press Ctrl-C or
@@ -26,12 +29,15 @@ close the graph window to exit gracefully.
 from __future__ import annotations
 
 import argparse
+import csv
 import glob
+import os
 import platform
 import re
 import signal
 import sys
 import threading
+import time
 from collections import deque
 from datetime import datetime
 
@@ -72,6 +78,8 @@ except ImportError as e:
     print("\nExiting...")
     sys.exit(1)
 
+from binary_log import BinaryLogReader, load_table
+
 # --- Global Variables for Data Sharing ---
 # Store last 50 data points
 MAX_POINTS = 50
@@ -83,6 +91,9 @@ data_lock: threading.Lock = threading.Lock()  # Prevent reading while writing
 # Global shutdown flag
 shutdown_event = threading.Event()
 
+# Set by --log-table, decodes the records of binary log builds
+log_reader: BinaryLogReader | None = None
+
 # Initialize colors
 init(autoreset=True)
 
@@ -189,6 +200,35 @@ def parse_memory_line(line: str) -> tuple[int | None, int | None]:
     return None, None
 
 
+def read_serial_line(ser) -> str:
+    """
+    Reads one line from the device, decoding binary log records when a log table was given.
+    Returns an empty string if nothing arrived before the port timeout.
+    """
+    if log_reader is None:
+        return ser.readline().decode("utf-8", errors="replace")
+    line = log_reader.next_line()
+    while line is None:
+        data = ser.read(max(1, ser.in_waiting))
+        if not data:
+            return ""
+        log_reader.feed(data)
+        line = log_reader.next_line()
+    return line + "\n"
+
+
+def read_screenshot_data(ser, size: int, deadline: float | None = None) -> bytes:
+    """
+    Reads the raw frame buffer that follows a SCREENSHOT_START line.
+    """
+    data = log_reader.take_raw(size) if log_reader else b""
+    while len(data) < size and not shutdown_event.is_set():
+        if deadline is not None and time.monotonic() > deadline:
+            break
+        data += ser.read(size - len(data))
+    return data
+
+
 def serial_worker(ser, kwargs: dict[str, str]) -> None:
     """
     Runs in a background thread. Handles reading serial data, printing to console,
@@ -220,10 +260,7 @@ def serial_worker(ser, kwargs: dict[str, str]) -> None:
     try:
         while not shutdown_event.is_set():
             if expecting_screenshot:
-                data = ser.read(screenshot_size - len(screenshot_data))
-                if not data:
-                    continue
-                screenshot_data += data
+                screenshot_data = read_screenshot_data(ser, screenshot_size)
                 if len(screenshot_data) == screenshot_size:
                     if Image:
                         img = Image.frombytes("1", (800, 480), screenshot_data)
@@ -243,7 +280,7 @@ def serial_worker(ser, kwargs: dict[str, str]) -> None:
                     screenshot_data = b""
             else:
                 try:
-                    raw_data = ser.readline().decode("utf-8", errors="replace")
+                    raw_data = read_serial_line(ser)
 
                     if not raw_data:
                         continue
@@ -305,6 +342,128 @@ def input_worker(ser) -> None:
             break
 
 
+REPLAY_REPLY_PREFIXES = ("OK:", "ERR:", "IDLE:", "TIMEOUT:", "VERSION:")
+REPLAY_TIMEOUT_S = 30
+
+
+def parse_replay_script(path: str) -> list[list[str]]:
+    """
+    Reads a replay script into a flat list of commands, expanding repeat blocks.
+
+    One command per line, '#' starts a comment:
+        press|release BUTTON      hold or let go of BACK, CONFIRM, LEFT, RIGHT, UP, DOWN or POWER
+        tap BUTTON [ms]           press and release after ms (default: next loop)
+        open PATH                 open a book on the SD card
+        wait [ms]                 wait until rendering is idle, adds a row to the report
+        screenshot                save the screen to screenshot_<step>.bmp
+        label NAME                name the following report rows
+        repeat N ... end          repeat the enclosed commands N times
+    """
+    stack: list[tuple[int, list[list[str]]]] = [(1, [])]
+    with open(path, encoding="utf-8") as f:
+        for number, raw in enumerate(f, 1):
+            line = raw.split("#", 1)[0].strip()
+            if not line:
+                continue
+            words = line.split(maxsplit=1)
+            cmd = words[0].lower()
+            if cmd == "repeat":
+                stack.append((int(words[1]), []))
+            elif cmd == "end":
+                if len(stack) == 1:
+                    raise ValueError(f"{path}:{number}: 'end' without 'repeat'")
+                count, block = stack.pop()
+                stack[-1][1].extend(block * count)
+            elif cmd in ("press", "release", "tap", "open", "wait", "screenshot", "label"):
+                stack[-1][1].append(words)
+            else:
+                raise ValueError(f"{path}:{number}: unknown command '{words[0]}'")
+    if len(stack) != 1:
+        raise ValueError(f"{path}: 'repeat' without 'end'")
+    return stack[0][1]
+
+
+def replay_request(ser, command: str, screenshot_path: str = "screenshot.bmp") -> str:
+    """
+    Sends one automation command and returns its reply line, echoing log output meanwhile.
+    A screenshot the command produces is saved to screenshot_path.
+    """
+    ser.write(f"CMD:{command}\n".encode())
+    deadline = time.monotonic() + REPLAY_TIMEOUT_S
+    while time.monotonic() < deadline and not shutdown_event.is_set():
+        line = read_serial_line(ser).strip()
+        if not line:
+            continue
+        if line.startswith("SCREENSHOT_START:"):
+            size = int(line.split(":")[1])
+            data = read_screenshot_data(ser, size, deadline)
+            if Image and len(data) == size:
+                img = Image.frombytes("1", (800, 480), data).transpose(Image.ROTATE_270)
+                img.save(screenshot_path)
+            return "OK:SCREENSHOT" if len(data) == size else "ERR:Short screenshot"
+        if line.startswith(REPLAY_REPLY_PREFIXES):
+            return line
+        print(f"{get_color_for_line(line)}{line}")
+    return "ERR:No reply"
+
+
+def run_replay(ser, script_path: str, report_path: str, screenshot_dir: str) -> bool:
+    """
+    Plays a replay script against the device and writes one CSV row per wait.
+    Each screenshot is saved to its own screenshot_<step>.bmp in screenshot_dir.
+    """
+    try:
+        commands = parse_replay_script(script_path)
+    except (OSError, ValueError) as e:
+        print(f"{Fore.RED}Error: {e}{Style.RESET_ALL}")
+        return False
+
+    version = replay_request(ser, "VERSION").partition(":")[2]
+    replay_request(ser, "LATENCY")
+    print(f"{Fore.CYAN}--- Replaying {len(commands)} commands on {version} ---{Style.RESET_ALL}")
+
+    os.makedirs(screenshot_dir, exist_ok=True)
+    ok = True
+    label = ""
+    with open(report_path, "w", newline="", encoding="utf-8") as f:
+        writer = csv.writer(f)
+        writer.writerow(
+            [
+                "version",
+                "label",
+                "step",
+                "input_to_render_us",
+                "render_us",
+                "display_us",
+                "save_us",
+                "renders",
+                "waited_ms",
+                "timed_out",
+            ]
+        )
+        for step, words in enumerate(commands, 1):
+            if shutdown_event.is_set():
+                return False
+            cmd = words[0].lower()
+            if cmd == "label":
+                label = words[1] if len(words) > 1 else ""
+                continue
+            name = "WAIT_IDLE" if cmd == "wait" else cmd.upper()
+            screenshot_path = os.path.join(screenshot_dir, f"screenshot_{step:04d}.bmp")
+            reply = replay_request(ser, " ".join([name] + words[1:]), screenshot_path)
+            if reply == "OK:SCREENSHOT" and Image:
+                print(f"{Fore.GREEN}Screenshot saved to {screenshot_path}{Style.RESET_ALL}")
+            if reply.startswith(("IDLE:", "TIMEOUT:")):
+                status, _, values = reply.partition(":")
+                writer.writerow([version, label, step] + values.split(",") + [int(status == "TIMEOUT")])
+                print(f"{Fore.BLUE}{label or 'step'} {step}: {reply}{Style.RESET_ALL}")
+            elif reply.startswith("ERR:"):
+                print(f"{Fore.RED}{' '.join(words)}: {reply}{Style.RESET_ALL}")
+                ok = False
+    print(f"{Fore.GREEN}Latency report saved to {report_path}{Style.RESET_ALL}")
+    return ok
+
+
 def update_graph(frame) -> list:  # pylint: disable=unused-argument
     """
     Called by Matplotlib animation to redraw the memory usage chart.
@@ -425,7 +584,34 @@ def main() -> None:
         default="",
         help="Suppress lines containing this keyword (case-insensitive)",
     )
+    parser.add_argument(
+        "--replay",
+        type=str,
+        default="",
+        help="Play this script of button presses instead of showing the graph",
+    )
+    parser.add_argument(
+        "--report",
+        type=str,
+        default="latency.csv",
+        help="CSV file for the timings measured by --replay (default: latency.csv)",
+    )
+    parser.add_argument(
+        "--screenshots",
+        type=str,
+        default=".",
+        help="Directory for the screenshot_<step>.bmp files taken by --replay (default: current directory)",
+    )
+    parser.add_argument(
+        "--log-table",
+        type=str,
+        default="",
+        help="String table of a binary log build (.pio/build/<env>/log_table.json)",
+    )
     args = parser.parse_args()
+    if args.log_table:
+        global log_reader  # pylint: disable=global-statement
+        log_reader = BinaryLogReader(load_table(args.log_table))
     port = args.port
     if port is None:
         port_list = get_auto_detected_port()
@@ -454,6 +640,11 @@ def main() -> None:
     # Set up signal handler for graceful shutdown
     signal.signal(signal.SIGINT, signal_handler)
 
+    if args.replay:
+        ok = run_replay(ser, args.replay, args.report, args.screenshots)
+        ser.close()
+        sys.exit(0 if ok else 1)
+
     # 1. Start the Serial Reader in a separate thread
     # Daemon=True means this thread dies when the main program closes
     myargs = vars(args)  # Convert Namespace to dict for easier passing
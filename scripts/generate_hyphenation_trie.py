@@ -1,10 +1,22 @@
 #!/usr/bin/env python3
-"""Embed hypher-generated `.bin` tries into constexpr headers."""
+"""Embed hypher-generated `.bin` tries into constexpr headers, or write them as SD card pattern packs.
+
+An output ending in `.hyph` becomes a pattern pack for HyphenationPack (see HyphenationPack.h for the layout) instead
+of a header. Inputs can also be existing `hyph-*.trie.h` headers, so a built-in language can be moved to the SD card
+without downloading its trie again.
+"""
 
 from __future__ import annotations
 
 import argparse
 import pathlib
+import re
+import struct
+
+PACK_MAGIC = b"HYPH"
+PACK_VERSION = 1
+PACK_SCRIPTS = {"latin": 0, "cyrillic": 1}
+NO_CHILD = 0xFFFFFFFF
 
 
 def _format_bytes(blob: bytes, per_line: int = 16) -> str:
@@ -76,12 +88,89 @@ constexpr SerializedHyphenationPatterns {patterns_symbol} = {{
     path.write_text(content)
 
 
+def read_trie(path: pathlib.Path) -> tuple[int, bytes]:
+    # Return (root offset, trie bytes) with the 4-byte root address already stripped, as stored in the headers.
+    if path.suffix == '.h':
+        text = path.read_text()
+        body = text[text.index('{') : text.index('};')]
+        data = bytes(int(b, 16) for b in re.findall(r'0x([0-9A-Fa-f]{2})\b', body))
+        root = int(re.search(r'_patterns = \{\s*0x([0-9A-Fa-f]+)u', text).group(1), 16)
+        return root, data
+    blob = path.read_bytes()
+    if len(blob) < 4:
+        raise ValueError(f"Blob too small: {len(blob)} bytes")
+    root_addr = int.from_bytes(blob[:4], 'big')
+    if root_addr > len(blob):
+        raise ValueError(f"Root address {root_addr} exceeds blob size {len(blob)}")
+    return root_addr - 4, blob[4:]
+
+
+def _node_children(data: bytes, addr: int) -> dict[int, int]:
+    # Decode the transitions of the node at addr into {byte: child address}, like decodeState in LiangHyphenation.cpp.
+    header = data[addr]
+    pos = addr + 1
+    stride = (header >> 5) & 0x03 or 1
+    count = header & 0x1F
+    if count == 31:
+        count = data[pos]
+        pos += 1
+    if header >> 7:
+        pos += 2  # levels offset and length
+    transitions = data[pos : pos + count]
+    pos += count
+    children = {}
+    for idx, letter in enumerate(transitions):
+        raw = data[pos + idx * stride : pos + (idx + 1) * stride]
+        if stride == 3:
+            delta = int.from_bytes(raw, 'big') - (1 << 23)
+        else:
+            delta = int.from_bytes(raw, 'big', signed=True)
+        children[letter] = addr + delta
+    return children
+
+
+def dispatch_tables(root: int, data: bytes, hot_nodes: int) -> list[tuple[int, list[int]]]:
+    # Root table plus the hot_nodes first-level nodes with the most children, lowest address first on ties.
+    # Must pick the same nodes as buildLiangDispatchTables in LiangHyphenation.cpp.
+    def table(node: int) -> tuple[int, list[int]]:
+        targets = [NO_CHILD] * 256
+        for letter, child in _node_children(data, node).items():
+            targets[letter] = child
+        return node, targets
+
+    root_children = _node_children(data, root)
+    counts = {child: len(_node_children(data, child)) for child in set(root_children.values())}
+    hot = sorted((child for child, count in counts.items() if count > 0), key=lambda c: (-counts[c], c))
+    return [table(root)] + [table(node) for node in hot[:hot_nodes]]
+
+
+def write_pack(path: pathlib.Path, root: int, data: bytes, script: str, min_prefix: int, min_suffix: int,
+               hot_nodes: int) -> None:
+    tables = dispatch_tables(root, data, hot_nodes)
+    out = bytearray(PACK_MAGIC)
+    out += struct.pack('<BBBBIIB', PACK_VERSION, PACK_SCRIPTS[script], min_prefix, min_suffix, root, len(data),
+                       len(tables))
+    for node, targets in tables:
+        out += struct.pack('<I256I', node, *targets)
+    out += data
+    path.parent.mkdir(parents=True, exist_ok=True)
+    path.write_bytes(bytes(out))
+
+
 def main() -> None:
     parser = argparse.ArgumentParser()
     parser.add_argument('--input', dest='inputs', action='append', required=True,
                         help='Path to a hypher-generated .bin trie')
     parser.add_argument('--output', dest='outputs', action='append', required=True,
-                        help='Destination header path (hyph-*.trie.h)')
+                        help='Destination header path (hyph-*.trie.h) or pattern pack (<lang>.hyph)')
+    parser.add_argument('--script', choices=sorted(PACK_SCRIPTS), default='latin',
+                        help='Letters the language is written in (pattern packs only)')
+    parser.add_argument('--min-prefix', type=int, default=2,
+                        help='Minimum letters before a break (pattern packs only)')
+    parser.add_argument('--min-suffix', type=int, default=2,
+                        help='Minimum letters after a break (pattern packs only)')
+    parser.add_argument('--dispatch-nodes', type=int, default=4,
+                        help='First-level nodes that get a dispatch table besides the root (pattern packs only)')
     args = parser.parse_args()
 
     if len(args.inputs) != len(args.outputs):
@@ -90,8 +179,13 @@ def main() -> None:
     for src, dst in zip(args.inputs, args.outputs):
         # Process each input/output pair independently so mixed-language refreshes work in one invocation.
         src_path = pathlib.Path(src)
-        blob = src_path.read_bytes()
         out_path = pathlib.Path(dst)
+        if out_path.suffix == '.hyph':
+            root, data = read_trie(src_path)
+            write_pack(out_path, root, data, args.script, args.min_prefix, args.min_suffix, args.dispatch_nodes)
+            print(f'wrote {dst} ({len(data)} bytes trie)')
+            continue
+        blob = src_path.read_bytes()
         symbol = _symbol_from_output(out_path)
         write_header(out_path, blob, symbol)
         print(f'wrote {dst} ({len(blob)} bytes payload)')
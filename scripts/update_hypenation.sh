@@ -16,9 +16,31 @@ process() {
     --output "lib/Epub/Epub/hyphenation/generated/hyph-${lang}.trie.h"
 }
 
+# Languages without a built-in trie, loaded from /hyphenation on the SD card
+process_pack() {
+  local lang="$1"
+  local script="$2"
+
+  mkdir -p "build/hyphenation"
+  wget -O "build/$lang.bin" "https://github.com/typst/hypher/raw/refs/heads/main/tries/$lang.bin"
+
+  python scripts/generate_hyphenation_trie.py \
+    --input "build/$lang.bin" \
+    --output "build/hyphenation/${lang}.hyph" \
+    --script "$script"
+}
+
 process en
 process fr
 process de
 process es
 process ru
 process it
+
+process_pack nl latin
+process_pack pt latin
+process_pack sv latin
+process_pack da latin
+process_pack fi latin
+process_pack uk cyrillic
+process_pack bg cyrillic
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+Rewrites an XTC/XTCH book with compressed page bitmaps.
+
+The reader decodes PackBits (compression 1) and raw deflate (compression 2) pages straight into its page buffer, so a
+compressed book takes less space on the card and every page turn reads fewer bytes from it. Deflate usually shrinks
+text pages about five-fold, PackBits is cheaper to decode but saves much less. Pages that would not get smaller, or
+that are already compressed, are copied unchanged.
+
+Usage:
+    python xtc_compress.py <input.xtc> <output.xtc> [--codec deflate|packbits]
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+import sys
+import zlib
+
+HEADER = struct.Struct("<IBBHBBBBIQQQQII")  # XtcHeader, 56 bytes
+METADATA_OFFSET, THUMB_OFFSET, CHAPTER_OFFSET = 9, 12, 13  # XtcHeader fields that may point past the pages
+PAGE_ENTRY = struct.Struct("<QIHH")  # PageTableEntry, 16 bytes
+PAGE_HEADER = struct.Struct("<IHHBBIQ")  # XtgPageHeader, 22 bytes
+
+XTCH_MAGIC = 0x48435458
+COMPRESSION_NONE = 0
+CODECS = {"packbits": 1, "deflate": 2}
+
+
+def pack_bits(data: bytes) -> bytes:
+    """
+    Greedy PackBits: runs of three or more equal bytes become repeat runs, everything else literals.
+    """
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 3:
+            out += bytes((257 - run, data[i]))
+            i += run
+            continue
+        start = i
+        while i < len(data) and i - start < 128 and not (i + 2 < len(data) and data[i] == data[i + 1] == data[i + 2]):
+            i += 1
+        out.append(i - start - 1)
+        out += data[start:i]
+    return bytes(out)
+
+
+def unpack_bits(data: bytes) -> bytes:
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        header = data[i]
+        i += 1
+        if header < 128:
+            out += data[i : i + header + 1]
+            i += header + 1
+        elif header > 128:
+            out += bytes([data[i]]) * (257 - header)
+            i += 1
+    return bytes(out)
+
+
+def deflate(data: bytes) -> bytes:
+    compressor = zlib.compressobj(9, zlib.DEFLATED, -15)
+    return compressor.compress(data) + compressor.flush()
+
+
+def inflate(data: bytes) -> bytes:
+    return zlib.decompressobj(-15).decompress(data)
+
+
+def bitmap_size(width: int, height: int, two_bit: bool) -> int:
+    if two_bit:
+        return (width * height + 7) // 8 * 2
+    return (width + 7) // 8 * height
+
+
+def compress_file(src_path: str, dst_path: str, codec: str) -> None:
+    with open(src_path, "rb") as f:
+        src = f.read()
+
+    header = list(HEADER.unpack_from(src))
+    magic, page_count, table_offset, data_offset = header[0], header[3], header[10], header[11]
+    two_bit = magic == XTCH_MAGIC
+    entries = [PAGE_ENTRY.unpack_from(src, table_offset + i * PAGE_ENTRY.size) for i in range(page_count)]
+    data_end = max(offset + size for offset, size, _, _ in entries)
+
+    pages = bytearray()
+    new_entries = []
+    raw_total = stored_total = 0
+    for index, (offset, _, width, height) in enumerate(entries):
+        page_magic, page_width, page_height, color, compression, size, md5 = PAGE_HEADER.unpack_from(src, offset)
+        payload_start = offset + PAGE_HEADER.size
+        if compression == COMPRESSION_NONE:
+            bitmap = src[payload_start : payload_start + bitmap_size(page_width, page_height, two_bit)]
+            payload = pack_bits(bitmap) if codec == "packbits" else deflate(bitmap)
+            decoded = unpack_bits(payload) if codec == "packbits" else inflate(payload)
+            if decoded != bitmap:
+                sys.exit(f"Page {index} does not round-trip through {codec}")
+            if len(payload) < len(bitmap):
+                compression = CODECS[codec]
+            else:
+                payload = bitmap
+            raw_total += len(bitmap)
+        else:
+            payload = src[payload_start : payload_start + size]
+            raw_total += bitmap_size(page_width, page_height, two_bit)
+        stored_total += len(payload)
+
+        page = PAGE_HEADER.pack(page_magic, page_width, page_height, color, compression, len(payload), md5) + payload
+        new_entries.append((data_offset + len(pages), len(page), width, height))
+        pages += page
+
+    # Anything stored after the pages (thumbnails, chapters) moves with the end of the page data
+    shift = data_offset + len(pages) - data_end
+    for field in (METADATA_OFFSET, THUMB_OFFSET, CHAPTER_OFFSET):
+        if header[field] >= data_end:
+            header[field] += shift
+
+    out = bytearray(src[:data_offset])
+    out[: HEADER.size] = HEADER.pack(*header)
+    for i, entry in enumerate(new_entries):
+        PAGE_ENTRY.pack_into(out, table_offset + i * PAGE_ENTRY.size, *entry)
+    out += pages
+    out += src[data_end:]
+    with open(dst_path, "wb") as f:
+        f.write(out)
+
+    print(
+        f"{page_count} pages: {raw_total // max(page_count, 1)} -> {stored_total // max(page_count, 1)} bytes per page, "
+        f"file {len(src)} -> {len(out)} bytes"
+    )
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description="Compress the page bitmaps of an XTC/XTCH book")
+    parser.add_argument("input")
+    parser.add_argument("output")
+    parser.add_argument("--codec", choices=sorted(CODECS), default="deflate")
+    args = parser.parse_args()
+    compress_file(args.input, args.output, args.codec)
+
+
+if __name__ == "__main__":
+    main()
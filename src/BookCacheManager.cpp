@@ -0,0 +1,345 @@
+#include "BookCacheManager.h"
+
+#include <HalStorage.h>
+#include <Logging.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "CrossPointSettings.h"
+
+namespace {
+constexpr uint8_t CACHE_INDEX_FILE_VERSION = 1;
+constexpr char CACHE_ROOT[] = "/.crosspoint";
+constexpr char CACHE_INDEX_FILE[] = "/.crosspoint/cache_index.bin";
+constexpr uint16_t MAX_ENTRIES = 512;
+
+enum class Artifact : uint8_t { Section, Image, Cover, Other };
+
+bool startsWith(const std::string& s, const char* prefix) { return s.rfind(prefix, 0) == 0; }
+
+bool endsWith(const std::string& s, const char* suffix) {
+  const size_t len = strlen(suffix);
+  return s.size() >= len && s.compare(s.size() - len, len, suffix) == 0;
+}
+
+bool isBookCacheDir(const std::string& name) {
+  return startsWith(name, "epub_") || startsWith(name, "xtc_") || startsWith(name, "txt_");
+}
+
+// Layout caches (sections/, txt index.bin, leftover .tmp files), extracted images and their pixel caches, and cover
+// renders (BMPs and their sleep frames) can all be regenerated from the book file. Anything else is metadata or
+// progress and is kept.
+Artifact classify(const std::string& name, const bool isDir) {
+  if (isDir) {
+    return name == "sections" ? Artifact::Section : Artifact::Other;
+  }
+  if (name == "index.bin" || startsWith(name, ".tmp")) {
+    return Artifact::Section;
+  }
+  if (startsWith(name, "img_")) {
+    return Artifact::Image;
+  }
+  if (endsWith(name, ".bmp") || endsWith(name, ".pages") || startsWith(name, ".cover.")) {
+    return Artifact::Cover;
+  }
+  return Artifact::Other;
+}
+
+uint32_t directorySize(FsFile& dir) {
+  uint32_t total = 0;
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    total += file.isDirectory() ? directorySize(file) : static_cast<uint32_t>(file.size());
+    file.close();
+  }
+  return total;
+}
+}  // namespace
+
+BookCacheManager BookCacheManager::instance;
+
+BookCacheEntry* BookCacheManager::find(const std::string& cacheDir) {
+  auto it = std::find_if(entries.begin(), entries.end(),
+                         [&](const BookCacheEntry& entry) { return entry.cacheDir == cacheDir; });
+  return it == entries.end() ? nullptr : &*it;
+}
+
+void BookCacheManager::touch(const std::string& bookPath, const std::string& cacheDir) {
+  BookCacheEntry* entry = find(cacheDir);
+  if (!entry) {
+    entries.push_back({});
+    entry = &entries.back();
+    entry->cacheDir = cacheDir;
+  }
+  entry->bookPath = bookPath;
+  entry->lastUsed = ++useCounter;
+  entry->dirty = true;
+}
+
+void BookCacheManager::forget(const std::string& cacheDir) {
+  const auto it = std::remove_if(entries.begin(), entries.end(),
+                                 [&](const BookCacheEntry& entry) { return entry.cacheDir == cacheDir; });
+  if (it != entries.end()) {
+    entries.erase(it, entries.end());
+    saveToFile();
+  }
+}
+
+void BookCacheManager::clear() {
+  entries.clear();
+  saveToFile();
+}
+
+// Sync the index with the directories on disk: unknown cache directories are added as least recently used, and
+// entries whose directory is gone are dropped. Only the top level is listed here; sizes are left to refresh().
+void BookCacheManager::rebuild() {
+  auto root = Storage.open(CACHE_ROOT);
+  if (!root || !root.isDirectory()) {
+    if (root) root.close();
+    entries.clear();
+    return;
+  }
+
+  std::vector<std::string> onDisk;
+  char name[128];
+  for (auto file = root.openNextFile(); file; file = root.openNextFile()) {
+    file.getName(name, sizeof(name));
+    if (file.isDirectory() && isBookCacheDir(name)) {
+      onDisk.push_back(std::string(CACHE_ROOT) + "/" + name);
+    }
+    file.close();
+  }
+  root.close();
+
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [&](const BookCacheEntry& entry) {
+                                 return std::find(onDisk.begin(), onDisk.end(), entry.cacheDir) == onDisk.end();
+                               }),
+                entries.end());
+
+  for (const auto& dir : onDisk) {
+    if (entries.size() >= MAX_ENTRIES) {
+      break;
+    }
+    if (!find(dir)) {
+      BookCacheEntry entry;
+      entry.cacheDir = dir;
+      entries.push_back(std::move(entry));
+    }
+  }
+}
+
+void BookCacheManager::scan(BookCacheEntry& entry) {
+  entry.sectionBytes = entry.imageBytes = entry.coverBytes = entry.otherBytes = 0;
+  entry.dirty = false;
+
+  auto dir = Storage.open(entry.cacheDir.c_str());
+  if (!dir || !dir.isDirectory()) {
+    if (dir) dir.close();
+    return;
+  }
+
+  char name[128];
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    file.getName(name, sizeof(name));
+    const bool isDir = file.isDirectory();
+    const uint32_t size = isDir ? directorySize(file) : static_cast<uint32_t>(file.size());
+    file.close();
+
+    switch (classify(name, isDir)) {
+      case Artifact::Section:
+        entry.sectionBytes += size;
+        break;
+      case Artifact::Image:
+        entry.imageBytes += size;
+        break;
+      case Artifact::Cover:
+        entry.coverBytes += size;
+        break;
+      case Artifact::Other:
+        entry.otherBytes += size;
+        break;
+    }
+  }
+  dir.close();
+}
+
+// Delete everything in the book's cache directory that can be regenerated. Returns false if anything was left behind.
+bool BookCacheManager::evict(BookCacheEntry& entry) {
+  auto dir = Storage.open(entry.cacheDir.c_str());
+  if (!dir || !dir.isDirectory()) {
+    if (dir) dir.close();
+    return false;
+  }
+
+  // Collect first; removing entries while iterating the directory is not safe on FAT
+  std::vector<std::pair<std::string, bool>> victims;
+  char name[128];
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    file.getName(name, sizeof(name));
+    const bool isDir = file.isDirectory();
+    if (classify(name, isDir) != Artifact::Other) {
+      victims.emplace_back(name, isDir);
+    }
+    file.close();
+  }
+  dir.close();
+
+  bool ok = true;
+  for (const auto& victim : victims) {
+    const std::string path = entry.cacheDir + "/" + victim.first;
+    if (!(victim.second ? Storage.removeDir(path.c_str()) : Storage.remove(path.c_str()))) {
+      LOG_ERR("BCM", "Failed to remove %s", path.c_str());
+      ok = false;
+    }
+  }
+
+  entry.dirty = true;
+  return ok;
+}
+
+void BookCacheManager::refresh() {
+  rebuild();
+  for (auto& entry : entries) {
+    if (entry.dirty) {
+      scan(entry);
+    }
+  }
+}
+
+void BookCacheManager::enforceBudget(const std::string& keepCacheDir) {
+  // Trust the sizes stored in the index; only books opened since the last pass are rescanned. The cache root is
+  // listed only when there is no index yet.
+  if (entries.empty()) {
+    rebuild();
+  }
+  for (auto& entry : entries) {
+    if (entry.dirty) {
+      scan(entry);
+    }
+  }
+
+  const uint32_t budget = SETTINGS.getCacheBudgetBytes();
+  uint64_t total = getTotalBytes();
+  if (budget != 0 && total > budget) {
+    std::vector<BookCacheEntry*> order;
+    order.reserve(entries.size());
+    for (auto& entry : entries) {
+      if (entry.cacheDir != keepCacheDir && entry.evictableBytes() > 0) {
+        order.push_back(&entry);
+      }
+    }
+    std::sort(order.begin(), order.end(),
+              [](const BookCacheEntry* a, const BookCacheEntry* b) { return a->lastUsed < b->lastUsed; });
+
+    for (auto* entry : order) {
+      if (total <= budget) {
+        break;
+      }
+      const uint32_t before = entry->totalBytes();
+      if (evict(*entry)) {
+        entry->sectionBytes = entry->imageBytes = entry->coverBytes = 0;
+        entry->dirty = false;
+      } else {
+        scan(*entry);
+      }
+      total -= before - entry->totalBytes();
+      LOG_INF("BCM", "Evicted %s (%u bytes freed)", entry->cacheDir.c_str(), before - entry->totalBytes());
+    }
+
+    if (total > budget) {
+      LOG_INF("BCM", "Cache still over budget: %u KB used, %u KB allowed", static_cast<uint32_t>(total / 1024),
+              budget / 1024);
+    }
+  }
+
+  // The book being read keeps growing, so its sizes are stale again until the next refresh
+  if (BookCacheEntry* keep = find(keepCacheDir)) {
+    keep->dirty = true;
+  }
+  saveToFile();
+}
+
+uint64_t BookCacheManager::getTotalBytes() const {
+  uint64_t total = 0;
+  for (const auto& entry : entries) {
+    total += entry.totalBytes();
+  }
+  return total;
+}
+
+bool BookCacheManager::saveToFile() const {
+  // Make sure the directory exists
+  Storage.mkdir(CACHE_ROOT);
+
+  FsFile outputFile;
+  if (!Storage.openFileForWrite("BCM", CACHE_INDEX_FILE, outputFile)) {
+    return false;
+  }
+
+  serialization::writePod(outputFile, CACHE_INDEX_FILE_VERSION);
+  serialization::writePod(outputFile, useCounter);
+  const uint16_t count = static_cast<uint16_t>(std::min<size_t>(entries.size(), MAX_ENTRIES));
+  serialization::writePod(outputFile, count);
+
+  for (uint16_t i = 0; i < count; i++) {
+    const auto& entry = entries[i];
+    serialization::writeString(outputFile, entry.cacheDir);
+    serialization::writeString(outputFile, entry.bookPath);
+    serialization::writePod(outputFile, entry.lastUsed);
+    serialization::writePod(outputFile, entry.sectionBytes);
+    serialization::writePod(outputFile, entry.imageBytes);
+    serialization::writePod(outputFile, entry.coverBytes);
+    serialization::writePod(outputFile, entry.otherBytes);
+    serialization::writePod(outputFile, static_cast<uint8_t>(entry.dirty));
+  }
+
+  outputFile.close();
+  LOG_DBG("BCM", "Cache index saved to file (%d entries)", count);
+  return true;
+}
+
+bool BookCacheManager::loadFromFile() {
+  FsFile inputFile;
+  if (!Storage.openFileForRead("BCM", CACHE_INDEX_FILE, inputFile)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(inputFile, version);
+  if (version != CACHE_INDEX_FILE_VERSION) {
+    // Sizes are rescanned from disk on the next refresh
+    LOG_ERR("BCM", "Deserialization failed: Unknown version %u", version);
+    inputFile.close();
+    return false;
+  }
+
+  uint16_t count;
+  serialization::readPod(inputFile, useCounter);
+  serialization::readPod(inputFile, count);
+  if (count > MAX_ENTRIES) {
+    LOG_ERR("BCM", "Deserialization failed: Too many entries %u", count);
+    inputFile.close();
+    return false;
+  }
+
+  entries.clear();
+  entries.resize(count);
+  for (auto& entry : entries) {
+    uint8_t dirty;
+    serialization::readString(inputFile, entry.cacheDir);
+    serialization::readString(inputFile, entry.bookPath);
+    serialization::readPod(inputFile, entry.lastUsed);
+    serialization::readPod(inputFile, entry.sectionBytes);
+    serialization::readPod(inputFile, entry.imageBytes);
+    serialization::readPod(inputFile, entry.coverBytes);
+    serialization::readPod(inputFile, entry.otherBytes);
+    serialization::readPod(inputFile, dirty);
+    entry.dirty = dirty != 0;
+  }
+
+  inputFile.close();
+  LOG_DBG("BCM", "Cache index loaded from file (%d entries)", count);
+  return true;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sizes of one book's cache directory, split by what can be thrown away. Sections, images and covers are rebuilt on
+// demand; everything else (book.bin, progress.bin, css_rules.cache) is kept so the book reopens at the same place.
+struct BookCacheEntry {
+  std::string cacheDir;  // e.g. /.crosspoint/epub_1234
+  std::string bookPath;  // empty if the directory was found on disk before the book was opened
+  uint32_t lastUsed = 0;
+  uint32_t sectionBytes = 0;
+  uint32_t imageBytes = 0;
+  uint32_t coverBytes = 0;
+  uint32_t otherBytes = 0;
+  bool dirty = true;  // sizes need a rescan
+
+  uint32_t evictableBytes() const { return sectionBytes + imageBytes + coverBytes; }
+  uint32_t totalBytes() const { return evictableBytes() + otherBytes; }
+};
+
+// Keeps /.crosspoint under the size budget from the settings. Each book cache directory is tracked in a small index
+// with its artifact sizes and a use counter; when the total goes over budget, the bulky artifacts of the least
+// recently read books are deleted first.
+class BookCacheManager {
+  // Static instance
+  static BookCacheManager instance;
+
+  std::vector<BookCacheEntry> entries;
+  uint32_t useCounter = 0;
+
+  BookCacheEntry* find(const std::string& cacheDir);
+  void rebuild();
+  static void scan(BookCacheEntry& entry);
+  static bool evict(BookCacheEntry& entry);
+
+ public:
+  ~BookCacheManager() = default;
+
+  // Get singleton instance
+  static BookCacheManager& getInstance() { return instance; }
+
+  // Mark a book's cache as most recently used. Its sizes are rescanned on the next refresh.
+  void touch(const std::string& bookPath, const std::string& cacheDir);
+
+  // Drop a cache directory from the index after it was removed elsewhere
+  void forget(const std::string& cacheDir);
+  void clear();
+
+  // Rescan entries whose sizes may have changed
+  void refresh();
+
+  // Evict least recently used books until the cache fits the budget. keepCacheDir is never evicted. Works from the
+  // index sizes, so it is cheap but not free; call it when a book is closed, not while one is being opened.
+  void enforceBudget(const std::string& keepCacheDir = "");
+
+  const std::vector<BookCacheEntry>& getEntries() const { return entries; }
+  uint64_t getTotalBytes() const;
+
+  bool saveToFile() const;
+  bool loadFromFile();
+};
+
+// Helper macro to access the book cache manager
+#define BOOK_CACHE BookCacheManager::getInstance()
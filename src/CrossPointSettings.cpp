@@ -134,6 +134,8 @@ uint8_t CrossPointSettings::writeSettings(FsFile& file, bool count_only) const {
   writer.writeItem(file, frontButtonRight);
   writer.writeItem(file, fadingFix);
   writer.writeItem(file, embeddedStyle);
+  writer.writeItem(file, cacheBudget);
+  writer.writeItem(file, pageBitmapCache);
   // New fields need to be added at end for backward compatibility
 
   return writer.item_count;
@@ -261,6 +263,10 @@ bool CrossPointSettings::loadFromFile() {
     if (++settingsRead >= fileSettingsCount) break;
     serialization::readPod(inputFile, embeddedStyle);
     if (++settingsRead >= fileSettingsCount) break;
+    readAndValidate(inputFile, cacheBudget, CACHE_BUDGET_COUNT);
+    if (++settingsRead >= fileSettingsCount) break;
+    serialization::readPod(inputFile, pageBitmapCache);
+    if (++settingsRead >= fileSettingsCount) break;
     // New fields added at end for backward compatibility
   } while (false);
 
@@ -327,6 +333,24 @@ unsigned long CrossPointSettings::getSleepTimeoutMs() const {
   }
 }
 
+uint32_t CrossPointSettings::getCacheBudgetBytes() const {
+  switch (cacheBudget) {
+    case CACHE_64MB:
+      return 64UL * 1024 * 1024;
+    case CACHE_128MB:
+      return 128UL * 1024 * 1024;
+    case CACHE_256MB:
+    default:
+      return 256UL * 1024 * 1024;
+    case CACHE_512MB:
+      return 512UL * 1024 * 1024;
+    case CACHE_1GB:
+      return 1024UL * 1024 * 1024;
+    case CACHE_UNLIMITED:
+      return 0;
+  }
+}
+
 int CrossPointSettings::getRefreshFrequency() const {
   switch (refreshFrequency) {
     case REFRESH_1:
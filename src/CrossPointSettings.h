@@ -113,6 +113,17 @@ class CrossPointSettings {
     REFRESH_FREQUENCY_COUNT
   };
 
+  // Size budget for the book cache directory
+  enum CACHE_BUDGET {
+    CACHE_64MB = 0,
+    CACHE_128MB = 1,
+    CACHE_256MB = 2,
+    CACHE_512MB = 3,
+    CACHE_1GB = 4,
+    CACHE_UNLIMITED = 5,
+    CACHE_BUDGET_COUNT
+  };
+
   // Short power button press actions
   enum SHORT_PWRBTN { IGNORE = 0, SLEEP = 1, PAGE_TURN = 2, SHORT_PWRBTN_COUNT };
 
@@ -174,6 +185,10 @@ class CrossPointSettings {
   uint8_t fadingFix = 0;
   // Use book's embedded CSS styles for EPUB rendering (1 = enabled, 0 = disabled)
   uint8_t embeddedStyle = 1;
+  // Book cache size budget, enforced by BookCacheManager
+  uint8_t cacheBudget = CACHE_256MB;
+  // Pre-render reader pages in idle time into a bitmap cache next to each section file
+  uint8_t pageBitmapCache = 0;
 
   ~CrossPointSettings() = default;
 
@@ -193,6 +208,8 @@ class CrossPointSettings {
 
   float getReaderLineCompression() const;
   unsigned long getSleepTimeoutMs() const;
+  // 0 means no budget
+  uint32_t getCacheBudgetBytes() const;
   int getRefreshFrequency() const;
 };
 
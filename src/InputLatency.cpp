@@ -0,0 +1,64 @@
+#include "InputLatency.h"
+
+#include <Logging.h>
+
+#include <cstdio>
+
+InputLatency InputLatency::instance;
+
+void InputLatency::onInput(const unsigned long nowUs) {
+  pendingSinceUs = nowUs;
+  pending = true;
+}
+
+void InputLatency::onRenderStart(const unsigned long nowUs) {
+  if (!pending.exchange(false)) {
+    return;
+  }
+  const unsigned long latencyUs = nowUs - pendingSinceUs;
+  if (latencyUs > MAX_LATENCY_US) {
+    return;
+  }
+
+  size_t bucket = 0;
+  while (bucket < BUCKET_COUNT - 1 && latencyUs >= BUCKET_LIMITS_MS[bucket] * 1000UL) {
+    bucket++;
+  }
+  buckets[bucket]++;
+  samples++;
+  totalUs += latencyUs;
+  if (latencyUs > maxUs) {
+    maxUs = latencyUs;
+  }
+}
+
+void InputLatency::log(const bool force) {
+  if (!force && samples == loggedSamples) {
+    return;
+  }
+  loggedSamples = samples;
+
+  // e.g. "<5:12 <10:30 <20:4 <50:1 <100:0 <200:0 >=200:0"
+  char histogram[96];
+  size_t used = 0;
+  for (size_t i = 0; i < BUCKET_COUNT && used < sizeof(histogram); i++) {
+    const bool last = i == BUCKET_COUNT - 1;
+    used += snprintf(histogram + used, sizeof(histogram) - used, "%s%s%u:%u", i > 0 ? " " : "", last ? ">=" : "<",
+                     static_cast<unsigned>(BUCKET_LIMITS_MS[last ? i - 1 : i]), static_cast<unsigned>(buckets[i]));
+  }
+  LOG_INF("LAT", "Input to render (ms) %s | n=%u mean=%.1f max=%.1f skipped=%u", histogram,
+          static_cast<unsigned>(samples), getMeanUs() / 1000.0f, maxUs / 1000.0f,
+          static_cast<unsigned>(pagesSkipped));
+}
+
+void InputLatency::reset() {
+  pending = false;
+  for (auto& bucket : buckets) {
+    bucket = 0;
+  }
+  samples = 0;
+  loggedSamples = 0;
+  maxUs = 0;
+  totalUs = 0;
+  pagesSkipped = 0;
+}
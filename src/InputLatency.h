@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Time from a button edge to the start of the render it caused, collected into a histogram and printed through the
+// log. The ladder buttons are sampled by the main loop, so their samples start when the edge was seen, not pressed.
+class InputLatency {
+  // Static instance
+  static InputLatency instance;
+
+ public:
+  // Upper bounds of the buckets in ms, the last bucket takes everything slower
+  static constexpr uint16_t BUCKET_LIMITS_MS[] = {5, 10, 20, 50, 100, 200};
+  static constexpr size_t BUCKET_COUNT = sizeof(BUCKET_LIMITS_MS) / sizeof(BUCKET_LIMITS_MS[0]) + 1;
+  // An edge with no render this long after it did not cause one, and is dropped
+  static constexpr unsigned long MAX_LATENCY_US = 1000000;
+
+  // Get singleton instance
+  static InputLatency& getInstance() { return instance; }
+
+  // A button edge was seen at nowUs; a later edge replaces one that has not been rendered yet
+  void onInput(unsigned long nowUs);
+  // A render task starts drawing. Records a sample if an edge is waiting for it.
+  void onRenderStart(unsigned long nowUs);
+  // A render landed several page turns ahead; the pages in between were never shown
+  void onPagesSkipped(uint32_t pages) { pagesSkipped += pages; }
+
+  uint32_t getSampleCount() const { return samples; }
+  uint32_t getBucket(const size_t index) const { return index < BUCKET_COUNT ? buckets[index] : 0; }
+  uint32_t getMaxUs() const { return maxUs; }
+  uint32_t getMeanUs() const { return samples > 0 ? static_cast<uint32_t>(totalUs / samples) : 0; }
+  uint32_t getPagesSkipped() const { return pagesSkipped; }
+
+  // Print the histogram as one LAT line if samples were added since the last call, or always with force
+  void log(bool force = false);
+  void reset();
+
+ private:
+  // Written by the main loop, read and cleared by render tasks
+  std::atomic<bool> pending{false};
+  std::atomic<unsigned long> pendingSinceUs{0};
+
+  uint32_t buckets[BUCKET_COUNT] = {};
+  uint32_t samples = 0;
+  uint32_t loggedSamples = 0;
+  uint32_t maxUs = 0;
+  uint64_t totalUs = 0;
+  std::atomic<uint32_t> pagesSkipped{0};
+};
+
+// Helper macro to access the input latency histogram
+#define INPUT_LATENCY InputLatency::getInstance()
@@ -0,0 +1,164 @@
+#include "PageSnapshot.h"
+
+#include <HalStorage.h>
+#include <Logging.h>
+#include <PackBits.h>
+#include <Serialization.h>
+
+namespace {
+constexpr uint8_t PAGE_SNAPSHOT_FILE_VERSION = 1;
+constexpr char PAGE_SNAPSHOT_FILE[] = "/.crosspoint/page_snapshot.bin";
+}  // namespace
+
+PageSnapshot PageSnapshot::instance;
+
+bool PageSnapshot::save(GfxRenderer& renderer, const std::string& bookPath, const uint16_t spineIndex,
+                        const uint16_t pageIndex, const bool grayscale,
+                        const std::function<void(GfxRenderer::RenderMode)>& renderPlane) const {
+  [[maybe_unused]] const auto start = millis();
+
+  // Make sure the directory exists
+  Storage.mkdir("/.crosspoint");
+
+  FsFile file;
+  if (!Storage.openFileForWrite("SNP", PAGE_SNAPSHOT_FILE, file)) {
+    return false;
+  }
+
+  serialization::writePod(file, PAGE_SNAPSHOT_FILE_VERSION);
+  serialization::writeString(file, bookPath);
+  serialization::writePod(file, spineIndex);
+  serialization::writePod(file, pageIndex);
+  const uint8_t planeCount = grayscale ? 3 : 1;
+  serialization::writePod(file, planeCount);
+
+  // BW last, so the frame buffer ends up holding it
+  static constexpr GfxRenderer::RenderMode planeOrder[] = {GfxRenderer::GRAYSCALE_LSB, GfxRenderer::GRAYSCALE_MSB,
+                                                           GfxRenderer::BW};
+  uint32_t totalBytes = 0;
+  for (const auto mode : planeOrder) {
+    if (mode != GfxRenderer::BW && !grayscale) {
+      continue;
+    }
+    renderPlane(mode);
+    renderer.setRenderMode(GfxRenderer::BW);
+
+    // Reserve the size field and fill it in once the plane is written
+    const size_t sizePos = file.position();
+    uint32_t compressedSize = 0;
+    serialization::writePod(file, compressedSize);
+    // Deflate compresses text pages about 2.5x better, but tdefl needs well over 100 KB of state at the moment the
+    // reader goes to sleep; PackBits needs none and decodes straight into the frame buffer
+    PackBits::Writer writer(file);
+    writer.encode(renderer.getFrameBuffer(), GfxRenderer::getBufferSize());
+    compressedSize = writer.flush();
+    const size_t endPos = file.position();
+    file.seek(sizePos);
+    serialization::writePod(file, compressedSize);
+    file.seek(endPos);
+    totalBytes += compressedSize;
+  }
+
+  file.close();
+  LOG_DBG("SNP", "Saved page snapshot of %s (%d planes, %u bytes) in %lu ms", bookPath.c_str(), planeCount, totalBytes,
+          millis() - start);
+  return true;
+}
+
+bool PageSnapshot::show(const GfxRenderer& renderer, const std::string& bookPath) {
+  [[maybe_unused]] const auto start = millis();
+  FsFile file;
+  if (!Storage.openFileForRead("SNP", PAGE_SNAPSHOT_FILE, file)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(file, version);
+  if (version != PAGE_SNAPSHOT_FILE_VERSION) {
+    LOG_ERR("SNP", "Deserialization failed: Unknown version %u", version);
+    file.close();
+    discard();
+    return false;
+  }
+
+  std::string path;
+  uint16_t spineIndex, pageIndex;
+  uint8_t planeCount;
+  serialization::readString(file, path);
+  serialization::readPod(file, spineIndex);
+  serialization::readPod(file, pageIndex);
+  serialization::readPod(file, planeCount);
+  if (path != bookPath || (planeCount != 1 && planeCount != 3)) {
+    LOG_DBG("SNP", "Snapshot is for %s, not %s", path.c_str(), bookPath.c_str());
+    file.close();
+    discard();
+    return false;
+  }
+
+  // Stored as LSB, MSB, BW: the grayscale planes are skipped for the first refresh and read back afterwards
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  const size_t bufferSize = GfxRenderer::getBufferSize();
+  const size_t grayPos = file.position();
+  uint32_t compressedSize;
+  for (uint8_t i = 1; i < planeCount; i++) {
+    serialization::readPod(file, compressedSize);
+    file.seek(file.position() + compressedSize);
+  }
+  const size_t bwPos = file.position();
+  serialization::readPod(file, compressedSize);
+  bool ok = PackBits::decode(file, compressedSize, frameBuffer, bufferSize);
+  if (ok) {
+    renderer.displayBuffer(HalDisplay::HALF_REFRESH);
+    LOG_DBG("SNP", "Page on screen after %lu ms", millis() - start);
+  }
+
+  if (ok && planeCount == 3) {
+    file.seek(grayPos);
+    serialization::readPod(file, compressedSize);
+    ok = PackBits::decode(file, compressedSize, frameBuffer, bufferSize);
+    if (ok) {
+      renderer.copyGrayscaleLsbBuffers();
+      serialization::readPod(file, compressedSize);
+      ok = PackBits::decode(file, compressedSize, frameBuffer, bufferSize);
+    }
+    if (ok) {
+      renderer.copyGrayscaleMsbBuffers();
+      renderer.displayGrayBuffer();
+    }
+
+    // The BW plane has to be back in the frame buffer and the controller either way
+    file.seek(bwPos);
+    serialization::readPod(file, compressedSize);
+    if (PackBits::decode(file, compressedSize, frameBuffer, bufferSize)) {
+      renderer.cleanupGrayscaleWithFrameBuffer();
+    } else {
+      ok = false;
+    }
+  }
+
+  file.close();
+  discard();
+  if (!ok) {
+    LOG_ERR("SNP", "Page snapshot is corrupt");
+    return false;
+  }
+
+  shownBookPath = bookPath;
+  shownSpineIndex = spineIndex;
+  shownPageIndex = pageIndex;
+  return true;
+}
+
+bool PageSnapshot::takeShown(const std::string& bookPath, const int spineIndex, const int pageIndex) {
+  const bool match = shownSpineIndex == spineIndex && shownPageIndex == pageIndex && shownBookPath == bookPath;
+  shownBookPath.clear();
+  shownSpineIndex = -1;
+  shownPageIndex = -1;
+  return match;
+}
+
+void PageSnapshot::discard() const {
+  if (Storage.exists(PAGE_SNAPSHOT_FILE)) {
+    Storage.remove(PAGE_SNAPSHOT_FILE);
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <GfxRenderer.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Last reader page, saved when the device goes to sleep so a power button wake can put it straight back on the panel
+// before fonts, books and activities are loaded. The BW plane and, with anti-aliasing, the two grayscale planes are
+// stored PackBits compressed in native panel layout, roughly 35 KB for a dense BW text page and much less for sparse ones.
+class PageSnapshot {
+  // Static instance
+  static PageSnapshot instance;
+
+  std::string shownBookPath;
+  int shownSpineIndex = -1;
+  int shownPageIndex = -1;
+
+ public:
+  ~PageSnapshot() = default;
+
+  // Get singleton instance
+  static PageSnapshot& getInstance() { return instance; }
+
+  // renderPlane(mode) must clear the frame buffer and draw the page for that render mode. BW is always saved; the
+  // grayscale planes only if grayscale is set. The frame buffer is left holding the BW plane.
+  bool save(GfxRenderer& renderer, const std::string& bookPath, uint16_t spineIndex, uint16_t pageIndex,
+            bool grayscale, const std::function<void(GfxRenderer::RenderMode)>& renderPlane) const;
+
+  // Push the saved page of bookPath to the panel. The snapshot is removed either way, so it is shown at most once.
+  bool show(const GfxRenderer& renderer, const std::string& bookPath);
+
+  // True once if the page about to be rendered is the one show() put on the panel; the reader can then skip the
+  // refresh and only rebuild its frame buffer
+  bool takeShown(const std::string& bookPath, int spineIndex, int pageIndex);
+
+  void discard() const;
+};
+
+// Helper macro to access the page snapshot
+#define PAGE_SNAPSHOT PageSnapshot::getInstance()
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+
+#include "InputLatency.h"
+
+// Page turns made by the input loop that the render task has not picked up yet. Only the net count is kept, so turns
+// made while a page is still refreshing collapse into a single jump instead of each loading and refreshing a page.
+class PageTurnQueue {
+ public:
+  // Input side: one turn, positive is forward
+  void push(const int direction) { pending += direction; }
+  void clear() { pending = 0; }
+  bool empty() const { return pending == 0; }
+
+  // Render side: net turns since the last call, 0 if none. Pages turned past without being shown are added to the
+  // input latency stats.
+  int take() {
+    const int turns = pending.exchange(0);
+    if (turns > 1 || turns < -1) {
+      INPUT_LATENCY.onPagesSkipped(std::abs(turns) - 1);
+    }
+    return turns;
+  }
+
+ private:
+  std::atomic<int> pending{0};
+};
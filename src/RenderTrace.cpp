@@ -0,0 +1,29 @@
+#include "RenderTrace.h"
+
+RenderTrace RenderTrace::instance;
+
+void RenderTrace::onRenderStart(const unsigned long nowUs, const bool render) {
+  coveredRequests = requests.load();
+  if (!render) {
+    return;
+  }
+  rendering = true;
+  renderStartedAt = nowUs;
+  if (markPending.exchange(false)) {
+    markedRenderStart = nowUs;
+  }
+}
+
+void RenderTrace::onRenderEnd(const unsigned long nowUs) {
+  renderMicros += static_cast<uint32_t>(nowUs) - renderStartedAt;
+  ++renders;
+  rendering = false;
+}
+
+bool RenderTrace::getMarkedRenderStart(uint32_t& us) const {
+  if (markPending) {
+    return false;
+  }
+  us = markedRenderStart;
+  return true;
+}
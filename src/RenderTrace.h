@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Counters shared by the render tasks, so an observer can tell when the UI has settled and what the work since its
+// last look cost. Times are cumulative microseconds in uint32_t: they wrap after 71 minutes, deltas stay correct.
+class RenderTrace {
+  // Static instance
+  static RenderTrace instance;
+
+  std::atomic<uint32_t> requests{0};
+  // Value of requests when the latest render started, every request up to it is covered by that render
+  std::atomic<uint32_t> coveredRequests{0};
+  std::atomic<bool> rendering{false};
+  std::atomic<uint32_t> renders{0};
+  std::atomic<uint32_t> renderMicros{0};
+  std::atomic<uint32_t> saveMicros{0};
+  std::atomic<uint32_t> renderStartedAt{0};
+  std::atomic<bool> markPending{false};
+  std::atomic<uint32_t> markedRenderStart{0};
+
+ public:
+  // Get singleton instance
+  static RenderTrace& getInstance() { return instance; }
+
+  // Activity::requestUpdate() notified a render task
+  void onRequest() { ++requests; }
+  // A render task woke up for all requests made so far; render says whether it actually draws
+  void onRenderStart(unsigned long nowUs, bool render = true);
+  void onRenderEnd(unsigned long nowUs);
+  // Time spent writing reading progress or other state to the SD card as part of a render
+  void addSaveTime(const unsigned long us) { saveMicros += us; }
+
+  // Remember the start of the next render, to time it against an input
+  void mark() { markPending = true; }
+  // Start time of the first render after mark(), false if none has started yet
+  bool getMarkedRenderStart(uint32_t& us) const;
+
+  // No render running and none requested
+  bool isIdle() const { return !rendering && coveredRequests == requests; }
+  uint32_t getRenderCount() const { return renders; }
+  uint32_t getRenderMicros() const { return renderMicros; }
+  uint32_t getSaveMicros() const { return saveMicros; }
+};
+
+// Helper macro to access the render trace
+#define RENDER_TRACE RenderTrace::getInstance()
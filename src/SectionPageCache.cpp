@@ -0,0 +1,193 @@
+#include "SectionPageCache.h"
+
+#include <Logging.h>
+#include <PackBits.h>
+#include <Serialization.h>
+
+#include <cstring>
+
+namespace {
+constexpr uint8_t SECTION_PAGE_CACHE_VERSION = 1;
+constexpr size_t HEADER_SIZE = sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t);
+constexpr GfxRenderer::RenderMode PLANE_ORDER[] = {GfxRenderer::BW, GfxRenderer::GRAYSCALE_LSB,
+                                                   GfxRenderer::GRAYSCALE_MSB};
+}  // namespace
+
+std::string SectionPageCache::pathFor(const std::string& sectionFilePath) {
+  const size_t dot = sectionFilePath.rfind('.');
+  const size_t slash = sectionFilePath.rfind('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return sectionFilePath + ".pages";
+  }
+  return sectionFilePath.substr(0, dot) + ".pages";
+}
+
+size_t SectionPageCache::tableOffset() const { return HEADER_SIZE; }
+
+bool SectionPageCache::open(const std::string& path, const uint32_t key, const uint16_t pageCount,
+                            const bool grayscale) {
+  close();
+  const uint8_t wantedPlanes = grayscale ? 3 : 1;
+
+  if (Storage.exists(path.c_str())) {
+    file = Storage.open(path.c_str(), O_RDWR);
+    if (file && file.size() >= tableOffset() + pageCount * sizeof(uint32_t)) {
+      uint8_t version;
+      uint32_t fileKey;
+      uint16_t filePageCount;
+      uint8_t filePlanes;
+      serialization::readPod(file, version);
+      serialization::readPod(file, fileKey);
+      serialization::readPod(file, filePageCount);
+      serialization::readPod(file, filePlanes);
+      if (version == SECTION_PAGE_CACHE_VERSION && fileKey == key && filePageCount == pageCount &&
+          filePlanes == wantedPlanes) {
+        offsets.resize(pageCount);
+        const int bytes = file.read(offsets.data(), pageCount * sizeof(uint32_t));
+        if (bytes == static_cast<int>(pageCount * sizeof(uint32_t))) {
+          planeCount = filePlanes;
+          return true;
+        }
+      }
+    }
+    LOG_DBG("SPC", "Page cache %s is stale, starting over", path.c_str());
+    file.close();
+  }
+
+  file = Storage.open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+  if (!file) {
+    LOG_ERR("SPC", "Failed to open page cache %s", path.c_str());
+    offsets.clear();
+    return false;
+  }
+  serialization::writePod(file, SECTION_PAGE_CACHE_VERSION);
+  serialization::writePod(file, key);
+  serialization::writePod(file, pageCount);
+  serialization::writePod(file, wantedPlanes);
+  offsets.assign(pageCount, 0);
+  const size_t tableSize = pageCount * sizeof(uint32_t);
+  if (file.write(reinterpret_cast<const uint8_t*>(offsets.data()), tableSize) != tableSize) {
+    LOG_ERR("SPC", "Failed to write page cache header %s", path.c_str());
+    close();
+    return false;
+  }
+  planeCount = wantedPlanes;
+  return true;
+}
+
+void SectionPageCache::close() {
+  if (file) {
+    file.close();
+  }
+  offsets.clear();
+  planeCount = 0;
+}
+
+uint8_t SectionPageCache::getFlags(const uint16_t pageIndex) {
+  if (!has(pageIndex) || !file.seek(offsets[pageIndex])) {
+    return 0;
+  }
+  uint8_t flags = 0;
+  serialization::readPod(file, flags);
+  return flags;
+}
+
+int SectionPageCache::nextMissing(const uint16_t from) const {
+  const size_t count = offsets.size();
+  for (size_t i = 0; i < count; i++) {
+    const size_t pageIndex = (from + i) % count;
+    if (offsets[pageIndex] == 0) {
+      return static_cast<int>(pageIndex);
+    }
+  }
+  return -1;
+}
+
+bool SectionPageCache::store(GfxRenderer& renderer, const uint16_t pageIndex, const uint8_t flags,
+                             const std::function<void(GfxRenderer::RenderMode)>& renderPlane) {
+  if (!file || pageIndex >= offsets.size()) {
+    return false;
+  }
+  [[maybe_unused]] const auto start = millis();
+
+  const uint32_t recordOffset = static_cast<uint32_t>(file.size());
+  if (!file.seek(recordOffset)) {
+    return false;
+  }
+  serialization::writePod(file, flags);
+  // Reserve the size fields and fill them in once the planes are written
+  const size_t sizesPos = file.position();
+  uint32_t sizes[3] = {};
+  for (uint8_t i = 0; i < planeCount; i++) {
+    serialization::writePod(file, sizes[i]);
+  }
+
+  uint32_t totalBytes = 0;
+  for (uint8_t i = 0; i < planeCount; i++) {
+    renderPlane(PLANE_ORDER[i]);
+    renderer.setRenderMode(GfxRenderer::BW);
+    PackBits::Writer writer(file);
+    writer.encode(renderer.getFrameBuffer(), GfxRenderer::getBufferSize());
+    sizes[i] = writer.flush();
+    totalBytes += sizes[i];
+  }
+
+  const size_t endPos = file.position();
+  if (endPos != sizesPos + planeCount * sizeof(uint32_t) + totalBytes) {
+    // Short write, most likely a full card. The page stays uncached, the partial record is dead space until the
+    // cache starts over.
+    LOG_ERR("SPC", "Failed to write page %u", pageIndex);
+    return false;
+  }
+  file.seek(sizesPos);
+  for (uint8_t i = 0; i < planeCount; i++) {
+    serialization::writePod(file, sizes[i]);
+  }
+  file.seek(tableOffset() + pageIndex * sizeof(uint32_t));
+  serialization::writePod(file, recordOffset);
+  file.flush();
+  offsets[pageIndex] = recordOffset;
+
+  LOG_DBG("SPC", "Cached page %u (%u planes, %u bytes) in %lu ms", pageIndex, planeCount, totalBytes,
+          millis() - start);
+  return true;
+}
+
+bool SectionPageCache::drawPlane(const GfxRenderer& renderer, const uint16_t pageIndex,
+                                 const GfxRenderer::RenderMode mode) {
+  if (!has(pageIndex)) {
+    return false;
+  }
+  uint8_t plane = 0;
+  while (plane < planeCount && PLANE_ORDER[plane] != mode) {
+    plane++;
+  }
+  if (plane == planeCount) {
+    return false;
+  }
+
+  uint32_t sizes[3] = {};
+  if (!file.seek(offsets[pageIndex] + sizeof(uint8_t))) {
+    return false;
+  }
+  for (uint8_t i = 0; i < planeCount; i++) {
+    serialization::readPod(file, sizes[i]);
+  }
+  uint32_t planeOffset = offsets[pageIndex] + sizeof(uint8_t) + planeCount * sizeof(uint32_t);
+  for (uint8_t i = 0; i < plane; i++) {
+    planeOffset += sizes[i];
+  }
+
+  // The plane decodes straight into the frame buffer, which the panel may still be reading from
+  renderer.waitForDisplay();
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  if (!file.seek(planeOffset) ||
+      !PackBits::decode(file, sizes[plane], frameBuffer, GfxRenderer::getBufferSize())) {
+    LOG_ERR("SPC", "Cached page %u is corrupt", pageIndex);
+    // Forget the record, the idle fill renders the page again
+    offsets[pageIndex] = 0;
+    memset(frameBuffer, mode == GfxRenderer::BW ? 0xFF : 0x00, GfxRenderer::getBufferSize());
+    return false;
+  }
+  return true;
+}
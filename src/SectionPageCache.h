@@ -0,0 +1,68 @@
+#pragma once
+#include <GfxRenderer.h>
+#include <HalStorage.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Rendered pages of one section, stored next to its section file. The reader fills it in idle time from Page::render
+// output and draws cached pages back by decoding their planes straight into the frame buffer, so a page turn costs an
+// SD read instead of rasterizing every glyph again (three times over with anti-aliasing). Planes are PackBits
+// compressed in native panel layout like PageSnapshot, 10-35 KB per text page.
+//
+// File layout: version, key, page count, plane count, then one u32 record offset per page (0 while the page is not
+// cached). Records are appended as pages come in: flags, the compressed size of each plane, then the planes in BW, LSB,
+// MSB order. The offset is written after its record, so an interrupted write leaves the page uncached.
+class SectionPageCache {
+ public:
+  static constexpr uint8_t FLAG_HAS_IMAGES = 1;
+
+  SectionPageCache() = default;
+  ~SectionPageCache() { close(); }
+
+  // Disable copy
+  SectionPageCache(const SectionPageCache&) = delete;
+  SectionPageCache& operator=(const SectionPageCache&) = delete;
+
+  static std::string pathFor(const std::string& sectionFilePath);
+
+  /**
+   * Open the cache file, starting it over if it was written with a different key or page count.
+   * @param key Identifies everything that changes the pixels of a page: layout settings, orientation, margins, fonts
+   * @param grayscale Whether the anti-aliasing planes are stored as well
+   */
+  bool open(const std::string& path, uint32_t key, uint16_t pageCount, bool grayscale);
+  void close();
+  bool isOpen() const { return static_cast<bool>(file); }
+
+  bool has(uint16_t pageIndex) const { return pageIndex < offsets.size() && offsets[pageIndex] != 0; }
+  bool hasGrayscale() const { return planeCount == 3; }
+  // Flags a cached page was stored with
+  uint8_t getFlags(uint16_t pageIndex);
+  // First page without a record, starting at from and wrapping around, or -1 once every page is cached
+  int nextMissing(uint16_t from) const;
+
+  /**
+   * Store a page. renderPlane(mode) must clear the frame buffer and draw the page for that render mode. The frame
+   * buffer is left holding the last plane drawn.
+   */
+  bool store(GfxRenderer& renderer, uint16_t pageIndex, uint8_t flags,
+             const std::function<void(GfxRenderer::RenderMode)>& renderPlane);
+
+  /**
+   * Decode one plane of a cached page into the frame buffer, replacing what it held. Waits for a refresh still in
+   * progress before the frame buffer is touched, like clearScreen().
+   */
+  bool drawPlane(const GfxRenderer& renderer, uint16_t pageIndex, GfxRenderer::RenderMode mode);
+
+  uint32_t getFileSize() { return file ? static_cast<uint32_t>(file.size()) : 0; }
+
+ private:
+  FsFile file;
+  std::vector<uint32_t> offsets;
+  uint8_t planeCount = 0;
+
+  size_t tableOffset() const;
+};
@@ -0,0 +1,181 @@
+#include "SerialAutomation.h"
+
+#include <Arduino.h>
+#include <HalGPIO.h>
+#include <Logging.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "InputLatency.h"
+#include "RenderTrace.h"
+
+namespace {
+constexpr size_t MAX_LINE_LENGTH = 256;
+
+struct ButtonName {
+  const char* name;
+  uint8_t index;
+};
+constexpr ButtonName BUTTON_NAMES[] = {
+    {"BACK", HalGPIO::BTN_BACK}, {"CONFIRM", HalGPIO::BTN_CONFIRM}, {"LEFT", HalGPIO::BTN_LEFT},
+    {"RIGHT", HalGPIO::BTN_RIGHT}, {"UP", HalGPIO::BTN_UP},         {"DOWN", HalGPIO::BTN_DOWN},
+    {"POWER", HalGPIO::BTN_POWER},
+};
+
+int parseButton(const std::string& name) {
+  for (const auto& button : BUTTON_NAMES) {
+    if (name == button.name) {
+      return button.index;
+    }
+  }
+  return -1;
+}
+}  // namespace
+
+void SerialAutomation::poll() {
+  while (serial.available() > 0) {
+    const int c = serial.read();
+    if (c < 0) {
+      break;
+    }
+    if (c == '\r') {
+      continue;
+    }
+    if (c != '\n') {
+      if (line.size() < MAX_LINE_LENGTH) {
+        line += static_cast<char>(c);
+      }
+      continue;
+    }
+    if (line.compare(0, 4, "CMD:") == 0) {
+      handle(line.substr(4));
+    }
+    line.clear();
+  }
+
+  if (tapButton >= 0) {
+    if (tapSeen && static_cast<long>(millis() - tapReleaseAt) >= 0) {
+      releaseTap();
+    } else {
+      tapSeen = true;
+    }
+  }
+  if (waiting) {
+    checkIdle();
+  }
+}
+
+void SerialAutomation::handle(const std::string& command) {
+  const size_t space = command.find(' ');
+  const std::string name = command.substr(0, space);
+  std::string argument = space == std::string::npos ? "" : command.substr(space + 1);
+  while (!argument.empty() && argument.back() == ' ') {
+    argument.pop_back();
+  }
+
+  if (name == "SCREENSHOT") {
+    screenshot();
+  } else if (name == "VERSION") {
+    serial.printf("VERSION:%s\n", version);
+  } else if (name == "LATENCY") {
+    INPUT_LATENCY.log(true);
+    serial.printf("OK:LATENCY\n");
+  } else if (name == "PRESS" || name == "RELEASE" || name == "TAP") {
+    const size_t argSpace = argument.find(' ');
+    const int button = parseButton(argument.substr(0, argSpace));
+    if (button < 0) {
+      serial.printf("ERR:Unknown button '%s'\n", argument.c_str());
+      return;
+    }
+    releaseTap();
+    if (name == "RELEASE") {
+      setButton(button, false);
+    } else {
+      pressButton(button);
+      if (name == "TAP") {
+        tapButton = button;
+        tapSeen = false;
+        const char* holdArg = argSpace == std::string::npos ? "0" : argument.c_str() + argSpace;
+        tapReleaseAt = millis() + strtoul(holdArg, nullptr, 10);
+      }
+    }
+    serial.printf("OK:%s\n", name.c_str());
+  } else if (name == "OPEN") {
+    if (argument.empty() || !openBook) {
+      serial.printf("ERR:OPEN needs a path\n");
+      return;
+    }
+    openBook(argument);
+    serial.printf("OK:OPEN\n");
+  } else if (name == "WAIT_IDLE") {
+    waiting = true;
+    waitStartedAt = millis();
+    waitTimeoutMs = argument.empty() ? DEFAULT_IDLE_TIMEOUT_MS : strtoul(argument.c_str(), nullptr, 10);
+    idle = false;
+  } else {
+    serial.printf("ERR:Unknown command '%s'\n", name.c_str());
+  }
+}
+
+void SerialAutomation::pressButton(const int button) {
+  if (!stepHasInput) {
+    stepHasInput = true;
+    stepInputUs = micros();
+    RENDER_TRACE.mark();
+  }
+  setButton(button, true);
+}
+
+void SerialAutomation::releaseTap() {
+  if (tapButton >= 0) {
+    setButton(tapButton, false);
+    tapButton = -1;
+  }
+}
+
+void SerialAutomation::checkIdle() {
+  const unsigned long now = millis();
+  if (!RENDER_TRACE.isIdle() || display.isBusy() || tapButton >= 0) {
+    idle = false;
+  } else if (!idle) {
+    idle = true;
+    idleSince = now;
+  }
+
+  const bool settled = idle && now - idleSince >= IDLE_SETTLE_MS;
+  const bool timedOut = now - waitStartedAt >= waitTimeoutMs;
+  if (!settled && !timedOut) {
+    return;
+  }
+
+  uint32_t renderStart = 0;
+  long inputToRender = -1;
+  if (stepHasInput && RENDER_TRACE.getMarkedRenderStart(renderStart)) {
+    inputToRender = static_cast<long>(renderStart - stepInputUs);
+  }
+  serial.printf("%s:%ld,%u,%u,%u,%u,%lu\n", settled ? "IDLE" : "TIMEOUT", inputToRender,
+                static_cast<unsigned>(RENDER_TRACE.getRenderMicros() - stepRenderUs),
+                static_cast<unsigned>(display.getRefreshMicros() - stepDisplayUs),
+                static_cast<unsigned>(RENDER_TRACE.getSaveMicros() - stepSaveUs),
+                static_cast<unsigned>(RENDER_TRACE.getRenderCount() - stepRenders), now - waitStartedAt);
+  waiting = false;
+  startStep();
+}
+
+void SerialAutomation::startStep() {
+  stepRenders = RENDER_TRACE.getRenderCount();
+  stepRenderUs = RENDER_TRACE.getRenderMicros();
+  stepDisplayUs = display.getRefreshMicros();
+  stepSaveUs = RENDER_TRACE.getSaveMicros();
+  stepHasInput = false;
+}
+
+void SerialAutomation::screenshot() {
+  // Binary log records must not end up inside the raw frame buffer
+  logBinaryPause(true);
+  serial.printf("SCREENSHOT_START:%d\n", HalDisplay::BUFFER_SIZE);
+  serial.write(display.getFrameBuffer(), HalDisplay::BUFFER_SIZE);
+  serial.printf("SCREENSHOT_END\n");
+  logBinaryPause(false);
+}
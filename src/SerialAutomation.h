@@ -0,0 +1,81 @@
+#pragma once
+#include <HalDisplay.h>
+#include <Stream.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/**
+ * Line protocol on the serial console for scripted tests and latency benchmarks, driven by
+ * scripts/debugging_monitor.py --replay. Every command is a line starting with CMD: and gets exactly one reply line:
+ *
+ *   CMD:SCREENSHOT             SCREENSHOT_START:<size>, the raw frame buffer, SCREENSHOT_END
+ *   CMD:VERSION                VERSION:<firmware version>
+ *   CMD:LATENCY                OK:LATENCY, after the LAT histogram log line
+ *   CMD:PRESS <button>         OK:PRESS     button stays down until RELEASE
+ *   CMD:RELEASE <button>       OK:RELEASE
+ *   CMD:TAP <button> [ms]      OK:TAP       pressed for at least one loop iteration, or for ms
+ *   CMD:OPEN <path>            OK:OPEN      opens the book in the reader
+ *   CMD:WAIT_IDLE [ms]         IDLE:<timings> once no render is running or requested, TIMEOUT:<timings> after ms
+ *
+ * Buttons are BACK, CONFIRM, LEFT, RIGHT, UP, DOWN and POWER, the physical buttons before any remapping. Timings
+ * cover the step since the previous WAIT_IDLE: input_to_render_us,render_us,display_us,save_us,renders,waited_ms.
+ * input_to_render_us runs from the first PRESS or TAP of the step to the start of the next render, -1 if none.
+ * Anything that cannot be run is answered with ERR:<reason>.
+ */
+class SerialAutomation {
+ public:
+  using ButtonHook = std::function<void(uint8_t button, bool pressed)>;
+  using OpenHook = std::function<void(const std::string& path)>;
+
+  static constexpr unsigned long DEFAULT_IDLE_TIMEOUT_MS = 10000;
+  // The UI has to stay idle this long, so a render that requests the next one does not count as done
+  static constexpr unsigned long IDLE_SETTLE_MS = 50;
+
+  SerialAutomation(Stream& serial, HalDisplay& display, ButtonHook setButton, OpenHook openBook, const char* version)
+      : serial(serial),
+        display(display),
+        setButton(std::move(setButton)),
+        openBook(std::move(openBook)),
+        version(version) {}
+
+  /**
+   * Run the command lines that have arrived, release tapped buttons and answer a pending WAIT_IDLE. Call once per
+   * main loop iteration, before the buttons are read.
+   */
+  void poll();
+
+ private:
+  Stream& serial;
+  HalDisplay& display;
+  ButtonHook setButton;
+  OpenHook openBook;
+  const char* version;
+  std::string line;
+
+  int tapButton = -1;
+  unsigned long tapReleaseAt = 0;
+  bool tapSeen = false;  // The press went through at least one loop iteration
+
+  bool waiting = false;
+  unsigned long waitStartedAt = 0;
+  unsigned long waitTimeoutMs = 0;
+  unsigned long idleSince = 0;
+  bool idle = false;
+
+  // Counters at the start of the current step
+  uint32_t stepRenders = 0;
+  uint32_t stepRenderUs = 0;
+  uint32_t stepDisplayUs = 0;
+  uint32_t stepSaveUs = 0;
+  bool stepHasInput = false;
+  uint32_t stepInputUs = 0;
+
+  void handle(const std::string& command);
+  void pressButton(int button);
+  void releaseTap();
+  void checkIdle();
+  void startStep();
+  void screenshot();
+};
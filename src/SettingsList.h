@@ -66,6 +66,8 @@ inline std::vector<SettingInfo> getSettingsList() {
                           StrId::STR_CAT_READER),
       SettingInfo::Toggle(StrId::STR_TEXT_AA, &CrossPointSettings::textAntiAliasing, "textAntiAliasing",
                           StrId::STR_CAT_READER),
+      SettingInfo::Toggle(StrId::STR_PAGE_BITMAP_CACHE, &CrossPointSettings::pageBitmapCache, "pageBitmapCache",
+                          StrId::STR_CAT_READER),
 
       // --- Controls ---
       SettingInfo::Enum(StrId::STR_SIDE_BTN_LAYOUT, &CrossPointSettings::sideButtonLayout,
@@ -80,6 +82,10 @@ inline std::vector<SettingInfo> getSettingsList() {
       SettingInfo::Enum(StrId::STR_TIME_TO_SLEEP, &CrossPointSettings::sleepTimeout,
                         {StrId::STR_MIN_1, StrId::STR_MIN_5, StrId::STR_MIN_10, StrId::STR_MIN_15, StrId::STR_MIN_30},
                         "sleepTimeout", StrId::STR_CAT_SYSTEM),
+      SettingInfo::Enum(StrId::STR_CACHE_BUDGET, &CrossPointSettings::cacheBudget,
+                        {StrId::STR_SIZE_64MB, StrId::STR_SIZE_128MB, StrId::STR_SIZE_256MB, StrId::STR_SIZE_512MB,
+                         StrId::STR_SIZE_1GB, StrId::STR_UNLIMITED},
+                        "cacheBudget", StrId::STR_CAT_SYSTEM),
 
       // --- KOReader Sync (web-only, uses KOReaderCredentialStore) ---
       SettingInfo::DynamicString(
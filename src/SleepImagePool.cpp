@@ -0,0 +1,187 @@
+#include "SleepImagePool.h"
+
+#include <Bitmap.h>
+#include <HalStorage.h>
+#include <Logging.h>
+#include <Serialization.h>
+
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "util/StringUtils.h"
+
+namespace {
+constexpr uint8_t SLEEP_INDEX_VERSION = 1;
+constexpr char CACHE_DIR[] = "/.crosspoint/sleep";
+constexpr char INDEX_FILE[] = "/.crosspoint/sleep/index.bin";
+
+uint32_t fnv1a(uint32_t hash, const void* data, const size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+std::string frameFileName(const std::string& imageName) {
+  char name[16];
+  const uint32_t hash = fnv1a(2166136261u, imageName.data(), imageName.size());
+  snprintf(name, sizeof(name), "%08x.pages", static_cast<unsigned>(hash));
+  return name;
+}
+}  // namespace
+
+std::string SleepImagePool::framePath(const Image& image) {
+  return std::string(CACHE_DIR) + "/" + frameFileName(image.name);
+}
+
+bool SleepImagePool::load() {
+  images.clear();
+  auto dir = Storage.open(SLEEP_DIR);
+  if (!dir || !dir.isDirectory()) {
+    if (dir) dir.close();
+    return false;
+  }
+
+  // Directory entries only: nothing below reads file data unless the listing differs from the index
+  std::vector<Image> listing;
+  uint32_t signature = 2166136261u;
+  char name[500];
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    if (file.isDirectory()) {
+      file.close();
+      continue;
+    }
+    file.getName(name, sizeof(name));
+    const std::string filename(name);
+    if (filename[0] != '.' && StringUtils::checkFileExtension(filename, ".bmp")) {
+      Image image{filename, static_cast<uint32_t>(file.size())};
+      uint16_t date = 0, time = 0;
+      if (file.getModifyDateTime(&date, &time)) {
+        image.modified = static_cast<uint32_t>(date) << 16 | time;
+      }
+      signature = fnv1a(signature, filename.c_str(), filename.size() + 1);
+      signature = fnv1a(signature, &image.size, sizeof(image.size));
+      signature = fnv1a(signature, &image.modified, sizeof(image.modified));
+      listing.push_back(std::move(image));
+    }
+    file.close();
+  }
+  dir.close();
+
+  uint32_t indexSignature = 0;
+  if (loadIndex(indexSignature) && indexSignature == signature) {
+    LOG_DBG("SLP", "Sleep image index is current, %u images", static_cast<unsigned>(images.size()));
+    return true;
+  }
+
+  // Images the index already vouched for are kept without reading them again
+  std::unordered_map<std::string, Image> known;
+  for (auto& image : images) {
+    known.emplace(image.name, std::move(image));
+  }
+  images.clear();
+  int parsed = 0;
+  for (auto& image : listing) {
+    const auto it = known.find(image.name);
+    if (it == known.end() || it->second.size != image.size || it->second.modified != image.modified) {
+      FsFile file;
+      if (!Storage.openFileForRead("SLP", imagePath(image), file)) {
+        continue;
+      }
+      Bitmap bitmap(file);
+      const bool valid = bitmap.parseHeaders() == BmpReaderError::Ok;
+      file.close();
+      parsed++;
+      if (!valid) {
+        LOG_DBG("SLP", "Skipping invalid BMP file: %s", image.name.c_str());
+        continue;
+      }
+    }
+    images.push_back(std::move(image));
+  }
+
+  LOG_DBG("SLP", "Sleep image index rebuilt, %u images (%d parsed)", static_cast<unsigned>(images.size()), parsed);
+  saveIndex(signature);
+  removeStaleFrames();
+  return true;
+}
+
+bool SleepImagePool::loadIndex(uint32_t& signature) {
+  FsFile file;
+  if (!Storage.exists(INDEX_FILE) || !Storage.openFileForRead("SLP", INDEX_FILE, file)) {
+    return false;
+  }
+
+  uint8_t version;
+  serialization::readPod(file, version);
+  if (version != SLEEP_INDEX_VERSION) {
+    LOG_DBG("SLP", "Sleep image index version %u is not %u, rebuilding", version, SLEEP_INDEX_VERSION);
+    file.close();
+    return false;
+  }
+  uint16_t count;
+  serialization::readPod(file, signature);
+  serialization::readPod(file, count);
+  images.resize(count);
+  for (auto& image : images) {
+    serialization::readString(file, image.name);
+    serialization::readPod(file, image.size);
+    serialization::readPod(file, image.modified);
+  }
+  const bool complete = file.position() == file.size();
+  file.close();
+  if (!complete) {
+    LOG_ERR("SLP", "Sleep image index is truncated");
+    images.clear();
+    return false;
+  }
+  return true;
+}
+
+bool SleepImagePool::saveIndex(const uint32_t signature) const {
+  Storage.mkdir(CACHE_DIR);
+  FsFile file;
+  if (!Storage.openFileForWrite("SLP", INDEX_FILE, file)) {
+    return false;
+  }
+  serialization::writePod(file, SLEEP_INDEX_VERSION);
+  serialization::writePod(file, signature);
+  serialization::writePod(file, static_cast<uint16_t>(images.size()));
+  for (const auto& image : images) {
+    serialization::writeString(file, image.name);
+    serialization::writePod(file, image.size);
+    serialization::writePod(file, image.modified);
+  }
+  file.close();
+  return true;
+}
+
+void SleepImagePool::removeStaleFrames() const {
+  auto dir = Storage.open(CACHE_DIR);
+  if (!dir || !dir.isDirectory()) {
+    if (dir) dir.close();
+    return;
+  }
+  std::unordered_set<std::string> wanted;
+  for (const auto& image : images) {
+    wanted.insert(frameFileName(image.name));
+  }
+
+  std::vector<std::string> stale;
+  char name[64];
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    file.getName(name, sizeof(name));
+    if (!file.isDirectory() && StringUtils::checkFileExtension(std::string(name), ".pages") && !wanted.count(name)) {
+      stale.emplace_back(name);
+    }
+    file.close();
+  }
+  dir.close();
+
+  for (const auto& frame : stale) {
+    Storage.remove((std::string(CACHE_DIR) + "/" + frame).c_str());
+  }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The valid BMPs in /sleep, kept in an index under /.crosspoint/sleep so entering sleep does not have to open and
+// parse every image just to count them. The directory listing (names, sizes and write times, no file data) is compared
+// with the index each time; only images that are new or changed get their headers parsed again.
+//
+// Each image's rendered sleep frame is cached next to the index as a one page SectionPageCache, see framePath().
+class SleepImagePool {
+ public:
+  struct Image {
+    std::string name;  // file name inside /sleep
+    uint32_t size = 0;
+    uint32_t modified = 0;  // FAT date << 16 | FAT time
+  };
+
+  /**
+   * Bring the index in line with /sleep, rewriting it and dropping the frames of removed images if anything changed.
+   * @return false if /sleep does not exist
+   */
+  bool load();
+
+  const std::vector<Image>& getImages() const { return images; }
+  static std::string imagePath(const Image& image) { return std::string(SLEEP_DIR) + "/" + image.name; }
+
+  // Frame cache file of an image in /sleep
+  static std::string framePath(const Image& image);
+
+  static constexpr char SLEEP_DIR[] = "/sleep";
+
+ private:
+  std::vector<Image> images;
+
+  bool loadIndex(uint32_t& signature);
+  bool saveIndex(uint32_t signature) const;
+  void removeStaleFrames() const;
+};
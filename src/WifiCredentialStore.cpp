@@ -9,7 +9,7 @@ WifiCredentialStore WifiCredentialStore::instance;
 
 namespace {
 // File format version
-constexpr uint8_t WIFI_FILE_VERSION = 2;  // Increased version
+constexpr uint8_t WIFI_FILE_VERSION = 4;  // Added the lease time and when it was granted
 
 // WiFi credentials file path
 constexpr char WIFI_FILE[] = "/.crosspoint/wifi.bin";
@@ -51,6 +51,10 @@ bool WifiCredentialStore::saveToFile() const {
     std::string obfuscatedPwd = cred.password;
     obfuscate(obfuscatedPwd);
     serialization::writeString(file, obfuscatedPwd);
+
+    serialization::writePod(file, cred.link.bssid);
+    serialization::writePod(file, cred.link.channel);
+    serialization::writePod(file, cred.link.lease);
   }
 
   file.close();
@@ -97,6 +101,18 @@ bool WifiCredentialStore::loadFromFile() {
     obfuscate(cred.password);  // XOR is symmetric, so same function deobfuscates
     LOG_DBG("WCS", "After deobfuscation, password length: %zu", cred.password.size());
 
+    if (version >= 4) {
+      serialization::readPod(file, cred.link.bssid);
+      serialization::readPod(file, cred.link.channel);
+      serialization::readPod(file, cred.link.lease);
+    } else if (version == 3) {
+      // Leases of version 3 have no time, so they are not reused; the access point still is
+      serialization::readPod(file, cred.link.bssid);
+      serialization::readPod(file, cred.link.channel);
+      uint32_t addresses[4];
+      serialization::readPod(file, addresses);
+    }
+
     credentials.push_back(cred);
   }
 
@@ -122,7 +138,7 @@ bool WifiCredentialStore::addCredential(const std::string& ssid, const std::stri
   }
 
   // Add new credential
-  credentials.push_back({ssid, password});
+  credentials.push_back({ssid, password, {}});
   LOG_DBG("WCS", "Added credentials for: %s", ssid.c_str());
   return saveToFile();
 }
@@ -154,6 +170,23 @@ const WifiCredential* WifiCredentialStore::findCredential(const std::string& ssi
 
 bool WifiCredentialStore::hasSavedCredential(const std::string& ssid) const { return findCredential(ssid) != nullptr; }
 
+void WifiCredentialStore::setLink(const std::string& ssid, const WifiLink& link) {
+  const auto cred = find_if(credentials.begin(), credentials.end(),
+                            [&ssid](const WifiCredential& cred) { return cred.ssid == ssid; });
+  if (cred == credentials.end()) {
+    return;
+  }
+  const WifiLease& lease = cred->link.lease;
+  if (cred->link.sameAccessPoint(link) && lease.ip == link.lease.ip && lease.gateway == link.lease.gateway &&
+      lease.subnet == link.lease.subnet && lease.dns == link.lease.dns && lease.seconds == link.lease.seconds &&
+      lease.obtainedAt == link.lease.obtainedAt) {
+    return;
+  }
+  cred->link = link;
+  LOG_DBG("WCS", "Link of %s is now channel %u", ssid.c_str(), link.channel);
+  saveToFile();
+}
+
 void WifiCredentialStore::setLastConnectedSsid(const std::string& ssid) {
   if (lastConnectedSsid != ssid) {
     lastConnectedSsid = ssid;
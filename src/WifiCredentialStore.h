@@ -1,10 +1,13 @@
 #pragma once
+#include <HalWifi.h>
+
 #include <string>
 #include <vector>
 
 struct WifiCredential {
   std::string ssid;
   std::string password;  // Stored obfuscated in file
+  WifiLink link;         // Where the network was last reached, for a directed reconnect
 };
 
 /**
@@ -49,6 +52,10 @@ class WifiCredentialStore {
   // Check if a network is saved
   bool hasSavedCredential(const std::string& ssid) const;
 
+  // Remember where a saved network was reached, writing the file only if that changed. A link without a channel
+  // forgets it.
+  void setLink(const std::string& ssid, const WifiLink& link);
+
   // Last connected network
   void setLastConnectedSsid(const std::string& ssid);
   const std::string& getLastConnectedSsid() const;
@@ -1,5 +1,8 @@
 #include "Activity.h"
 
+#include "InputLatency.h"
+#include "RenderTrace.h"
+
 void Activity::renderTaskTrampoline(void* param) {
   auto* self = static_cast<Activity*>(param);
   self->renderTaskLoop();
@@ -10,8 +13,11 @@ void Activity::renderTaskLoop() {
     ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     {
       RenderLock lock(*this);
+      INPUT_LATENCY.onRenderStart(micros());
+      RENDER_TRACE.onRenderStart(micros());
       render(std::move(lock));
     }
+    RENDER_TRACE.onRenderEnd(micros());
   }
 }
 
@@ -40,6 +46,7 @@ void Activity::requestUpdate() {
   // Using direct notification to signal the render task to update
   // Increment counter so multiple rapid calls won't be lost
   if (renderTaskHandle) {
+    RENDER_TRACE.onRequest();
     xTaskNotify(renderTaskHandle, 1, eIncrement);
   }
 }
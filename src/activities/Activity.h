@@ -47,6 +47,8 @@ class Activity {
   virtual bool skipLoopDelay() { return false; }
   virtual bool preventAutoSleep() { return false; }
   virtual bool isReaderActivity() const { return false; }
+  // Called just before the device goes to deep sleep, while the activity is still alive
+  virtual void onEnterSleep() {}
 
   // RAII helper to lock rendering mutex for the duration of a scope.
   class RenderLock {
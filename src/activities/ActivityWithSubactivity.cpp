@@ -1,12 +1,20 @@
 #include "ActivityWithSubactivity.h"
 
+#include "InputLatency.h"
+#include "RenderTrace.h"
+
 void ActivityWithSubactivity::renderTaskLoop() {
   while (true) {
     ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
     {
       RenderLock lock(*this);
       if (!subActivity) {
+        INPUT_LATENCY.onRenderStart(micros());
+        RENDER_TRACE.onRenderStart(micros());
         render(std::move(lock));
+        RENDER_TRACE.onRenderEnd(micros());
+      } else {
+        RENDER_TRACE.onRenderStart(micros(), false);
       }
       // If subActivity is set, consume the notification but skip parent render
       // Note: the sub-activity will call its render() from its own display task
@@ -48,3 +56,9 @@ void ActivityWithSubactivity::onExit() {
   exitActivity();
   Activity::onExit();
 }
+
+void ActivityWithSubactivity::onEnterSleep() {
+  if (subActivity) {
+    subActivity->onEnterSleep();
+  }
+}
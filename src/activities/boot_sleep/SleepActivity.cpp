@@ -9,11 +9,31 @@
 
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
+#include "SectionPageCache.h"
+#include "SleepImagePool.h"
 #include "components/UITheme.h"
 #include "fontIds.h"
 #include "images/Logo120.h"
 #include "util/StringUtils.h"
 
+namespace {
+uint32_t fnv1a(const char* text) {
+  uint32_t hash = 2166136261u;
+  for (const char* c = text; *c; c++) {
+    hash ^= static_cast<uint8_t>(*c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Size and last write time of an image, so a replaced file does not show the frame of the old one
+uint32_t fileStamp(FsFile& file) {
+  uint16_t date = 0, time = 0;
+  file.getModifyDateTime(&date, &time);
+  return static_cast<uint32_t>(file.size()) * 31u ^ (static_cast<uint32_t>(date) << 16 | time);
+}
+}  // namespace
+
 void SleepActivity::onEnter() {
   Activity::onEnter();
   GUI.drawPopup(renderer, tr(STR_ENTERING_SLEEP));
@@ -32,63 +52,30 @@ void SleepActivity::onEnter() {
 }
 
 void SleepActivity::renderCustomSleepScreen() const {
-  // Check if we have a /sleep directory
-  auto dir = Storage.open("/sleep");
-  if (dir && dir.isDirectory()) {
-    std::vector<std::string> files;
-    char name[500];
-    // collect all valid BMP files
-    for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
-      if (file.isDirectory()) {
-        file.close();
-        continue;
-      }
-      file.getName(name, sizeof(name));
-      auto filename = std::string(name);
-      if (filename[0] == '.') {
-        file.close();
-        continue;
-      }
-
-      if (filename.substr(filename.length() - 4) != ".bmp") {
-        LOG_DBG("SLP", "Skipping non-.bmp file name: %s", name);
-        file.close();
-        continue;
-      }
-      Bitmap bitmap(file);
-      if (bitmap.parseHeaders() != BmpReaderError::Ok) {
-        LOG_DBG("SLP", "Skipping invalid BMP file: %s", name);
-        file.close();
-        continue;
-      }
-      files.emplace_back(filename);
-      file.close();
+  SleepImagePool pool;
+  if (pool.load() && !pool.getImages().empty()) {
+    const auto& images = pool.getImages();
+    const auto numFiles = images.size();
+    // Generate a random number between 1 and numFiles
+    auto randomFileIndex = random(numFiles);
+    // If we picked the same image as last time, reroll
+    while (numFiles > 1 && randomFileIndex == APP_STATE.lastSleepImage) {
+      randomFileIndex = random(numFiles);
     }
-    const auto numFiles = files.size();
-    if (numFiles > 0) {
-      // Generate a random number between 1 and numFiles
-      auto randomFileIndex = random(numFiles);
-      // If we picked the same image as last time, reroll
-      while (numFiles > 1 && randomFileIndex == APP_STATE.lastSleepImage) {
-        randomFileIndex = random(numFiles);
-      }
-      APP_STATE.lastSleepImage = randomFileIndex;
-      APP_STATE.saveToFile();
-      const auto filename = "/sleep/" + files[randomFileIndex];
-      FsFile file;
-      if (Storage.openFileForRead("SLP", filename, file)) {
-        LOG_DBG("SLP", "Randomly loading: /sleep/%s", files[randomFileIndex].c_str());
-        delay(100);
-        Bitmap bitmap(file, true);
-        if (bitmap.parseHeaders() == BmpReaderError::Ok) {
-          renderBitmapSleepScreen(bitmap);
-          dir.close();
-          return;
-        }
+    APP_STATE.lastSleepImage = randomFileIndex;
+    APP_STATE.saveToFile();
+    const auto& image = images[randomFileIndex];
+    FsFile file;
+    if (Storage.openFileForRead("SLP", SleepImagePool::imagePath(image), file)) {
+      LOG_DBG("SLP", "Randomly loading: /sleep/%s", image.name.c_str());
+      delay(100);
+      Bitmap bitmap(file, true);
+      if (bitmap.parseHeaders() == BmpReaderError::Ok) {
+        renderBitmapSleepScreen(bitmap, SleepImagePool::framePath(image), fileStamp(file));
+        return;
       }
     }
   }
-  if (dir) dir.close();
 
   // Look for sleep.bmp on the root of the sd card to determine if we should
   // render a custom sleep screen instead of the default.
@@ -122,7 +109,8 @@ void SleepActivity::renderDefaultSleepScreen() const {
   renderer.displayBuffer(HalDisplay::HALF_REFRESH);
 }
 
-void SleepActivity::renderBitmapSleepScreen(const Bitmap& bitmap) const {
+void SleepActivity::renderBitmapSleepScreen(const Bitmap& bitmap, const std::string& framePath,
+                                            const uint32_t sourceStamp) const {
   int x, y;
   const auto pageWidth = renderer.getScreenWidth();
   const auto pageHeight = renderer.getScreenHeight();
@@ -163,34 +151,49 @@ void SleepActivity::renderBitmapSleepScreen(const Bitmap& bitmap) const {
   }
 
   LOG_DBG("SLP", "drawing to %d x %d", x, y);
-  renderer.clearScreen();
 
   const bool hasGreyscale = bitmap.hasGreyscale() &&
                             SETTINGS.sleepScreenCoverFilter == CrossPointSettings::SLEEP_SCREEN_COVER_FILTER::NO_FILTER;
 
-  renderer.drawBitmap(bitmap, x, y, pageWidth, pageHeight, cropX, cropY);
-
-  if (SETTINGS.sleepScreenCoverFilter == CrossPointSettings::SLEEP_SCREEN_COVER_FILTER::INVERTED_BLACK_AND_WHITE) {
-    renderer.invertScreen();
+  const auto renderPlane = [&](const GfxRenderer::RenderMode mode) {
+    bitmap.rewindToData();
+    renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+    renderer.setRenderMode(mode);
+    renderer.drawBitmap(bitmap, x, y, pageWidth, pageHeight, cropX, cropY);
+    if (mode == GfxRenderer::BW &&
+        SETTINGS.sleepScreenCoverFilter == CrossPointSettings::SLEEP_SCREEN_COVER_FILTER::INVERTED_BLACK_AND_WHITE) {
+      renderer.invertScreen();
+    }
+    renderer.setRenderMode(GfxRenderer::BW);
+  };
+
+  // The frame is decoded, scaled and dithered once per image and settings; afterwards every plane is a blit
+  SectionPageCache frames;
+  if (!framePath.empty()) {
+    char id[160];
+    snprintf(id, sizeof(id), "%s|%s|%u|%d|%d|%d|%d|%d|%d|%d", CROSSPOINT_VERSION, framePath.c_str(),
+             static_cast<unsigned>(sourceStamp), bitmap.getWidth(), bitmap.getHeight(), bitmap.getBpp(),
+             SETTINGS.sleepScreenCoverMode, SETTINGS.sleepScreenCoverFilter, pageWidth, pageHeight);
+    if (frames.open(framePath, fnv1a(id), 1, hasGreyscale) && !frames.has(0)) {
+      frames.store(renderer, 0, 0, renderPlane);
+    }
   }
+  const auto showPlane = [&](const GfxRenderer::RenderMode mode) {
+    if (frames.has(0) && frames.drawPlane(renderer, 0, mode)) {
+      return;
+    }
+    renderPlane(mode);
+  };
 
+  showPlane(GfxRenderer::BW);
   renderer.displayBuffer(HalDisplay::HALF_REFRESH);
 
   if (hasGreyscale) {
-    bitmap.rewindToData();
-    renderer.clearScreen(0x00);
-    renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
-    renderer.drawBitmap(bitmap, x, y, pageWidth, pageHeight, cropX, cropY);
+    showPlane(GfxRenderer::GRAYSCALE_LSB);
     renderer.copyGrayscaleLsbBuffers();
-
-    bitmap.rewindToData();
-    renderer.clearScreen(0x00);
-    renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
-    renderer.drawBitmap(bitmap, x, y, pageWidth, pageHeight, cropX, cropY);
+    showPlane(GfxRenderer::GRAYSCALE_MSB);
     renderer.copyGrayscaleMsbBuffers();
-
     renderer.displayGrayBuffer();
-    renderer.setRenderMode(GfxRenderer::BW);
   }
 }
 
@@ -266,7 +269,7 @@ void SleepActivity::renderCoverSleepScreen() const {
     Bitmap bitmap(file);
     if (bitmap.parseHeaders() == BmpReaderError::Ok) {
       LOG_DBG("SLP", "Rendering sleep cover: %s", coverBmpPath.c_str());
-      renderBitmapSleepScreen(bitmap);
+      renderBitmapSleepScreen(bitmap, SectionPageCache::pathFor(coverBmpPath), fileStamp(file));
       return;
     }
   }
@@ -1,4 +1,6 @@
 #pragma once
+#include <string>
+
 #include "../Activity.h"
 
 class Bitmap;
@@ -13,6 +15,7 @@ class SleepActivity final : public Activity {
   void renderDefaultSleepScreen() const;
   void renderCustomSleepScreen() const;
   void renderCoverSleepScreen() const;
-  void renderBitmapSleepScreen(const Bitmap& bitmap) const;
+  // framePath names a SectionPageCache file for the rendered frame, sourceStamp identifies the image file version
+  void renderBitmapSleepScreen(const Bitmap& bitmap, const std::string& framePath = "", uint32_t sourceStamp = 0) const;
   void renderBlankSleepScreen() const;
 };
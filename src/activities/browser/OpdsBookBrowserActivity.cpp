@@ -4,10 +4,10 @@
 #include <GfxRenderer.h>
 #include <I18n.h>
 #include <Logging.h>
-#include <OpdsStream.h>
 #include <WiFi.h>
 
 #include "CrossPointSettings.h"
+#include "KOReaderSyncClient.h"
 #include "MappedInputManager.h"
 #include "activities/network/WifiSelectionActivity.h"
 #include "components/UITheme.h"
@@ -18,13 +18,27 @@
 
 namespace {
 constexpr int PAGE_ITEMS = 23;
+
+OpdsFetchResult fetchFromServer(const std::string& url, const OpdsValidators& validators, OpdsValidators& received,
+                                Stream& body) {
+  switch (HttpDownloader::fetchUrlIfModified(UrlUtils::buildUrl(SETTINGS.opdsServerUrl, url), body, validators.etag,
+                                             validators.lastModified, &received.etag, &received.lastModified)) {
+    case HttpDownloader::FETCHED:
+      return OpdsFetchResult::OK;
+    case HttpDownloader::NOT_MODIFIED:
+      return OpdsFetchResult::NOT_MODIFIED;
+    default:
+      return OpdsFetchResult::FAILED;
+  }
+}
 }  // namespace
 
 void OpdsBookBrowserActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
   state = BrowserState::CHECK_WIFI;
-  entries.clear();
+  pageEntries.clear();
+  pageStart = 0;
   navigationHistory.clear();
   currentPath = "";  // Root path - user provides full URL in settings
   selectorIndex = 0;
@@ -32,6 +46,8 @@ void OpdsBookBrowserActivity::onEnter() {
   statusMessage = tr(STR_CHECKING_WIFI);
   requestUpdate();
 
+  OpdsFeedCache::trim();
+
   // Check WiFi and connect if needed, then fetch feed
   checkAndConnectWifi();
 }
@@ -39,10 +55,15 @@ void OpdsBookBrowserActivity::onEnter() {
 void OpdsBookBrowserActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
+  KOReaderSyncClient::pushQueuedProgress();
+
   // Turn off WiFi when exiting
   WiFi.mode(WIFI_OFF);
 
-  entries.clear();
+  // A failed download can be retried while browsing; once the browser is left its .part is abandoned
+  HttpDownloader::removePartialDownloads("/");
+
+  pageEntries.clear();
   navigationHistory.clear();
 }
 
@@ -99,8 +120,8 @@ void OpdsBookBrowserActivity::loop() {
   // Handle browsing state
   if (state == BrowserState::BROWSING) {
     if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
-      if (!entries.empty()) {
-        const auto& entry = entries[selectorIndex];
+      if (const OpdsEntry* selected = selectedEntry()) {
+        const OpdsEntry entry = *selected;
         if (entry.type == OpdsEntryType::BOOK) {
           downloadBook(entry);
         } else {
@@ -111,25 +132,36 @@ void OpdsBookBrowserActivity::loop() {
       navigateBack();
     }
 
-    // Handle navigation
-    if (!entries.empty()) {
+    // Handle navigation. Further pages of the feed are fetched once the selection reaches the last loaded entry
+    // (or page, when skipping a page at a time) instead of wrapping around.
+    if (feed.getEntryCount() > 0) {
       buttonNavigator.onNextRelease([this] {
-        selectorIndex = ButtonNavigator::nextIndex(selectorIndex, entries.size());
+        if (static_cast<size_t>(selectorIndex) + 1 >= feed.getEntryCount() && feed.hasMore()) {
+          loadMoreEntries();
+        }
+        selectorIndex = ButtonNavigator::nextIndex(selectorIndex, feed.getEntryCount());
+        loadPage();
         requestUpdate();
       });
 
       buttonNavigator.onPreviousRelease([this] {
-        selectorIndex = ButtonNavigator::previousIndex(selectorIndex, entries.size());
+        selectorIndex = ButtonNavigator::previousIndex(selectorIndex, feed.getEntryCount());
+        loadPage();
         requestUpdate();
       });
 
       buttonNavigator.onNextContinuous([this] {
-        selectorIndex = ButtonNavigator::nextPageIndex(selectorIndex, entries.size(), PAGE_ITEMS);
+        if (static_cast<size_t>(selectorIndex) + PAGE_ITEMS >= feed.getEntryCount() && feed.hasMore()) {
+          loadMoreEntries();
+        }
+        selectorIndex = ButtonNavigator::nextPageIndex(selectorIndex, feed.getEntryCount(), PAGE_ITEMS);
+        loadPage();
         requestUpdate();
       });
 
       buttonNavigator.onPreviousContinuous([this] {
-        selectorIndex = ButtonNavigator::previousPageIndex(selectorIndex, entries.size(), PAGE_ITEMS);
+        selectorIndex = ButtonNavigator::previousPageIndex(selectorIndex, feed.getEntryCount(), PAGE_ITEMS);
+        loadPage();
         requestUpdate();
       });
     }
@@ -186,23 +218,23 @@ void OpdsBookBrowserActivity::render(Activity::RenderLock&&) {
   // Browsing state
   // Show appropriate button hint based on selected entry type
   const char* confirmLabel = tr(STR_OPEN);
-  if (!entries.empty() && entries[selectorIndex].type == OpdsEntryType::BOOK) {
+  const OpdsEntry* selected = selectedEntry();
+  if (selected && selected->type == OpdsEntryType::BOOK) {
     confirmLabel = tr(STR_DOWNLOAD);
   }
   const auto labels = mappedInput.mapLabels(tr(STR_BACK), confirmLabel, "", "");
   GUI.drawButtonHints(renderer, labels.btn1, labels.btn2, labels.btn3, labels.btn4);
 
-  if (entries.empty()) {
+  if (pageEntries.empty()) {
     renderer.drawCenteredText(UI_10_FONT_ID, pageHeight / 2, tr(STR_NO_ENTRIES));
     renderer.displayBuffer();
     return;
   }
 
-  const auto pageStartIndex = selectorIndex / PAGE_ITEMS * PAGE_ITEMS;
   renderer.fillRect(0, 60 + (selectorIndex % PAGE_ITEMS) * 30 - 2, pageWidth - 1, 30);
 
-  for (size_t i = pageStartIndex; i < entries.size() && i < static_cast<size_t>(pageStartIndex + PAGE_ITEMS); i++) {
-    const auto& entry = entries[i];
+  for (size_t i = pageStart; i < pageStart + pageEntries.size(); i++) {
+    const auto& entry = pageEntries[i - pageStart];
 
     // Format display text with type indicator
     std::string displayText;
@@ -224,7 +256,7 @@ void OpdsBookBrowserActivity::render(Activity::RenderLock&&) {
   renderer.displayBuffer();
 }
 
-void OpdsBookBrowserActivity::fetchFeed(const std::string& path) {
+void OpdsBookBrowserActivity::fetchFeed(const std::string& path, const bool revalidate) {
   const char* serverUrl = SETTINGS.opdsServerUrl;
   if (strlen(serverUrl) == 0) {
     state = BrowserState::ERROR;
@@ -236,30 +268,26 @@ void OpdsBookBrowserActivity::fetchFeed(const std::string& path) {
   std::string url = UrlUtils::buildUrl(serverUrl, path);
   LOG_DBG("OPDS", "Fetching: %s", url.c_str());
 
-  OpdsParser parser;
-
-  {
-    OpdsParserStream stream{parser};
-    if (!HttpDownloader::fetchUrl(url, stream)) {
-      state = BrowserState::ERROR;
-      errorMessage = tr(STR_FETCH_FEED_FAILED);
-      requestUpdate();
-      return;
-    }
+  const auto result = feed.open(url, revalidate, fetchFromServer);
+  if (result == OpdsFeedCache::Result::FETCH_FAILED) {
+    state = BrowserState::ERROR;
+    errorMessage = tr(STR_FETCH_FEED_FAILED);
+    requestUpdate();
+    return;
   }
 
-  if (!parser) {
+  if (result == OpdsFeedCache::Result::PARSE_FAILED) {
     state = BrowserState::ERROR;
     errorMessage = tr(STR_PARSE_FEED_FAILED);
     requestUpdate();
     return;
   }
 
-  entries = std::move(parser).getEntries();
-  LOG_DBG("OPDS", "Found %d entries", entries.size());
+  LOG_DBG("OPDS", "Found %zu entries%s", feed.getEntryCount(), feed.hasMore() ? " (more to load)" : "");
   selectorIndex = 0;
+  loadPage(true);
 
-  if (entries.empty()) {
+  if (pageEntries.empty()) {
     state = BrowserState::ERROR;
     errorMessage = tr(STR_NO_ENTRIES);
     requestUpdate();
@@ -270,6 +298,39 @@ void OpdsBookBrowserActivity::fetchFeed(const std::string& path) {
   requestUpdate();
 }
 
+void OpdsBookBrowserActivity::loadMoreEntries() {
+  state = BrowserState::LOADING;
+  statusMessage = tr(STR_LOADING);
+  requestUpdate();
+
+  if (feed.loadMore(fetchFromServer) != OpdsFeedCache::Result::OK) {
+    LOG_ERR("OPDS", "Failed to load the next page of the feed");
+  }
+  state = BrowserState::BROWSING;
+}
+
+void OpdsBookBrowserActivity::loadPage(const bool reload) {
+  // A short page is re-read as well, more entries may have been appended to the feed since
+  const size_t start = selectorIndex / PAGE_ITEMS * PAGE_ITEMS;
+  if (!reload && start == pageStart && pageEntries.size() == PAGE_ITEMS) {
+    return;
+  }
+
+  RenderLock lock(*this);
+  pageStart = start;
+  if (!feed.readEntries(pageStart, PAGE_ITEMS, pageEntries)) {
+    LOG_ERR("OPDS", "Failed to read entries %zu-%zu from the feed cache", pageStart, pageStart + PAGE_ITEMS - 1);
+  }
+}
+
+const OpdsEntry* OpdsBookBrowserActivity::selectedEntry() const {
+  const size_t index = selectorIndex;
+  if (index < pageStart || index >= pageStart + pageEntries.size()) {
+    return nullptr;
+  }
+  return &pageEntries[index - pageStart];
+}
+
 void OpdsBookBrowserActivity::navigateToEntry(const OpdsEntry& entry) {
   // Push current path to history before navigating
   navigationHistory.push_back(currentPath);
@@ -277,7 +338,6 @@ void OpdsBookBrowserActivity::navigateToEntry(const OpdsEntry& entry) {
 
   state = BrowserState::LOADING;
   statusMessage = tr(STR_LOADING);
-  entries.clear();
   selectorIndex = 0;
   requestUpdate();
 
@@ -295,11 +355,11 @@ void OpdsBookBrowserActivity::navigateBack() {
 
     state = BrowserState::LOADING;
     statusMessage = tr(STR_LOADING);
-    entries.clear();
     selectorIndex = 0;
     requestUpdate();
 
-    fetchFeed(currentPath);
+    // The parent feed was just browsed, its cached copy is used without asking the server
+    fetchFeed(currentPath, false);
   }
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <OpdsFeedCache.h>
 #include <OpdsParser.h>
 
 #include <functional>
@@ -36,7 +37,9 @@ class OpdsBookBrowserActivity final : public ActivityWithSubactivity {
  private:
   ButtonNavigator buttonNavigator;
   BrowserState state = BrowserState::LOADING;
-  std::vector<OpdsEntry> entries;
+  OpdsFeedCache feed;                          // Entries of the current feed, kept on SD
+  std::vector<OpdsEntry> pageEntries;          // The screenful of entries around the selection
+  size_t pageStart = 0;                        // Feed index of pageEntries[0]
   std::vector<std::string> navigationHistory;  // Stack of previous feed paths for back navigation
   std::string currentPath;                     // Current feed path being displayed
   int selectorIndex = 0;
@@ -50,7 +53,10 @@ class OpdsBookBrowserActivity final : public ActivityWithSubactivity {
   void checkAndConnectWifi();
   void launchWifiSelection();
   void onWifiSelectionComplete(bool connected);
-  void fetchFeed(const std::string& path);
+  void fetchFeed(const std::string& path, bool revalidate = true);
+  void loadMoreEntries();
+  void loadPage(bool reload = false);
+  const OpdsEntry* selectedEntry() const;
   void navigateToEntry(const OpdsEntry& entry);
   void navigateBack();
   void downloadBook(const OpdsEntry& book);
@@ -107,6 +107,7 @@ void MyLibraryActivity::onEnter() {
 
   loadFiles();
   selectorIndex = 0;
+  renderedSelectorIndex = -1;
 
   requestUpdate();
 }
@@ -190,31 +191,46 @@ void MyLibraryActivity::loop() {
 }
 
 void MyLibraryActivity::render(Activity::RenderLock&&) {
-  renderer.clearScreen();
+  // The previous frame of this folder is still in the frame buffer: only the header and the rows whose selection
+  // changed are drawn again
+  const bool listShown = renderedSelectorIndex >= 0 && renderedPath == basepath;
+  if (!listShown) {
+    renderer.clearScreen();
+  }
 
   const auto pageWidth = renderer.getScreenWidth();
   const auto pageHeight = renderer.getScreenHeight();
   auto metrics = UITheme::getInstance().getMetrics();
 
   auto folderName = basepath == "/" ? tr(STR_SD_CARD) : basepath.substr(basepath.rfind('/') + 1).c_str();
-  GUI.drawHeader(renderer, Rect{0, metrics.topPadding, pageWidth, metrics.headerHeight}, folderName);
+  const Rect headerRect{0, metrics.topPadding, pageWidth, metrics.headerHeight};
+  if (listShown) {
+    renderer.fillRect(headerRect.x, headerRect.y, headerRect.width, headerRect.height, false);
+  }
+  GUI.drawHeader(renderer, headerRect, folderName);
 
   const int contentTop = metrics.topPadding + metrics.headerHeight + metrics.verticalSpacing;
   const int contentHeight = pageHeight - contentTop - metrics.buttonHintsHeight - metrics.verticalSpacing;
   if (files.empty()) {
-    renderer.drawText(UI_10_FONT_ID, metrics.contentSidePadding, contentTop + 20, tr(STR_NO_BOOKS_FOUND));
+    if (!listShown) {
+      renderer.drawText(UI_10_FONT_ID, metrics.contentSidePadding, contentTop + 20, tr(STR_NO_BOOKS_FOUND));
+    }
   } else {
     GUI.drawList(
         renderer, Rect{0, contentTop, pageWidth, contentHeight}, files.size(), selectorIndex,
-        [this](int index) { return files[index]; }, nullptr, nullptr, nullptr);
+        [this](int index) { return files[index]; }, nullptr, nullptr, nullptr, listShown ? renderedSelectorIndex : -1);
   }
 
-  // Help text
-  const auto labels = mappedInput.mapLabels(basepath == "/" ? tr(STR_HOME) : tr(STR_BACK), tr(STR_OPEN), tr(STR_DIR_UP),
-                                            tr(STR_DIR_DOWN));
-  GUI.drawButtonHints(renderer, labels.btn1, labels.btn2, labels.btn3, labels.btn4);
+  if (!listShown) {
+    // Help text
+    const auto labels = mappedInput.mapLabels(basepath == "/" ? tr(STR_HOME) : tr(STR_BACK), tr(STR_OPEN),
+                                              tr(STR_DIR_UP), tr(STR_DIR_DOWN));
+    GUI.drawButtonHints(renderer, labels.btn1, labels.btn2, labels.btn3, labels.btn4);
+  }
 
   renderer.displayBuffer();
+  renderedPath = basepath;
+  renderedSelectorIndex = static_cast<int>(selectorIndex);
 }
 
 size_t MyLibraryActivity::findEntry(const std::string& name) const {
@@ -16,6 +16,9 @@ class MyLibraryActivity final : public Activity {
   // Files state
   std::string basepath = "/";
   std::vector<std::string> files;
+  // Folder and selection of the list frame left in the frame buffer, -1 before the first one
+  std::string renderedPath;
+  int renderedSelectorIndex = -1;
 
   // Callbacks
   const std::function<void(const std::string& path)> onSelectBook;
@@ -37,6 +37,7 @@ void RecentBooksActivity::onEnter() {
   loadRecentBooks();
 
   selectorIndex = 0;
+  renderedSelectorIndex = -1;
   requestUpdate();
 }
 
@@ -84,30 +85,44 @@ void RecentBooksActivity::loop() {
 }
 
 void RecentBooksActivity::render(Activity::RenderLock&&) {
-  renderer.clearScreen();
+  // The previous frame of this list is still in the frame buffer: only the header and the rows whose selection changed
+  // are drawn again
+  const bool listShown = renderedSelectorIndex >= 0;
+  if (!listShown) {
+    renderer.clearScreen();
+  }
 
   const auto pageWidth = renderer.getScreenWidth();
   const auto pageHeight = renderer.getScreenHeight();
   auto metrics = UITheme::getInstance().getMetrics();
 
-  GUI.drawHeader(renderer, Rect{0, metrics.topPadding, pageWidth, metrics.headerHeight}, tr(STR_MENU_RECENT_BOOKS));
+  const Rect headerRect{0, metrics.topPadding, pageWidth, metrics.headerHeight};
+  if (listShown) {
+    renderer.fillRect(headerRect.x, headerRect.y, headerRect.width, headerRect.height, false);
+  }
+  GUI.drawHeader(renderer, headerRect, tr(STR_MENU_RECENT_BOOKS));
 
   const int contentTop = metrics.topPadding + metrics.headerHeight + metrics.verticalSpacing;
   const int contentHeight = pageHeight - contentTop - metrics.buttonHintsHeight - metrics.verticalSpacing;
 
   // Recent tab
   if (recentBooks.empty()) {
-    renderer.drawText(UI_10_FONT_ID, metrics.contentSidePadding, contentTop + 20, tr(STR_NO_RECENT_BOOKS));
+    if (!listShown) {
+      renderer.drawText(UI_10_FONT_ID, metrics.contentSidePadding, contentTop + 20, tr(STR_NO_RECENT_BOOKS));
+    }
   } else {
     GUI.drawList(
         renderer, Rect{0, contentTop, pageWidth, contentHeight}, recentBooks.size(), selectorIndex,
         [this](int index) { return recentBooks[index].title; }, [this](int index) { return recentBooks[index].author; },
-        nullptr, nullptr);
+        nullptr, nullptr, renderedSelectorIndex);
   }
 
-  // Help text
-  const auto labels = mappedInput.mapLabels(tr(STR_HOME), tr(STR_OPEN), tr(STR_DIR_UP), tr(STR_DIR_DOWN));
-  GUI.drawButtonHints(renderer, labels.btn1, labels.btn2, labels.btn3, labels.btn4);
+  if (!listShown) {
+    // Help text
+    const auto labels = mappedInput.mapLabels(tr(STR_HOME), tr(STR_OPEN), tr(STR_DIR_UP), tr(STR_DIR_DOWN));
+    GUI.drawButtonHints(renderer, labels.btn1, labels.btn2, labels.btn3, labels.btn4);
+  }
 
   renderer.displayBuffer();
+  renderedSelectorIndex = static_cast<int>(selectorIndex);
 }
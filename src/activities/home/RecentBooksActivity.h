@@ -14,6 +14,8 @@ class RecentBooksActivity final : public Activity {
   ButtonNavigator buttonNavigator;
 
   size_t selectorIndex = 0;
+  // Selection of the list frame left in the frame buffer, -1 before the first one
+  int renderedSelectorIndex = -1;
 
   // Recent tab state
   std::vector<RecentBook> recentBooks;
@@ -6,6 +6,7 @@
 #include <WiFi.h>
 #include <esp_task_wdt.h>
 
+#include "KOReaderSyncClient.h"
 #include "MappedInputManager.h"
 #include "WifiSelectionActivity.h"
 #include "components/UITheme.h"
@@ -45,6 +46,7 @@ void CalibreConnectActivity::onExit() {
 
   stopWebServer();
   MDNS.end();
+  KOReaderSyncClient::pushQueuedProgress();
 
   delay(50);
   WiFi.disconnect(false);
@@ -10,6 +10,7 @@
 
 #include <cstddef>
 
+#include "KOReaderSyncClient.h"
 #include "MappedInputManager.h"
 #include "NetworkModeSelectionActivity.h"
 #include "WifiSelectionActivity.h"
@@ -73,6 +74,8 @@ void CrossPointWebServerActivity::onExit() {
     dnsServer = nullptr;
   }
 
+  KOReaderSyncClient::pushQueuedProgress();
+
   // Brief wait for LWIP stack to flush pending packets
   delay(50);
 
@@ -5,6 +5,7 @@
 #include <Logging.h>
 #include <WiFi.h>
 
+#include <cstring>
 #include <map>
 
 #include "MappedInputManager.h"
@@ -28,6 +29,7 @@ void WifiSelectionActivity::onEnter() {
   networks.clear();
   state = WifiSelectionState::SCANNING;
   selectedSSID.clear();
+  selectedLink = WifiLink{};
   connectedIP.clear();
   connectionError.clear();
   enteredPassword.clear();
@@ -57,6 +59,7 @@ void WifiSelectionActivity::onEnter() {
         selectedSSID = cred->ssid;
         enteredPassword = cred->password;
         selectedRequiresPassword = !cred->password.empty();
+        selectedLink = cred->link;
         usedSavedPassword = true;
         autoConnecting = true;
         attemptConnection();
@@ -138,6 +141,11 @@ void WifiSelectionActivity::processWifiScanResults() {
       network.rssi = rssi;
       network.isEncrypted = (WiFi.encryptionType(i) != WIFI_AUTH_OPEN);
       network.hasSavedPassword = WIFI_STORE.hasSavedCredential(network.ssid);
+      const uint8_t* bssid = WiFi.BSSID(i);
+      if (bssid) {
+        memcpy(network.link.bssid, bssid, sizeof(network.link.bssid));
+        network.link.channel = static_cast<uint8_t>(WiFi.channel(i));
+      }
       uniqueNetworks[ssid] = network;
     }
   }
@@ -176,8 +184,9 @@ void WifiSelectionActivity::selectNetwork(const int index) {
   enteredPassword.clear();
   autoConnecting = false;
 
-  // Check if we have saved credentials for this network
+  // The scan just found the access point, so connect to it directly. Its saved lease is only good for the same one.
   const auto* savedCred = WIFI_STORE.findCredential(selectedSSID);
+  selectedLink = savedCred && savedCred->link.sameAccessPoint(network.link) ? savedCred->link : network.link;
   if (savedCred && !savedCred->password.empty()) {
     // Use saved password - connect directly
     enteredPassword = savedCred->password;
@@ -214,18 +223,11 @@ void WifiSelectionActivity::selectNetwork(const int index) {
 
 void WifiSelectionActivity::attemptConnection() {
   state = autoConnecting ? WifiSelectionState::AUTO_CONNECTING : WifiSelectionState::CONNECTING;
-  connectionStartTime = millis();
   connectedIP.clear();
   connectionError.clear();
   requestUpdate();
 
-  WiFi.mode(WIFI_STA);
-
-  if (selectedRequiresPassword && !enteredPassword.empty()) {
-    WiFi.begin(selectedSSID.c_str(), enteredPassword.c_str());
-  } else {
-    WiFi.begin(selectedSSID.c_str());
-  }
+  connector.begin(selectedSSID, selectedRequiresPassword ? enteredPassword : std::string(), selectedLink);
 }
 
 void WifiSelectionActivity::checkConnectionStatus() {
@@ -233,9 +235,9 @@ void WifiSelectionActivity::checkConnectionStatus() {
     return;
   }
 
-  const wl_status_t status = WiFi.status();
+  const WifiConnector::Result result = connector.update();
 
-  if (status == WL_CONNECTED) {
+  if (result == WifiConnector::Result::Connected) {
     // Successfully connected
     IPAddress ip = WiFi.localIP();
     char ipStr[16];
@@ -243,11 +245,12 @@ void WifiSelectionActivity::checkConnectionStatus() {
     connectedIP = ipStr;
     autoConnecting = false;
 
-    // Save this as the last connected network - SD card operations need lock as
-    // we use SPI for both
+    // Save this as the last connected network and where it was found - SD card operations need lock as we use SPI
+    // for both
     {
       RenderLock lock(*this);
       WIFI_STORE.setLastConnectedSsid(selectedSSID);
+      WIFI_STORE.setLink(selectedSSID, connector.getLink());
     }
 
     // If we entered a new password, ask if user wants to save it
@@ -266,24 +269,30 @@ void WifiSelectionActivity::checkConnectionStatus() {
     return;
   }
 
-  if (status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL) {
-    connectionError = tr(STR_ERROR_GENERAL_FAILURE);
-    if (status == WL_NO_SSID_AVAIL) {
-      connectionError = tr(STR_ERROR_NETWORK_NOT_FOUND);
-    }
-    state = WifiSelectionState::CONNECTION_FAILED;
-    requestUpdate();
+  if (result == WifiConnector::Result::Pending) {
     return;
   }
 
-  // Check for timeout
-  if (millis() - connectionStartTime > CONNECTION_TIMEOUT_MS) {
-    WiFi.disconnect();
+  if (connector.isLinkStale()) {
+    // The remembered access point did not answer, don't try it first again
+    RenderLock lock(*this);
+    WIFI_STORE.setLink(selectedSSID, WifiLink{});
+  } else if (selectedLink.lease.ip != 0) {
+    // Whatever went wrong, the next attempt asks DHCP again rather than trusting the remembered address
+    selectedLink.lease = WifiLease{};
+    RenderLock lock(*this);
+    WIFI_STORE.setLink(selectedSSID, selectedLink);
+  }
+
+  if (result == WifiConnector::Result::TimedOut) {
     connectionError = tr(STR_ERROR_CONNECTION_TIMEOUT);
-    state = WifiSelectionState::CONNECTION_FAILED;
-    requestUpdate();
-    return;
+  } else if (result == WifiConnector::Result::NoNetwork) {
+    connectionError = tr(STR_ERROR_NETWORK_NOT_FOUND);
+  } else {
+    connectionError = tr(STR_ERROR_GENERAL_FAILURE);
   }
+  state = WifiSelectionState::CONNECTION_FAILED;
+  requestUpdate();
 }
 
 void WifiSelectionActivity::loop() {
@@ -329,6 +338,7 @@ void WifiSelectionActivity::loop() {
         // User chose "Yes" - save the password
         RenderLock lock(*this);
         WIFI_STORE.addCredential(selectedSSID, enteredPassword);
+        WIFI_STORE.setLink(selectedSSID, connector.getLink());
       }
       // Complete - parent will start web server
       onComplete(true);
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "activities/ActivityWithSubactivity.h"
+#include "network/WifiConnector.h"
 #include "util/ButtonNavigator.h"
 
 // Structure to hold WiFi network information
@@ -15,6 +16,7 @@ struct WifiNetworkInfo {
   int32_t rssi;
   bool isEncrypted;
   bool hasSavedPassword;  // Whether we have saved credentials for this network
+  WifiLink link;          // Access point and channel of the strongest signal
 };
 
 // WiFi selection states
@@ -52,6 +54,9 @@ class WifiSelectionActivity final : public ActivityWithSubactivity {
   // Selected network for connection
   std::string selectedSSID;
   bool selectedRequiresPassword = false;
+  WifiLink selectedLink;
+
+  WifiConnector connector{HalWifi::getInstance()};
 
   // Connection result
   std::string connectedIP;
@@ -76,10 +81,6 @@ class WifiSelectionActivity final : public ActivityWithSubactivity {
   int savePromptSelection = 0;
   int forgetPromptSelection = 0;
 
-  // Connection timeout
-  static constexpr unsigned long CONNECTION_TIMEOUT_MS = 15000;
-  unsigned long connectionStartTime = 0;
-
   void renderNetworkList() const;
   void renderPasswordEntry() const;
   void renderConnecting() const;
@@ -3,18 +3,25 @@
 #include <Epub/Page.h>
 #include <FsHelpers.h>
 #include <GfxRenderer.h>
+#include <HalSpiBus.h>
 #include <HalStorage.h>
 #include <I18n.h>
 #include <Logging.h>
 
+#include <ctime>
+
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "EpubReaderChapterSelectionActivity.h"
 #include "EpubReaderPercentSelectionActivity.h"
 #include "KOReaderCredentialStore.h"
+#include "KOReaderDocumentId.h"
+#include "KOReaderProgressQueue.h"
 #include "KOReaderSyncActivity.h"
 #include "MappedInputManager.h"
+#include "PageSnapshot.h"
 #include "RecentBooksStore.h"
+#include "RenderTrace.h"
 #include "components/UITheme.h"
 #include "fontIds.h"
 
@@ -22,6 +29,8 @@ namespace {
 // pagesPerRefresh now comes from SETTINGS.getRefreshFrequency()
 constexpr unsigned long skipChapterMs = 700;
 constexpr unsigned long goHomeMs = 1000;
+// Pages are only pre-rendered once the reader has rested on a page this long, so turning pages never waits on it
+constexpr unsigned long pageCacheIdleMs = 1500;
 constexpr int statusBarMargin = 19;
 constexpr int progressBarMarginTop = 1;
 
@@ -111,12 +120,58 @@ void EpubReaderActivity::onExit() {
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
 
+  // Leave the position for the next time the device is online, no need to bring up WiFi for it now
+  if (epub && section && KOREADER_STORE.hasCredentials()) {
+    const std::string document =
+        KOReaderDocumentId::calculateCached(epub->getPath(), epub->getCachePath(), KOREADER_STORE.getMatchMethod());
+    if (!document.empty()) {
+      const KOReaderPosition position = ProgressMapper::toKOReader(
+          epub, {currentSpineIndex, section->currentPage, section->pageCount,
+                 section->getElementPathForPage(section->currentPage)});
+      KOReaderProgress progress{};
+      progress.document = document;
+      progress.progress = position.xpath;
+      progress.percentage = position.percentage;
+      // Only a clock that was set (by an earlier NTP sync) can tell whether the server has newer progress
+      const time_t now = time(nullptr);
+      progress.timestamp = now > 1600000000 ? now : 0;
+      KOREADER_QUEUE.add(progress);
+    }
+  }
+
   APP_STATE.readerActivityLoadCount = 0;
   APP_STATE.saveToFile();
+  pageCache.reset();
   section.reset();
   epub.reset();
 }
 
+void EpubReaderActivity::onEnterSleep() {
+  RenderLock lock(*this);
+  if (!epub || !section || section->currentPage < 0 || section->currentPage >= section->pageCount) {
+    PAGE_SNAPSHOT.discard();
+    return;
+  }
+
+  // Re-render rather than trusting the frame buffer, which may hold a menu drawn over the page
+  auto page = section->loadPageFromSectionFile();
+  if (!page) {
+    PAGE_SNAPSHOT.discard();
+    return;
+  }
+  int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
+  getOrientedMargins(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom, &orientedMarginLeft);
+  PAGE_SNAPSHOT.save(renderer, epub->getPath(), currentSpineIndex, section->currentPage, SETTINGS.textAntiAliasing,
+                     [&](const GfxRenderer::RenderMode mode) {
+                       renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+                       renderer.setRenderMode(mode);
+                       page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+                       if (mode == GfxRenderer::BW) {
+                         renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+                       }
+                     });
+}
+
 void EpubReaderActivity::loop() {
   // Pass input responsibility to sub activity if exists
   if (subActivity) {
@@ -207,6 +262,7 @@ void EpubReaderActivity::loop() {
                                     mappedInput.wasReleased(MappedInputManager::Button::Right));
 
   if (!prevTriggered && !nextTriggered) {
+    fillPageCache();
     return;
   }
 
@@ -214,6 +270,7 @@ void EpubReaderActivity::loop() {
   if (currentSpineIndex > 0 && currentSpineIndex >= epub->getSpineItemsCount()) {
     currentSpineIndex = epub->getSpineItemsCount() - 1;
     nextPageNumber = UINT16_MAX;
+    pendingPageTurns.clear();
     requestUpdate();
     return;
   }
@@ -226,45 +283,17 @@ void EpubReaderActivity::loop() {
       RenderLock lock(*this);
       nextPageNumber = 0;
       currentSpineIndex = nextTriggered ? currentSpineIndex + 1 : currentSpineIndex - 1;
+      pendingPageTurns.clear();
       section.reset();
     }
     requestUpdate();
     return;
   }
 
-  // No current section, attempt to rerender the book
-  if (!section) {
-    requestUpdate();
-    return;
-  }
-
-  if (prevTriggered) {
-    if (section->currentPage > 0) {
-      section->currentPage--;
-    } else {
-      // We don't want to delete the section mid-render, so grab the semaphore
-      {
-        RenderLock lock(*this);
-        nextPageNumber = UINT16_MAX;
-        currentSpineIndex--;
-        section.reset();
-      }
-    }
-    requestUpdate();
-  } else {
-    if (section->currentPage < section->pageCount - 1) {
-      section->currentPage++;
-    } else {
-      // We don't want to delete the section mid-render, so grab the semaphore
-      {
-        RenderLock lock(*this);
-        nextPageNumber = 0;
-        currentSpineIndex++;
-        section.reset();
-      }
-    }
-    requestUpdate();
-  }
+  // Only queue the turn: the render task works out where it lands, so turns made while a page is still refreshing
+  // collapse into a single jump instead of each loading and refreshing its own page
+  pendingPageTurns.push(prevTriggered ? -1 : 1);
+  requestUpdate();
 }
 
 void EpubReaderActivity::onReaderMenuBack(const uint8_t orientation) {
@@ -357,10 +386,12 @@ void EpubReaderActivity::onReaderMenuConfirm(EpubReaderMenuActivity::MenuAction
             exitActivity();
             requestUpdate();
           },
-          [this](const int newSpineIndex) {
-            if (currentSpineIndex != newSpineIndex) {
+          [this](const int newSpineIndex, const std::string& anchor) {
+            // An anchor can point anywhere in the chapter, so it is looked up even within the current one
+            if (currentSpineIndex != newSpineIndex || !anchor.empty()) {
               currentSpineIndex = newSpineIndex;
               nextPageNumber = 0;
+              pendingAnchor = anchor;
               section.reset();
             }
             exitActivity();
@@ -435,18 +466,21 @@ void EpubReaderActivity::onReaderMenuConfirm(EpubReaderMenuActivity::MenuAction
       if (KOREADER_STORE.hasCredentials()) {
         const int currentPage = section ? section->currentPage : 0;
         const int totalPages = section ? section->pageCount : 0;
+        const std::string elementPath = section ? section->getElementPathForPage(currentPage) : "";
         exitActivity();
         enterNewActivity(new KOReaderSyncActivity(
-            renderer, mappedInput, epub, epub->getPath(), currentSpineIndex, currentPage, totalPages,
+            renderer, mappedInput, epub, epub->getPath(), currentSpineIndex, currentPage, totalPages, elementPath,
             [this]() {
               // On cancel - defer exit to avoid use-after-free
               pendingSubactivityExit = true;
             },
-            [this](int newSpineIndex, int newPage) {
+            [this](int newSpineIndex, int newPage, const std::string& elementPath) {
               // On sync complete - update position and defer exit
-              if (currentSpineIndex != newSpineIndex || (section && section->currentPage != newPage)) {
+              if (currentSpineIndex != newSpineIndex || !elementPath.empty() ||
+                  (section && section->currentPage != newPage)) {
                 currentSpineIndex = newSpineIndex;
                 nextPageNumber = newPage;
+                pendingElementPath = elementPath;
                 section.reset();
               }
               pendingSubactivityExit = true;
@@ -484,54 +518,69 @@ void EpubReaderActivity::applyOrientation(const uint8_t orientation) {
   }
 }
 
+void EpubReaderActivity::getOrientedMargins(int* outTop, int* outRight, int* outBottom, int* outLeft) const {
+  // Apply screen viewable areas and additional padding
+  renderer.getOrientedViewableTRBL(outTop, outRight, outBottom, outLeft);
+  *outTop += SETTINGS.screenMargin;
+  *outLeft += SETTINGS.screenMargin;
+  *outRight += SETTINGS.screenMargin;
+  *outBottom += SETTINGS.screenMargin;
+
+  auto metrics = UITheme::getInstance().getMetrics();
+
+  // Add status bar margin
+  if (SETTINGS.statusBar != CrossPointSettings::STATUS_BAR_MODE::NONE) {
+    // Add additional margin for status bar if progress bar is shown
+    const bool showProgressBar = SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::BOOK_PROGRESS_BAR ||
+                                 SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::ONLY_BOOK_PROGRESS_BAR ||
+                                 SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::CHAPTER_PROGRESS_BAR;
+    *outBottom += statusBarMargin - SETTINGS.screenMargin +
+                  (showProgressBar ? (metrics.bookProgressBarHeight + progressBarMarginTop) : 0);
+  }
+}
+
 // TODO: Failure handling
 void EpubReaderActivity::render(Activity::RenderLock&& lock) {
   if (!epub) {
     return;
   }
 
-  // edge case handling for sub-zero spine index
-  if (currentSpineIndex < 0) {
-    currentSpineIndex = 0;
+  // Page turns queued by loop() since the last render, only the page they end up on gets loaded and displayed
+  int turns = pendingPageTurns.take();
+  if (turns > 1 || turns < -1) {
+    LOG_DBG("ERS", "Coalesced %d page turns", turns);
   }
-  // based bounds of book, show end of book screen
-  if (currentSpineIndex > epub->getSpineItemsCount()) {
-    currentSpineIndex = epub->getSpineItemsCount();
+  if (section && turns != 0) {
+    applyPageTurns(turns);
   }
 
-  // Show end of book screen
-  if (currentSpineIndex == epub->getSpineItemsCount()) {
-    renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_END_OF_BOOK), true, EpdFontFamily::BOLD);
-    renderer.displayBuffer();
-    return;
-  }
-
-  // Apply screen viewable areas and additional padding
   int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
-  renderer.getOrientedViewableTRBL(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom,
-                                   &orientedMarginLeft);
-  orientedMarginTop += SETTINGS.screenMargin;
-  orientedMarginLeft += SETTINGS.screenMargin;
-  orientedMarginRight += SETTINGS.screenMargin;
-  orientedMarginBottom += SETTINGS.screenMargin;
+  getOrientedMargins(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom, &orientedMarginLeft);
 
-  auto metrics = UITheme::getInstance().getMetrics();
+  // Turns that run past a chapter boundary load each chapter on the way for its page count, without rendering it
+  while (!section) {
+    // edge case handling for sub-zero spine index
+    if (currentSpineIndex < 0) {
+      currentSpineIndex = 0;
+    }
+    // based bounds of book, show end of book screen
+    if (currentSpineIndex > epub->getSpineItemsCount()) {
+      currentSpineIndex = epub->getSpineItemsCount();
+    }
 
-  // Add status bar margin
-  if (SETTINGS.statusBar != CrossPointSettings::STATUS_BAR_MODE::NONE) {
-    // Add additional margin for status bar if progress bar is shown
-    const bool showProgressBar = SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::BOOK_PROGRESS_BAR ||
-                                 SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::ONLY_BOOK_PROGRESS_BAR ||
-                                 SETTINGS.statusBar == CrossPointSettings::STATUS_BAR_MODE::CHAPTER_PROGRESS_BAR;
-    orientedMarginBottom += statusBarMargin - SETTINGS.screenMargin +
-                            (showProgressBar ? (metrics.bookProgressBarHeight + progressBarMarginTop) : 0);
-  }
+    // Show end of book screen
+    if (currentSpineIndex == epub->getSpineItemsCount()) {
+      renderer.clearScreen();
+      renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_END_OF_BOOK), true, EpdFontFamily::BOLD);
+      renderer.displayBuffer();
+      return;
+    }
 
-  if (!section) {
     const auto filepath = epub->getSpineItem(currentSpineIndex).href;
     LOG_DBG("ERS", "Loading file: %s, index: %d", filepath.c_str(), currentSpineIndex);
     section = std::unique_ptr<Section>(new Section(epub, currentSpineIndex, renderer));
+    prefetchedPage.reset();
+    pageCache.reset();
 
     const uint16_t viewportWidth = renderer.getScreenWidth() - orientedMarginLeft - orientedMarginRight;
     const uint16_t viewportHeight = renderer.getScreenHeight() - orientedMarginTop - orientedMarginBottom;
@@ -550,9 +599,12 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
         section.reset();
         return;
       }
+      // Pages pre-rendered from the previous section file may not match the new one
+      Storage.remove(SectionPageCache::pathFor(section->getFilePath()).c_str());
     } else {
       LOG_DBG("ERS", "Cache found, skipping build...");
     }
+    openPageCache(orientedMarginTop, orientedMarginLeft);
 
     if (nextPageNumber == UINT16_MAX) {
       section->currentPage = section->pageCount - 1;
@@ -580,6 +632,21 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
       section->currentPage = newPage;
       pendingPercentJump = false;
     }
+
+    // Positions recorded in the section file beat the chapter start and byte estimates
+    if (!pendingAnchor.empty() || !pendingElementPath.empty()) {
+      const int page = !pendingAnchor.empty() ? section->getPageForAnchor(pendingAnchor)
+                                              : section->getPageForElementPath(pendingElementPath);
+      if (page >= 0 && page < section->pageCount) {
+        section->currentPage = page;
+      }
+      pendingAnchor.clear();
+      pendingElementPath.clear();
+    }
+
+    if (turns != 0) {
+      applyPageTurns(turns);
+    }
   }
 
   renderer.clearScreen();
@@ -601,23 +668,155 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
   }
 
   {
-    auto p = section->loadPageFromSectionFile();
-    if (!p) {
-      LOG_ERR("ERS", "Failed to load page from SD - clearing section cache");
-      section->clearCache();
-      section.reset();
-      requestUpdate();  // Try again after clearing cache
-      // TODO: prevent infinite loop if the page keeps failing to load for some reason
-      return;
+    const int pageIndex = section->currentPage;
+    const bool cached = pageCache && pageCache->has(pageIndex);
+    std::unique_ptr<Page> p;
+    if (!cached) {
+      p = prefetchedPage && prefetchedPageIndex == pageIndex ? std::move(prefetchedPage)
+                                                             : section->loadPageFromSectionFile();
+      if (!p) {
+        LOG_ERR("ERS", "Failed to load page from SD - clearing section cache");
+        pageCache.reset();
+        Storage.remove(SectionPageCache::pathFor(section->getFilePath()).c_str());
+        section->clearCache();
+        section.reset();
+        requestUpdate();  // Try again after clearing cache
+        // TODO: prevent infinite loop if the page keeps failing to load for some reason
+        return;
+      }
     }
+    prefetchedPage.reset();
+    const bool hasImages =
+        p ? p->hasImages() : (pageCache->getFlags(pageIndex) & SectionPageCache::FLAG_HAS_IMAGES) != 0;
+
     const auto start = millis();
-    renderContents(std::move(p), orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
-    LOG_DBG("ERS", "Rendered page in %dms", millis() - start);
+    renderContents(
+        [&](const GfxRenderer::RenderMode mode) {
+          if (!p && pageCache->drawPlane(renderer, pageIndex, mode)) {
+            return;
+          }
+          // Not cached, or the cached record could not be read back
+          if (!p) {
+            p = section->loadPageFromSectionFile(pageIndex);
+          }
+          renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+          if (p) {
+            p->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+          }
+        },
+        hasImages, orientedMarginRight, orientedMarginBottom, orientedMarginLeft,
+        [this] {
+          saveProgress(currentSpineIndex, section->currentPage, section->pageCount);
+          // Most turns go forward, so the next page is read while this one is still being refreshed
+          const int nextPage = section->currentPage + 1;
+          if (nextPage < section->pageCount && !(pageCache && pageCache->has(nextPage))) {
+            prefetchedPage = section->loadPageFromSectionFile(nextPage);
+            prefetchedPageIndex = nextPage;
+          }
+        });
+    lastRenderAt = millis();
+    LOG_DBG("ERS", "Rendered %s page in %dms", cached ? "cached" : "uncached", millis() - start);
+  }
+}
+
+void EpubReaderActivity::openPageCache(const int orientedMarginTop, const int orientedMarginLeft) {
+  pageCache.reset();
+  if (!SETTINGS.pageBitmapCache || section->pageCount == 0) {
+    return;
+  }
+
+  // Everything that moves a pixel of the page content; the status bar is drawn live over cached pages
+  char id[160];
+  snprintf(id, sizeof(id), "%s|%d|%.3f|%d|%d|%d|%d|%d|%d|%d|%d|%d", CROSSPOINT_VERSION, SETTINGS.getReaderFontId(),
+           SETTINGS.getReaderLineCompression(), SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment,
+           SETTINGS.hyphenationEnabled, SETTINGS.embeddedStyle, SETTINGS.orientation, renderer.getScreenWidth(),
+           renderer.getScreenHeight(), orientedMarginTop, orientedMarginLeft);
+  uint32_t key = 2166136261u;
+  for (const char* c = id; *c; c++) {
+    key ^= static_cast<uint8_t>(*c);
+    key *= 16777619u;
+  }
+
+  pageCache.reset(new SectionPageCache());
+  if (!pageCache->open(SectionPageCache::pathFor(section->getFilePath()), key, section->pageCount,
+                       SETTINGS.textAntiAliasing)) {
+    pageCache.reset();
+  }
+}
+
+void EpubReaderActivity::fillPageCache() {
+  if (!pageCache || subActivity || !pendingPageTurns.empty() || renderer.isDisplayBusy() ||
+      millis() - lastRenderAt < pageCacheIdleMs) {
+    return;
+  }
+
+  RenderLock lock(*this);
+  if (!section || !pageCache || section->currentPage < 0 || section->currentPage >= section->pageCount) {
+    return;
+  }
+  // The current page first, then onwards in reading order
+  const int pageIndex = pageCache->nextMissing(section->currentPage);
+  if (pageIndex < 0) {
+    return;
+  }
+
+  auto page = section->loadPageFromSectionFile(pageIndex);
+  if (!page) {
+    LOG_ERR("ERS", "Failed to load page %d for the page cache", pageIndex);
+    pageCache.reset();
+    return;
+  }
+  // The frame buffer holds the page on the panel, it is needed again for the next differential refresh
+  if (!renderer.storeBwBuffer()) {
+    return;
+  }
+  int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
+  getOrientedMargins(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom, &orientedMarginLeft);
+  const bool stored = pageCache->store(renderer, pageIndex, page->hasImages() ? SectionPageCache::FLAG_HAS_IMAGES : 0,
+                                       [&](const GfxRenderer::RenderMode mode) {
+                                         renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+                                         renderer.setRenderMode(mode);
+                                         page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft,
+                                                      orientedMarginTop);
+                                       });
+  renderer.restoreBwBuffer();
+  if (!stored) {
+    // Most likely a full card, stop trying for this section
+    pageCache.reset();
   }
-  saveProgress(currentSpineIndex, section->currentPage, section->pageCount);
+}
+
+void EpubReaderActivity::applyPageTurns(int& turns) {
+  // An empty chapter still takes one turn to get through
+  const int pageCount = std::max<int>(section->pageCount, 1);
+  const int target = section->currentPage + turns;
+  if (target >= 0 && target < pageCount) {
+    section->currentPage = target;
+    turns = 0;
+    return;
+  }
+
+  if (target < 0 && currentSpineIndex == 0) {
+    section->currentPage = 0;
+    turns = 0;
+    return;
+  }
+
+  // Step into the neighbouring chapter, what is left of the turns is applied once it is loaded
+  if (target >= pageCount) {
+    turns = target - pageCount;
+    nextPageNumber = 0;
+    currentSpineIndex++;
+  } else {
+    turns = target + 1;
+    nextPageNumber = UINT16_MAX;
+    currentSpineIndex--;
+  }
+  section.reset();
 }
 
 void EpubReaderActivity::saveProgress(int spineIndex, int currentPage, int pageCount) {
+  const auto start = micros();
   FsFile f;
   if (Storage.openFileForWrite("ERS", epub->getCachePath() + "/progress.bin", f)) {
     uint8_t data[6];
@@ -633,39 +832,56 @@ void EpubReaderActivity::saveProgress(int spineIndex, int currentPage, int pageC
   } else {
     LOG_ERR("ERS", "Could not save progress!");
   }
+  RENDER_TRACE.addSaveTime(micros() - start);
 }
-void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int orientedMarginTop,
-                                        const int orientedMarginRight, const int orientedMarginBottom,
-                                        const int orientedMarginLeft) {
+
+void EpubReaderActivity::renderContents(const std::function<void(GfxRenderer::RenderMode)>& drawPage,
+                                        const bool hasImages, const int orientedMarginRight,
+                                        const int orientedMarginBottom, const int orientedMarginLeft,
+                                        const std::function<void()>& whileRefreshing) {
+  drawPage(GfxRenderer::BW);
+  renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+
+  // Woken from sleep with this page already on the panel: only the frame buffer needed rebuilding
+  if (PAGE_SNAPSHOT.takeShown(epub->getPath(), currentSpineIndex, section->currentPage)) {
+    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
+    whileRefreshing();
+    return;
+  }
+
   // Force full refresh for pages with images when anti-aliasing is on,
   // as grayscale tones require half refresh to display correctly
-  bool forceFullRefresh = page->hasImages() && SETTINGS.textAntiAliasing;
+  bool forceFullRefresh = hasImages && SETTINGS.textAntiAliasing;
 
-  page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
-  renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
   if (forceFullRefresh || pagesUntilFullRefresh <= 1) {
-    renderer.displayBuffer(HalDisplay::HALF_REFRESH);
+    renderer.displayBufferAsync(HalDisplay::HALF_REFRESH);
     pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
   } else {
-    renderer.displayBuffer();
+    renderer.displayBufferAsync();
     pagesUntilFullRefresh--;
   }
 
-  // Save bw buffer to reset buffer state after grayscale data sync
+  // Save bw buffer to reset buffer state after grayscale data sync (only reads the frame buffer, so it does not have
+  // to wait for the panel)
   renderer.storeBwBuffer();
 
+  // The refresh task outranks this one and takes the SPI bus first, so the SD work below waits for the frame to reach
+  // the panel instead of delaying it
+  {
+    SpiBusLock bus;
+    whileRefreshing();
+  }
+
   // grayscale rendering
   // TODO: Only do this if font supports it
   if (SETTINGS.textAntiAliasing) {
-    renderer.clearScreen(0x00);
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+    drawPage(GfxRenderer::GRAYSCALE_LSB);
     renderer.copyGrayscaleLsbBuffers();
 
     // Render and copy to MSB buffer
-    renderer.clearScreen(0x00);
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+    drawPage(GfxRenderer::GRAYSCALE_MSB);
     renderer.copyGrayscaleMsbBuffers();
 
     // display grayscale part
@@ -2,7 +2,12 @@
 #include <Epub.h>
 #include <Epub/Section.h>
 
+#include <atomic>
+#include <functional>
+
 #include "EpubReaderMenuActivity.h"
+#include "PageTurnQueue.h"
+#include "SectionPageCache.h"
 #include "activities/ActivityWithSubactivity.h"
 
 class EpubReaderActivity final : public ActivityWithSubactivity {
@@ -18,16 +23,38 @@ class EpubReaderActivity final : public ActivityWithSubactivity {
   bool pendingPercentJump = false;
   // Normalized 0.0-1.0 progress within the target spine item, computed from book percentage.
   float pendingSpineProgress = 0.0f;
+  // TOC anchor or KOReader element path to look up in the section file once the target section is loaded
+  std::string pendingAnchor;
+  std::string pendingElementPath;
+  // Page turns made since the last render
+  PageTurnQueue pendingPageTurns;
   bool pendingSubactivityExit = false;  // Defer subactivity exit to avoid use-after-free
   bool pendingGoHome = false;           // Defer go home to avoid race condition with display task
   bool skipNextButtonCheck = false;     // Skip button processing for one frame after subactivity exit
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
-  void renderContents(std::unique_ptr<Page> page, int orientedMarginTop, int orientedMarginRight,
-                      int orientedMarginBottom, int orientedMarginLeft);
+  // Next page read ahead while the current one was refreshing, only valid for the current section
+  std::unique_ptr<Page> prefetchedPage;
+  int prefetchedPageIndex = -1;
+  // Pre-rendered pages of the current section, only open with the page bitmap cache setting on
+  std::unique_ptr<SectionPageCache> pageCache;
+  std::atomic<unsigned long> lastRenderAt{0};
+
+  // drawPage(mode) fills the frame buffer with the page for that render mode, the status bar is drawn over it.
+  // whileRefreshing runs once the BW refresh has been started, holding the SPI bus; it must not draw
+  void renderContents(const std::function<void(GfxRenderer::RenderMode)>& drawPage, bool hasImages,
+                      int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft,
+                      const std::function<void()>& whileRefreshing);
+  void openPageCache(int orientedMarginTop, int orientedMarginLeft);
+  // Render one page of the current section into the page cache, if the reader has been idle for a while
+  void fillPageCache();
+  void getOrientedMargins(int* outTop, int* outRight, int* outBottom, int* outLeft) const;
   void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
   void saveProgress(int spineIndex, int currentPage, int pageCount);
+  // Move the current position by turns pages. When that leaves the section, steps to the neighbouring chapter and
+  // resets section, leaving the turns still to be applied there in turns.
+  void applyPageTurns(int& turns);
   // Jump to a percentage of the book (0-100), mapping it to spine and page.
   void jumpToPercent(int percent);
   void onReaderMenuBack(uint8_t orientation);
@@ -43,6 +70,7 @@ class EpubReaderActivity final : public ActivityWithSubactivity {
         onGoHome(onGoHome) {}
   void onEnter() override;
   void onExit() override;
+  void onEnterSleep() override;
   void loop() override;
   void render(Activity::RenderLock&& lock) override;
 };
@@ -8,6 +8,7 @@
 
 #include "KOReaderCredentialStore.h"
 #include "KOReaderDocumentId.h"
+#include "KOReaderProgressQueue.h"
 #include "MappedInputManager.h"
 #include "activities/network/WifiSelectionActivity.h"
 #include "components/UITheme.h"
@@ -72,12 +73,8 @@ void KOReaderSyncActivity::onWifiSelectionComplete(const bool success) {
 }
 
 void KOReaderSyncActivity::performSync() {
-  // Calculate document hash based on user's preferred method
-  if (KOREADER_STORE.getMatchMethod() == DocumentMatchMethod::FILENAME) {
-    documentHash = KOReaderDocumentId::calculateFromFilename(epubPath);
-  } else {
-    documentHash = KOReaderDocumentId::calculate(epubPath);
-  }
+  // Calculate document hash based on user's preferred method, read from the book cache after the first time
+  documentHash = KOReaderDocumentId::calculateCached(epubPath, epub->getCachePath(), KOREADER_STORE.getMatchMethod());
   if (documentHash.empty()) {
     {
       RenderLock lock(*this);
@@ -126,7 +123,7 @@ void KOReaderSyncActivity::performSync() {
   remotePosition = ProgressMapper::toCrossPoint(epub, koPos, totalPagesInSpine);
 
   // Calculate local progress in KOReader format (for display)
-  CrossPointPosition localPos = {currentSpineIndex, currentPage, totalPagesInSpine};
+  CrossPointPosition localPos = {currentSpineIndex, currentPage, totalPagesInSpine, currentElementPath};
   localProgress = ProgressMapper::toKOReader(epub, localPos);
 
   {
@@ -147,7 +144,7 @@ void KOReaderSyncActivity::performUpload() {
   requestUpdateAndWait();
 
   // Convert current position to KOReader format
-  CrossPointPosition localPos = {currentSpineIndex, currentPage, totalPagesInSpine};
+  CrossPointPosition localPos = {currentSpineIndex, currentPage, totalPagesInSpine, currentElementPath};
   KOReaderPosition koPos = ProgressMapper::toKOReader(epub, localPos);
 
   KOReaderProgress progress;
@@ -169,6 +166,8 @@ void KOReaderSyncActivity::performUpload() {
 
   {
     RenderLock lock(*this);
+    // Whatever the reader queued for this book is older than what was just uploaded
+    KOREADER_QUEUE.remove(documentHash);
     state = UPLOAD_COMPLETE;
   }
   requestUpdate();
@@ -222,6 +221,8 @@ void KOReaderSyncActivity::onEnter() {
 void KOReaderSyncActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
+  KOReaderSyncClient::pushQueuedProgress();
+
   // Turn off wifi
   WiFi.disconnect(false);
   delay(100);
@@ -374,8 +375,12 @@ void KOReaderSyncActivity::loop() {
 
     if (mappedInput.wasPressed(MappedInputManager::Button::Confirm)) {
       if (selectedOption == 0) {
-        // Apply remote progress
-        onSyncComplete(remotePosition.spineIndex, remotePosition.pageNumber);
+        // Apply remote progress, the position queued for this book is no longer wanted
+        {
+          RenderLock lock(*this);
+          KOREADER_QUEUE.remove(documentHash);
+        }
+        onSyncComplete(remotePosition.spineIndex, remotePosition.pageNumber, remotePosition.elementPath);
       } else if (selectedOption == 1) {
         // Upload local progress
         performUpload();
@@ -392,11 +397,8 @@ void KOReaderSyncActivity::loop() {
     if (mappedInput.wasPressed(MappedInputManager::Button::Confirm)) {
       // Calculate hash if not done yet
       if (documentHash.empty()) {
-        if (KOREADER_STORE.getMatchMethod() == DocumentMatchMethod::FILENAME) {
-          documentHash = KOReaderDocumentId::calculateFromFilename(epubPath);
-        } else {
-          documentHash = KOReaderDocumentId::calculate(epubPath);
-        }
+        documentHash =
+            KOReaderDocumentId::calculateCached(epubPath, epub->getCachePath(), KOREADER_STORE.getMatchMethod());
       }
       performUpload();
     }
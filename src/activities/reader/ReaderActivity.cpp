@@ -2,6 +2,7 @@
 
 #include <HalStorage.h>
 
+#include "BookCacheManager.h"
 #include "CrossPointSettings.h"
 #include "Epub.h"
 #include "EpubReaderActivity.h"
@@ -10,6 +11,7 @@
 #include "Xtc.h"
 #include "XtcReaderActivity.h"
 #include "activities/util/FullScreenMessageActivity.h"
+#include "components/UITheme.h"
 #include "util/StringUtils.h"
 
 std::string ReaderActivity::extractFolderPath(const std::string& filePath) {
@@ -83,6 +85,8 @@ void ReaderActivity::goToLibrary(const std::string& fromBookPath) {
 void ReaderActivity::onGoToEpubReader(std::unique_ptr<Epub> epub) {
   const auto epubPath = epub->getPath();
   currentBookPath = epubPath;
+  currentCacheDir = epub->getCachePath();
+  BOOK_CACHE.touch(epubPath, currentCacheDir);
   exitActivity();
   enterNewActivity(new EpubReaderActivity(
       renderer, mappedInput, std::move(epub), [this, epubPath] { goToLibrary(epubPath); }, [this] { onGoBack(); }));
@@ -91,6 +95,8 @@ void ReaderActivity::onGoToEpubReader(std::unique_ptr<Epub> epub) {
 void ReaderActivity::onGoToXtcReader(std::unique_ptr<Xtc> xtc) {
   const auto xtcPath = xtc->getPath();
   currentBookPath = xtcPath;
+  currentCacheDir = xtc->getCachePath();
+  BOOK_CACHE.touch(xtcPath, currentCacheDir);
   exitActivity();
   enterNewActivity(new XtcReaderActivity(
       renderer, mappedInput, std::move(xtc), [this, xtcPath] { goToLibrary(xtcPath); }, [this] { onGoBack(); }));
@@ -99,14 +105,25 @@ void ReaderActivity::onGoToXtcReader(std::unique_ptr<Xtc> xtc) {
 void ReaderActivity::onGoToTxtReader(std::unique_ptr<Txt> txt) {
   const auto txtPath = txt->getPath();
   currentBookPath = txtPath;
+  currentCacheDir = txt->getCachePath();
+  BOOK_CACHE.touch(txtPath, currentCacheDir);
   exitActivity();
   enterNewActivity(new TxtReaderActivity(
       renderer, mappedInput, std::move(txt), [this, txtPath] { goToLibrary(txtPath); }, [this] { onGoBack(); }));
 }
 
+void ReaderActivity::onExit() {
+  ActivityWithSubactivity::onExit();
+  // Trim the book cache once the book is closed (also on the way to sleep), so opening a book never waits on it
+  BOOK_CACHE.enforceBudget(currentCacheDir);
+}
+
 void ReaderActivity::onEnter() {
   ActivityWithSubactivity::onEnter();
 
+  // Menu tiles are cheap to rebuild; give their heap to the reader
+  UITheme::getInstance().getTileCache().clear();
+
   if (initialBookPath.empty()) {
     goToLibrary();  // Start from root when entering via Browse
     return;
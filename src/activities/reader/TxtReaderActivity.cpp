@@ -9,7 +9,9 @@
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "MappedInputManager.h"
+#include "PageSnapshot.h"
 #include "RecentBooksStore.h"
+#include "RenderTrace.h"
 #include "components/UITheme.h"
 #include "fontIds.h"
 
@@ -75,6 +77,29 @@ void TxtReaderActivity::onExit() {
   txt.reset();
 }
 
+void TxtReaderActivity::onEnterSleep() {
+  RenderLock lock(*this);
+  size_t nextOffset;
+  // The page is reloaded because a page turn may not have been rendered yet
+  if (!txt || !initialized || currentPage < 0 || currentPage >= static_cast<int>(pageOffsets.size()) ||
+      !loadPageAtOffset(pageOffsets[currentPage], currentPageLines, nextOffset)) {
+    PAGE_SNAPSHOT.discard();
+    return;
+  }
+
+  int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
+  getOrientedMargins(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom, &orientedMarginLeft);
+  PAGE_SNAPSHOT.save(renderer, txt->getPath(), 0, currentPage, SETTINGS.textAntiAliasing,
+                     [&](const GfxRenderer::RenderMode mode) {
+                       renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+                       renderer.setRenderMode(mode);
+                       renderLines(orientedMarginTop, orientedMarginLeft);
+                       if (mode == GfxRenderer::BW) {
+                         renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+                       }
+                     });
+}
+
 void TxtReaderActivity::loop() {
   if (subActivity) {
     subActivity->loop();
@@ -373,57 +398,67 @@ void TxtReaderActivity::render(Activity::RenderLock&&) {
   saveProgress();
 }
 
-void TxtReaderActivity::renderPage() {
-  int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
-  renderer.getOrientedViewableTRBL(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom,
-                                   &orientedMarginLeft);
-  orientedMarginTop += cachedScreenMargin;
-  orientedMarginLeft += cachedScreenMargin;
-  orientedMarginRight += cachedScreenMargin;
-  orientedMarginBottom += statusBarMargin;
+void TxtReaderActivity::getOrientedMargins(int* orientedMarginTop, int* orientedMarginRight,
+                                           int* orientedMarginBottom, int* orientedMarginLeft) const {
+  renderer.getOrientedViewableTRBL(orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+  *orientedMarginTop += cachedScreenMargin;
+  *orientedMarginLeft += cachedScreenMargin;
+  *orientedMarginRight += cachedScreenMargin;
+  *orientedMarginBottom += statusBarMargin;
+}
 
+void TxtReaderActivity::renderLines(const int orientedMarginTop, const int orientedMarginLeft) const {
   const int lineHeight = renderer.getLineHeight(cachedFontId);
   const int contentWidth = viewportWidth;
 
   // Render text lines with alignment
-  auto renderLines = [&]() {
-    int y = orientedMarginTop;
-    for (const auto& line : currentPageLines) {
-      if (!line.empty()) {
-        int x = orientedMarginLeft;
-
-        // Apply text alignment
-        switch (cachedParagraphAlignment) {
-          case CrossPointSettings::LEFT_ALIGN:
-          default:
-            // x already set to left margin
-            break;
-          case CrossPointSettings::CENTER_ALIGN: {
-            int textWidth = renderer.getTextWidth(cachedFontId, line.c_str());
-            x = orientedMarginLeft + (contentWidth - textWidth) / 2;
-            break;
-          }
-          case CrossPointSettings::RIGHT_ALIGN: {
-            int textWidth = renderer.getTextWidth(cachedFontId, line.c_str());
-            x = orientedMarginLeft + contentWidth - textWidth;
-            break;
-          }
-          case CrossPointSettings::JUSTIFIED:
-            // For plain text, justified is treated as left-aligned
-            // (true justification would require word spacing adjustments)
-            break;
+  int y = orientedMarginTop;
+  for (const auto& line : currentPageLines) {
+    if (!line.empty()) {
+      int x = orientedMarginLeft;
+
+      // Apply text alignment
+      switch (cachedParagraphAlignment) {
+        case CrossPointSettings::LEFT_ALIGN:
+        default:
+          // x already set to left margin
+          break;
+        case CrossPointSettings::CENTER_ALIGN: {
+          int textWidth = renderer.getTextWidth(cachedFontId, line.c_str());
+          x = orientedMarginLeft + (contentWidth - textWidth) / 2;
+          break;
         }
-
-        renderer.drawText(cachedFontId, x, y, line.c_str());
+        case CrossPointSettings::RIGHT_ALIGN: {
+          int textWidth = renderer.getTextWidth(cachedFontId, line.c_str());
+          x = orientedMarginLeft + contentWidth - textWidth;
+          break;
+        }
+        case CrossPointSettings::JUSTIFIED:
+          // For plain text, justified is treated as left-aligned
+          // (true justification would require word spacing adjustments)
+          break;
       }
-      y += lineHeight;
+
+      renderer.drawText(cachedFontId, x, y, line.c_str());
     }
-  };
+    y += lineHeight;
+  }
+}
+
+void TxtReaderActivity::renderPage() {
+  int orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft;
+  getOrientedMargins(&orientedMarginTop, &orientedMarginRight, &orientedMarginBottom, &orientedMarginLeft);
 
   // First pass: BW rendering
-  renderLines();
+  renderLines(orientedMarginTop, orientedMarginLeft);
   renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
 
+  // Woken from sleep with this page already on the panel: only the frame buffer needed rebuilding
+  if (PAGE_SNAPSHOT.takeShown(txt->getPath(), 0, currentPage)) {
+    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
+    return;
+  }
+
   if (pagesUntilFullRefresh <= 1) {
     renderer.displayBuffer(HalDisplay::HALF_REFRESH);
     pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
@@ -439,12 +474,12 @@ void TxtReaderActivity::renderPage() {
 
     renderer.clearScreen(0x00);
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
-    renderLines();
+    renderLines(orientedMarginTop, orientedMarginLeft);
     renderer.copyGrayscaleLsbBuffers();
 
     renderer.clearScreen(0x00);
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
-    renderLines();
+    renderLines(orientedMarginTop, orientedMarginLeft);
     renderer.copyGrayscaleMsbBuffers();
 
     renderer.displayGrayBuffer();
@@ -530,6 +565,7 @@ void TxtReaderActivity::renderStatusBar(const int orientedMarginRight, const int
 }
 
 void TxtReaderActivity::saveProgress() const {
+  const auto start = micros();
   FsFile f;
   if (Storage.openFileForWrite("TRS", txt->getCachePath() + "/progress.bin", f)) {
     uint8_t data[4];
@@ -540,6 +576,7 @@ void TxtReaderActivity::saveProgress() const {
     f.write(data, 4);
     f.close();
   }
+  RENDER_TRACE.addSaveTime(micros() - start);
 }
 
 void TxtReaderActivity::loadProgress() {
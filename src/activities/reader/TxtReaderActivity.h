@@ -29,6 +29,9 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
   int cachedScreenMargin = 0;
   uint8_t cachedParagraphAlignment = CrossPointSettings::LEFT_ALIGN;
 
+  void getOrientedMargins(int* orientedMarginTop, int* orientedMarginRight, int* orientedMarginBottom,
+                          int* orientedMarginLeft) const;
+  void renderLines(int orientedMarginTop, int orientedMarginLeft) const;
   void renderPage();
   void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
 
@@ -51,4 +54,5 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
   void onExit() override;
   void loop() override;
   void render(Activity::RenderLock&&) override;
+  void onEnterSleep() override;
 };
@@ -15,7 +15,9 @@
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
 #include "MappedInputManager.h"
+#include "PageSnapshot.h"
 #include "RecentBooksStore.h"
+#include "RenderTrace.h"
 #include "XtcReaderChapterSelectionActivity.h"
 #include "components/UITheme.h"
 #include "fontIds.h"
@@ -153,50 +155,26 @@ void XtcReaderActivity::render(Activity::RenderLock&&) {
   saveProgress();
 }
 
-void XtcReaderActivity::renderPage() {
+size_t XtcReaderActivity::getPageBufferSize() const {
   const uint16_t pageWidth = xtc->getPageWidth();
   const uint16_t pageHeight = xtc->getPageHeight();
-  const uint8_t bitDepth = xtc->getBitDepth();
 
   // Calculate buffer size for one page
   // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
   // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
-  size_t pageBufferSize;
-  if (bitDepth == 2) {
-    pageBufferSize = ((static_cast<size_t>(pageWidth) * pageHeight + 7) / 8) * 2;
-  } else {
-    pageBufferSize = ((pageWidth + 7) / 8) * pageHeight;
-  }
-
-  // Allocate page buffer
-  uint8_t* pageBuffer = static_cast<uint8_t*>(malloc(pageBufferSize));
-  if (!pageBuffer) {
-    LOG_ERR("XTR", "Failed to allocate page buffer (%lu bytes)", pageBufferSize);
-    renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_MEMORY_ERROR), true, EpdFontFamily::BOLD);
-    renderer.displayBuffer();
-    return;
-  }
-
-  // Load page data
-  size_t bytesRead = xtc->loadPage(currentPage, pageBuffer, pageBufferSize);
-  if (bytesRead == 0) {
-    LOG_ERR("XTR", "Failed to load page %lu", currentPage);
-    free(pageBuffer);
-    renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_PAGE_LOAD_ERROR), true, EpdFontFamily::BOLD);
-    renderer.displayBuffer();
-    return;
+  if (xtc->getBitDepth() == 2) {
+    return ((static_cast<size_t>(pageWidth) * pageHeight + 7) / 8) * 2;
   }
+  return ((pageWidth + 7) / 8) * pageHeight;
+}
 
-  // Clear screen first
-  renderer.clearScreen();
+void XtcReaderActivity::drawPage(const uint8_t* pageBuffer, const GfxRenderer::RenderMode mode) const {
+  const uint16_t pageWidth = xtc->getPageWidth();
+  const uint16_t pageHeight = xtc->getPageHeight();
 
   // Copy page bitmap using GfxRenderer's drawPixel
   // XTC/XTCH pages are pre-rendered with status bar included, so render full page
-  const uint16_t maxSrcY = pageHeight;
-
-  if (bitDepth == 2) {
+  if (xtc->getBitDepth() == 2) {
     // XTH 2-bit mode: Two bit planes, column-major order
     // - Columns scanned right to left (x = width-1 down to 0)
     // - 8 vertical pixels per byte (MSB = topmost pixel in group)
@@ -220,106 +198,87 @@ void XtcReaderActivity::renderPage() {
       return (bit1 << 1) | bit2;
     };
 
-    // Optimized grayscale rendering without storeBwBuffer (saves 48KB peak memory)
-    // Flow: BW display → LSB/MSB passes → grayscale display → re-render BW for next frame
-
-    // Count pixel distribution for debugging
-    uint32_t pixelCounts[4] = {0, 0, 0, 0};
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        pixelCounts[getPixelValue(x, y)]++;
-      }
-    }
-    LOG_DBG("XTR", "Pixel distribution: White=%lu, DarkGrey=%lu, LightGrey=%lu, Black=%lu", pixelCounts[0],
-            pixelCounts[1], pixelCounts[2], pixelCounts[3]);
-
-    // Pass 1: BW buffer - draw all non-white pixels as black
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
-    }
-
-    // Display BW with conditional refresh based on pagesUntilFullRefresh
-    if (pagesUntilFullRefresh <= 1) {
-      renderer.displayBuffer(HalDisplay::HALF_REFRESH);
-      pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
-    } else {
-      renderer.displayBuffer();
-      pagesUntilFullRefresh--;
-    }
-
-    // Pass 2: LSB buffer - mark DARK gray only (XTH value 1)
-    // In LUT: 0 bit = apply gray effect, 1 bit = untouched
-    renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) == 1) {  // Dark grey only
-          renderer.drawPixel(x, y, false);
+    if (mode == GfxRenderer::BW) {
+      // BW buffer - draw all non-white pixels as black
+      renderer.clearScreen();
+      for (uint16_t y = 0; y < pageHeight; y++) {
+        for (uint16_t x = 0; x < pageWidth; x++) {
+          if (getPixelValue(x, y) >= 1) {
+            renderer.drawPixel(x, y, true);
+          }
         }
       }
+      return;
     }
-    renderer.copyGrayscaleLsbBuffers();
 
-    // Pass 3: MSB buffer - mark LIGHT AND DARK gray (XTH value 1 or 2)
+    // LSB buffer marks DARK gray only (XTH value 1), MSB buffer LIGHT AND DARK gray (XTH value 1 or 2)
     // In LUT: 0 bit = apply gray effect, 1 bit = untouched
     renderer.clearScreen(0x00);
     for (uint16_t y = 0; y < pageHeight; y++) {
       for (uint16_t x = 0; x < pageWidth; x++) {
         const uint8_t pv = getPixelValue(x, y);
-        if (pv == 1 || pv == 2) {  // Dark grey or Light grey
+        if (pv == 1 || (pv == 2 && mode == GfxRenderer::GRAYSCALE_MSB)) {
           renderer.drawPixel(x, y, false);
         }
       }
     }
-    renderer.copyGrayscaleMsbBuffers();
+    return;
+  }
 
-    // Display grayscale overlay
-    renderer.displayGrayBuffer();
+  // 1-bit mode: 8 pixels per byte, MSB first
+  const size_t srcRowBytes = (pageWidth + 7) / 8;  // 60 bytes for 480 width
 
-    // Pass 4: Re-render BW to framebuffer (restore for next frame, instead of restoreBwBuffer)
-    renderer.clearScreen();
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
+  // White pixels are cleared by clearScreen()
+  renderer.clearScreen();
+  for (uint16_t srcY = 0; srcY < pageHeight; srcY++) {
+    const size_t srcRowStart = srcY * srcRowBytes;
+
+    for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
+      // Read source pixel (MSB first, bit 7 = leftmost pixel)
+      const size_t srcByte = srcRowStart + srcX / 8;
+      const size_t srcBit = 7 - (srcX % 8);
+      const bool isBlack = !((pageBuffer[srcByte] >> srcBit) & 1);  // XTC: 0 = black, 1 = white
+
+      if (isBlack) {
+        renderer.drawPixel(srcX, srcY, true);
       }
     }
+  }
+}
 
-    // Cleanup grayscale buffers with current frame buffer
-    renderer.cleanupGrayscaleWithFrameBuffer();
+void XtcReaderActivity::renderPage() {
+  // Allocate page buffer
+  const size_t pageBufferSize = getPageBufferSize();
+  uint8_t* pageBuffer = static_cast<uint8_t*>(malloc(pageBufferSize));
+  if (!pageBuffer) {
+    LOG_ERR("XTR", "Failed to allocate page buffer (%lu bytes)", pageBufferSize);
+    renderer.clearScreen();
+    renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_MEMORY_ERROR), true, EpdFontFamily::BOLD);
+    renderer.displayBuffer();
+    return;
+  }
 
+  // Load page data
+  size_t bytesRead = xtc->loadPage(currentPage, pageBuffer, pageBufferSize);
+  if (bytesRead == 0) {
+    LOG_ERR("XTR", "Failed to load page %lu", currentPage);
     free(pageBuffer);
-
-    LOG_DBG("XTR", "Rendered page %lu/%lu (2-bit grayscale)", currentPage + 1, xtc->getPageCount());
+    renderer.clearScreen();
+    renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_PAGE_LOAD_ERROR), true, EpdFontFamily::BOLD);
+    renderer.displayBuffer();
     return;
-  } else {
-    // 1-bit mode: 8 pixels per byte, MSB first
-    const size_t srcRowBytes = (pageWidth + 7) / 8;  // 60 bytes for 480 width
-
-    for (uint16_t srcY = 0; srcY < maxSrcY; srcY++) {
-      const size_t srcRowStart = srcY * srcRowBytes;
-
-      for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
-        // Read source pixel (MSB first, bit 7 = leftmost pixel)
-        const size_t srcByte = srcRowStart + srcX / 8;
-        const size_t srcBit = 7 - (srcX % 8);
-        const bool isBlack = !((pageBuffer[srcByte] >> srcBit) & 1);  // XTC: 0 = black, 1 = white
-
-        if (isBlack) {
-          renderer.drawPixel(srcX, srcY, true);
-        }
-      }
-    }
   }
-  // White pixels are already cleared by clearScreen()
-
-  free(pageBuffer);
 
+  const uint8_t bitDepth = xtc->getBitDepth();
   // XTC pages already have status bar pre-rendered, no need to add our own
+  drawPage(pageBuffer, GfxRenderer::BW);
+
+  // Woken from sleep with this page already on the panel: only the frame buffer needed rebuilding
+  if (PAGE_SNAPSHOT.takeShown(xtc->getPath(), 0, static_cast<int>(currentPage))) {
+    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
+    free(pageBuffer);
+    return;
+  }
 
   // Display with appropriate refresh
   if (pagesUntilFullRefresh <= 1) {
@@ -330,10 +289,49 @@ void XtcReaderActivity::renderPage() {
     pagesUntilFullRefresh--;
   }
 
+  if (bitDepth == 2) {
+    // Optimized grayscale rendering without storeBwBuffer (saves 48KB peak memory)
+    // Flow: BW display → LSB/MSB passes → grayscale display → re-render BW for next frame
+    drawPage(pageBuffer, GfxRenderer::GRAYSCALE_LSB);
+    renderer.copyGrayscaleLsbBuffers();
+    drawPage(pageBuffer, GfxRenderer::GRAYSCALE_MSB);
+    renderer.copyGrayscaleMsbBuffers();
+
+    // Display grayscale overlay
+    renderer.displayGrayBuffer();
+
+    // Re-render BW to framebuffer (restore for next frame, instead of restoreBwBuffer)
+    drawPage(pageBuffer, GfxRenderer::BW);
+
+    // Cleanup grayscale buffers with current frame buffer
+    renderer.cleanupGrayscaleWithFrameBuffer();
+  }
+
+  free(pageBuffer);
+
   LOG_DBG("XTR", "Rendered page %lu/%lu (%u-bit)", currentPage + 1, xtc->getPageCount(), bitDepth);
 }
 
+void XtcReaderActivity::onEnterSleep() {
+  RenderLock lock(*this);
+  if (!xtc || currentPage >= xtc->getPageCount() || currentPage > UINT16_MAX) {
+    PAGE_SNAPSHOT.discard();
+    return;
+  }
+  const size_t pageBufferSize = getPageBufferSize();
+  uint8_t* pageBuffer = static_cast<uint8_t*>(malloc(pageBufferSize));
+  if (!pageBuffer || xtc->loadPage(currentPage, pageBuffer, pageBufferSize) == 0) {
+    free(pageBuffer);
+    PAGE_SNAPSHOT.discard();
+    return;
+  }
+  PAGE_SNAPSHOT.save(renderer, xtc->getPath(), 0, currentPage, xtc->getBitDepth() == 2,
+                     [&](const GfxRenderer::RenderMode mode) { drawPage(pageBuffer, mode); });
+  free(pageBuffer);
+}
+
 void XtcReaderActivity::saveProgress() const {
+  const auto start = micros();
   FsFile f;
   if (Storage.openFileForWrite("XTR", xtc->getCachePath() + "/progress.bin", f)) {
     uint8_t data[4];
@@ -344,6 +342,7 @@ void XtcReaderActivity::saveProgress() const {
     f.write(data, 4);
     f.close();
   }
+  RENDER_TRACE.addSaveTime(micros() - start);
 }
 
 void XtcReaderActivity::loadProgress() {
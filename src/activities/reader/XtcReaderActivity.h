@@ -20,6 +20,9 @@ class XtcReaderActivity final : public ActivityWithSubactivity {
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
+  size_t getPageBufferSize() const;
+  // Clears the frame buffer and draws one plane of the page
+  void drawPage(const uint8_t* pageBuffer, GfxRenderer::RenderMode mode) const;
   void renderPage();
   void saveProgress() const;
   void loadProgress();
@@ -35,4 +38,5 @@ class XtcReaderActivity final : public ActivityWithSubactivity {
   void onExit() override;
   void loop() override;
   void render(Activity::RenderLock&&) override;
+  void onEnterSleep() override;
 };
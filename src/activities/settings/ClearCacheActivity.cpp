@@ -5,6 +5,7 @@
 #include <I18n.h>
 #include <Logging.h>
 
+#include "BookCacheManager.h"
 #include "MappedInputManager.h"
 #include "components/UITheme.h"
 #include "fontIds.h"
@@ -91,8 +92,8 @@ void ClearCacheActivity::clearCache() {
     file.getName(name, sizeof(name));
     String itemName(name);
 
-    // Only delete directories starting with epub_ or xtc_
-    if (file.isDirectory() && (itemName.startsWith("epub_") || itemName.startsWith("xtc_"))) {
+    // Only delete book cache directories (epub_, xtc_) and the OPDS feed cache
+    if (file.isDirectory() && (itemName.startsWith("epub_") || itemName.startsWith("xtc_") || itemName == "opds")) {
       String fullPath = "/.crosspoint/" + itemName;
       LOG_DBG("CLEAR_CACHE", "Removing cache: %s", fullPath.c_str());
 
@@ -109,6 +110,7 @@ void ClearCacheActivity::clearCache() {
     }
   }
   root.close();
+  BOOK_CACHE.clear();
 
   LOG_DBG("CLEAR_CACHE", "Cache cleared: %d removed, %d failed", clearedCount, failedCount);
 
@@ -81,6 +81,8 @@ void KOReaderAuthActivity::onEnter() {
 void KOReaderAuthActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
+  KOReaderSyncClient::pushQueuedProgress();
+
   // Turn off wifi
   WiFi.disconnect(false);
   delay(100);
@@ -4,6 +4,7 @@
 #include <I18n.h>
 #include <WiFi.h>
 
+#include "KOReaderSyncClient.h"
 #include "MappedInputManager.h"
 #include "activities/network/WifiSelectionActivity.h"
 #include "components/UITheme.h"
@@ -71,6 +72,8 @@ void OtaUpdateActivity::onEnter() {
 void OtaUpdateActivity::onExit() {
   ActivityWithSubactivity::onExit();
 
+  KOReaderSyncClient::pushQueuedProgress();
+
   // Turn off wifi
   WiFi.disconnect(false);  // false = don't erase credentials, send disconnect frame
   delay(100);              // Allow disconnect frame to be sent
@@ -0,0 +1,141 @@
+#include "TileCache.h"
+
+#include <GfxRenderer.h>
+#include <Logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include "components/themes/BaseTheme.h"
+
+TileCache::Tile* TileCache::find(const uint32_t key) {
+  auto it = std::find_if(tiles.begin(), tiles.end(), [key](const Tile& tile) { return tile.key == key; });
+  return it == tiles.end() ? nullptr : &*it;
+}
+
+bool TileCache::contains(const uint32_t key) const {
+  return std::any_of(tiles.begin(), tiles.end(), [key](const Tile& tile) { return tile.key == key; });
+}
+
+void TileCache::invalidate(const uint32_t key) {
+  auto it = std::find_if(tiles.begin(), tiles.end(), [key](const Tile& tile) { return tile.key == key; });
+  if (it != tiles.end()) {
+    usedBytes -= it->size();
+    tiles.erase(it);
+  }
+}
+
+void TileCache::clear() {
+  tiles.clear();
+  usedBytes = 0;
+}
+
+void TileCache::evictFor(const size_t bytes) {
+  while (!tiles.empty() && usedBytes + bytes > budgetBytes) {
+    auto oldest = std::min_element(tiles.begin(), tiles.end(),
+                                   [](const Tile& a, const Tile& b) { return a.lastUsed < b.lastUsed; });
+    usedBytes -= oldest->size();
+    tiles.erase(oldest);
+  }
+}
+
+bool TileCache::store(const GfxRenderer& renderer, const uint32_t key, const Rect& rect) {
+  invalidate(key);
+
+  Tile tile;
+  int x, y, width, height;
+  if (!renderer.getPanelRect(rect.x, rect.y, rect.width, rect.height, &x, &y, &width, &height)) {
+    return false;
+  }
+  tile.key = key;
+  tile.x = static_cast<int16_t>(x);
+  tile.y = static_cast<int16_t>(y);
+  tile.width = static_cast<int16_t>(width);
+  tile.height = static_cast<int16_t>(height);
+
+  const size_t size = tile.size();
+  if (size > budgetBytes) {
+    LOG_DBG("TILE", "Tile of %u bytes exceeds the %u byte budget", static_cast<unsigned>(size),
+            static_cast<unsigned>(budgetBytes));
+    return false;
+  }
+  evictFor(size);
+
+  tile.bits.reset(new (std::nothrow) uint8_t[size]);
+  if (!tile.bits) {
+    LOG_ERR("TILE", "Failed to allocate %u byte tile", static_cast<unsigned>(size));
+    return false;
+  }
+
+  const uint8_t* frameBuffer = renderer.getFrameBuffer();
+  const size_t rowBytes = tile.rowBytes();
+  const size_t firstByte = tile.x / 8;
+  for (int row = 0; row < tile.height; row++) {
+    memcpy(tile.bits.get() + row * rowBytes,
+           frameBuffer + (tile.y + row) * HalDisplay::DISPLAY_WIDTH_BYTES + firstByte, rowBytes);
+  }
+
+  tile.lastUsed = ++useCounter;
+  usedBytes += size;
+  tiles.push_back(std::move(tile));
+  return true;
+}
+
+bool TileCache::draw(const GfxRenderer& renderer, const uint32_t key, const Rect& rect) {
+  Tile* tile = find(key);
+  if (!tile) {
+    return false;
+  }
+
+  int x, y, width, height;
+  if (!renderer.getPanelRect(rect.x, rect.y, rect.width, rect.height, &x, &y, &width, &height) || x != tile->x ||
+      y != tile->y || width != tile->width || height != tile->height) {
+    return false;
+  }
+
+  // Pixels of the edge bytes that lie outside the tile belong to neighbouring widgets and are kept (MSB first)
+  const int lastX = tile->x + tile->width - 1;
+  const uint8_t leftMask = 0xFF >> (tile->x % 8);
+  const uint8_t rightMask = static_cast<uint8_t>(0xFF << (7 - lastX % 8));
+  const size_t rowBytes = tile->rowBytes();
+  const size_t firstByte = tile->x / 8;
+
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  for (int row = 0; row < tile->height; row++) {
+    const uint8_t* src = tile->bits.get() + row * rowBytes;
+    uint8_t* dst = frameBuffer + (tile->y + row) * HalDisplay::DISPLAY_WIDTH_BYTES + firstByte;
+    if (rowBytes == 1) {
+      const uint8_t mask = leftMask & rightMask;
+      dst[0] = (dst[0] & ~mask) | (src[0] & mask);
+      continue;
+    }
+    dst[0] = (dst[0] & ~leftMask) | (src[0] & leftMask);
+    memcpy(dst + 1, src + 1, rowBytes - 2);
+    dst[rowBytes - 1] = (dst[rowBytes - 1] & ~rightMask) | (src[rowBytes - 1] & rightMask);
+  }
+
+  tile->lastUsed = ++useCounter;
+  return true;
+}
+
+void TileCache::drawOrRender(const GfxRenderer& renderer, const uint32_t key, const Rect& rect,
+                             const std::function<void()>& render) {
+  if (renderer.getRenderMode() != GfxRenderer::BW) {
+    render();
+    return;
+  }
+  if (!draw(renderer, key, rect)) {
+    render();
+    store(renderer, key, rect);
+  }
+}
+
+uint32_t TileCache::keyFor(const std::string& id) {
+  uint32_t hash = 2166136261u;
+  for (const char c : id) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
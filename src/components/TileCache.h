@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class GfxRenderer;
+struct Rect;
+
+// Retained-mode store for pre-rendered UI tiles (cover thumbnails and the like). A tile is a copy of a rectangle of
+// the frame buffer, kept packed in native panel orientation so storing and drawing it are row memcpy's rather than
+// BMP decodes and per-pixel drawPixel() calls. Tiles are looked up by key and evicted least recently used first once
+// the byte budget is reached.
+class TileCache {
+ public:
+  static constexpr size_t DEFAULT_BUDGET = 20 * 1024;
+
+  explicit TileCache(size_t budgetBytes = DEFAULT_BUDGET) : budgetBytes(budgetBytes) {}
+
+  // Copy rect of the current frame buffer into the tile for key, replacing any previous tile
+  bool store(const GfxRenderer& renderer, uint32_t key, const Rect& rect);
+  // Draw the tile for key back at rect. Returns false if there is no tile for key or it was stored for a different
+  // rectangle or orientation; the caller then renders the widget the slow way and stores it again.
+  bool draw(const GfxRenderer& renderer, uint32_t key, const Rect& rect);
+  // Draw the tile for key, or call render to draw rect from scratch and keep the result as the tile. render must
+  // paint every pixel of rect. Only black and white frames are cached; grayscale passes always call render.
+  void drawOrRender(const GfxRenderer& renderer, uint32_t key, const Rect& rect, const std::function<void()>& render);
+
+  bool contains(uint32_t key) const;
+  void invalidate(uint32_t key);
+  void clear();
+
+  size_t getUsedBytes() const { return usedBytes; }
+  size_t getTileCount() const { return tiles.size(); }
+
+  static uint32_t keyFor(const std::string& id);
+
+ private:
+  struct Tile {
+    uint32_t key = 0;
+    uint32_t lastUsed = 0;
+    // Panel rectangle in pixels; each row is stored from the byte holding x to the byte holding x + width - 1
+    int16_t x = 0;
+    int16_t y = 0;
+    int16_t width = 0;
+    int16_t height = 0;
+    std::unique_ptr<uint8_t[]> bits;
+
+    size_t rowBytes() const { return (x + width - 1) / 8 - x / 8 + 1; }
+    size_t size() const { return rowBytes() * height; }
+  };
+
+  size_t budgetBytes;
+  size_t usedBytes = 0;
+  uint32_t useCounter = 0;
+  std::vector<Tile> tiles;
+
+  Tile* find(uint32_t key);
+  void evictFor(size_t bytes);
+};
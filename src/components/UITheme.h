@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "CrossPointSettings.h"
+#include "components/TileCache.h"
 #include "components/themes/BaseTheme.h"
 
 class UITheme {
@@ -16,6 +17,8 @@ class UITheme {
 
   const ThemeMetrics& getMetrics() { return *currentMetrics; }
   const BaseTheme& getTheme() { return *currentTheme; }
+  // Pre-rendered tiles shared by the menu screens; cleared when the theme changes
+  TileCache& getTileCache() { return tileCache; }
   void reload();
   void setTheme(CrossPointSettings::UI_THEME type);
   static int getNumberOfItemsPerPage(const GfxRenderer& renderer, bool hasHeader, bool hasTabBar, bool hasButtonHints,
@@ -25,6 +28,7 @@ class UITheme {
  private:
   const ThemeMetrics* currentMetrics;
   const BaseTheme* currentTheme;
+  TileCache tileCache;
 };
 
 // Helper macro to access current theme
@@ -113,16 +113,21 @@ void BaseTheme::drawButtonHints(GfxRenderer& renderer, const char* btn1, const c
   constexpr int textYOffset = 7;                                  // Distance from top of button to text baseline
   constexpr int buttonPositions[] = {25, 130, 245, 350};
   const char* labels[] = {btn1, btn2, btn3, btn4};
+  TileCache& tiles = UITheme::getInstance().getTileCache();
 
   for (int i = 0; i < 4; i++) {
     // Only draw if the label is non-empty
     if (labels[i] != nullptr && labels[i][0] != '\0') {
       const int x = buttonPositions[i];
-      renderer.fillRect(x, pageHeight - buttonY, buttonWidth, buttonHeight, false);
-      renderer.drawRect(x, pageHeight - buttonY, buttonWidth, buttonHeight);
-      const int textWidth = renderer.getTextWidth(UI_10_FONT_ID, labels[i]);
-      const int textX = x + (buttonWidth - 1 - textWidth) / 2;
-      renderer.drawText(UI_10_FONT_ID, textX, pageHeight - buttonY + textYOffset, labels[i]);
+      // Hints repeat across screens, so each button is rendered once and blitted from its tile afterwards
+      const uint32_t tileKey = TileCache::keyFor(std::string("hint") + static_cast<char>('0' + i) + labels[i]);
+      tiles.drawOrRender(renderer, tileKey, Rect{x, pageHeight - buttonY, buttonWidth, buttonHeight}, [&] {
+        renderer.fillRect(x, pageHeight - buttonY, buttonWidth, buttonHeight, false);
+        renderer.drawRect(x, pageHeight - buttonY, buttonWidth, buttonHeight);
+        const int textWidth = renderer.getTextWidth(UI_10_FONT_ID, labels[i]);
+        const int textX = x + (buttonWidth - 1 - textWidth) / 2;
+        renderer.drawText(UI_10_FONT_ID, textX, pageHeight - buttonY + textYOffset, labels[i]);
+      });
     }
   }
 
@@ -185,13 +190,16 @@ void BaseTheme::drawList(const GfxRenderer& renderer, Rect rect, int itemCount,
                          const std::function<std::string(int index)>& rowTitle,
                          const std::function<std::string(int index)>& rowSubtitle,
                          const std::function<std::string(int index)>& rowIcon,
-                         const std::function<std::string(int index)>& rowValue) const {
+                         const std::function<std::string(int index)>& rowValue, int previousSelectedIndex) const {
   int rowHeight =
       (rowSubtitle != nullptr) ? BaseMetrics::values.listWithSubtitleRowHeight : BaseMetrics::values.listRowHeight;
   int pageItems = rect.height / rowHeight;
 
   const int totalPages = (itemCount + pageItems - 1) / pageItems;
-  if (totalPages > 1) {
+  const auto drawPageIndicator = [&] {
+    if (totalPages <= 1) {
+      return;
+    }
     constexpr int indicatorWidth = 20;
     constexpr int arrowSize = 6;
     constexpr int margin = 15;  // Offset from right edge
@@ -214,16 +222,10 @@ void BaseTheme::drawList(const GfxRenderer& renderer, Rect rect, int itemCount,
       renderer.drawLine(startX, indicatorBottom - arrowSize + 1 + i, startX + lineWidth - 1,
                         indicatorBottom - arrowSize + 1 + i);
     }
-  }
+  };
 
-  // Draw selection
   int contentWidth = rect.width - 5;
-  if (selectedIndex >= 0) {
-    renderer.fillRect(0, rect.y + selectedIndex % pageItems * rowHeight - 2, rect.width, rowHeight);
-  }
-  // Draw all items
-  const auto pageStartIndex = selectedIndex / pageItems * pageItems;
-  for (int i = pageStartIndex; i < itemCount && i < pageStartIndex + pageItems; i++) {
+  const auto drawItem = [&](const int i) {
     const int itemY = rect.y + (i % pageItems) * rowHeight;
     int textWidth = contentWidth - BaseMetrics::values.contentSidePadding * 2 - (rowValue != nullptr ? 60 : 0);
 
@@ -248,6 +250,38 @@ void BaseTheme::drawList(const GfxRenderer& renderer, Rect rect, int itemCount,
       renderer.drawText(UI_10_FONT_ID, rect.x + contentWidth - BaseMetrics::values.contentSidePadding - valueTextWidth,
                         itemY, valueText.c_str(), i != selectedIndex);
     }
+  };
+
+  // Only the rows that were and are selected change: repaint their band (the selection bar covers exactly one), put
+  // back the indicator arrows that may cross it and draw their text again
+  if (previousSelectedIndex >= 0 && selectedIndex >= 0 &&
+      previousSelectedIndex / pageItems == selectedIndex / pageItems) {
+    if (previousSelectedIndex == selectedIndex) {
+      return;
+    }
+    for (const int i : {previousSelectedIndex, selectedIndex}) {
+      renderer.fillRect(0, rect.y + i % pageItems * rowHeight - 2, rect.width, rowHeight, i == selectedIndex);
+    }
+    drawPageIndicator();
+    drawItem(previousSelectedIndex);
+    drawItem(selectedIndex);
+    return;
+  }
+  if (previousSelectedIndex >= 0) {
+    // The selection bar starts 2 px above the list
+    renderer.fillRect(rect.x, rect.y - 2, rect.width, rect.height + 2, false);
+  }
+
+  drawPageIndicator();
+
+  // Draw selection
+  if (selectedIndex >= 0) {
+    renderer.fillRect(0, rect.y + selectedIndex % pageItems * rowHeight - 2, rect.width, rowHeight);
+  }
+  // Draw all items
+  const auto pageStartIndex = selectedIndex / pageItems * pageItems;
+  for (int i = pageStartIndex; i < itemCount && i < pageStartIndex + pageItems; i++) {
+    drawItem(i);
   }
 }
 
@@ -302,8 +336,7 @@ void BaseTheme::drawTabBar(const GfxRenderer& renderer, const Rect rect, const s
 // Draw the "Recent Book" cover card on the home screen
 // TODO: Refactor method to make it cleaner, split into smaller methods
 void BaseTheme::drawRecentBookCover(GfxRenderer& renderer, Rect rect, const std::vector<RecentBook>& recentBooks,
-                                    const int selectorIndex, bool& coverRendered, bool& coverBufferStored,
-                                    bool& bufferRestored, std::function<bool()> storeCoverBuffer) const {
+                                    const int selectorIndex) const {
   // --- Top "book" card for the current title (selectorIndex == 0) ---
   const int bookWidth = rect.width / 2;
   const int bookHeight = rect.height;
@@ -319,17 +352,20 @@ void BaseTheme::drawRecentBookCover(GfxRenderer& renderer, Rect rect, const std:
   const int bookmarkY = bookY + 5;
 
   // Draw book card regardless, fill with message based on `hasContinueReading`
+  bool coverRendered = false;
   {
     // Draw cover image as background if available (inside the box)
-    // Only load from SD on first render, then use stored buffer
-
-    if (hasContinueReading && !recentBooks[0].coverBmpPath.empty() && !coverRendered) {
+    // Only decode from SD on first render, then blit the cached tile
+    if (hasContinueReading && !recentBooks[0].coverBmpPath.empty()) {
       const std::string coverBmpPath =
           UITheme::getCoverThumbPath(recentBooks[0].coverBmpPath, BaseMetrics::values.homeCoverHeight);
+      const Rect cardRect{bookX, bookY, bookWidth, bookHeight};
+      TileCache& tiles = UITheme::getInstance().getTileCache();
+      const uint32_t tileKey = TileCache::keyFor(coverBmpPath);
+      coverRendered = tiles.draw(renderer, tileKey, cardRect);
 
-      // First time: load cover from SD and render
       FsFile file;
-      if (Storage.openFileForRead("HOME", coverBmpPath, file)) {
+      if (!coverRendered && Storage.openFileForRead("HOME", coverBmpPath, file)) {
         Bitmap bitmap(file);
         if (bitmap.parseHeaders() == BmpReaderError::Ok) {
           LOG_DBG("THEME", "Rendering bmp");
@@ -360,22 +396,21 @@ void BaseTheme::drawRecentBookCover(GfxRenderer& renderer, Rect rect, const std:
 
           // No bookmark ribbon when cover is shown - it would just cover the art
 
-          // Store the buffer with cover image for fast navigation
-          coverBufferStored = storeCoverBuffer();
+          // Keep the undecorated card for fast navigation
+          tiles.store(renderer, tileKey, cardRect);
           coverRendered = true;
-
-          // First render: if selected, draw selection indicators now
-          if (bookSelected) {
-            LOG_DBG("THEME", "Drawing selection");
-            renderer.drawRect(bookX + 1, bookY + 1, bookWidth - 2, bookHeight - 2);
-            renderer.drawRect(bookX + 2, bookY + 2, bookWidth - 4, bookHeight - 4);
-          }
         }
         file.close();
       }
     }
 
-    if (!bufferRestored && !coverRendered) {
+    if (coverRendered) {
+      if (bookSelected) {
+        // Draw selection border (no bookmark inversion needed since cover has no bookmark)
+        renderer.drawRect(bookX + 1, bookY + 1, bookWidth - 2, bookHeight - 2);
+        renderer.drawRect(bookX + 2, bookY + 2, bookWidth - 4, bookHeight - 4);
+      }
+    } else {
       // No cover image: draw border or fill, plus bookmark as visual flair
       if (bookSelected) {
         renderer.fillRect(bookX, bookY, bookWidth, bookHeight);
@@ -407,15 +442,6 @@ void BaseTheme::drawRecentBookCover(GfxRenderer& renderer, Rect rect, const std:
         renderer.fillPolygon(xPoints, yPoints, 5, !bookSelected);
       }
     }
-
-    // If buffer was restored, draw selection indicators if needed
-    if (bufferRestored && bookSelected && coverRendered) {
-      // Draw selection border (no bookmark inversion needed since cover has no bookmark)
-      renderer.drawRect(bookX + 1, bookY + 1, bookWidth - 2, bookHeight - 2);
-      renderer.drawRect(bookX + 2, bookY + 2, bookWidth - 4, bookHeight - 4);
-    } else if (!coverRendered && !bufferRestored) {
-      // Selection border already handled above in the no-cover case
-    }
   }
 
   if (hasContinueReading) {
@@ -156,38 +156,22 @@ void LyraTheme::drawList(const GfxRenderer& renderer, Rect rect, int itemCount,
                          const std::function<std::string(int index)>& rowTitle,
                          const std::function<std::string(int index)>& rowSubtitle,
                          const std::function<std::string(int index)>& rowIcon,
-                         const std::function<std::string(int index)>& rowValue) const {
+                         const std::function<std::string(int index)>& rowValue, int previousSelectedIndex) const {
   int rowHeight =
       (rowSubtitle != nullptr) ? LyraMetrics::values.listWithSubtitleRowHeight : LyraMetrics::values.listRowHeight;
   int pageItems = rect.height / rowHeight;
 
   const int totalPages = (itemCount + pageItems - 1) / pageItems;
-  if (totalPages > 1) {
-    const int scrollAreaHeight = rect.height;
-
-    // Draw scroll bar
-    const int scrollBarHeight = (scrollAreaHeight * pageItems) / itemCount;
-    const int currentPage = selectedIndex / pageItems;
-    const int scrollBarY = rect.y + ((scrollAreaHeight - scrollBarHeight) * currentPage) / (totalPages - 1);
-    const int scrollBarX = rect.x + rect.width - LyraMetrics::values.scrollBarRightOffset;
-    renderer.drawLine(scrollBarX, rect.y, scrollBarX, rect.y + scrollAreaHeight, true);
-    renderer.fillRect(scrollBarX - LyraMetrics::values.scrollBarWidth, scrollBarY, LyraMetrics::values.scrollBarWidth,
-                      scrollBarHeight, true);
-  }
-
-  // Draw selection
   int contentWidth =
       rect.width -
       (totalPages > 1 ? (LyraMetrics::values.scrollBarWidth + LyraMetrics::values.scrollBarRightOffset) : 1);
-  if (selectedIndex >= 0) {
+
+  const auto drawSelection = [&] {
     renderer.fillRoundedRect(LyraMetrics::values.contentSidePadding, rect.y + selectedIndex % pageItems * rowHeight,
                              contentWidth - LyraMetrics::values.contentSidePadding * 2, rowHeight, cornerRadius,
                              Color::LightGray);
-  }
-
-  // Draw all items
-  const auto pageStartIndex = selectedIndex / pageItems * pageItems;
-  for (int i = pageStartIndex; i < itemCount && i < pageStartIndex + pageItems; i++) {
+  };
+  const auto drawItem = [&](const int i) {
     const int itemY = rect.y + (i % pageItems) * rowHeight;
 
     // Draw name
@@ -223,6 +207,49 @@ void LyraTheme::drawList(const GfxRenderer& renderer, Rect rect, int itemCount,
                           itemY + 6, valueText.c_str(), i != selectedIndex);
       }
     }
+  };
+
+  // Only the rows that were and are selected change; the scroll bar lies right of contentWidth and stays as it is
+  if (previousSelectedIndex >= 0 && selectedIndex >= 0 &&
+      previousSelectedIndex / pageItems == selectedIndex / pageItems) {
+    if (previousSelectedIndex == selectedIndex) {
+      return;
+    }
+    for (const int i : {previousSelectedIndex, selectedIndex}) {
+      renderer.fillRect(0, rect.y + i % pageItems * rowHeight, contentWidth, rowHeight, false);
+    }
+    drawSelection();
+    drawItem(previousSelectedIndex);
+    drawItem(selectedIndex);
+    return;
+  }
+  if (previousSelectedIndex >= 0) {
+    // The scroll bar line ends on the row below the list
+    renderer.fillRect(rect.x, rect.y, rect.width, rect.height + 1, false);
+  }
+
+  if (totalPages > 1) {
+    const int scrollAreaHeight = rect.height;
+
+    // Draw scroll bar
+    const int scrollBarHeight = (scrollAreaHeight * pageItems) / itemCount;
+    const int currentPage = selectedIndex / pageItems;
+    const int scrollBarY = rect.y + ((scrollAreaHeight - scrollBarHeight) * currentPage) / (totalPages - 1);
+    const int scrollBarX = rect.x + rect.width - LyraMetrics::values.scrollBarRightOffset;
+    renderer.drawLine(scrollBarX, rect.y, scrollBarX, rect.y + scrollAreaHeight, true);
+    renderer.fillRect(scrollBarX - LyraMetrics::values.scrollBarWidth, scrollBarY, LyraMetrics::values.scrollBarWidth,
+                      scrollBarHeight, true);
+  }
+
+  // Draw selection
+  if (selectedIndex >= 0) {
+    drawSelection();
+  }
+
+  // Draw all items
+  const auto pageStartIndex = selectedIndex / pageItems * pageItems;
+  for (int i = pageStartIndex; i < itemCount && i < pageStartIndex + pageItems; i++) {
+    drawItem(i);
   }
 }
 
@@ -239,22 +266,32 @@ void LyraTheme::drawButtonHints(GfxRenderer& renderer, const char* btn1, const c
   constexpr int textYOffset = 7;                                  // Distance from top of button to text baseline
   constexpr int buttonPositions[] = {58, 146, 254, 342};
   const char* labels[] = {btn1, btn2, btn3, btn4};
+  TileCache& tiles = UITheme::getInstance().getTileCache();
 
   for (int i = 0; i < 4; i++) {
     const int x = buttonPositions[i];
-    if (labels[i] != nullptr && labels[i][0] != '\0') {
+    // Hints repeat across screens, so each button is rendered once and blitted from its tile afterwards
+    const char* label = labels[i] != nullptr ? labels[i] : "";
+    const uint32_t tileKey = TileCache::keyFor(std::string("hint") + static_cast<char>('0' + i) + label);
+    if (label[0] != '\0') {
       // Draw the filled background and border for a FULL-sized button
-      renderer.fillRect(x, pageHeight - buttonY, buttonWidth, buttonHeight, false);
-      renderer.drawRoundedRect(x, pageHeight - buttonY, buttonWidth, buttonHeight, 1, cornerRadius, true, true, false,
-                               false, true);
-      const int textWidth = renderer.getTextWidth(SMALL_FONT_ID, labels[i]);
-      const int textX = x + (buttonWidth - 1 - textWidth) / 2;
-      renderer.drawText(SMALL_FONT_ID, textX, pageHeight - buttonY + textYOffset, labels[i]);
+      const Rect buttonRect{x, pageHeight - buttonY, buttonWidth, buttonHeight};
+      tiles.drawOrRender(renderer, tileKey, buttonRect, [&] {
+        renderer.fillRect(x, pageHeight - buttonY, buttonWidth, buttonHeight, false);
+        renderer.drawRoundedRect(x, pageHeight - buttonY, buttonWidth, buttonHeight, 1, cornerRadius, true, true,
+                                 false, false, true);
+        const int textWidth = renderer.getTextWidth(SMALL_FONT_ID, label);
+        const int textX = x + (buttonWidth - 1 - textWidth) / 2;
+        renderer.drawText(SMALL_FONT_ID, textX, pageHeight - buttonY + textYOffset, label);
+      });
     } else {
       // Draw the filled background and border for a SMALL-sized button
-      renderer.fillRect(x, pageHeight - smallButtonHeight, buttonWidth, smallButtonHeight, false);
-      renderer.drawRoundedRect(x, pageHeight - smallButtonHeight, buttonWidth, smallButtonHeight, 1, cornerRadius, true,
-                               true, false, false, true);
+      const Rect buttonRect{x, pageHeight - smallButtonHeight, buttonWidth, smallButtonHeight};
+      tiles.drawOrRender(renderer, tileKey, buttonRect, [&] {
+        renderer.fillRect(x, pageHeight - smallButtonHeight, buttonWidth, smallButtonHeight, false);
+        renderer.drawRoundedRect(x, pageHeight - smallButtonHeight, buttonWidth, smallButtonHeight, 1, cornerRadius,
+                                 true, true, false, false, true);
+      });
     }
   }
 
@@ -298,8 +335,7 @@ void LyraTheme::drawSideButtonHints(const GfxRenderer& renderer, const char* top
 }
 
 void LyraTheme::drawRecentBookCover(GfxRenderer& renderer, Rect rect, const std::vector<RecentBook>& recentBooks,
-                                    const int selectorIndex, bool& coverRendered, bool& coverBufferStored,
-                                    bool& bufferRestored, std::function<bool()> storeCoverBuffer) const {
+                                    const int selectorIndex) const {
   const int tileWidth = (rect.width - 2 * LyraMetrics::values.contentSidePadding) / 3;
   const int tileHeight = rect.height;
   const int bookTitleHeight = tileHeight - LyraMetrics::values.homeCoverHeight - hPaddingInSelection;
@@ -308,39 +344,43 @@ void LyraTheme::drawRecentBookCover(GfxRenderer& renderer, Rect rect, const std:
 
   // Draw book card regardless, fill with message based on `hasContinueReading`
   // Draw cover image as background if available (inside the box)
-  // Only load from SD on first render, then use stored buffer
+  // Only decode from SD on first render, then blit the cached tile
   if (hasContinueReading) {
-    if (!coverRendered) {
-      for (int i = 0; i < std::min(static_cast<int>(recentBooks.size()), LyraMetrics::values.homeRecentBooksCount);
-           i++) {
-        std::string coverPath = recentBooks[i].coverBmpPath;
-        int tileX = LyraMetrics::values.contentSidePadding + tileWidth * i;
-        renderer.drawRect(tileX + hPaddingInSelection, tileY + hPaddingInSelection, tileWidth - 2 * hPaddingInSelection,
-                          LyraMetrics::values.homeCoverHeight);
-        if (!coverPath.empty()) {
-          const std::string coverBmpPath = UITheme::getCoverThumbPath(coverPath, LyraMetrics::values.homeCoverHeight);
-
-          // First time: load cover from SD and render
-          FsFile file;
-          if (Storage.openFileForRead("HOME", coverBmpPath, file)) {
-            Bitmap bitmap(file);
-            if (bitmap.parseHeaders() == BmpReaderError::Ok) {
-              float coverHeight = static_cast<float>(bitmap.getHeight());
-              float coverWidth = static_cast<float>(bitmap.getWidth());
-              float ratio = coverWidth / coverHeight;
-              const float tileRatio = static_cast<float>(tileWidth - 2 * hPaddingInSelection) /
-                                      static_cast<float>(LyraMetrics::values.homeCoverHeight);
-              float cropX = 1.0f - (tileRatio / ratio);
-              renderer.drawBitmap(bitmap, tileX + hPaddingInSelection, tileY + hPaddingInSelection,
-                                  tileWidth - 2 * hPaddingInSelection, LyraMetrics::values.homeCoverHeight, cropX);
-            }
-            file.close();
-          }
-        }
+    TileCache& tiles = UITheme::getInstance().getTileCache();
+    for (int i = 0; i < std::min(static_cast<int>(recentBooks.size()), LyraMetrics::values.homeRecentBooksCount);
+         i++) {
+      std::string coverPath = recentBooks[i].coverBmpPath;
+      int tileX = LyraMetrics::values.contentSidePadding + tileWidth * i;
+      const Rect coverRect{tileX + hPaddingInSelection, tileY + hPaddingInSelection,
+                           tileWidth - 2 * hPaddingInSelection, LyraMetrics::values.homeCoverHeight};
+      if (coverPath.empty()) {
+        renderer.drawRect(coverRect.x, coverRect.y, coverRect.width, coverRect.height);
+        continue;
+      }
+
+      const std::string coverBmpPath = UITheme::getCoverThumbPath(coverPath, LyraMetrics::values.homeCoverHeight);
+      const uint32_t tileKey = TileCache::keyFor(coverBmpPath);
+      if (tiles.draw(renderer, tileKey, coverRect)) {
+        continue;
       }
 
-      coverBufferStored = storeCoverBuffer();
-      coverRendered = true;
+      renderer.drawRect(coverRect.x, coverRect.y, coverRect.width, coverRect.height);
+
+      // First time: load cover from SD and render
+      FsFile file;
+      if (Storage.openFileForRead("HOME", coverBmpPath, file)) {
+        Bitmap bitmap(file);
+        if (bitmap.parseHeaders() == BmpReaderError::Ok) {
+          float coverHeight = static_cast<float>(bitmap.getHeight());
+          float coverWidth = static_cast<float>(bitmap.getWidth());
+          float ratio = coverWidth / coverHeight;
+          const float tileRatio = static_cast<float>(coverRect.width) / static_cast<float>(coverRect.height);
+          float cropX = 1.0f - (tileRatio / ratio);
+          renderer.drawBitmap(bitmap, coverRect.x, coverRect.y, coverRect.width, coverRect.height, cropX);
+          tiles.store(renderer, tileKey, coverRect);
+        }
+        file.close();
+      }
     }
 
     for (int i = 0; i < std::min(static_cast<int>(recentBooks.size()), LyraMetrics::values.homeRecentBooksCount); i++) {
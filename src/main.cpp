@@ -12,11 +12,16 @@
 #include <cstring>
 
 #include "Battery.h"
+#include "BookCacheManager.h"
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
+#include "InputLatency.h"
 #include "KOReaderCredentialStore.h"
+#include "KOReaderProgressQueue.h"
 #include "MappedInputManager.h"
+#include "PageSnapshot.h"
 #include "RecentBooksStore.h"
+#include "SerialAutomation.h"
 #include "activities/boot_sleep/BootActivity.h"
 #include "activities/boot_sleep/SleepActivity.h"
 #include "activities/browser/OpdsBookBrowserActivity.h"
@@ -187,6 +192,19 @@ void verifyPowerButtonDuration() {
   }
 }
 
+// Light sleep would drop the USB serial connection used for logs, so it is only enabled while on battery and is
+// re-applied whenever USB is plugged in or out
+void updatePowerSaving() {
+  static int8_t onBattery = -1;
+  const bool battery = !gpio.isUsbConnected();
+  if (battery == onBattery) {
+    return;
+  }
+  onBattery = battery;
+  LOG_INF("PWR", "USB %s, light sleep %s", battery ? "unplugged" : "plugged in", battery ? "on" : "off");
+  gpio.enablePowerSaving(battery);
+}
+
 void waitForPowerRelease() {
   gpio.update();
   while (gpio.isPressed(HalGPIO::BTN_POWER)) {
@@ -199,6 +217,12 @@ void waitForPowerRelease() {
 void enterDeepSleep() {
   APP_STATE.lastSleepFromReader = currentActivity && currentActivity->isReaderActivity();
   APP_STATE.saveToFile();
+  if (APP_STATE.lastSleepFromReader) {
+    // Lets the next power button wake show the page before anything else is loaded
+    currentActivity->onEnterSleep();
+  } else {
+    PAGE_SNAPSHOT.discard();
+  }
   exitActivity();
   enterNewActivity(new SleepActivity(renderer, mappedInputManager));
 
@@ -279,6 +303,11 @@ void setupDisplayAndFonts() {
   LOG_DBG("MAIN", "Fonts setup");
 }
 
+// nb: we use logSerial from logging to avoid deprecation warnings
+SerialAutomation serialAutomation(
+    logSerial, display, [](const uint8_t button, const bool pressed) { gpio.injectButton(button, pressed); },
+    [](const std::string& path) { onGoToReader(path); }, CROSSPOINT_VERSION);
+
 void setup() {
   t1 = millis();
 
@@ -307,6 +336,7 @@ void setup() {
   SETTINGS.loadFromFile();
   I18N.loadSettings();
   KOREADER_STORE.loadFromFile();
+  KOREADER_QUEUE.loadFromFile();
   UITheme::getInstance().reload();
   ButtonNavigator::setMappedInputManager(mappedInputManager);
 
@@ -329,20 +359,30 @@ void setup() {
   }
 
   // First serial output only here to avoid timing inconsistencies for power button press duration verification
-  LOG_DBG("MAIN", "Starting CrossPoint version " CROSSPOINT_VERSION);
+  LOG_DBG("MAIN", "Starting CrossPoint version %s", CROSSPOINT_VERSION);
 
   setupDisplayAndFonts();
-
-  exitActivity();
-  enterNewActivity(new BootActivity(renderer, mappedInputManager));
-
   APP_STATE.loadFromFile();
-  RECENT_BOOKS.loadFromFile();
 
   // Boot to home screen if no book is open, last sleep was not from reader, back button is held, or reader activity
   // crashed (indicated by readerActivityLoadCount > 0)
-  if (APP_STATE.openEpubPath.empty() || !APP_STATE.lastSleepFromReader ||
-      mappedInputManager.isPressed(MappedInputManager::Button::Back) || APP_STATE.readerActivityLoadCount > 0) {
+  const bool resumeReader = !APP_STATE.openEpubPath.empty() && APP_STATE.lastSleepFromReader &&
+                            !mappedInputManager.isPressed(MappedInputManager::Button::Back) &&
+                            APP_STATE.readerActivityLoadCount == 0;
+
+  // Waking into the reader: put the page from before sleep back on the panel right away and skip the boot screen.
+  // The reader below then rebuilds its state and only refreshes once the user turns the page.
+  const bool snapshotShown = resumeReader && gpio.getWakeupReason() == HalGPIO::WakeupReason::PowerButton &&
+                             PAGE_SNAPSHOT.show(renderer, APP_STATE.openEpubPath);
+  if (!snapshotShown) {
+    exitActivity();
+    enterNewActivity(new BootActivity(renderer, mappedInputManager));
+  }
+
+  RECENT_BOOKS.loadFromFile();
+  BOOK_CACHE.loadFromFile();
+
+  if (!resumeReader) {
     onGoHome();
   } else {
     // Clear app state to avoid getting into a boot loop if the epub doesn't load
@@ -355,6 +395,8 @@ void setup() {
 
   // Ensure we're not still holding the power button before leaving setup
   waitForPowerRelease();
+
+  updatePowerSaving();
 }
 
 void loop() {
@@ -362,32 +404,24 @@ void loop() {
   const unsigned long loopStartTime = millis();
   static unsigned long lastMemPrint = 0;
 
+  // Serial commands, including buttons injected by test scripts, are applied before the buttons are read
+  serialAutomation.poll();
+
   gpio.update();
+  updatePowerSaving();
+  if (gpio.wasAnyPressed() || gpio.wasAnyReleased()) {
+    INPUT_LATENCY.onInput(gpio.getLastEventMicros());
+  }
 
   renderer.setFadingFix(SETTINGS.fadingFix);
 
   if (Serial && millis() - lastMemPrint >= 10000) {
     LOG_INF("MEM", "Free: %d bytes, Total: %d bytes, Min Free: %d bytes", ESP.getFreeHeap(), ESP.getHeapSize(),
             ESP.getMinFreeHeap());
+    INPUT_LATENCY.log();
     lastMemPrint = millis();
   }
 
-  // Handle incoming serial commands,
-  // nb: we use logSerial from logging to avoid deprecation warnings
-  if (logSerial.available() > 0) {
-    String line = logSerial.readStringUntil('\n');
-    if (line.startsWith("CMD:")) {
-      String cmd = line.substring(4);
-      cmd.trim();
-      if (cmd == "SCREENSHOT") {
-        logSerial.printf("SCREENSHOT_START:%d\n", HalDisplay::BUFFER_SIZE);
-        uint8_t* buf = display.getFrameBuffer();
-        logSerial.write(buf, HalDisplay::BUFFER_SIZE);
-        logSerial.printf("SCREENSHOT_END\n");
-      }
-    }
-  }
-
   // Check for any user activity (button press or release) or active background work
   static unsigned long lastActivityTime = millis();
   if (gpio.wasAnyPressed() || gpio.wasAnyReleased() || (currentActivity && currentActivity->preventAutoSleep())) {
@@ -422,19 +456,16 @@ void loop() {
     }
   }
 
-  // Add delay at the end of the loop to prevent tight spinning
+  // Block until the next button sample is due to prevent tight spinning. A power button edge ends the wait early.
   // When an activity requests skip loop delay (e.g., webserver running), use yield() for faster response
-  // Otherwise, use longer delay to save power
   if (currentActivity && currentActivity->skipLoopDelay()) {
     yield();  // Give FreeRTOS a chance to run tasks, but return immediately
   } else {
+    static constexpr unsigned long INPUT_POLL_MS = 10;
+    static constexpr unsigned long IDLE_POLL_MS = 50;
     static constexpr unsigned long IDLE_POWER_SAVING_MS = 3000;  // 3 seconds
-    if (millis() - lastActivityTime >= IDLE_POWER_SAVING_MS) {
-      // If we've been inactive for a while, increase the delay to save power
-      delay(50);
-    } else {
-      // Short delay to prevent tight loop while still being responsive
-      delay(10);
-    }
+    // Light sleep only saves power between wakeups and every wakeup still runs the CPU at full current, so sample
+    // less often once the user is idle. Fast sampling while active keeps page turns responsive.
+    gpio.waitForInput(millis() - lastActivityTime >= IDLE_POWER_SAVING_MS ? IDLE_POLL_MS : INPUT_POLL_MS);
   }
 }
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 
+#include "BookCacheManager.h"
 #include "CrossPointSettings.h"
 #include "SettingsList.h"
 #include "html/FilesPageHtml.generated.h"
@@ -44,7 +45,9 @@ unsigned long wsLastCompleteAt = 0;
 void clearEpubCacheIfNeeded(const String& filePath) {
   // Only clear cache for .epub files
   if (StringUtils::checkFileExtension(filePath, ".epub")) {
-    Epub(filePath.c_str(), "/.crosspoint").clearCache();
+    Epub epub(filePath.c_str(), "/.crosspoint");
+    epub.clearCache();
+    BOOK_CACHE.forget(epub.getCachePath());
     LOG_DBG("WEB", "Cleared epub cache for: %s", filePath.c_str());
   }
 }
@@ -133,6 +136,7 @@ void CrossPointWebServer::begin() {
   server->on("/files", HTTP_GET, [this] { handleFileList(); });
 
   server->on("/api/status", HTTP_GET, [this] { handleStatus(); });
+  server->on("/api/cache", HTTP_GET, [this] { handleCacheStats(); });
   server->on("/api/files", HTTP_GET, [this] { handleFileListData(); });
   server->on("/download", HTTP_GET, [this] { handleDownload(); });
 
@@ -326,6 +330,37 @@ void CrossPointWebServer::handleStatus() const {
   server->send(200, "application/json", json);
 }
 
+void CrossPointWebServer::handleCacheStats() const {
+  BOOK_CACHE.refresh();
+
+  JsonDocument doc;
+  doc["budget"] = SETTINGS.getCacheBudgetBytes();
+  doc["used"] = BOOK_CACHE.getTotalBytes();
+
+  // Most recently read first, matching the eviction order in reverse
+  std::vector<const BookCacheEntry*> entries;
+  for (const auto& entry : BOOK_CACHE.getEntries()) {
+    entries.push_back(&entry);
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const BookCacheEntry* a, const BookCacheEntry* b) { return a->lastUsed > b->lastUsed; });
+
+  JsonArray books = doc["books"].to<JsonArray>();
+  for (const auto* entry : entries) {
+    JsonObject book = books.add<JsonObject>();
+    book["path"] = entry->bookPath;
+    book["cacheDir"] = entry->cacheDir;
+    book["sections"] = entry->sectionBytes;
+    book["images"] = entry->imageBytes;
+    book["covers"] = entry->coverBytes;
+    book["other"] = entry->otherBytes;
+  }
+
+  String json;
+  serializeJson(doc, json);
+  server->send(200, "application/json", json);
+}
+
 void CrossPointWebServer::scanFiles(const char* path, const std::function<void(FileInfo)>& callback) const {
   FsFile root = Storage.open(path);
   if (!root) {
@@ -0,0 +1,174 @@
+#include "DownloadPipeline.h"
+
+#include <Arduino.h>
+#include <HalSpiBus.h>
+#include <Logging.h>
+#include <miniz.h>
+
+#include <new>
+
+DownloadPipeline::~DownloadPipeline() { finish(); }
+
+bool DownloadPipeline::begin(const bool pipelined) {
+  for (auto& buffer : buffers) {
+    buffer.reset(new (std::nothrow) uint8_t[BUFFER_SIZE]);
+    if (!buffer) {
+      LOG_ERR("DL", "Failed to allocate %u byte download buffer", static_cast<unsigned>(BUFFER_SIZE));
+      return false;
+    }
+  }
+  if (!pipelined) {
+    return true;
+  }
+
+  freeBuffers = xQueueCreate(BUFFER_COUNT, sizeof(uint8_t));
+  fullBuffers = xQueueCreate(BUFFER_COUNT + 1, sizeof(Chunk));
+  writerDone = xSemaphoreCreateBinary();
+  if (!freeBuffers || !fullBuffers || !writerDone) {
+    LOG_ERR("DL", "Failed to create download queues, writing inline");
+    deleteQueues();
+    return true;
+  }
+  for (uint8_t i = 0; i < BUFFER_COUNT; i++) {
+    xQueueSend(freeBuffers, &i, 0);
+  }
+  if (xTaskCreate(&writerTask, "DownloadWriter", 4096, this, 1, nullptr) != pdPASS) {
+    LOG_ERR("DL", "Failed to start download writer, writing inline");
+    deleteQueues();
+    return true;
+  }
+  running = true;
+  return true;
+}
+
+void DownloadPipeline::deleteQueues() {
+  if (freeBuffers) vQueueDelete(freeBuffers);
+  if (fullBuffers) vQueueDelete(fullBuffers);
+  if (writerDone) vSemaphoreDelete(writerDone);
+  freeBuffers = nullptr;
+  fullBuffers = nullptr;
+  writerDone = nullptr;
+}
+
+void DownloadPipeline::write(const uint8_t* data, const size_t length) {
+  if (writeFailed) {
+    return;
+  }
+  size_t written;
+  {
+    // The progress screen may be refreshing meanwhile
+    SpiBusLock bus;
+    written = sink.write(data, length);
+  }
+  if (written != length) {
+    LOG_ERR("DL", "Write failed: wrote %u of %u bytes", static_cast<unsigned>(written),
+            static_cast<unsigned>(length));
+    writeFailed = true;
+    return;
+  }
+  crc32 = static_cast<uint32_t>(mz_crc32(crc32, data, length));
+}
+
+void DownloadPipeline::writerTask(void* param) {
+  auto* self = static_cast<DownloadPipeline*>(param);
+  Chunk chunk;
+  while (xQueueReceive(self->fullBuffers, &chunk, portMAX_DELAY) == pdPASS && chunk.length > 0) {
+    self->write(self->buffers[chunk.index].get(), chunk.length);
+    xQueueSend(self->freeBuffers, &chunk.index, portMAX_DELAY);
+  }
+  xSemaphoreGive(self->writerDone);
+  vTaskDelete(nullptr);
+}
+
+size_t DownloadPipeline::receive(Stream& source, const size_t length, const std::function<bool()>& isOpen,
+                                 const ProgressCallback& progress) {
+  if (!buffers[0]) {
+    return 0;
+  }
+
+  size_t received = 0;
+  unsigned long lastDataAt = millis();
+  bool done = false;
+  while (!done && !writeFailed) {
+    uint8_t index = 0;
+    if (running) {
+      xQueueReceive(freeBuffers, &index, portMAX_DELAY);
+    }
+    uint8_t* buffer = buffers[index].get();
+
+    size_t filled = 0;
+    while (filled < BUFFER_SIZE) {
+      if (length > 0 && received + filled >= length) {
+        done = true;
+        break;
+      }
+      const int available = source.available();
+      if (available <= 0) {
+        if (!isOpen() || millis() - lastDataAt > STALL_TIMEOUT_MS) {
+          done = true;
+          break;
+        }
+        // Only full buffers are handed over, a short SD write costs nearly as much as a full one
+        delay(1);
+        continue;
+      }
+
+      size_t toRead = std::min(static_cast<size_t>(available), BUFFER_SIZE - filled);
+      if (length > 0) {
+        toRead = std::min(toRead, length - received - filled);
+      }
+      const size_t bytesRead = source.readBytes(buffer + filled, toRead);
+      if (bytesRead > 0) {
+        filled += bytesRead;
+        lastDataAt = millis();
+      }
+    }
+
+    if (filled == 0) {
+      if (running) {
+        xQueueSend(freeBuffers, &index, portMAX_DELAY);
+      }
+      continue;
+    }
+    if (running) {
+      const Chunk chunk{index, static_cast<uint16_t>(filled)};
+      xQueueSend(fullBuffers, &chunk, portMAX_DELAY);
+    } else {
+      write(buffer, filled);
+    }
+    received += filled;
+    bytesReceived += filled;
+    if (progress) {
+      progress(bytesReceived);
+    }
+  }
+  return received;
+}
+
+bool DownloadPipeline::finish() {
+  if (running) {
+    constexpr Chunk stop{0, 0};
+    xQueueSend(fullBuffers, &stop, portMAX_DELAY);
+    xSemaphoreTake(writerDone, portMAX_DELAY);
+    deleteQueues();
+    running = false;
+  }
+  return !writeFailed;
+}
+
+uint32_t DownloadPipeline::fileCrc32(FsFile& file, const size_t length) {
+  uint8_t buffer[512];
+  uint32_t crc = 0;
+  size_t remaining = length;
+  file.seek(0);
+  while (remaining > 0) {
+    const int bytesRead = file.read(buffer, std::min(sizeof(buffer), remaining));
+    if (bytesRead <= 0) {
+      break;
+    }
+    crc = static_cast<uint32_t>(mz_crc32(crc, buffer, bytesRead));
+    remaining -= bytesRead;
+  }
+  file.seek(length);
+  return crc;
+}
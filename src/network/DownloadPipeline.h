@@ -0,0 +1,97 @@
+#pragma once
+#include <HalStorage.h>
+#include <Print.h>
+#include <Stream.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+/**
+ * Double-buffered copy of a download body from the network to the SD card. A writer task empties one buffer into
+ * the sink while receive() fills the other, so WiFi receive and SD writes overlap instead of taking turns.
+ *
+ * A pipeline can be fed from several connections in a row (a download resumed after a dropped connection) and
+ * keeps a running CRC-32 of everything written.
+ */
+class DownloadPipeline {
+ public:
+  static constexpr size_t BUFFER_SIZE = 4096;
+  // receive() gives up on a connection that stays open without delivering anything for this long
+  static constexpr unsigned long STALL_TIMEOUT_MS = 10000;
+
+  using ProgressCallback = std::function<void(size_t received)>;
+
+  explicit DownloadPipeline(Print& sink) : sink(sink) {}
+  ~DownloadPipeline();
+
+  // Disable copy
+  DownloadPipeline(const DownloadPipeline&) = delete;
+  DownloadPipeline& operator=(const DownloadPipeline&) = delete;
+
+  /**
+   * Allocate the buffers and start the writer task. Without pipelined, or if the task cannot be started, buffers are
+   * written inline by receive().
+   * @return false if the buffers could not be allocated
+   */
+  bool begin(bool pipelined = true);
+
+  /**
+   * Continue the CRC-32 from bytes that are already in the sink, e.g. the start of a resumed .part file.
+   */
+  void setCrc32(const uint32_t crc) { crc32 = crc; }
+
+  /**
+   * Copy from source until length bytes have arrived (0: until the connection closes), isOpen() reports a closed
+   * connection with nothing left to read, or the connection stalls.
+   * @param progress Optional, called with the total received by this pipeline after every buffer
+   * @return Bytes received by this call
+   */
+  size_t receive(Stream& source, size_t length, const std::function<bool()>& isOpen,
+                 const ProgressCallback& progress = nullptr);
+
+  /**
+   * Wait until every received byte is written and stop the writer task.
+   * @return false if a write to the sink fell short
+   */
+  bool finish();
+
+  size_t getBytesReceived() const { return bytesReceived; }
+  // Only final once finish() returned
+  uint32_t getCrc32() const { return crc32; }
+  bool hasFailed() const { return writeFailed; }
+
+  /**
+   * CRC-32 of the first length bytes of file, for resuming a checksummed download. Leaves the file positioned at
+   * length.
+   */
+  static uint32_t fileCrc32(FsFile& file, size_t length);
+
+ private:
+  static constexpr uint8_t BUFFER_COUNT = 2;
+
+  struct Chunk {
+    uint8_t index;
+    uint16_t length;  // 0 stops the writer
+  };
+
+  Print& sink;
+  std::unique_ptr<uint8_t[]> buffers[BUFFER_COUNT];
+  QueueHandle_t freeBuffers = nullptr;
+  QueueHandle_t fullBuffers = nullptr;
+  SemaphoreHandle_t writerDone = nullptr;
+  bool running = false;
+  std::atomic<bool> writeFailed{false};
+  size_t bytesReceived = 0;
+  uint32_t crc32 = 0;
+
+  void write(const uint8_t* data, size_t length);
+  void deleteQueues();
+  static void writerTask(void* param);
+};
@@ -9,12 +9,15 @@
 
 #include <cstring>
 #include <memory>
+#include <vector>
 
 #include "CrossPointSettings.h"
+#include "DownloadPipeline.h"
 #include "util/UrlUtils.h"
 
-bool HttpDownloader::fetchUrl(const std::string& url, Stream& outContent) {
-  // Use WiFiClientSecure for HTTPS, regular WiFiClient for HTTP
+namespace {
+// Use WiFiClientSecure for HTTPS, regular WiFiClient for HTTP. The client has to outlive the request.
+std::unique_ptr<WiFiClient> beginRequest(HTTPClient& http, const std::string& url) {
   std::unique_ptr<WiFiClient> client;
   if (UrlUtils::isHttpsUrl(url)) {
     auto* secureClient = new WiFiClientSecure();
@@ -23,9 +26,6 @@ bool HttpDownloader::fetchUrl(const std::string& url, Stream& outContent) {
   } else {
     client.reset(new WiFiClient());
   }
-  HTTPClient http;
-
-  LOG_DBG("HTTP", "Fetching: %s", url.c_str());
 
   http.begin(*client, url.c_str());
   http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
@@ -37,12 +37,67 @@ bool HttpDownloader::fetchUrl(const std::string& url, Stream& outContent) {
     String encoded = base64::encode(credentials.c_str());
     http.addHeader("Authorization", "Basic " + encoded);
   }
+  return client;
+}
+
+// Total length from a "bytes first-last/total" or "bytes */total" Content-Range header, 0 if unknown
+size_t contentRangeTotal(const String& contentRange) {
+  const int slash = contentRange.lastIndexOf('/');
+  if (slash < 0 || contentRange.substring(slash + 1) == "*") {
+    return 0;
+  }
+  return strtoul(contentRange.c_str() + slash + 1, nullptr, 10);
+}
+
+// Value for If-Range: a strong ETag, else Last-Modified. Weak ETags never match If-Range, so they are not kept.
+std::string rangeValidator(HTTPClient& http) {
+  const String etag = http.header("ETag");
+  if (etag.length() > 0 && !etag.startsWith("W/")) {
+    return etag.c_str();
+  }
+  return http.header("Last-Modified").c_str();
+}
+
+bool endsWith(const std::string& s, const char* suffix) {
+  const size_t len = strlen(suffix);
+  return s.size() >= len && s.compare(s.size() - len, len, suffix) == 0;
+}
+}  // namespace
+
+HttpDownloader::FetchResult HttpDownloader::fetchUrlIfModified(const std::string& url, Stream& outContent,
+                                                               const std::string& etag,
+                                                               const std::string& lastModified, std::string* outEtag,
+                                                               std::string* outLastModified) {
+  HTTPClient http;
+  LOG_DBG("HTTP", "Fetching: %s", url.c_str());
+  const auto client = beginRequest(http, url);
+
+  if (!etag.empty()) {
+    http.addHeader("If-None-Match", etag.c_str());
+  }
+  if (!lastModified.empty()) {
+    http.addHeader("If-Modified-Since", lastModified.c_str());
+  }
+  const char* validatorHeaders[] = {"ETag", "Last-Modified"};
+  http.collectHeaders(validatorHeaders, 2);
 
   const int httpCode = http.GET();
+  if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+    LOG_DBG("HTTP", "Not modified");
+    http.end();
+    return NOT_MODIFIED;
+  }
   if (httpCode != HTTP_CODE_OK) {
     LOG_ERR("HTTP", "Fetch failed: %d", httpCode);
     http.end();
-    return false;
+    return FETCH_FAILED;
+  }
+
+  if (outEtag) {
+    *outEtag = http.header("ETag").c_str();
+  }
+  if (outLastModified) {
+    *outLastModified = http.header("Last-Modified").c_str();
   }
 
   http.writeToStream(&outContent);
@@ -50,7 +105,11 @@ bool HttpDownloader::fetchUrl(const std::string& url, Stream& outContent) {
   http.end();
 
   LOG_DBG("HTTP", "Fetch success");
-  return true;
+  return FETCHED;
+}
+
+bool HttpDownloader::fetchUrl(const std::string& url, Stream& outContent) {
+  return fetchUrlIfModified(url, outContent, "", "") == FETCHED;
 }
 
 bool HttpDownloader::fetchUrl(const std::string& url, std::string& outContent) {
@@ -63,111 +122,205 @@ bool HttpDownloader::fetchUrl(const std::string& url, std::string& outContent) {
 }
 
 HttpDownloader::DownloadError HttpDownloader::downloadToFile(const std::string& url, const std::string& destPath,
-                                                             ProgressCallback progress) {
-  // Use WiFiClientSecure for HTTPS, regular WiFiClient for HTTP
-  std::unique_ptr<WiFiClient> client;
-  if (UrlUtils::isHttpsUrl(url)) {
-    auto* secureClient = new WiFiClientSecure();
-    secureClient->setInsecure();
-    client.reset(secureClient);
-  } else {
-    client.reset(new WiFiClient());
-  }
-  HTTPClient http;
-
+                                                             ProgressCallback progress, const uint32_t expectedCrc32) {
   LOG_DBG("HTTP", "Downloading: %s", url.c_str());
   LOG_DBG("HTTP", "Destination: %s", destPath.c_str());
 
-  http.begin(*client, url.c_str());
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.addHeader("User-Agent", "CrossPoint-ESP32-" CROSSPOINT_VERSION);
-
-  // Add Basic HTTP auth if credentials are configured
-  if (strlen(SETTINGS.opdsUsername) > 0 && strlen(SETTINGS.opdsPassword) > 0) {
-    std::string credentials = std::string(SETTINGS.opdsUsername) + ":" + SETTINGS.opdsPassword;
-    String encoded = base64::encode(credentials.c_str());
-    http.addHeader("Authorization", "Basic " + encoded);
-  }
-
-  const int httpCode = http.GET();
-  if (httpCode != HTTP_CODE_OK) {
-    LOG_ERR("HTTP", "Download failed: %d", httpCode);
-    http.end();
-    return HTTP_ERROR;
-  }
-
-  const size_t contentLength = http.getSize();
-  LOG_DBG("HTTP", "Content-Length: %zu", contentLength);
-
-  // Remove existing file if present
-  if (Storage.exists(destPath.c_str())) {
-    Storage.remove(destPath.c_str());
-  }
-
-  // Open file for writing
-  FsFile file;
-  if (!Storage.openFileForWrite("HTTP", destPath.c_str(), file)) {
+  // Received data goes to a .part file next to the destination, which a later attempt or call continues from. The
+  // validator of the version it holds is kept next to it, so a resume never splices two versions of the file.
+  const std::string partPath = destPath + PART_SUFFIX;
+  const std::string validatorPath = destPath + VALIDATOR_SUFFIX;
+  FsFile file = Storage.open(partPath.c_str(), O_RDWR | O_CREAT);
+  if (!file) {
     LOG_ERR("HTTP", "Failed to open file for writing");
-    http.end();
     return FILE_ERROR;
   }
+  size_t offset = file.size();
+  std::string validator;
+  if (offset > 0 && Storage.exists(validatorPath.c_str())) {
+    validator = Storage.readFile(validatorPath.c_str()).c_str();
+  }
+  uint32_t crc = 0;
+  if (offset > 0 && validator.empty()) {
+    LOG_INF("HTTP", "No validator for the existing .part, restarting download");
+    file.truncate(0);
+    offset = 0;
+  } else if (offset > 0) {
+    LOG_INF("HTTP", "Resuming from %zu bytes", offset);
+    crc = expectedCrc32 ? DownloadPipeline::fileCrc32(file, offset) : 0;
+    file.seek(offset);
+  }
 
-  // Get the stream for chunked reading
-  WiFiClient* stream = http.getStreamPtr();
-  if (!stream) {
-    LOG_ERR("HTTP", "Failed to get stream");
+  auto pipeline = std::unique_ptr<DownloadPipeline>(new DownloadPipeline(file));
+  if (!pipeline->begin()) {
     file.close();
-    Storage.remove(destPath.c_str());
-    http.end();
-    return HTTP_ERROR;
+    return FILE_ERROR;
   }
-
-  // Download in chunks
-  uint8_t buffer[DOWNLOAD_CHUNK_SIZE];
-  size_t downloaded = 0;
-  const size_t total = contentLength > 0 ? contentLength : 0;
-
-  while (http.connected() && (contentLength == 0 || downloaded < contentLength)) {
-    const size_t available = stream->available();
-    if (available == 0) {
-      delay(1);
-      continue;
+  pipeline->setCrc32(crc);
+
+  // Throw away what the .part holds and receive the file from the first byte
+  const auto restart = [&] {
+    LOG_INF("HTTP", "Server did not resume, restarting download");
+    pipeline->finish();
+    pipeline.reset(new DownloadPipeline(file));
+    file.truncate(0);
+    file.seek(0);
+    offset = 0;
+    return pipeline->begin();
+  };
+
+  size_t total = 0;
+  bool complete = false;
+  for (int attempt = 0; attempt < MAX_DOWNLOAD_ATTEMPTS && !complete && !pipeline->hasFailed(); attempt++) {
+    if (attempt > 0) {
+      delay(RETRY_DELAY_MS * attempt);
     }
-
-    const size_t toRead = available < DOWNLOAD_CHUNK_SIZE ? available : DOWNLOAD_CHUNK_SIZE;
-    const size_t bytesRead = stream->readBytes(buffer, toRead);
-
-    if (bytesRead == 0) {
-      break;
+    const size_t position = offset + pipeline->getBytesReceived();
+
+    HTTPClient http;
+    const auto client = beginRequest(http, url);
+    // Without a validator the server cannot tell whether the .part is still current, so the whole file is requested
+    if (position > 0 && !validator.empty()) {
+      http.addHeader("Range", ("bytes=" + std::to_string(position) + "-").c_str());
+      http.addHeader("If-Range", validator.c_str());
+    }
+    const char* responseHeaders[] = {"Content-Range", "ETag", "Last-Modified"};
+    http.collectHeaders(responseHeaders, 3);
+
+    const int httpCode = http.GET();
+    // A server that ignores If-Range would answer 206 for a changed file; its ETag gives it away
+    const String etag = http.header("ETag");
+    const bool changed = httpCode == HTTP_CODE_PARTIAL_CONTENT && !validator.empty() && validator[0] == '"' &&
+                         etag.length() > 0 && validator != etag.c_str();
+    if (httpCode == HTTP_CODE_PARTIAL_CONTENT && position > 0 && !changed) {
+      total = contentRangeTotal(http.header("Content-Range"));
+    } else if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_RANGE_NOT_SATISFIABLE || changed) {
+      const size_t rangeTotal =
+          httpCode == HTTP_CODE_RANGE_NOT_SATISFIABLE ? contentRangeTotal(http.header("Content-Range")) : 0;
+      if (rangeTotal > 0 && rangeTotal == position) {
+        // The .part already holds everything
+        total = rangeTotal;
+        complete = true;
+        http.end();
+        break;
+      }
+      // A 200 is the whole file, either because the range was not asked for or because the file changed
+      if (position > 0 && !restart()) {
+        http.end();
+        break;
+      }
+      if (httpCode != HTTP_CODE_OK) {
+        http.end();
+        continue;
+      }
+      validator = rangeValidator(http);
+      if (validator.empty()) {
+        Storage.remove(validatorPath.c_str());
+      } else {
+        Storage.writeFile(validatorPath.c_str(), validator.c_str());
+      }
+      const int contentLength = http.getSize();
+      total = contentLength > 0 ? contentLength : 0;
+    } else {
+      LOG_ERR("HTTP", "Download failed: %d", httpCode);
+      http.end();
+      if (httpCode > 0) {
+        // The server answered and refused, retrying will not help
+        break;
+      }
+      continue;
     }
 
-    const size_t written = file.write(buffer, bytesRead);
-    if (written != bytesRead) {
-      LOG_ERR("HTTP", "Write failed: wrote %zu of %zu bytes", written, bytesRead);
-      file.close();
-      Storage.remove(destPath.c_str());
+    WiFiClient* stream = http.getStreamPtr();
+    if (!stream) {
+      LOG_ERR("HTTP", "Failed to get stream");
       http.end();
-      return FILE_ERROR;
+      continue;
     }
 
-    downloaded += bytesRead;
+    const size_t start = offset + pipeline->getBytesReceived();
+    LOG_DBG("HTTP", "Receiving %zu of %zu bytes", total > start ? total - start : 0, total);
+    pipeline->receive(
+        *stream, total > start ? total - start : 0, [&http] { return http.connected(); },
+        [&](const size_t received) {
+          if (progress && total > 0) {
+            progress(offset + received, total);
+          }
+        });
+    http.end();
 
-    if (progress && total > 0) {
-      progress(downloaded, total);
+    const size_t reached = offset + pipeline->getBytesReceived();
+    // Without a length the end of the connection is the end of the body
+    complete = total > 0 ? reached >= total : true;
+    if (!complete) {
+      LOG_INF("HTTP", "Connection dropped at %zu of %zu bytes", reached, total);
     }
   }
 
-  file.close();
-  http.end();
-
+  const bool written = pipeline->finish();
+  crc = pipeline->getCrc32();
+  pipeline.reset();
+  const size_t downloaded = file.size();
+  if (!written) {
+    file.close();
+    Storage.remove(partPath.c_str());
+    Storage.remove(validatorPath.c_str());
+    return FILE_ERROR;
+  }
   LOG_DBG("HTTP", "Downloaded %zu bytes", downloaded);
 
-  // Verify download size if known
-  if (contentLength > 0 && downloaded != contentLength) {
-    LOG_ERR("HTTP", "Size mismatch: got %zu, expected %zu", downloaded, contentLength);
-    Storage.remove(destPath.c_str());
+  // Verify download size if known. An incomplete .part is kept so the download can resume later.
+  if (!complete || (total > 0 && downloaded != total)) {
+    LOG_ERR("HTTP", "Size mismatch: got %zu, expected %zu", downloaded, total);
+    file.close();
     return HTTP_ERROR;
   }
+  if (expectedCrc32 && crc != expectedCrc32) {
+    LOG_ERR("HTTP", "Checksum mismatch: got %08x, expected %08x", static_cast<unsigned>(crc),
+            static_cast<unsigned>(expectedCrc32));
+    file.close();
+    Storage.remove(partPath.c_str());
+    Storage.remove(validatorPath.c_str());
+    return CHECKSUM_ERROR;
+  }
 
+  // Replace any existing file
+  if (Storage.exists(destPath.c_str())) {
+    Storage.remove(destPath.c_str());
+  }
+  const bool renamed = file.rename(destPath.c_str());
+  file.close();
+  if (!renamed) {
+    LOG_ERR("HTTP", "Failed to rename %s", partPath.c_str());
+    return FILE_ERROR;
+  }
+  Storage.remove(validatorPath.c_str());
   return OK;
 }
+
+void HttpDownloader::removePartialDownloads(const char* dir) {
+  auto root = Storage.open(dir);
+  if (!root || !root.isDirectory()) {
+    if (root) root.close();
+    return;
+  }
+
+  // Collect first; removing entries while iterating the directory is not safe on FAT
+  std::vector<std::string> victims;
+  char name[128];
+  for (auto file = root.openNextFile(); file; file = root.openNextFile()) {
+    file.getName(name, sizeof(name));
+    if (!file.isDirectory() && (endsWith(name, PART_SUFFIX) || endsWith(name, VALIDATOR_SUFFIX))) {
+      victims.emplace_back(name);
+    }
+    file.close();
+  }
+  root.close();
+
+  const std::string base = std::string(dir) == "/" ? "" : dir;
+  for (const auto& victim : victims) {
+    const std::string path = base + "/" + victim;
+    LOG_DBG("HTTP", "Removing unfinished download %s", path.c_str());
+    Storage.remove(path.c_str());
+  }
+}
@@ -17,6 +17,7 @@ class HttpDownloader {
     HTTP_ERROR,
     FILE_ERROR,
     ABORTED,
+    CHECKSUM_ERROR,
   };
 
   /**
@@ -29,16 +30,50 @@ class HttpDownloader {
 
   static bool fetchUrl(const std::string& url, Stream& stream);
 
+  enum FetchResult {
+    FETCHED = 0,
+    NOT_MODIFIED,
+    FETCH_FAILED,
+  };
+
+  /**
+   * Conditional GET: sends If-None-Match / If-Modified-Since for the non-empty validators and only writes the body
+   * to stream if the server answers 200.
+   * @param etag ETag of the cached copy, may be empty
+   * @param lastModified Last-Modified of the cached copy, may be empty
+   * @param outEtag Optional, set to the ETag of a fetched response (empty if none)
+   * @param outLastModified Optional, set to the Last-Modified of a fetched response (empty if none)
+   * @return FETCHED, NOT_MODIFIED on 304, or FETCH_FAILED
+   */
+  static FetchResult fetchUrlIfModified(const std::string& url, Stream& stream, const std::string& etag,
+                                        const std::string& lastModified, std::string* outEtag = nullptr,
+                                        std::string* outLastModified = nullptr);
+
   /**
    * Download a file to the SD card.
+   * The body is written through a DownloadPipeline into destPath + ".part", which is renamed to destPath once the
+   * size (and checksum, if given) checks out. A dropped connection is resumed with an HTTP Range request, and a
+   * .part left by an earlier call is continued the same way. Resuming sends If-Range with the ETag or Last-Modified
+   * saved next to the .part, so a file that changed on the server is downloaded again from the start.
    * @param url The URL to download
    * @param destPath The destination path on SD card
    * @param progress Optional progress callback
+   * @param expectedCrc32 Optional CRC-32 of the whole file, 0 to skip the check
    * @return DownloadError indicating success or failure type
    */
   static DownloadError downloadToFile(const std::string& url, const std::string& destPath,
-                                      ProgressCallback progress = nullptr);
+                                      ProgressCallback progress = nullptr, uint32_t expectedCrc32 = 0);
+
+  /**
+   * Remove unfinished downloads (.part files and their saved validators) from a directory, once nothing is going to
+   * resume them.
+   */
+  static void removePartialDownloads(const char* dir);
+
+  static constexpr char PART_SUFFIX[] = ".part";
+  static constexpr char VALIDATOR_SUFFIX[] = ".part.tag";
 
  private:
-  static constexpr size_t DOWNLOAD_CHUNK_SIZE = 1024;
+  static constexpr int MAX_DOWNLOAD_ATTEMPTS = 4;
+  static constexpr unsigned long RETRY_DELAY_MS = 1000;
 };
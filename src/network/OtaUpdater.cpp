@@ -9,6 +9,7 @@
 
 namespace {
 constexpr char latestReleaseUrl[] = "https://api.github.com/repos/crosspoint-reader/crosspoint-reader/releases/latest";
+constexpr int otaRequestSize = 64 * 1024;
 
 /* This is buffer and size holder to keep upcoming data from latestReleaseUrl */
 char* local_buf;
@@ -227,6 +228,11 @@ OtaUpdater::OtaUpdaterError OtaUpdater::installUpdate() {
   esp_https_ota_config_t ota_config = {
       .http_config = &client_config,
       .http_client_init_cb = http_client_set_header_cb,
+      /* Fetch the image as a series of HTTP Range requests instead of one long response, so a slow or
+       * dropped connection only has to carry one request's worth of data at a time.
+       */
+      .partial_http_download = true,
+      .max_http_request_size = otaRequestSize,
   };
 
   /* For better timing and connectivity, we disable power saving for WiFi */
@@ -0,0 +1,70 @@
+#include "WifiConnector.h"
+
+#include <Arduino.h>
+#include <Logging.h>
+
+#include <ctime>
+
+void WifiConnector::begin(const std::string& ssid, const std::string& password, const WifiLink& link) {
+  this->ssid = ssid;
+  this->password = password;
+  this->link = link;
+  if (link.lease.ip != 0 && !link.lease.isCurrent(time(nullptr))) {
+    // The DHCP server may have handed the address to someone else by now
+    LOG_DBG("WCN", "Lease of %s has run out, using DHCP", ssid.c_str());
+    this->link.lease = WifiLease{};
+  }
+  linkStale = false;
+  startAttempt(link.isKnown());
+}
+
+void WifiConnector::startAttempt(const bool directed) {
+  phase = directed ? Phase::Directed : Phase::Scanning;
+  attemptStart = millis();
+  if (directed) {
+    LOG_DBG("WCN", "Connecting to %s on channel %u", ssid.c_str(), link.channel);
+    driver.connect(ssid.c_str(), password.c_str(), &link);
+  } else {
+    LOG_DBG("WCN", "Connecting to %s", ssid.c_str());
+    driver.connect(ssid.c_str(), password.c_str(), nullptr);
+  }
+}
+
+WifiConnector::Result WifiConnector::update() {
+  if (phase == Phase::Idle) {
+    return Result::Failed;
+  }
+
+  const WifiDriver::Status status = driver.status();
+  if (status == WifiDriver::Status::Connected) {
+    if (!driver.getLink(link)) {
+      link = WifiLink{};
+    }
+    LOG_DBG("WCN", "Connected to %s after %lu ms%s", ssid.c_str(), millis() - attemptStart,
+            phase == Phase::Directed ? " (directed)" : "");
+    phase = Phase::Idle;
+    return Result::Connected;
+  }
+
+  const bool failed = status == WifiDriver::Status::Failed || status == WifiDriver::Status::NoNetwork;
+  const unsigned long timeout = phase == Phase::Directed ? DIRECTED_TIMEOUT_MS : CONNECTION_TIMEOUT_MS;
+  const bool timedOut = millis() - attemptStart > timeout;
+  if (!failed && !timedOut) {
+    return Result::Pending;
+  }
+
+  if (phase == Phase::Directed) {
+    LOG_DBG("WCN", "%s is not on its last access point any more, scanning", ssid.c_str());
+    linkStale = true;
+    driver.disconnect();
+    startAttempt(false);
+    return Result::Pending;
+  }
+
+  phase = Phase::Idle;
+  if (timedOut && !failed) {
+    driver.disconnect();
+    return Result::TimedOut;
+  }
+  return status == WifiDriver::Status::NoNetwork ? Result::NoNetwork : Result::Failed;
+}
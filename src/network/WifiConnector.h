@@ -0,0 +1,47 @@
+#pragma once
+#include <HalWifi.h>
+
+#include <string>
+
+/**
+ * Joins one network. When the access point, channel and lease it was last reached on are known, the first attempt
+ * goes straight there: no all-channel scan, and no DHCP round trip while the lease is current. If that access point is gone (moved channel,
+ * replaced router, roaming between access points) the connector falls back to a regular connect, which scans, and
+ * getLink() then reports where the network is now.
+ *
+ * Call update() from the activity loop until it stops returning Pending.
+ */
+class WifiConnector {
+ public:
+  enum class Result : uint8_t { Pending, Connected, Failed, NoNetwork, TimedOut };
+
+  // A directed attempt that gets no answer is given up quickly, the scanning attempt that follows has the full time
+  static constexpr unsigned long DIRECTED_TIMEOUT_MS = 4000;
+  static constexpr unsigned long CONNECTION_TIMEOUT_MS = 15000;
+
+  explicit WifiConnector(WifiDriver& driver) : driver(driver) {}
+
+  /**
+   * @param link Where the network was last reached, channel 0 if unknown
+   */
+  void begin(const std::string& ssid, const std::string& password, const WifiLink& link);
+  Result update();
+
+  // Where the network was reached, valid once update() returned Connected
+  const WifiLink& getLink() const { return link; }
+  // Whether the remembered link was tried and failed, so it should not be tried again
+  bool isLinkStale() const { return linkStale; }
+
+ private:
+  enum class Phase : uint8_t { Idle, Directed, Scanning };
+
+  WifiDriver& driver;
+  std::string ssid;
+  std::string password;
+  WifiLink link;
+  Phase phase = Phase::Idle;
+  bool linkStale = false;
+  unsigned long attemptStart = 0;
+
+  void startAttempt(bool directed);
+};
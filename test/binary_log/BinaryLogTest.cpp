@@ -0,0 +1,131 @@
+// Host harness for the binary log mode: sample records are framed like a LOG_BINARY build and written with the lines
+// logPrintf would have printed; run_binary_log.sh decodes them with scripts/binary_log.py and compares the two. The
+// cost of a record is timed against formatting the line.
+
+#include <Arduino.h>
+#include <Logging.h>
+#include <Print.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test/host/HostHarness.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Sink for the throughput part of checkBinaryLog
+class NullPrint : public Print {
+ public:
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t*, const size_t size) override { return size; }
+};
+
+// Encodes sample records like a LOG_BINARY build, with a line of plain text in between, and writes the stream to
+// binlog.bin next to binlog.txt holding what logPrintf would have printed. run_binary_log.sh decodes the
+// stream with scripts/binary_log.py and compares the two.
+bool checkBinaryLog(const fs::path& buildDir) {
+  if (!logBinaryBegin(false)) {
+    std::cout << "Binary log: ring allocation failed\n";
+    return false;
+  }
+  std::vector<std::string> expected;
+  std::vector<uint32_t> ids;
+  const auto expect = [&](const char* level, const char* origin, const char* format, auto... args) {
+    char text[320];
+    const int len = snprintf(text, sizeof(text), "[%s] [%s] ", level, origin);
+    snprintf(text + len, sizeof(text) - len, format, args...);
+    expected.emplace_back(text);
+    ids.push_back(binlog::formatId((std::string(level) + "\x1f" + origin + "\x1f" + format).c_str()));
+  };
+  const std::string longName(300, 'x');
+
+  ScriptedSerial serial;
+  LOG_RECORD("DBG", "SCT", "Page %d processed", 7);
+  expect("DBG", "SCT", "Page %d processed", 7);
+  LOG_RECORD("INF", "IMG", "Decoded %s (%ux%u) in %lu ms, scale %.2f", "cover.jpg", 480u, 800u, 42ul, 0.5f);
+  expect("INF", "IMG", "Decoded %s (%ux%u) in %lu ms, scale %.2f", "cover.jpg", 480u, 800u, 42ul, 0.5);
+  logBinaryDrain(serial);
+  serial.print("OK:LATENCY\n");
+  expected.emplace_back("OK:LATENCY");
+  ids.push_back(0);
+  LOG_RECORD("ERR", "TST", "Offset %d of %u, size %lld, flags %02x%%, mark %c", -12, 4000000000u, -5000000000LL, 10,
+             'A');
+  expect("ERR", "TST", "Offset %d of %u, size %lld, flags %02x%%, mark %c", -12, 4000000000u, -5000000000LL, 10, 'A');
+  LOG_RECORD("DBG", "TST", "Name: %s, after: %d", longName.c_str(), 1);
+  // The string is cut to what fits in the record, the argument after it is dropped
+  expect("DBG", "TST", "Name: %s, after: %d", longName.substr(0, binlog::MAX_PAYLOAD - 10).c_str(), 1);
+  expected.back().back() = '?';
+  logBinaryDrain(serial);
+
+  // Walk the frames: text lines pass through, every record must carry the id of its format
+  bool framesOk = true;
+  std::ostringstream text;
+  size_t pos = 0, next = 0;
+  const std::string& stream = serial.tx;
+  while (pos < stream.size() && next < expected.size()) {
+    if (stream[pos] != 0) {
+      const size_t end = stream.find('\n', pos);
+      framesOk = framesOk && end != std::string::npos && ids[next] == 0;
+      text << expected[next++] << "\n";
+      pos = end == std::string::npos ? stream.size() : end + 1;
+      continue;
+    }
+    const size_t payload = static_cast<uint8_t>(stream[pos + 1]);
+    uint32_t id, ms;
+    memcpy(&id, stream.data() + pos + 2, sizeof(id));
+    memcpy(&ms, stream.data() + pos + 6, sizeof(ms));
+    framesOk = framesOk && id == ids[next] && pos + 2 + payload <= stream.size();
+    text << "[" << ms << "] " << expected[next++] << "\n";
+    pos += 2 + payload;
+  }
+  framesOk = framesOk && pos == stream.size() && next == expected.size();
+  std::ofstream(buildDir / "binlog.bin", std::ios::binary) << stream;
+  std::ofstream(buildDir / "binlog.txt") << text.str();
+
+  // Cost on the logging thread: one record plus the drain vs. formatting the line like logPrintf
+  constexpr int kCalls = 20000;
+  NullPrint sink;
+  const auto binaryStart = std::chrono::steady_clock::now();
+  for (int i = 0; i < kCalls; i++) {
+    LOG_RECORD("DBG", "SCT", "Page %d processed", i);
+    if (i % 64 == 63) {
+      logBinaryDrain(sink);
+    }
+  }
+  logBinaryDrain(sink);
+  const auto binaryNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                            binaryStart).count() / kCalls;
+  char line[256];
+  size_t formatted = 0;
+  const auto textStart = std::chrono::steady_clock::now();
+  for (int i = 0; i < kCalls; i++) {
+    formatted += snprintf(line, sizeof(line), "[%lu] [DBG] [SCT] Page %d processed\n", millis(), i);
+  }
+  const auto textNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                          textStart).count() / kCalls;
+
+  if (!framesOk || formatted == 0) {
+    std::cout << "Binary log: records do not match their formats\n";
+    return false;
+  }
+  std::cout << "Binary log: " << expected.size() << " sample lines framed, " << binaryNs << " ns per record vs "
+            << textNs << " ns formatting\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path buildDir = "build/binary_log";
+  fs::create_directories(buildDir);
+  return checkBinaryLog(buildDir) ? 0 : 1;
+}
@@ -0,0 +1,391 @@
+// Host harness for the EPUB parsers. XhtmlTokenizer must recover from malformed markup however it is split across
+// reads, content.opf spines of 50 to 3000 items must resolve through ContentOpfParser's hashed manifest index, and a
+// stylesheet fed to CssParser in chunks must parse like the whole file. Every chapter of the test EPUBs is parsed with
+// expat and XhtmlTokenizer to compare throughput and peak heap, and the time and SD bytes written by each book's
+// first open are reported.
+
+#include <Epub.h>
+#include <Epub/BookMetadataCache.h>
+#include <Epub/css/CssParser.h>
+#include <Epub/parsers/ContentOpfParser.h>
+#include <Epub/parsers/XhtmlTokenizer.h>
+#include <HalStorage.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+#include <expat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test/host/HostHarness.h"
+#include "test/host/HostHeap.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kBookDir = "test/epubs";
+
+// Parses synthetic content.opf files whose spine lists every manifest item in shuffled order. The spine must resolve
+// to the right hrefs at every size; the time of the linear .items.bin scan each itemref used to do below 400 items is
+// printed next to it.
+bool checkContentOpfLookup() {
+  const std::string cachePath = "/.crosspoint/opf_lookup";
+  Storage.mkdir(cachePath.c_str());
+  const std::string basePath = "OEBPS/";
+  std::ostringstream report;
+
+  for (const int itemCount : {50, 200, 399, 1000, 3000}) {
+    std::vector<int> spineOrder(itemCount);
+    for (int i = 0; i < itemCount; i++) {
+      spineOrder[i] = i;
+    }
+    std::shuffle(spineOrder.begin(), spineOrder.end(), std::mt19937(itemCount));
+
+    std::string opf = "<?xml version=\"1.0\"?><package><metadata><dc:title>Lookup</dc:title></metadata><manifest>";
+    for (int i = 0; i < itemCount; i++) {
+      opf += "<item id=\"chapter-" + std::to_string(i) + "\" href=\"text/ch" + std::to_string(i) +
+             ".xhtml\" media-type=\"application/xhtml+xml\"/>";
+    }
+    opf += "</manifest><spine>";
+    for (const int i : spineOrder) {
+      opf += "<itemref idref=\"chapter-" + std::to_string(i) + "\"/>";
+    }
+    opf += "</spine></package>";
+
+    BookMetadataCache cache(cachePath);
+    cache.beginWrite();
+    cache.beginContentOpfPass();
+    const auto start = std::chrono::steady_clock::now();
+    {
+      ContentOpfParser parser(cachePath, basePath, opf.size(), &cache);
+      parser.setup();
+      for (size_t pos = 0; pos < opf.size(); pos += 1024) {
+        const size_t chunk = std::min<size_t>(1024, opf.size() - pos);
+        if (parser.write(reinterpret_cast<const uint8_t*>(opf.data() + pos), chunk) != chunk) {
+          std::cout << "content.opf lookup: parse failed at " << itemCount << " items\n";
+          return false;
+        }
+      }
+    }
+    const double parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    cache.endContentOpfPass();
+
+    FsFile spine;
+    if (cache.getSpineCount() != itemCount || !Storage.openFileForRead("TST", cachePath + "/spine.bin.tmp", spine)) {
+      std::cout << "content.opf lookup: " << cache.getSpineCount() << " of " << itemCount << " spine items resolved\n";
+      return false;
+    }
+    for (const int i : spineOrder) {
+      std::string href;
+      uint32_t cumulativeSize;
+      int16_t tocIndex;
+      serialization::readString(spine, href);
+      serialization::readPod(spine, cumulativeSize);
+      serialization::readPod(spine, tocIndex);
+      if (href != basePath + "text/ch" + std::to_string(i) + ".xhtml") {
+        std::cout << "content.opf lookup: chapter-" << i << " resolved to " << href << "\n";
+        return false;
+      }
+    }
+    spine.close();
+    report << (report.tellp() > 0 ? ", " : "") << itemCount << " items " << parseMs << " ms";
+    if (itemCount >= 400) {
+      continue;
+    }
+
+    // The previous small-manifest lookup: rescan the items file from the start for every itemref
+    FsFile items;
+    Storage.openFileForWrite("TST", cachePath + "/scan.bin", items);
+    for (int i = 0; i < itemCount; i++) {
+      serialization::writeString(items, "chapter-" + std::to_string(i));
+      serialization::writeString(items, basePath + "text/ch" + std::to_string(i) + ".xhtml");
+    }
+    items.close();
+    Storage.openFileForRead("TST", cachePath + "/scan.bin", items);
+    const auto scanStart = std::chrono::steady_clock::now();
+    for (const int i : spineOrder) {
+      const std::string idref = "chapter-" + std::to_string(i);
+      std::string itemId, href;
+      items.seek(0);
+      while (items.available()) {
+        serialization::readString(items, itemId);
+        serialization::readString(items, href);
+        if (itemId == idref) {
+          break;
+        }
+      }
+    }
+    const double scanMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scanStart).count();
+    items.close();
+
+    report << " (linear lookups alone " << scanMs << " ms)";
+  }
+  std::cout << "content.opf lookup: spines resolve through the hashed manifest index; parse of " << report.str()
+            << "\n";
+  return true;
+}
+
+// Event log of a parse, used to compare what each parser reports
+struct ParseLog {
+  std::string events;
+  uint32_t elements = 0;
+  uint64_t textBytes = 0;
+  bool record = false;
+
+  static void XMLCALL start(void* userData, const char* name, const char** atts) {
+    auto* log = static_cast<ParseLog*>(userData);
+    log->elements++;
+    if (log->record) {
+      log->events += "<" + std::string(name);
+      for (int i = 0; atts[i]; i += 2) {
+        log->events += std::string(" ") + atts[i] + "=" + atts[i + 1];
+      }
+      log->events += ">";
+    }
+  }
+  static void XMLCALL end(void* userData, const char* name) {
+    auto* log = static_cast<ParseLog*>(userData);
+    if (log->record) {
+      log->events += "</" + std::string(name) + ">";
+    }
+  }
+  static void XMLCALL text(void* userData, const char* s, const int len) {
+    auto* log = static_cast<ParseLog*>(userData);
+    log->textBytes += len;
+    if (log->record) {
+      log->events.append(s, len);
+    }
+  }
+};
+
+// Feeds data to the tokenizer in reads of chunkSize bytes, like ChapterHtmlSlimParser does from the temp file
+void tokenize(const char* data, const size_t size, const size_t chunkSize, ParseLog& log) {
+  XhtmlTokenizer tokenizer;
+  tokenizer.setUserData(&log);
+  tokenizer.setElementHandler(ParseLog::start, ParseLog::end);
+  tokenizer.setCharacterDataHandler(ParseLog::text);
+  size_t offset = 0;
+  bool done;
+  do {
+    const size_t len = std::min({chunkSize, tokenizer.getBufferSpace(), size - offset});
+    memcpy(tokenizer.getBuffer(len), data + offset, len);
+    offset += len;
+    done = offset == size;
+    tokenizer.parseBuffer(len, done);
+  } while (!done);
+}
+
+bool expatParse(const char* data, const size_t size, const size_t chunkSize, ParseLog& log) {
+  static const XML_Memory_Handling_Suite memsuite = {heap::countedMalloc, heap::countedRealloc, heap::countedFree};
+  const XML_Parser parser = XML_ParserCreate_MM(nullptr, &memsuite, nullptr);
+  XML_SetUserData(parser, &log);
+  XML_SetElementHandler(parser, ParseLog::start, ParseLog::end);
+  XML_SetCharacterDataHandler(parser, ParseLog::text);
+  bool ok = true;
+  size_t offset = 0;
+  bool done;
+  do {
+    const size_t len = std::min(chunkSize, size - offset);
+    void* buf = XML_GetBuffer(parser, static_cast<int>(len));
+    memcpy(buf, data + offset, len);
+    offset += len;
+    done = offset == size;
+    ok = XML_ParseBuffer(parser, static_cast<int>(len), done) != XML_STATUS_ERROR;
+  } while (ok && !done);
+  XML_ParserFree(parser);
+  return ok;
+}
+
+// A stylesheet written to CssParser in small chunks, the way Epub::parseCssFiles inflates it out of the ZIP, must give
+// the same rules as parsing it from a file. The chunk sizes split comments, selectors and declarations mid-token.
+bool checkCssChunkedParse(const fs::path& sdRoot) {
+  std::string css = "/* leading comment */ @charset \"utf-8\";\n"
+                    "@media print { p { color: red; } }\n"
+                    "p { text-indent: 1.5em; margin-top: 0.5em; text-align: justify }\n"
+                    "h1, h2.title { font-weight: bold; text-align: center; /* inline */ margin-bottom: 12px }\n"
+                    ".italic{font-style:italic}.under{text-decoration:underline}\n"
+                    "div.note > p { margin-left: 2em }\n";
+  for (int i = 0; i < 40; i++) {
+    css += ".c" + std::to_string(i) + " { padding-left: " + std::to_string(i) + "px; text-align: right }\n";
+  }
+  {
+    std::ofstream out(sdRoot / "chunked.css", std::ios::binary);
+    out << css;
+  }
+
+  auto describe = [](const CssParser& parser) {
+    std::ostringstream text;
+    text << parser.ruleCount();
+    const std::pair<const char*, const char*> lookups[] = {{"p", ""},   {"h1", ""},         {"h2", "title"},
+                                                           {"span", "italic under"}, {"div", "c7"}, {"p", "c39"}};
+    for (const auto& [tag, classes] : lookups) {
+      const CssStyle style = parser.resolveStyle(tag, classes);
+      text << ' ' << static_cast<int>(style.textAlign) << static_cast<int>(style.fontStyle)
+           << static_cast<int>(style.fontWeight) << static_cast<int>(style.textDecoration) << ':'
+           << style.textIndent.value << ',' << style.marginTop.value << ',' << style.marginBottom.value << ','
+           << style.paddingLeft.value;
+    }
+    return text.str();
+  };
+
+  CssParser fromFile("/.crosspoint/css_chunked");
+  FsFile file;
+  if (!Storage.openFileForRead("TEST", "/chunked.css", file) || !fromFile.loadFromStream(file)) {
+    std::cerr << "CSS chunked parse: could not parse stylesheet file\n";
+    return false;
+  }
+  file.close();
+  const std::string expected = describe(fromFile);
+
+  for (const size_t chunk : {1, 7, 64, 1024}) {
+    CssParser chunked("/.crosspoint/css_chunked");
+    chunked.beginParse();
+    for (size_t pos = 0; pos < css.size(); pos += chunk) {
+      const size_t size = std::min(chunk, css.size() - pos);
+      if (chunked.write(reinterpret_cast<const uint8_t*>(css.data() + pos), size) != size) {
+        std::cerr << "CSS chunked parse: write of " << chunk << " byte chunks was refused\n";
+        return false;
+      }
+    }
+    chunked.endParse();
+    const std::string actual = describe(chunked);
+    if (actual != expected) {
+      std::cerr << "CSS chunked parse: " << chunk << " byte chunks gave " << actual << ", file gave " << expected
+                << "\n";
+      return false;
+    }
+  }
+  std::cout << "CSS chunked parse: " << fromFile.ruleCount() << " rules match for 1 to 1024 byte chunks\n";
+  return true;
+}
+
+// Malformed chapter markup must still produce sensible events, however it is split across reads
+bool checkTokenizerRecovery() {
+  static const char markup[] =
+      "\xEF\xBB\xBF<?xml version=\"1.0\"?><!DOCTYPE html><HTML><body><!-- note -->"
+      "<P CLASS=intro hidden>Caf&eacute; &amp; b&#233;b&#xE9; &bogus; 5 < 6<br><img src='a.png' alt=\"x &gt; y\">"
+      "<i>unclosed</p></span><![CDATA[<raw>]]><div id=\"q\"/>tail";
+  static const char expected[] =
+      "<html><body><p class=intro hidden=>Café & bébé &bogus; 5 < 6<br></br><img src=a.png alt=x > y></img>"
+      "<i>unclosed</i></p><raw><div id=q></div>tail</body></html>";
+
+  for (size_t chunk = 1; chunk <= sizeof(markup); chunk++) {
+    ParseLog log;
+    log.record = true;
+    tokenize(markup, sizeof(markup) - 1, chunk, log);
+    if (log.events != expected) {
+      std::cout << "Tokenizer recovery mismatch with " << chunk << " byte reads:\n  " << log.events << "\n";
+      return false;
+    }
+  }
+  std::cout << "Tokenizer recovery: malformed markup parsed identically for every read size\n";
+  return true;
+}
+
+struct ParserStats {
+  uint64_t bytes = 0;
+  uint64_t micros = 0;
+  size_t peakHeap = 0;
+  uint64_t textBytes = 0;
+  uint32_t chapters = 0;
+};
+
+// Parses every chapter of the book with both parsers using no-op handlers and 1 KB reads
+bool benchmarkParsers(Epub& epub, ParserStats& expat, ParserStats& tokenizer) {
+  constexpr size_t kReadSize = 1024;
+  for (int spine = 0; spine < epub.getSpineItemsCount(); spine++) {
+    size_t size = 0;
+    uint8_t* data = epub.readItemContentsToBytes(epub.getSpineItem(spine).href, &size, false);
+    if (!data) {
+      return false;
+    }
+    const auto* text = reinterpret_cast<const char*>(data);
+
+    const auto run = [&](ParserStats& stats, const bool useTokenizer) {
+      ParseLog log;
+      const heap::Scope scope;
+      const unsigned long start = micros();
+      const bool ok =
+          useTokenizer ? (tokenize(text, size, kReadSize, log), true) : expatParse(text, size, kReadSize, log);
+      stats.micros += micros() - start;
+      stats.peakHeap = std::max(stats.peakHeap, scope.peakBytes());
+      if (ok) {
+        stats.bytes += size;
+        stats.textBytes += log.textBytes;
+        stats.chapters++;
+      }
+    };
+    run(expat, false);
+    run(tokenizer, true);
+    free(data);
+  }
+  return true;
+}
+
+void printParserStats(const char* name, const ParserStats& stats) {
+  const double mbPerSecond = stats.micros ? static_cast<double>(stats.bytes) / stats.micros : 0.0;
+  std::cout << "  " << name << ": " << stats.chapters << " chapters, " << stats.bytes << " bytes in " << stats.micros
+            << "us (" << mbPerSecond << " MB/s), peak heap " << stats.peakHeap << " bytes, " << stats.textBytes
+            << " text bytes\n";
+}
+
+}  // namespace
+
+int main() {
+  const fs::path sdRoot = "build/epub_parsing/sd";
+  if (!resetSdRoot(sdRoot)) {
+    return 1;
+  }
+  fs::create_directories(sdRoot / "books");
+
+  const bool tokenizerOk = checkTokenizerRecovery();
+  const bool opfOk = checkContentOpfLookup();
+  const bool cssOk = checkCssChunkedParse(sdRoot);
+
+  std::vector<std::string> books;
+  for (const auto& entry : fs::directory_iterator(kBookDir)) {
+    if (entry.path().extension() == ".epub") {
+      fs::copy_file(entry.path(), sdRoot / "books" / entry.path().filename());
+      books.push_back(entry.path().filename().string());
+    }
+  }
+  std::sort(books.begin(), books.end());
+
+  ParserStats expatStats, tokenizerStats;
+  std::ostringstream firstOpenReport;
+  for (const auto& book : books) {
+    auto epub = std::make_shared<Epub>("/books/" + book, "/.crosspoint");
+    auto& writeStats = SDCardManager::getInstance().writeStats;
+    writeStats = {};
+    const auto openStart = std::chrono::steady_clock::now();
+    if (!epub->load()) {
+      std::cerr << "Failed to load " << book << "\n";
+      return 1;
+    }
+    firstOpenReport << "  " << book << ": "
+                    << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - openStart).count()
+                    << " ms, " << writeStats.bytes << " bytes written, " << writeStats.filesCreated
+                    << " files created\n";
+    if (!benchmarkParsers(*epub, expatStats, tokenizerStats)) {
+      std::cerr << "Failed to read chapters of " << book << "\n";
+      return 1;
+    }
+  }
+
+  std::cout << "Chapter parsing (1 KB reads, no-op handlers):\n";
+  printParserStats("expat", expatStats);
+  printParserStats("XhtmlTokenizer", tokenizerStats);
+  std::cout << "First open (book cache build):\n" << firstOpenReport.str();
+  return tokenizerOk && opfOk && cssOk ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// Host implementations of the Arduino core, serial port, input and panel shims in test/host/include.
+
+#include <Arduino.h>
+#include <EInkDisplay.h>
+#include <InputManager.h>
+
+#include <chrono>
+#include <thread>
+
+EspClass ESP;
+HWCDC Serial;
+
+namespace {
+const auto bootTime = std::chrono::steady_clock::now();
+unsigned long long delayedMicros = 0;
+
+unsigned long long elapsedMicros() {
+  const auto now = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(now - bootTime).count() + delayedMicros;
+}
+}  // namespace
+
+unsigned long millis() { return static_cast<unsigned long>(elapsedMicros() / 1000); }
+
+unsigned long micros() { return static_cast<unsigned long>(elapsedMicros()); }
+
+void delay(const unsigned long ms) { delayedMicros += static_cast<unsigned long long>(ms) * 1000; }
+
+void yield() {}
+
+size_t HWCDC::write(const uint8_t b) { return fputc(b, stderr) == EOF ? 0 : 1; }
+
+size_t HWCDC::write(const uint8_t* buffer, const size_t size) { return fwrite(buffer, 1, size, stderr); }
+
+int HWCDC::read() {
+  if (rx.empty()) {
+    return -1;
+  }
+  const int c = static_cast<uint8_t>(rx.front());
+  rx.erase(0, 1);
+  return c;
+}
+
+String HWCDC::readStringUntil(const char terminator) {
+  const auto pos = rx.find(terminator);
+  String line(rx.substr(0, pos));
+  rx.erase(0, pos == std::string::npos ? pos : pos + 1);
+  return line;
+}
+
+void InputManager::update() {
+  previous = current;
+  if (pending && !current) {
+    pressStart = millis();
+  }
+  current = pending;
+}
+
+unsigned long InputManager::getHeldTime() const { return current ? millis() - pressStart : 0; }
+
+void EInkDisplay::drawImage(const uint8_t* imageData, const uint16_t x, const uint16_t y, const uint16_t w,
+                            const uint16_t h, bool) const {
+  // Same contract as the device driver: x and w are byte aligned, rows are packed 1bpp
+  const uint16_t widthBytes = w / 8;
+  const uint16_t xByte = x / 8;
+  for (uint16_t row = 0; row < h && y + row < DISPLAY_HEIGHT; row++) {
+    const uint16_t bytes = std::min<uint16_t>(widthBytes, DISPLAY_WIDTH_BYTES - xByte);
+    memcpy(&frameBuffer[(y + row) * DISPLAY_WIDTH_BYTES + xByte], &imageData[row * widthBytes], bytes);
+  }
+}
+
+void EInkDisplay::displayBuffer(const RefreshMode mode, bool) {
+  memcpy(panelPlane, frameBuffer, BUFFER_SIZE);
+  std::this_thread::sleep_for(std::chrono::milliseconds(refreshLatencyMs[mode]));
+  // The driver reads the frame buffer during the refresh, a change before it is over would tear the page
+  if (memcmp(panelPlane, frameBuffer, BUFFER_SIZE) != 0) {
+    tornRefreshCount++;
+  }
+  bwRefreshCount++;
+}
+
+void EInkDisplay::refreshDisplay(const RefreshMode mode, bool) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(refreshLatencyMs[mode]));
+  bwRefreshCount++;
+}
+
+void EInkDisplay::copyGrayscaleBuffers(const uint8_t* lsbBuffer, const uint8_t* msbBuffer) {
+  copyGrayscaleLsbBuffers(lsbBuffer);
+  copyGrayscaleMsbBuffers(msbBuffer);
+}
+
+void EInkDisplay::displayGrayBuffer(bool) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(grayRefreshLatencyMs));
+  grayRefreshCount++;
+}
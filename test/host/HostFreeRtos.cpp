@@ -0,0 +1,137 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Ring buffer allocated up front, so sending and receiving never allocate (tests count heap use)
+struct HostQueue {
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<uint8_t> storage;
+  size_t length;
+  size_t itemSize;
+  size_t head = 0;
+  size_t count = 0;
+  // Recursive mutexes only: the thread holding it and how often it took it
+  std::thread::id owner;
+  uint32_t depth = 0;
+};
+
+namespace {
+// Waits for ready() under the queue lock, for at most ticks milliseconds
+template <typename Ready>
+bool waitFor(HostQueue* queue, std::unique_lock<std::mutex>& lock, const TickType_t ticks, Ready ready) {
+  if (ticks == portMAX_DELAY) {
+    queue->changed.wait(lock, ready);
+    return true;
+  }
+  return queue->changed.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+}
+}  // namespace
+
+BaseType_t xTaskCreate(const TaskFunction_t function, const char*, uint32_t, void* parameters, UBaseType_t,
+                       TaskHandle_t* createdTask) {
+  std::thread thread(function, parameters);
+  static std::atomic<uintptr_t> nextTask{1};
+  if (createdTask) {
+    *createdTask = reinterpret_cast<TaskHandle_t>(nextTask++);
+  }
+  thread.detach();
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t) {}
+
+void vTaskDelay(const TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
+
+QueueHandle_t xQueueCreate(const UBaseType_t length, const UBaseType_t itemSize) {
+  auto* queue = new HostQueue;
+  queue->length = length;
+  queue->itemSize = itemSize;
+  queue->storage.resize(length * itemSize);
+  return queue;
+}
+
+BaseType_t xQueueSend(const QueueHandle_t queue, const void* item, const TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!waitFor(queue, lock, ticksToWait, [queue] { return queue->count < queue->length; })) {
+    return pdFAIL;
+  }
+  if (queue->itemSize > 0) {
+    const size_t slot = (queue->head + queue->count) % queue->length;
+    memcpy(queue->storage.data() + slot * queue->itemSize, item, queue->itemSize);
+  }
+  queue->count++;
+  queue->changed.notify_all();
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(const QueueHandle_t queue, void* buffer, const TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!waitFor(queue, lock, ticksToWait, [queue] { return queue->count > 0; })) {
+    return pdFAIL;
+  }
+  if (queue->itemSize > 0) {
+    memcpy(buffer, queue->storage.data() + queue->head * queue->itemSize, queue->itemSize);
+  }
+  queue->head = (queue->head + 1) % queue->length;
+  queue->count--;
+  queue->changed.notify_all();
+  return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(const QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  return queue->count;
+}
+
+void vQueueDelete(const QueueHandle_t queue) { delete queue; }
+
+SemaphoreHandle_t xSemaphoreCreateBinary() { return xQueueCreate(1, 0); }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  const SemaphoreHandle_t mutex = xQueueCreate(1, 0);
+  xSemaphoreGive(mutex);
+  return mutex;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return xSemaphoreCreateMutex(); }
+
+BaseType_t xSemaphoreTakeRecursive(const SemaphoreHandle_t mutex, const TickType_t ticksToWait) {
+  {
+    std::lock_guard<std::mutex> lock(mutex->mutex);
+    if (mutex->depth > 0 && mutex->owner == std::this_thread::get_id()) {
+      mutex->depth++;
+      return pdPASS;
+    }
+  }
+  if (xSemaphoreTake(mutex, ticksToWait) != pdPASS) {
+    return pdFAIL;
+  }
+  std::lock_guard<std::mutex> lock(mutex->mutex);
+  mutex->owner = std::this_thread::get_id();
+  mutex->depth = 1;
+  return pdPASS;
+}
+
+BaseType_t xSemaphoreGiveRecursive(const SemaphoreHandle_t mutex) {
+  {
+    std::lock_guard<std::mutex> lock(mutex->mutex);
+    if (mutex->depth == 0 || mutex->owner != std::this_thread::get_id()) {
+      return pdFAIL;
+    }
+    if (--mutex->depth > 0) {
+      return pdPASS;
+    }
+    mutex->owner = std::thread::id();
+  }
+  return xSemaphoreGive(mutex);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+// Fixtures shared by the host harnesses in test/: a fresh SD card root, a scripted serial port and synthetic BMPs.
+
+#include <HalStorage.h>
+#include <SDCardManager.h>
+#include <Stream.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Empties sdRoot and mounts it as the card, so caches are always rebuilt by the code under test
+inline bool resetSdRoot(const std::filesystem::path& sdRoot) {
+  std::filesystem::remove_all(sdRoot);
+  std::filesystem::create_directories(sdRoot);
+  SDCardManager::getInstance().setRoot(sdRoot.string());
+  if (!Storage.begin()) {
+    std::cerr << "Failed to initialise host SD root " << sdRoot << "\n";
+    return false;
+  }
+  return true;
+}
+
+// Serial port of a test script: commands are queued up front, replies collect in tx
+class ScriptedSerial : public Stream {
+ public:
+  std::string rx;
+  std::string tx;
+
+  size_t write(const uint8_t b) override {
+    tx += static_cast<char>(b);
+    return 1;
+  }
+  int available() override { return static_cast<int>(rx.size()); }
+  int read() override {
+    if (rx.empty()) {
+      return -1;
+    }
+    const int c = static_cast<uint8_t>(rx.front());
+    rx.erase(0, 1);
+    return c;
+  }
+};
+
+// Bottom-up BMP like most exporters write, 1-bit black and white, 8-bit grayscale or 24-bit color. The pixels are a
+// diagonal gradient that depends on seed, with some texture so scaling and dithering have detail to work on.
+inline void writeTestBmp(const std::filesystem::path& path, const int width, const int height, const int seed,
+                         const int bpp = 8) {
+  const int rowBytes = (width * bpp + 31) / 32 * 4;
+  const int paletteSize = bpp == 24 ? 0 : 1 << bpp;
+  const uint32_t dataOffset = 14 + 40 + paletteSize * 4;
+  std::string bmp;
+  auto put16 = [&](const uint16_t v) { bmp.append(reinterpret_cast<const char*>(&v), 2); };
+  auto put32 = [&](const uint32_t v) { bmp.append(reinterpret_cast<const char*>(&v), 4); };
+  bmp += "BM";
+  put32(dataOffset + rowBytes * height);
+  put32(0);
+  put32(dataOffset);
+  put32(40);
+  put32(width);
+  put32(height);
+  put16(1);
+  put16(bpp);
+  put32(0);
+  put32(rowBytes * height);
+  put32(2835);
+  put32(2835);
+  put32(paletteSize);
+  put32(0);
+  for (int i = 0; i < paletteSize; i++) {
+    put32(i * 0xFFFFFF / (paletteSize - 1));
+  }
+  for (int y = height - 1; y >= 0; y--) {
+    std::string row(rowBytes, '\0');
+    for (int x = 0; x < width; x++) {
+      const int gray = ((x + y + seed * 37) * 255 / (width + height) + ((x / 7 + y / 5) % 3) * 24) & 0xFF;
+      if (bpp == 1) {
+        row[x / 8] |= static_cast<char>(gray > 127 ? 0x80 >> (x % 8) : 0);
+      } else if (bpp == 8) {
+        row[x] = static_cast<char>(gray);
+      } else {
+        row[x * 3] = static_cast<char>(gray);
+        row[x * 3 + 1] = static_cast<char>(255 - gray);
+        row[x * 3 + 2] = static_cast<char>((gray + x) & 0xFF);
+      }
+    }
+    bmp += row;
+  }
+  std::ofstream(path, std::ios::binary) << bmp;
+}
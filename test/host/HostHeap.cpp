@@ -0,0 +1,57 @@
+#include "HostHeap.h"
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace heap {
+size_t live = 0;
+size_t peak = 0;
+
+namespace {
+void add(void* p) {
+  if (p) {
+    live += malloc_usable_size(p);
+    peak = std::max(peak, live);
+  }
+}
+
+void remove(void* p) {
+  if (p) {
+    live -= malloc_usable_size(p);
+  }
+}
+}  // namespace
+
+void* countedMalloc(const size_t size) {
+  void* p = malloc(size);
+  add(p);
+  return p;
+}
+
+void* countedRealloc(void* old, const size_t size) {
+  remove(old);
+  void* p = realloc(old, size);
+  add(p ? p : old);
+  return p;
+}
+
+void countedFree(void* p) {
+  remove(p);
+  free(p);
+}
+}  // namespace heap
+
+void* operator new(const size_t size) {
+  if (void* p = heap::countedMalloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void* operator new[](const size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { heap::countedFree(p); }
+void operator delete[](void* p) noexcept { heap::countedFree(p); }
+void operator delete(void* p, size_t) noexcept { heap::countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { heap::countedFree(p); }
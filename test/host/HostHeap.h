@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+// Live heap accounting for the harnesses that report peak heap. Linking HostHeap.cpp routes every C++ allocation
+// through these counters; C libraries such as expat can be given the same functions through their allocator hooks.
+namespace heap {
+extern size_t live;
+extern size_t peak;
+
+void* countedMalloc(size_t size);
+void* countedRealloc(void* old, size_t size);
+void countedFree(void* p);
+
+// Peak bytes allocated on top of what was live when the scope started
+struct Scope {
+  size_t base = live;
+  Scope() { peak = live; }
+  size_t peakBytes() const { return peak - base; }
+};
+}  // namespace heap
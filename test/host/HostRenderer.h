@@ -0,0 +1,73 @@
+#pragma once
+
+// Renderer fixture of the host harnesses: an in-memory panel with Bookerly 14 loaded, plus frame buffer hashing and
+// the reader settings the EPUB pipeline is laid out with.
+
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <builtinFonts/bookerly_14_bold.h>
+#include <builtinFonts/bookerly_14_bolditalic.h>
+#include <builtinFonts/bookerly_14_italic.h>
+#include <builtinFonts/bookerly_14_regular.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "src/fontIds.h"
+
+// Mirrors the CrossPointSettings defaults used by EpubReaderActivity
+inline constexpr int kScreenMargin = 5;
+inline constexpr float kLineCompression = 1.0f;
+inline constexpr bool kExtraParagraphSpacing = true;
+inline constexpr uint8_t kParagraphAlignment = 0;  // JUSTIFIED
+inline constexpr bool kHyphenation = false;
+inline constexpr bool kEmbeddedStyle = true;
+
+struct OrientationCase {
+  GfxRenderer::Orientation orientation;
+  const char* name;
+};
+
+inline constexpr OrientationCase kOrientations[] = {
+    {GfxRenderer::Portrait, "portrait"},
+    {GfxRenderer::LandscapeClockwise, "landscape_cw"},
+    {GfxRenderer::PortraitInverted, "portrait_inverted"},
+    {GfxRenderer::LandscapeCounterClockwise, "landscape_ccw"},
+};
+
+inline uint64_t fnv1a(const uint8_t* data, const size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+inline std::string toHex(const uint64_t value) {
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(value));
+  return buf;
+}
+
+// Hash of the whole frame buffer; equal hashes mean equal frames
+inline std::string frameHash(const GfxRenderer& renderer) {
+  return toHex(fnv1a(renderer.getFrameBuffer(), GfxRenderer::getBufferSize()));
+}
+
+// Display and renderer brought up like in setup(), with BOOKERLY_14_FONT_ID registered
+struct HostRenderer {
+  HalDisplay display;
+  GfxRenderer renderer{display};
+  EpdFont regular{&bookerly_14_regular};
+  EpdFont bold{&bookerly_14_bold};
+  EpdFont italic{&bookerly_14_italic};
+  EpdFont boldItalic{&bookerly_14_bolditalic};
+
+  HostRenderer() {
+    display.begin();
+    renderer.begin();
+    renderer.insertFont(BOOKERLY_14_FONT_ID, EpdFontFamily(&regular, &bold, &italic, &boldItalic));
+  }
+};
@@ -0,0 +1,373 @@
+// Host implementation of FsFile and SDCardManager on top of stdio and <filesystem>.
+
+#include <Logging.h>
+#include <SDCardManager.h>
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+struct FsFile::Handle {
+  FILE* fp = nullptr;
+  std::string path;
+  bool directory = false;
+  fs::directory_iterator dirIt;
+
+  ~Handle() {
+    if (fp) {
+      fclose(fp);
+    }
+  }
+};
+
+bool FsFile::open(const char* hostPath, const oflag_t oflag) {
+  close();
+  auto h = std::make_shared<Handle>();
+  h->path = hostPath;
+  std::error_code ec;
+  if (fs::is_directory(hostPath, ec)) {
+    h->directory = true;
+    h->dirIt = fs::directory_iterator(hostPath, ec);
+    handle = h;
+    return true;
+  }
+
+  const int access = oflag & O_ACCMODE;
+  const bool exists = fs::exists(hostPath, ec);
+  if (!exists && !(oflag & O_CREAT)) {
+    return false;
+  }
+  const char* mode = "rb";
+  if (access != O_RDONLY) {
+    if (oflag & O_TRUNC || !exists) {
+      mode = access == O_WRONLY ? "wb" : "w+b";
+    } else {
+      mode = "r+b";
+    }
+  }
+  h->fp = fopen(hostPath, mode);
+  if (!h->fp) {
+    return false;
+  }
+  if (!exists) {
+    SDCardManager::getInstance().writeStats.filesCreated++;
+  }
+  if (oflag & O_APPEND) {
+    fseek(h->fp, 0, SEEK_END);
+  }
+  handle = h;
+  return true;
+}
+
+bool FsFile::close() {
+  handle.reset();
+  return true;
+}
+
+bool FsFile::isOpen() const { return handle && (handle->fp || handle->directory); }
+
+bool FsFile::isDirectory() const { return handle && handle->directory; }
+
+int FsFile::read(void* buf, const size_t count) {
+  if (!handle || !handle->fp) {
+    return -1;
+  }
+  return static_cast<int>(fread(buf, 1, count, handle->fp));
+}
+
+int FsFile::read() {
+  uint8_t b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+int FsFile::peek() {
+  if (!handle || !handle->fp) {
+    return -1;
+  }
+  const int c = fgetc(handle->fp);
+  if (c != EOF) {
+    ungetc(c, handle->fp);
+  }
+  return c == EOF ? -1 : c;
+}
+
+int FsFile::available() {
+  if (!handle || !handle->fp) {
+    return 0;
+  }
+  return static_cast<int>(size() - position());
+}
+
+size_t FsFile::write(const uint8_t b) { return write(&b, 1); }
+
+size_t FsFile::write(const uint8_t* buffer, const size_t size) {
+  if (!handle || !handle->fp) {
+    return 0;
+  }
+  const size_t written = fwrite(buffer, 1, size, handle->fp);
+  SDCardManager::getInstance().writeStats.bytes += written;
+  return written;
+}
+
+void FsFile::flush() {
+  if (handle && handle->fp) {
+    fflush(handle->fp);
+  }
+}
+
+bool FsFile::seek(const uint64_t pos) {
+  return handle && handle->fp && fseeko(handle->fp, static_cast<off_t>(pos), SEEK_SET) == 0;
+}
+
+bool FsFile::seekCur(const int64_t offset) {
+  return handle && handle->fp && fseeko(handle->fp, static_cast<off_t>(offset), SEEK_CUR) == 0;
+}
+
+bool FsFile::seekEnd(const int64_t offset) {
+  return handle && handle->fp && fseeko(handle->fp, static_cast<off_t>(offset), SEEK_END) == 0;
+}
+
+uint64_t FsFile::position() const {
+  if (!handle || !handle->fp) {
+    return 0;
+  }
+  return static_cast<uint64_t>(ftello(handle->fp));
+}
+
+uint64_t FsFile::size() const {
+  if (!handle || !handle->fp) {
+    return 0;
+  }
+  fflush(handle->fp);
+  std::error_code ec;
+  const auto s = fs::file_size(handle->path, ec);
+  return ec ? 0 : s;
+}
+
+bool FsFile::truncate(const uint64_t length) {
+  if (!handle || !handle->fp) {
+    return false;
+  }
+  fflush(handle->fp);
+  std::error_code ec;
+  fs::resize_file(handle->path, length, ec);
+  return !ec;
+}
+
+FsFile FsFile::openNextFile(const oflag_t oflag) {
+  FsFile next;
+  if (!handle || !handle->directory) {
+    return next;
+  }
+  std::error_code ec;
+  if (handle->dirIt != fs::directory_iterator()) {
+    const std::string p = handle->dirIt->path().string();
+    handle->dirIt.increment(ec);
+    next.open(p.c_str(), oflag);
+  }
+  return next;
+}
+
+void FsFile::rewindDirectory() {
+  if (handle && handle->directory) {
+    std::error_code ec;
+    handle->dirIt = fs::directory_iterator(handle->path, ec);
+  }
+}
+
+bool FsFile::getModifyDateTime(uint16_t* pdate, uint16_t* ptime) {
+  if (!handle) {
+    return false;
+  }
+  std::error_code ec;
+  const auto written = fs::last_write_time(handle->path, ec);
+  if (ec) {
+    return false;
+  }
+  const auto seconds = std::chrono::time_point_cast<std::chrono::seconds>(
+      std::chrono::file_clock::to_sys(written));
+  const std::time_t t = std::chrono::system_clock::to_time_t(seconds);
+  std::tm tm{};
+  gmtime_r(&t, &tm);
+  *pdate = static_cast<uint16_t>((std::max(tm.tm_year - 80, 0) << 9) | ((tm.tm_mon + 1) << 5) | tm.tm_mday);
+  *ptime = static_cast<uint16_t>((tm.tm_hour << 11) | (tm.tm_min << 5) | (tm.tm_sec / 2));
+  return true;
+}
+
+size_t FsFile::getName(char* name, const size_t len) const {
+  if (!handle || len == 0) {
+    return 0;
+  }
+  const std::string base = fs::path(handle->path).filename().string();
+  const size_t n = std::min(base.size(), len - 1);
+  memcpy(name, base.data(), n);
+  name[n] = '\0';
+  return n;
+}
+
+bool FsFile::rename(const char* newPath) {
+  if (!handle) {
+    return false;
+  }
+  // newPath is a card path; resolve it the same way SDCardManager does
+  const std::string target = SDCardManager::getInstance().hostPath(newPath);
+  std::error_code ec;
+  fs::rename(handle->path, target, ec);
+  if (ec) {
+    return false;
+  }
+  handle->path = target;
+  return true;
+}
+
+SDCardManager& SDCardManager::getInstance() {
+  static SDCardManager instance;
+  return instance;
+}
+
+std::string SDCardManager::hostPath(const char* path) const {
+  std::string p = path ? path : "";
+  if (p.empty() || p[0] != '/') {
+    p = "/" + p;
+  }
+  return root + p;
+}
+
+bool SDCardManager::begin() {
+  std::error_code ec;
+  initialized = fs::is_directory(root, ec);
+  return initialized;
+}
+
+std::vector<String> SDCardManager::listFiles(const char* path, const int maxFiles) {
+  std::vector<String> result;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(hostPath(path), ec)) {
+    if (static_cast<int>(result.size()) >= maxFiles) {
+      break;
+    }
+    if (entry.is_regular_file()) {
+      result.emplace_back(entry.path().filename().string());
+    }
+  }
+  return result;
+}
+
+String SDCardManager::readFile(const char* path) {
+  FsFile f;
+  if (!f.open(hostPath(path).c_str(), O_RDONLY)) {
+    return String();
+  }
+  String content;
+  char buf[512];
+  int n;
+  while ((n = f.read(buf, sizeof(buf))) > 0) {
+    content.append(buf, n);
+  }
+  return content;
+}
+
+bool SDCardManager::readFileToStream(const char* path, Print& out, const size_t chunkSize) {
+  FsFile f;
+  if (!f.open(hostPath(path).c_str(), O_RDONLY)) {
+    return false;
+  }
+  std::vector<uint8_t> buf(chunkSize ? chunkSize : 256);
+  int n;
+  while ((n = f.read(buf.data(), buf.size())) > 0) {
+    out.write(buf.data(), n);
+  }
+  return true;
+}
+
+size_t SDCardManager::readFileToBuffer(const char* path, char* buffer, const size_t bufferSize,
+                                       const size_t maxBytes) {
+  if (!buffer || bufferSize == 0) {
+    return 0;
+  }
+  FsFile f;
+  if (!f.open(hostPath(path).c_str(), O_RDONLY)) {
+    buffer[0] = '\0';
+    return 0;
+  }
+  size_t limit = bufferSize - 1;
+  if (maxBytes > 0 && maxBytes < limit) {
+    limit = maxBytes;
+  }
+  const int n = f.read(buffer, limit);
+  const size_t len = n > 0 ? n : 0;
+  buffer[len] = '\0';
+  return len;
+}
+
+bool SDCardManager::writeFile(const char* path, const String& content) {
+  FsFile f;
+  if (!f.open(hostPath(path).c_str(), O_RDWR | O_CREAT | O_TRUNC)) {
+    return false;
+  }
+  return f.write(reinterpret_cast<const uint8_t*>(content.data()), content.size()) == content.size();
+}
+
+bool SDCardManager::ensureDirectoryExists(const char* path) { return mkdir(path, true); }
+
+FsFile SDCardManager::open(const char* path, const oflag_t oflag) {
+  FsFile f;
+  f.open(hostPath(path).c_str(), oflag);
+  return f;
+}
+
+bool SDCardManager::mkdir(const char* path, const bool pFlag) {
+  std::error_code ec;
+  const std::string p = hostPath(path);
+  if (fs::is_directory(p, ec)) {
+    return true;
+  }
+  return pFlag ? fs::create_directories(p, ec) : fs::create_directory(p, ec);
+}
+
+bool SDCardManager::exists(const char* path) {
+  std::error_code ec;
+  return fs::exists(hostPath(path), ec);
+}
+
+bool SDCardManager::remove(const char* path) {
+  std::error_code ec;
+  const std::string p = hostPath(path);
+  return fs::is_regular_file(p, ec) && fs::remove(p, ec);
+}
+
+bool SDCardManager::rmdir(const char* path) {
+  std::error_code ec;
+  const std::string p = hostPath(path);
+  return fs::is_directory(p, ec) && fs::remove(p, ec);
+}
+
+bool SDCardManager::openFileForRead(const char* moduleName, const char* path, FsFile& file) {
+  if (!exists(path)) {
+    LOG_ERR(moduleName, "File does not exist: %s", path);
+    return false;
+  }
+  if (!file.open(hostPath(path).c_str(), O_RDONLY)) {
+    LOG_ERR(moduleName, "Failed to open file for reading: %s", path);
+    return false;
+  }
+  return true;
+}
+
+bool SDCardManager::openFileForWrite(const char* moduleName, const char* path, FsFile& file) {
+  if (!file.open(hostPath(path).c_str(), O_RDWR | O_CREAT | O_TRUNC)) {
+    LOG_ERR(moduleName, "Failed to open file for writing: %s", path);
+    return false;
+  }
+  return true;
+}
+
+bool SDCardManager::removeDir(const char* path) {
+  std::error_code ec;
+  fs::remove_all(hostPath(path), ec);
+  return !ec;
+}
@@ -0,0 +1,61 @@
+# Sourced by the test/run_*.sh scripts of the host harnesses. build_host_harness compiles a harness and the lib/src
+# sources it tests against the shims in test/host, with the defines of the firmware build.
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+
+# Arduino core, SD card and logging shims every harness links
+HOST_SOURCES=(
+  "$ROOT_DIR/test/host/HostArduino.cpp"
+  "$ROOT_DIR/test/host/HostFreeRtos.cpp"
+  "$ROOT_DIR/test/host/HostSdCard.cpp"
+  "$ROOT_DIR/lib/Logging/Logging.cpp"
+  "$ROOT_DIR/lib/hal/HalSpiBus.cpp"
+  "$ROOT_DIR/lib/hal/HalStorage.cpp"
+)
+
+DEFINES=(
+  -DENABLE_SERIAL_LOG
+  -DLOG_LEVEL="${LOG_LEVEL:-0}"
+  -DCROSSPOINT_EMULATED=0
+  -DGFX_DRAW_PIXEL_STATS
+  -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1
+  -DMINIZ_NO_STDIO=1
+  -DXML_GE=0
+  -DXML_CONTEXT_BYTES=1024
+  -DPNG_MAX_BUFFERED_PIXELS=6402
+)
+
+INCLUDES=(
+  -I"$ROOT_DIR"
+  -I"$ROOT_DIR/test/host/include"
+  -I"$ROOT_DIR/lib"
+)
+for dir in "$ROOT_DIR"/lib/*/; do
+  INCLUDES+=(-I"$dir")
+done
+INCLUDES+=(-I"$ROOT_DIR/lib/Epub/Epub" -I"$ROOT_DIR/src")
+
+# build_host_harness <name> <binary> <sources...>
+# Builds build/<name>/<binary> from the given .c and .cpp files plus HOST_SOURCES, and sets BUILD_DIR and BINARY
+build_host_harness() {
+  local name="$1" binary="$2"
+  shift 2
+  BUILD_DIR="$ROOT_DIR/build/$name"
+  BINARY="$BUILD_DIR/$binary"
+  mkdir -p "$BUILD_DIR/obj"
+
+  local cxxSources=() objects=()
+  for src in "$@"; do
+    if [[ "$src" == *.c ]]; then
+      local obj="$BUILD_DIR/obj/$(basename "$src").o"
+      cc -O2 "${DEFINES[@]}" "${INCLUDES[@]}" -c "$src" -o "$obj"
+      objects+=("$obj")
+    else
+      cxxSources+=("$src")
+    fi
+  done
+
+  # The ESP32 toolchain headers leak <cstdint> types into every translation unit; a few lib headers rely on that
+  c++ -std=c++20 ${EXTRA_CXXFLAGS:-} -O2 -Wall -Wextra -include cstdint "${DEFINES[@]}" "${INCLUDES[@]}" \
+    "${cxxSources[@]}" "${HOST_SOURCES[@]}" "${objects[@]}" -pthread -o "$BINARY"
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Minimal Arduino core surface used by the firmware libraries, so they can be compiled into host-side test and
+// benchmark binaries. Only what lib/ actually touches is provided here.
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "HardwareSerial.h"
+#include "Print.h"
+#include "Stream.h"
+#include "WString.h"
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t*>(addr))
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+using std::max;
+using std::min;
+
+// millis()/micros() advance with wall time plus every delay() issued so far. delay() itself does not sleep, so
+// SD "settle" delays in the firmware do not distort host benchmarks but timeouts still expire.
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+class EspClass {
+ public:
+  uint32_t getFreeHeap() const { return freeHeap; }
+  uint32_t getHeapSize() const { return 320 * 1024; }
+  uint32_t getMinFreeHeap() const { return freeHeap; }
+  uint32_t getMaxAllocHeap() const { return freeHeap; }
+  // Tests can lower this to exercise the low-memory paths
+  uint32_t freeHeap = 200 * 1024;
+};
+
+extern EspClass ESP;
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+class BatteryMonitor {
+ public:
+  explicit BatteryMonitor(uint8_t) {}
+  int readPercentage() const { return 100; }
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// Host panel: keeps the frame buffer and the two grayscale planes in RAM and counts refreshes instead of driving
+// the SSD1677. Refreshes complete immediately unless a latency is set with setRefreshLatency().
+class EInkDisplay {
+ public:
+  static constexpr uint16_t DISPLAY_WIDTH = 800;
+  static constexpr uint16_t DISPLAY_HEIGHT = 480;
+  static constexpr uint16_t DISPLAY_WIDTH_BYTES = DISPLAY_WIDTH / 8;
+  static constexpr uint32_t BUFFER_SIZE = DISPLAY_WIDTH_BYTES * DISPLAY_HEIGHT;
+
+  enum RefreshMode { FULL_REFRESH, HALF_REFRESH, FAST_REFRESH };
+
+  EInkDisplay(int8_t, int8_t, int8_t, int8_t, int8_t, int8_t) {}
+
+  void begin() { memset(frameBuffer, 0xFF, BUFFER_SIZE); }
+  void clearScreen(const uint8_t color = 0xFF) const { memset(frameBuffer, color, BUFFER_SIZE); }
+  void drawImage(const uint8_t* imageData, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                 bool fromProgmem = false) const;
+  void displayBuffer(RefreshMode mode = FAST_REFRESH, bool turnOffScreen = false);
+  void refreshDisplay(RefreshMode mode = FAST_REFRESH, bool turnOffScreen = false);
+  void deepSleep() {}
+  uint8_t* getFrameBuffer() const { return frameBuffer; }
+
+  void copyGrayscaleBuffers(const uint8_t* lsbBuffer, const uint8_t* msbBuffer);
+  void copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer) { memcpy(lsbPlane, lsbBuffer, BUFFER_SIZE); }
+  void copyGrayscaleMsbBuffers(const uint8_t* msbBuffer) { memcpy(msbPlane, msbBuffer, BUFFER_SIZE); }
+  void cleanupGrayscaleBuffers(const uint8_t* bwBuffer) { memcpy(panelPlane, bwBuffer, BUFFER_SIZE); }
+  void displayGrayBuffer(bool turnOffScreen = false);
+
+  // Host only: what the panel currently shows, and how often it was refreshed.
+  const uint8_t* getPanelPlane() const { return panelPlane; }
+  const uint8_t* getLsbPlane() const { return lsbPlane; }
+  const uint8_t* getMsbPlane() const { return msbPlane; }
+  uint32_t bwRefreshCount = 0;
+  uint32_t grayRefreshCount = 0;
+
+  // Host only: make every BW refresh in mode (and every grayscale refresh) block for ms, like a real waveform
+  static void setRefreshLatency(const RefreshMode mode, const uint32_t ms) { refreshLatencyMs[mode] = ms; }
+  static void setGrayRefreshLatency(const uint32_t ms) { grayRefreshLatencyMs = ms; }
+  // Host only: BW refreshes whose frame buffer was drawn into before the waveform was over
+  static inline uint32_t tornRefreshCount = 0;
+
+ private:
+  static inline uint32_t refreshLatencyMs[3] = {};
+  static inline uint32_t grayRefreshLatencyMs = 0;
+
+  mutable uint8_t frameBuffer[BUFFER_SIZE] = {};
+  uint8_t panelPlane[BUFFER_SIZE] = {};
+  uint8_t lsbPlane[BUFFER_SIZE] = {};
+  uint8_t msbPlane[BUFFER_SIZE] = {};
+};
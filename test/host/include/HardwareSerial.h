@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+
+#include "Stream.h"
+#include "WString.h"
+
+unsigned long millis();
+
+// Host serial port: output goes to stderr, input can be queued by tests through feed().
+class HWCDC : public Stream {
+  std::string rx;
+
+ public:
+  void begin(unsigned long) {}
+  operator bool() const { return true; }
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override { return static_cast<int>(rx.size()); }
+  int read() override;
+  int peek() override { return rx.empty() ? -1 : static_cast<uint8_t>(rx.front()); }
+  String readStringUntil(char terminator);
+
+  void feed(const std::string& data) { rx += data; }
+};
+
+extern HWCDC Serial;
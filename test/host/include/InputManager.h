@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// Host input: buttons are driven by tests through press()/release() and latched until the next update().
+class InputManager {
+  uint8_t current = 0;
+  uint8_t previous = 0;
+  uint8_t pending = 0;
+  unsigned long pressStart = 0;
+
+ public:
+  static constexpr uint8_t POWER_BUTTON_PIN = 3;
+
+  void begin() {}
+  void update();
+  bool isPressed(uint8_t index) const { return current & (1 << index); }
+  bool wasPressed(uint8_t index) const { return (current & ~previous) & (1 << index); }
+  bool wasAnyPressed() const { return current & ~previous; }
+  bool wasReleased(uint8_t index) const { return (previous & ~current) & (1 << index); }
+  bool wasAnyReleased() const { return previous & ~current; }
+  unsigned long getHeldTime() const;
+
+  void press(uint8_t index) { pending |= 1 << index; }
+  void release(uint8_t index) { pending &= ~(1 << index); }
+};
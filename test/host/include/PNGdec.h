@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+// PNGdec is a PlatformIO dependency and is not vendored in this tree. On the host every open fails, so PNG images
+// take the same fallback path as an undecodable image on the device (alt text or nothing).
+
+enum { PNG_SUCCESS = 0, PNG_INVALID_FILE = 2, PNG_UNSUPPORTED_FEATURE = 6 };
+enum { PNG_PIXEL_GRAYSCALE = 0, PNG_PIXEL_TRUECOLOR = 2, PNG_PIXEL_INDEXED = 3, PNG_PIXEL_GRAY_ALPHA = 4,
+       PNG_PIXEL_TRUECOLOR_ALPHA = 6 };
+
+struct PNGFILE {
+  void* fHandle;
+  int32_t iPos;
+  int32_t iSize;
+};
+
+struct PNGDRAW {
+  int y;
+  int iWidth;
+  int iPixelType;
+  int iHasAlpha;
+  uint8_t* pPixels;
+  uint8_t* pPalette;
+  void* pUser;
+};
+
+typedef void* (*PNG_OPEN_CALLBACK)(const char* filename, int32_t* size);
+typedef void (*PNG_CLOSE_CALLBACK)(void* handle);
+typedef int32_t (*PNG_READ_CALLBACK)(PNGFILE* pFile, uint8_t* pBuf, int32_t len);
+typedef int32_t (*PNG_SEEK_CALLBACK)(PNGFILE* pFile, int32_t pos);
+typedef int (*PNG_DRAW_CALLBACK)(PNGDRAW* pDraw);
+
+class PNG {
+ public:
+  int open(const char*, PNG_OPEN_CALLBACK, PNG_CLOSE_CALLBACK, PNG_READ_CALLBACK, PNG_SEEK_CALLBACK,
+           PNG_DRAW_CALLBACK) {
+    return PNG_INVALID_FILE;
+  }
+  int decode(void*, int) { return PNG_INVALID_FILE; }
+  void close() {}
+  int getWidth() const { return 0; }
+  int getHeight() const { return 0; }
+  int getBpp() const { return 0; }
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SdFat.h>
+
+#include <string>
+#include <vector>
+
+#include "WString.h"
+
+// Host SD card: every absolute card path is resolved below a root directory on the host file system.
+class SDCardManager {
+  std::string root = ".";
+  bool initialized = false;
+
+ public:
+  // Host only: write traffic through FsFile, so first-open SD churn can be measured
+  struct WriteStats {
+    uint64_t bytes = 0;
+    uint32_t filesCreated = 0;
+  };
+  WriteStats writeStats;
+
+  static SDCardManager& getInstance();
+
+  // Host only: choose the directory that stands in for the card root. Must exist.
+  void setRoot(const std::string& hostDirectory) { root = hostDirectory; }
+  const std::string& getRoot() const { return root; }
+  std::string hostPath(const char* path) const;
+
+  bool begin();
+  bool ready() const { return initialized; }
+  std::vector<String> listFiles(const char* path, int maxFiles);
+  String readFile(const char* path);
+  bool readFileToStream(const char* path, Print& out, size_t chunkSize);
+  size_t readFileToBuffer(const char* path, char* buffer, size_t bufferSize, size_t maxBytes);
+  bool writeFile(const char* path, const String& content);
+  bool ensureDirectoryExists(const char* path);
+
+  FsFile open(const char* path, oflag_t oflag = O_RDONLY);
+  bool mkdir(const char* path, bool pFlag = true);
+  bool exists(const char* path);
+  bool remove(const char* path);
+  bool rmdir(const char* path);
+  bool openFileForRead(const char* moduleName, const char* path, FsFile& file);
+  bool openFileForWrite(const char* moduleName, const char* path, FsFile& file);
+  bool removeDir(const char* path);
+};
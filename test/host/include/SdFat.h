@@ -0,0 +1,53 @@
+#pragma once
+
+#include <fcntl.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Arduino.h"
+
+typedef int oflag_t;
+
+// FsFile backed by a host file or directory. Copies share the same underlying handle, like SdFat's FsFile copies
+// refer to the same open file.
+class FsFile : public Stream {
+  struct Handle;
+  std::shared_ptr<Handle> handle;
+
+ public:
+  FsFile() = default;
+
+  bool open(const char* hostPath, oflag_t oflag = O_RDONLY);
+  bool close();
+  bool isOpen() const;
+  operator bool() const { return isOpen(); }
+  bool isDirectory() const;
+
+  int read(void* buf, size_t count);
+  int read() override;
+  int peek() override;
+  int available() override;
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  size_t write(const void* buffer, size_t size) { return write(static_cast<const uint8_t*>(buffer), size); }
+  void flush() override;
+
+  bool seek(uint64_t pos);
+  bool seekSet(uint64_t pos) { return seek(pos); }
+  bool seekCur(int64_t offset);
+  bool seekEnd(int64_t offset = 0);
+  uint64_t position() const;
+  uint64_t curPosition() const { return position(); }
+  uint64_t size() const;
+  uint64_t fileSize() const { return size(); }
+  bool truncate(uint64_t length);
+
+  FsFile openNextFile(oflag_t oflag = O_RDONLY);
+  void rewindDirectory();
+  size_t getName(char* name, size_t len) const;
+  // FAT encoded last write date and time, as SdFat reports them
+  bool getModifyDateTime(uint16_t* pdate, uint16_t* ptime);
+  bool rename(const char* newPath);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+// Arduino String backed by std::string. Only the members used by lib/ and the HAL headers are provided.
+class String : public std::string {
+ public:
+  String() = default;
+  String(const char* s) : std::string(s ? s : "") {}
+  String(const std::string& s) : std::string(s) {}
+  explicit String(int v) : std::string(std::to_string(v)) {}
+  explicit String(unsigned v) : std::string(std::to_string(v)) {}
+  explicit String(long v) : std::string(std::to_string(v)) {}
+  explicit String(unsigned long v) : std::string(std::to_string(v)) {}
+
+  unsigned int length() const { return static_cast<unsigned int>(size()); }
+  bool startsWith(const String& prefix) const { return compare(0, prefix.size(), prefix) == 0; }
+  bool endsWith(const String& suffix) const {
+    return size() >= suffix.size() && compare(size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+  String substring(size_t from) const { return from < size() ? String(substr(from)) : String(); }
+  String substring(size_t from, size_t to) const {
+    return from < size() && to > from ? String(substr(from, to - from)) : String();
+  }
+  int indexOf(char c) const {
+    const auto pos = find(c);
+    return pos == npos ? -1 : static_cast<int>(pos);
+  }
+  int toInt() const { return atoi(c_str()); }
+  void toLowerCase() {
+    for (auto& c : *this) {
+      c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+  }
+  void trim() {
+    const auto first = find_first_not_of(" \t\r\n");
+    if (first == npos) {
+      clear();
+      return;
+    }
+    const auto last = find_last_not_of(" \t\r\n");
+    assign(substr(first, last - first + 1));
+  }
+};
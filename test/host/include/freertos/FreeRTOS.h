@@ -0,0 +1,28 @@
+#pragma once
+
+// Host stand-in for the FreeRTOS subset used by the firmware: tasks are detached std::threads and queues/semaphores
+// are mutex + condition variable backed. Ticks are milliseconds.
+
+#include <cstdint>
+#include <mutex>
+
+using BaseType_t = int;
+using UBaseType_t = unsigned int;
+using TickType_t = uint32_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY 0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms) static_cast<TickType_t>(ms)
+#define tskIDLE_PRIORITY 0
+
+// Critical sections only need mutual exclusion between host threads
+struct portMUX_TYPE {
+  std::mutex mutex;
+};
+#define portMUX_INITIALIZER_UNLOCKED \
+  {}
+#define portENTER_CRITICAL(mux) (mux)->mutex.lock()
+#define portEXIT_CRITICAL(mux) (mux)->mutex.unlock()
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "queue.h"
+
+using SemaphoreHandle_t = QueueHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticksToWait);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex);
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) { return xQueueSend(semaphore, nullptr, 0); }
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, const TickType_t ticksToWait) {
+  return xQueueReceive(semaphore, nullptr, ticksToWait);
+}
+inline void vSemaphoreDelete(SemaphoreHandle_t semaphore) { vQueueDelete(semaphore); }
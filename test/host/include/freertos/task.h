@@ -0,0 +1,12 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+using TaskHandle_t = void*;
+using TaskFunction_t = void (*)(void*);
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* createdTask);
+// Only vTaskDelete(nullptr) from inside a task is supported; on the host it returns and the task function ends
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
@@ -0,0 +1,110 @@
+// Host harness for hyphenation pattern packs on the SD card: a pack generated from the built-in English trie must
+// hyphenate exactly like it, and the trie walk is timed with and without dispatch tables.
+
+#include <Epub/hyphenation/HyphenationCommon.h>
+#include <Epub/hyphenation/HyphenationPack.h>
+#include <Epub/hyphenation/Hyphenator.h>
+#include <Epub/hyphenation/LanguageRegistry.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "test/host/HostHarness.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// A pattern pack written by generate_hyphenation_trie.py from the built-in English trie (run_hyphenation_pack.sh
+// does that) must hyphenate exactly like the built-in patterns, through the dispatch tables and through Hyphenator
+// for a language that is only on the card. Also times the trie walk with and without dispatch tables.
+bool checkHyphenationPack(const fs::path& buildDir, const fs::path& sdRoot) {
+  const fs::path packFile = buildDir / "hyphenation" / "en.hyph";
+  if (!fs::exists(packFile)) {
+    std::cout << "Hyphenation pack: " << packFile << " missing, run through test/run_hyphenation_pack.sh\n";
+    return false;
+  }
+  fs::create_directories(sdRoot / "hyphenation");
+  fs::copy_file(packFile, sdRoot / "hyphenation" / "xx.hyph", fs::copy_options::overwrite_existing);
+
+  HyphenationPack pack;
+  const LanguageHyphenator* english = getLanguageHyphenatorForPrimaryTag("en");
+  const LanguageHyphenator* german = getLanguageHyphenatorForPrimaryTag("de");
+  if (!pack.load(HyphenationPack::pathFor("xx")) || !english || !german || pack.dispatchTables().empty()) {
+    std::cout << "Hyphenation pack: failed to load\n";
+    return false;
+  }
+
+  // The generator and buildLiangDispatchTables must pick the same nodes
+  const auto englishTables = buildLiangDispatchTables(english->patterns(), pack.dispatchTables().size() - 1);
+  bool tablesMatch = englishTables.size() == pack.dispatchTables().size();
+  for (size_t i = 0; tablesMatch && i < englishTables.size(); i++) {
+    tablesMatch = memcmp(&englishTables[i], &pack.dispatchTables()[i], sizeof(LiangDispatchTable)) == 0;
+  }
+
+  static const char* const englishWords[] = {
+      "hyphenation",    "characteristically", "internationalization", "responsibility", "extraordinary",
+      "unbelievable",   "photographic",       "incomprehensibilities", "representation", "encyclopedia",
+      "organization",   "mathematical",       "environmental",        "communication",  "independently",
+      "understanding",  "thermodynamics",     "electromagnetic",      "misunderstanding", "transformation"};
+  static const char* const germanWords[] = {
+      "Donaudampfschifffahrt",    "Rechtsschutzversicherung", "Geschwindigkeitsbegrenzung",
+      "Bundesverfassungsgericht", "Lebensversicherung",       "Kraftfahrzeughaftpflicht",
+      "Silbentrennung",           "Wahrscheinlichkeit",       "Unabh\xC3\xA4ngigkeitserkl\xC3\xA4rung",
+      "Freundschaftsbeziehungen"};
+
+  bool breaksMatch = true;
+  size_t breaks = 0;
+  Hyphenator::setPreferredLanguage("xx-TEST");
+  for (const char* word : englishWords) {
+    const auto cps = collectCodepoints(word);
+    const auto expected = english->breakIndexes(cps);
+    breaks += expected.size();
+    breaksMatch = breaksMatch && english->breakIndexes(cps, &englishTables) == expected &&
+                  pack.hyphenator()->breakIndexes(cps, &pack.dispatchTables()) == expected &&
+                  Hyphenator::breakOffsets(word, false).size() == expected.size();
+  }
+  Hyphenator::setPreferredLanguage("");
+  if (!tablesMatch || !breaksMatch || breaks == 0) {
+    std::cout << "Hyphenation pack: " << (tablesMatch ? "breaks" : "dispatch tables") << " differ from built-in\n";
+    return false;
+  }
+
+  const auto timeWords = [](const LanguageHyphenator& hyphenator, const auto& words,
+                            const std::vector<LiangDispatchTable>* dispatch) {
+    std::vector<std::vector<CodepointInfo>> cps;
+    for (const char* word : words) {
+      cps.push_back(collectCodepoints(word));
+    }
+    size_t found = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 2000; round++) {
+      for (const auto& word : cps) {
+        found += hyphenator.breakIndexes(word, dispatch).size();
+      }
+    }
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    return found > 0 ? ns.count() / (2000 * static_cast<long long>(cps.size())) : 0;
+  };
+  const auto germanTables = buildLiangDispatchTables(german->patterns(), Hyphenator::kBuiltinHotNodes);
+  std::cout << "Hyphenation pack: matches built-in English; ns per word en "
+            << timeWords(*english, englishWords, nullptr) << " -> " << timeWords(*english, englishWords, &englishTables)
+            << ", de "
+            << timeWords(*german, germanWords, nullptr) << " -> " << timeWords(*german, germanWords, &germanTables)
+            << " with dispatch tables\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path buildDir = "build/hyphenation_pack";
+  const fs::path sdRoot = buildDir / "sd";
+  if (!resetSdRoot(sdRoot)) {
+    return 1;
+  }
+  return checkHyphenationPack(buildDir, sdRoot) ? 0 : 1;
+}
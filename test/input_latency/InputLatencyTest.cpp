@@ -0,0 +1,98 @@
+// Host harness for InputLatency and PageTurnQueue: the latency histogram must take one sample per render an input
+// edge caused, and page turns queued faster than they render must collapse into fewer renders, counted as skipped.
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "src/InputLatency.h"
+#include "src/PageTurnQueue.h"
+
+namespace {
+
+// Edges replace each other until a render picks one up, renders without an edge and stale edges add no sample
+bool checkInputLatency() {
+  InputLatency latency;
+  latency.onInput(1000);
+  latency.onRenderStart(4000);  // 3 ms
+  latency.onRenderStart(5000);  // no edge waiting
+  latency.onInput(10000);
+  latency.onInput(20000);
+  latency.onRenderStart(32000);  // 12 ms from the later edge
+  latency.onInput(40000);
+  latency.onRenderStart(40000 + InputLatency::MAX_LATENCY_US + 1);  // edge that caused no render
+  latency.onInput(2000000);
+  latency.onRenderStart(2250000);  // 250 ms
+
+  const bool ok = latency.getSampleCount() == 3 && latency.getBucket(0) == 1 && latency.getBucket(2) == 1 &&
+                  latency.getBucket(InputLatency::BUCKET_COUNT - 1) == 1 && latency.getMaxUs() == 250000 &&
+                  latency.getMeanUs() == 88333;
+  if (!ok) {
+    std::cout << "Input latency: " << latency.getSampleCount() << " samples, max " << latency.getMaxUs() << " us\n";
+    return false;
+  }
+  std::cout << "Input latency: histogram buckets and stale edges check out\n";
+  return true;
+}
+
+// Turns pushed faster than a slow render takes them must collapse into fewer renders that still land on the right
+// page, with every page turned past counted as skipped in the input latency stats
+bool checkPageTurnCoalescing() {
+  INPUT_LATENCY.reset();
+  PageTurnQueue queue;
+  queue.push(1);
+  queue.push(1);
+  queue.push(-1);
+  queue.push(1);
+  const int mixed = queue.take();
+  queue.push(-1);
+  queue.push(-1);
+  queue.push(-1);
+  const int back = queue.take();
+  if (mixed != 2 || back != -3 || queue.take() != 0 || INPUT_LATENCY.getPagesSkipped() != 3) {
+    std::cout << "Page turns: took " << mixed << " and " << back << ", " << INPUT_LATENCY.getPagesSkipped()
+              << " skipped\n";
+    return false;
+  }
+
+  INPUT_LATENCY.reset();
+  constexpr int kTurns = 40;
+  std::thread input([&] {
+    for (int i = 0; i < kTurns; i++) {
+      queue.push(1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  int page = 0;
+  int renders = 0;
+  for (auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+       page < kTurns && std::chrono::steady_clock::now() < deadline;) {
+    const int turns = queue.take();
+    if (turns != 0) {
+      page += turns;
+      renders++;
+      std::this_thread::sleep_for(std::chrono::milliseconds(6));  // page load and refresh
+    }
+  }
+  input.join();
+  page += queue.take();
+  const uint32_t skipped = INPUT_LATENCY.getPagesSkipped();
+  INPUT_LATENCY.reset();
+
+  if (page != kTurns || renders >= kTurns || skipped != static_cast<uint32_t>(kTurns - renders)) {
+    std::cout << "Page turns: " << kTurns << " turns landed on page " << page << " after " << renders << " renders, "
+              << skipped << " skipped\n";
+    return false;
+  }
+  std::cout << "Page turns: " << kTurns << " turns coalesced into " << renders << " renders, " << skipped
+            << " pages skipped\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const bool latencyOk = checkInputLatency();
+  const bool coalescingOk = checkPageTurnCoalescing();
+  return latencyOk && coalescingOk ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+// Host harness for KOReaderDocumentId and KOReaderProgressQueue: the document digest must come from the book cache
+// until the book changes, and progress queued offline must reach a stand-in sync server without overwriting newer or
+// foreign progress.
+
+#include <HalStorage.h>
+#include <KOReaderDocumentId.h>
+#include <KOReaderProgressQueue.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test/host/HostHarness.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// KOReader sync server stand-in behind KOReaderProgressQueue's pusher: keeps the latest progress per document with
+// its own clock and, like KOReaderSyncClient, leaves progress alone that is newer than a queued update, or that another
+// device wrote when the update has no time
+struct FakeKOSyncServer {
+  struct Record {
+    std::string progress;
+    float percentage;
+    int64_t timestamp;
+    std::string deviceId = "crosspoint-reader";
+  };
+  std::map<std::string, Record> records;
+  int64_t clock = 1700000000;
+  int sessions = 0;
+  int requests = 0;
+  int dropAfter = -1;  // Requests until the connection drops, -1: never
+
+  KOReaderSyncClient::Error push(const std::vector<KOReaderProgress>& pending, size_t& done) {
+    sessions++;
+    done = 0;
+    for (const auto& progress : pending) {
+      if (dropAfter == 0) {
+        return KOReaderSyncClient::NETWORK_ERROR;
+      }
+      dropAfter -= dropAfter > 0;
+      requests++;
+      const auto existing = records.find(progress.document);
+      const bool keep = existing != records.end() && (progress.timestamp != 0
+                                                          ? existing->second.timestamp > progress.timestamp
+                                                          : existing->second.deviceId != "crosspoint-reader");
+      if (!keep) {
+        records[progress.document] = {progress.progress, progress.percentage, clock++};
+      }
+      done++;
+    }
+    return KOReaderSyncClient::OK;
+  }
+};
+
+KOReaderProgress queuedProgress(const std::string& document, const std::string& xpath, const int64_t timestamp) {
+  KOReaderProgress progress{};
+  progress.document = document;
+  progress.progress = xpath;
+  progress.percentage = 0.25f;
+  progress.timestamp = timestamp;
+  return progress;
+}
+
+// The KOReader document digest must be read back from the book cache until the book changes, and progress queued
+// offline must survive a reboot, keep one entry per book and go out in one session, picking up after a dropped one.
+bool checkKOReaderSync(const fs::path& sdRoot) {
+  const auto fail = [](const char* what) {
+    std::cout << "KOReader sync: " << what << "\n";
+    return false;
+  };
+  if (KOReaderDocumentId::calculateFromFilename("/books/abc") != "900150983cd24fb0d6963f7d28e17f72") {
+    return fail("MD5 of a file name is wrong");
+  }
+
+  fs::create_directories(sdRoot / "kosync/cache");
+  std::vector<char> book(6 * 1024 * 1024);
+  std::mt19937 rng(49);
+  std::generate(book.begin(), book.end(), [&rng] { return static_cast<char>(rng()); });
+  std::ofstream(sdRoot / "kosync/book.epub", std::ios::binary).write(book.data(), book.size());
+
+  const auto timed = [](std::string& hash) {
+    const auto start = std::chrono::steady_clock::now();
+    hash = KOReaderDocumentId::calculateCached("/kosync/book.epub", "/kosync/cache", DocumentMatchMethod::BINARY);
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  };
+  std::string first, cached;
+  const double firstMicros = timed(first);
+  const double cachedMicros = timed(cached);
+  const std::string uncached = KOReaderDocumentId::calculate("/kosync/book.epub");
+  if (first.size() != 32 || first != uncached || cached != first) {
+    return fail("cached digest differs from the calculated one");
+  }
+
+  // A cache hit must not read the book at all: a doctored digest comes back as it is
+  const fs::path cachePath = sdRoot / "kosync/cache/koreader_id.bin";
+  std::string cacheBytes;
+  {
+    std::ifstream in(cachePath, std::ios::binary);
+    cacheBytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+  cacheBytes.replace(cacheBytes.size() - 32, 32, std::string(32, 'f'));
+  std::ofstream(cachePath, std::ios::binary) << cacheBytes;
+  std::string doctored, changed;
+  timed(doctored);
+  std::ofstream(sdRoot / "kosync/book.epub", std::ios::binary | std::ios::app) << "appendix";
+  timed(changed);
+  if (doctored != std::string(32, 'f') || changed == doctored ||
+      changed != KOReaderDocumentId::calculate("/kosync/book.epub")) {
+    return fail("digest cache not used, or not renewed after the book changed");
+  }
+
+  // Three books closed offline, the first one twice
+  FakeKOSyncServer server;
+  server.records["bbbb"] = {"/body/DocFragment[9]", 0.9f, 1800000000};
+  KOREADER_QUEUE.loadFromFile();
+  KOREADER_QUEUE.add(queuedProgress("aaaa", "/body/DocFragment[1]", 0));
+  KOREADER_QUEUE.add(queuedProgress("bbbb", "/body/DocFragment[2]", 1750000000));
+  KOREADER_QUEUE.add(queuedProgress("cccc", "/body/DocFragment[3]", 1750000000));
+  KOREADER_QUEUE.add(queuedProgress("aaaa", "/body/DocFragment[4]", 0));
+  KOREADER_QUEUE.loadFromFile();
+  const auto& entries = KOREADER_QUEUE.getEntries();
+  if (entries.size() != 3 || entries[0].document != "bbbb" || entries[2].document != "aaaa" ||
+      entries[2].progress != "/body/DocFragment[4]" || entries[1].timestamp != 1750000000) {
+    return fail("queue not kept across a reload");
+  }
+
+  const auto push = [&server](const std::vector<KOReaderProgress>& pending, size_t& done) {
+    return server.push(pending, done);
+  };
+  server.dropAfter = 2;
+  if (KOREADER_QUEUE.flush(push) != KOReaderSyncClient::NETWORK_ERROR || !KOREADER_QUEUE.saveToFile() ||
+      !KOREADER_QUEUE.loadFromFile() || entries.size() != 1 || entries[0].document != "aaaa") {
+    return fail("dropped connection lost or repeated updates");
+  }
+  server.dropAfter = -1;
+  if (KOREADER_QUEUE.flush(push) != KOReaderSyncClient::OK || !KOREADER_QUEUE.empty() || server.sessions != 2 ||
+      server.requests != 3 || server.records["aaaa"].progress != "/body/DocFragment[4]" ||
+      server.records["bbbb"].progress != "/body/DocFragment[9]" || server.records["cccc"].percentage != 0.25f) {
+    return fail("queue not flushed as expected");
+  }
+  const int sessions = server.sessions;
+
+  for (int i = 0; i < 20; i++) {
+    KOREADER_QUEUE.add(queuedProgress("book" + std::to_string(i), "/body/DocFragment[1]", 0));
+  }
+  const bool capped = entries.size() == 16 && entries.front().document == "book4";
+  KOREADER_QUEUE.remove("book7");
+  const bool removed = entries.size() == 15;
+  size_t done = 0;
+  KOREADER_QUEUE.flush([&done](const std::vector<KOReaderProgress>& pending, size_t& pushed) {
+    done = pushed = pending.size();
+    return KOReaderSyncClient::OK;
+  });
+  KOREADER_QUEUE.saveToFile();
+  if (!capped || !removed || done != 15) {
+    return fail("queue not capped to the most recent books");
+  }
+
+  // Closed while the clock was not set: progress another device wrote cannot be ordered against it and stays, the
+  // reader's own is replaced
+  server.records["dddd"] = {"/body/DocFragment[7]", 0.7f, 1800000000, "koreader-phone"};
+  server.records["eeee"] = {"/body/DocFragment[7]", 0.7f, 1800000000};
+  KOREADER_QUEUE.add(queuedProgress("dddd", "/body/DocFragment[1]", 0));
+  KOREADER_QUEUE.add(queuedProgress("eeee", "/body/DocFragment[1]", 0));
+  if (KOREADER_QUEUE.flush(push) != KOReaderSyncClient::OK || !KOREADER_QUEUE.empty() ||
+      server.records["dddd"].progress != "/body/DocFragment[7]" ||
+      server.records["eeee"].progress != "/body/DocFragment[1]") {
+    return fail("progress without a time replaced another device's, or not the reader's own");
+  }
+  KOREADER_QUEUE.saveToFile();
+
+  std::cout << "KOReader sync: digest of a 6 MB book " << firstMicros << " us calculated, " << cachedMicros
+            << " us from the book cache; 3 books closed offline pushed in " << sessions
+            << " sessions (1 dropped), newer server progress and other devices' progress kept\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path sdRoot = "build/koreader_sync/sd";
+  if (!resetSdRoot(sdRoot)) {
+    return 1;
+  }
+  return checkKOReaderSync(sdRoot) ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+// Host harness for OpdsFeedCache: a catalog served by a stand-in OPDS server must page in lazily with only a screen of
+// entries in RAM, be reused from the SD copy, revalidate with ETags and fall back to the cached copy while offline.
+
+#include <HalStorage.h>
+#include <OpdsFeedCache.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "test/host/HostHarness.h"
+#include "test/host/HostHeap.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Stand-in OPDS server: feeds are served from memory, If-None-Match is honoured like Calibre and COPS do
+struct FakeOpdsServer {
+  struct Feed {
+    std::string body;
+    std::string etag;
+  };
+  std::map<std::string, Feed> feeds;
+  bool online = true;
+  int requests = 0;
+  int bodiesSent = 0;
+
+  OpdsFetchResult fetch(const std::string& url, const OpdsValidators& validators, OpdsValidators& received,
+                        Stream& body) {
+    requests++;
+    const auto it = feeds.find(url);
+    if (!online || it == feeds.end()) {
+      return OpdsFetchResult::FAILED;
+    }
+    if (!validators.etag.empty() && validators.etag == it->second.etag) {
+      return OpdsFetchResult::NOT_MODIFIED;
+    }
+    received.etag = it->second.etag;
+    // In small writes, like HTTPClient::writeToStream hands over what arrived
+    const std::string& data = it->second.body;
+    for (size_t i = 0; i < data.size(); i += 200) {
+      body.write(reinterpret_cast<const uint8_t*>(data.data() + i), std::min<size_t>(200, data.size() - i));
+    }
+    bodiesSent++;
+    return OpdsFetchResult::OK;
+  }
+};
+
+// One page of a catalog: every tenth entry is a navigation link, the rest are books
+std::string opdsFeedPage(const int first, const int count, const std::string& next) {
+  std::string xml =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<feed xmlns=\"http://www.w3.org/2005/Atom\">"
+      "<title>Catalog</title><link rel=\"self\" type=\"application/atom+xml\" href=\"/self\"/>"
+      "<link rel=\"start\" type=\"application/atom+xml\" href=\"/opds\"/>";
+  if (!next.empty()) {
+    xml += "<link rel=\"next\" type=\"application/atom+xml;profile=opds-catalog\" href=\"" + next + "\"/>";
+  }
+  for (int i = first; i < first + count; i++) {
+    const std::string n = std::to_string(i);
+    if (i % 10 == 0) {
+      xml += "<entry><title>Shelf " + n + "</title><id>urn:shelf:" + n +
+             "</id><link rel=\"subsection\" type=\"application/atom+xml;profile=opds-catalog\" href=\"/opds/shelf/" +
+             n + "\"/></entry>";
+    } else {
+      xml += "<entry><title>Book " + n + "</title><author><name>Author " + n + "</name></author><id>urn:book:" + n +
+             "</id><link rel=\"http://opds-spec.org/acquisition\" type=\"application/epub+zip\" href=\"/get/" + n +
+             ".epub\"/></entry>";
+    }
+  }
+  return xml + "</feed>";
+}
+
+bool checkOpdsFeedCache() {
+  constexpr int kPageSize = 100;
+  FakeOpdsServer server;
+  server.feeds["http://opds/root"] = {opdsFeedPage(0, kPageSize, "http://opds/root?page=2"), "\"r1\""};
+  server.feeds["http://opds/root?page=2"] = {opdsFeedPage(kPageSize, kPageSize, "/root?page=3"), "\"p2\""};
+  server.feeds["/root?page=3"] = {opdsFeedPage(2 * kPageSize, 7, ""), "\"p3\""};
+  server.feeds["http://opds/opds/shelf/0"] = {opdsFeedPage(1000, 3, ""), "\"s0\""};
+  server.feeds["http://opds/broken"] = {"<feed><entry><title>Half", "\"b\""};
+  const auto fetcher = [&server](const std::string& url, const OpdsValidators& validators, OpdsValidators& received,
+                                 Stream& body) { return server.fetch(url, validators, received, body); };
+  const auto fail = [](const char* what) {
+    std::cout << "OPDS feed cache: " << what << "\n";
+    return false;
+  };
+
+  // Pages arrive one at a time, only as many entries as a screen shows are ever in RAM
+  OpdsFeedCache feed;
+  heap::Scope scope;
+  if (feed.open("http://opds/root", true, fetcher) != OpdsFeedCache::Result::OK ||
+      feed.getEntryCount() != kPageSize || !feed.hasMore()) {
+    return fail("first page not loaded");
+  }
+  while (feed.hasMore()) {
+    if (feed.loadMore(fetcher) != OpdsFeedCache::Result::OK) {
+      return fail("next page not loaded");
+    }
+  }
+  std::vector<OpdsEntry> page;
+  if (feed.getEntryCount() != 2 * kPageSize + 7 || server.requests != 3 || !feed.readEntries(95, 23, page) ||
+      page.size() != 23) {
+    return fail("pages not appended");
+  }
+  const size_t peakBytes = scope.peakBytes();
+  if (page[0].title != "Book 95" || page[0].author != "Author 95" || page[0].href != "/get/95.epub" ||
+      page[0].type != OpdsEntryType::BOOK || page[5].title != "Shelf 100" ||
+      page[5].type != OpdsEntryType::NAVIGATION || page[5].href != "/opds/shelf/100" ||
+      page[22].id != "urn:book:117") {
+    return fail("entries read back wrong");
+  }
+  if (!feed.readEntries(200, 23, page) || page.size() != 7 || page[6].title != "Book 206") {
+    return fail("short last page read back wrong");
+  }
+
+  // Going back to a feed that was already browsed needs no request at all, revalidating it only a 304
+  if (feed.open("http://opds/opds/shelf/0", true, fetcher) != OpdsFeedCache::Result::OK ||
+      feed.getEntryCount() != 3) {
+    return fail("second feed not loaded");
+  }
+  const int requestsBefore = server.requests;
+  const int bodiesBefore = server.bodiesSent;
+  if (feed.open("http://opds/root", false, fetcher) != OpdsFeedCache::Result::OK ||
+      feed.getEntryCount() != 2 * kPageSize + 7 || server.requests != requestsBefore) {
+    return fail("cached feed not reused");
+  }
+  if (feed.open("http://opds/root", true, fetcher) != OpdsFeedCache::Result::OK ||
+      feed.getEntryCount() != 2 * kPageSize + 7 || server.requests != requestsBefore + 1 ||
+      server.bodiesSent != bodiesBefore) {
+    return fail("unchanged feed not revalidated with a 304");
+  }
+
+  // Offline, the cached copy is used; a changed feed replaces it
+  server.online = false;
+  if (feed.open("http://opds/root", true, fetcher) != OpdsFeedCache::Result::OK ||
+      feed.getEntryCount() != 2 * kPageSize + 7) {
+    return fail("cached copy not used while offline");
+  }
+  server.online = true;
+  server.feeds["http://opds/root"] = {opdsFeedPage(500, 4, ""), "\"r2\""};
+  if (feed.open("http://opds/root", true, fetcher) != OpdsFeedCache::Result::OK || feed.getEntryCount() != 4 ||
+      feed.hasMore() || !feed.readEntries(0, 23, page) || page.size() != 4 || page[1].title != "Book 501") {
+    return fail("changed feed not refetched");
+  }
+
+  if (feed.open("http://opds/broken", true, fetcher) != OpdsFeedCache::Result::PARSE_FAILED ||
+      feed.getEntryCount() != 0 ||
+      feed.open("http://opds/missing", true, fetcher) != OpdsFeedCache::Result::FETCH_FAILED) {
+    return fail("broken or missing feed not reported");
+  }
+
+  std::cout << "OPDS feed cache: 3 pages / " << 2 * kPageSize + 7 << " entries spilled to SD with " << peakBytes
+            << " bytes peak heap, revalidated with a 304\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  if (!resetSdRoot("build/opds_feed_cache/sd")) {
+    return 1;
+  }
+  return checkOpdsFeedCache() ? 0 : 1;
+}
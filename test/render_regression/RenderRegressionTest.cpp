@@ -0,0 +1,841 @@
+// Host render regression and benchmark for the EPUB reader pipeline.
+//
+// Every chapter of the test EPUBs is laid out in all four orientations with the default reader settings, then each
+// page is rendered in BW, GRAYSCALE_LSB and GRAYSCALE_MSB mode exactly like EpubReaderActivity::renderContents does.
+// The resulting frame buffers are hashed and compared with test/render_regression/goldens.txt, and the time and
+// number of drawPixel() calls per page are reported so renderer optimisations can be measured. Every page is also
+// stored in a SectionPageCache and each plane must blit back to the golden frame; the blit time is reported next to
+// the raster time per mode.
+//
+// The other render paths are checked here too: streaming layout of a giant paragraph must produce the same lines as
+// laying it out in one pass, UI tiles from TileCache must redraw pixel-identically in every orientation, a saved
+// PageSnapshot must come back as the same frame, cached planes drawn while a refresh is in flight must wait for the
+// panel, and drawBitmap must sample BMPs like a per-pixel reference in every orientation and render mode. Features
+// that do not render have their own harnesses next to this one.
+
+#include <Bitmap.h>
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/ParsedText.h>
+#include <Epub/Section.h>
+#include <Epub/hyphenation/Hyphenator.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <HalStorage.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/PageSnapshot.h"
+#include "src/SectionPageCache.h"
+#include "src/components/TileCache.h"
+#include "src/components/themes/BaseTheme.h"
+#include "test/host/HostHarness.h"
+#include "test/host/HostRenderer.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kGoldenFile = "test/render_regression/goldens.txt";
+constexpr const char* kBookDir = "test/epubs";
+
+struct ModeCase {
+  GfxRenderer::RenderMode mode;
+  const char* name;
+  uint8_t clearColor;
+};
+
+const ModeCase kModes[] = {
+    {GfxRenderer::BW, "bw", 0xFF},
+    {GfxRenderer::GRAYSCALE_LSB, "lsb", 0x00},
+    {GfxRenderer::GRAYSCALE_MSB, "msb", 0x00},
+};
+
+struct Options {
+  bool update = false;
+  bool snapshots = false;
+  bool plainSections = false;
+  bool tokenizer = false;
+  std::vector<std::string> extraBooks;
+};
+
+struct ModeStats {
+  uint64_t micros = 0;
+  uint64_t pixels = 0;
+  uint32_t pages = 0;
+};
+
+// The frame buffer is already 1bpp MSB-first in panel orientation, which is exactly the PBM (P4) raster layout
+// apart from the inverted bit meaning.
+void writePbm(const fs::path& path, const uint8_t* frameBuffer) {
+  fs::create_directories(path.parent_path());
+  std::ofstream out(path, std::ios::binary);
+  out << "P4\n" << HalDisplay::DISPLAY_WIDTH << " " << HalDisplay::DISPLAY_HEIGHT << "\n";
+  for (uint32_t i = 0; i < HalDisplay::BUFFER_SIZE; i++) {
+    out.put(static_cast<char>(~frameBuffer[i]));
+  }
+}
+
+std::map<std::string, std::string> loadGoldens(const std::string& path) {
+  std::map<std::string, std::string> goldens;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string key, hash;
+    if (fields >> key >> hash) {
+      goldens[key] = hash;
+    }
+  }
+  return goldens;
+}
+
+bool saveGoldens(const std::string& path, const std::map<std::string, std::string>& goldens) {
+  std::ofstream out(path);
+  if (!out) {
+    return false;
+  }
+  out << "# Frame buffer hashes (FNV-1a 64) produced by test/run_render_regression.sh\n";
+  out << "# Regenerate with: test/run_render_regression.sh --update\n";
+  for (const auto& [key, hash] : goldens) {
+    out << key << " " << hash << "\n";
+  }
+  return true;
+}
+
+Options parseArgs(const int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--update") {
+      options.update = true;
+    } else if (arg == "--snapshots") {
+      options.snapshots = true;
+    } else if (arg == "--plain-sections") {
+      options.plainSections = true;
+    } else if (arg == "--tokenizer") {
+      options.tokenizer = true;
+    } else if (arg == "--help" || arg == "-h") {
+      std::cout << "Usage: RenderRegressionTest [--update] [--snapshots] [--plain-sections] [--tokenizer] "
+                   "[extra.epub ...]\n"
+                << "  --update          rewrite " << kGoldenFile << " from the current renderer output\n"
+                << "  --snapshots       write a PBM image of every rendered page, not only of mismatches\n"
+                << "  --plain-sections  build section files without the word table\n"
+                << "  --tokenizer       parse chapters with XhtmlTokenizer instead of expat\n"
+                << "  extra.epub        additional books to benchmark; they are not compared against goldens\n";
+      std::exit(0);
+    } else {
+      options.extraBooks.push_back(arg);
+    }
+  }
+  return options;
+}
+
+// Hash of a single line rendered on a blank frame; equal hashes mean equal words, positions and styles
+std::string hashLine(GfxRenderer& renderer, const TextBlock& line) {
+  renderer.clearScreen();
+  line.render(renderer, BOOKERLY_14_FONT_ID, 0, 40);
+  return frameHash(renderer);
+}
+
+// Lays the same paragraph out in one pass and as a sliding window the way ChapterHtmlSlimParser feeds it. The greedy
+// hyphenating layout only looks at the current line, so a giant paragraph must produce exactly the same lines either
+// way. Without hyphenation the breaks come from a whole-paragraph DP, so paragraphs up to the streaming threshold must
+// never stream at all: a 700 word one at 790 px has to come out exactly as in one pass.
+bool checkStreamingLayout(GfxRenderer& renderer) {
+  static const char* const vocabulary[] = {"the",       "of",          "paragraph", "layout",    "window",
+                                           "memory,",   "reader.",     "chapter",   "continuous", "unbroken",
+                                           "extraordinarily", "incomprehensible", "nevertheless", "well-known", "a"};
+
+  Hyphenator::setPreferredLanguage("en");
+  BlockStyle style;
+  style.textIndent = 24;
+  style.textIndentDefined = true;
+
+  size_t peakWords = 0;
+  auto layout = [&](const bool streaming, const bool hyphenation, const size_t wordCount, const uint16_t width) {
+    std::vector<std::string> hashes;
+    const auto collect = [&](const std::shared_ptr<TextBlock>& line) { hashes.push_back(hashLine(renderer, *line)); };
+    ParsedText text(false, hyphenation, style);
+    uint32_t seed = 29;
+    for (size_t i = 0; i < wordCount; i++) {
+      seed = seed * 1103515245u + 12345u;
+      const auto wordStyle = (seed >> 24) % 11 == 0 ? EpdFontFamily::ITALIC : EpdFontFamily::REGULAR;
+      text.addWord(vocabulary[(seed >> 16) % (sizeof(vocabulary) / sizeof(vocabulary[0]))], wordStyle);
+      peakWords = std::max(peakWords, text.size());
+      if (streaming && text.needsStreamingLayout()) {
+        text.layoutAndExtractLines(renderer, BOOKERLY_14_FONT_ID, width, collect, false);
+      }
+    }
+    text.layoutAndExtractLines(renderer, BOOKERLY_14_FONT_ID, width, collect);
+    return hashes;
+  };
+
+  renderer.setOrientation(GfxRenderer::Portrait);
+  const auto whole = layout(false, true, 3000, 460);
+  peakWords = 0;
+  const auto streamed = layout(true, true, 3000, 460);
+  const size_t streamedPeak = peakWords;
+
+  renderer.setOrientation(GfxRenderer::LandscapeCounterClockwise);
+  const auto dpWhole = layout(false, false, 700, 790);
+  const auto dpStreamed = layout(true, false, 700, 790);
+  renderer.setOrientation(GfxRenderer::Portrait);
+  Hyphenator::setPreferredLanguage("");
+
+  if (streamedPeak > ParsedText::STREAMING_WORD_THRESHOLD + 1) {
+    std::cout << "Streaming layout buffered " << streamedPeak << " words\n";
+    return false;
+  }
+  if (whole.empty() || whole != streamed) {
+    std::cout << "Streaming layout mismatch: " << whole.size() << " lines in one pass, " << streamed.size()
+              << " lines streamed\n";
+    return false;
+  }
+  if (dpWhole.empty() || dpWhole != dpStreamed) {
+    std::cout << "Streaming layout: 700 word paragraph without hyphenation reflowed (" << dpWhole.size() << " vs "
+              << dpStreamed.size() << " lines)\n";
+    return false;
+  }
+  std::cout << "Streaming layout: " << streamed.size() << " hyphenated lines match the one-pass layout, a 700 word "
+            << "paragraph without hyphenation keeps its " << dpWhole.size() << " lines\n";
+  return true;
+}
+
+// Draws a tile over a patterned background, then redraws only the background and blits the tile back. The frame must
+// come out identical, which also proves the unaligned edges of the tile leave neighbouring pixels alone.
+bool checkTileCache(GfxRenderer& renderer) {
+  const auto background = [&] {
+    renderer.clearScreen();
+    for (int y = 0; y < renderer.getScreenHeight(); y += 3) {
+      renderer.drawLine(0, y, renderer.getScreenWidth() - 1, y);
+    }
+  };
+
+  TileCache tiles;
+  size_t peakBytes = 0;
+  for (const auto& orientation : kOrientations) {
+    renderer.setOrientation(orientation.orientation);
+    const Rect rect{37, 61, 141, 203};
+    const uint32_t key = TileCache::keyFor(orientation.name);
+
+    background();
+    renderer.fillRect(rect.x, rect.y, rect.width, rect.height, false);
+    renderer.drawRect(rect.x, rect.y, rect.width, rect.height);
+    renderer.drawText(BOOKERLY_14_FONT_ID, rect.x + 5, rect.y + 40, "Tile");
+    renderer.fillRectDither(rect.x + 10, rect.y + 100, rect.width - 20, 60, Color::LightGray);
+    const std::string expected = frameHash(renderer);
+    if (!tiles.store(renderer, key, rect)) {
+      std::cout << "Tile cache: failed to store " << orientation.name << " tile\n";
+      return false;
+    }
+    peakBytes = std::max(peakBytes, tiles.getUsedBytes());
+
+    background();
+    const Rect moved{rect.x + 1, rect.y, rect.width, rect.height};
+    if (tiles.draw(renderer, key, moved) || !tiles.draw(renderer, key, rect)) {
+      std::cout << "Tile cache: wrong hit or miss for " << orientation.name << "\n";
+      return false;
+    }
+    if (frameHash(renderer) != expected) {
+      std::cout << "Tile cache: " << orientation.name << " tile does not redraw identically\n";
+      return false;
+    }
+  }
+  renderer.setOrientation(GfxRenderer::Portrait);
+
+  // Button hints go through drawOrRender: rendered once, blitted afterwards, never cached from a grayscale pass
+  int renders = 0;
+  const Rect hint{25, renderer.getScreenHeight() - 40, 106, 40};
+  const auto renderHint = [&] {
+    renders++;
+    renderer.fillRect(hint.x, hint.y, hint.width, hint.height, false);
+    renderer.drawRect(hint.x, hint.y, hint.width, hint.height);
+    renderer.drawText(BOOKERLY_14_FONT_ID, hint.x + 20, hint.y + 7, "Back");
+  };
+  const uint32_t hintKey = TileCache::keyFor("hint0Back");
+  background();
+  tiles.drawOrRender(renderer, hintKey, hint, renderHint);
+  const std::string expected = frameHash(renderer);
+  background();
+  tiles.drawOrRender(renderer, hintKey, hint, renderHint);
+  const bool hintMatches = frameHash(renderer) == expected;
+  renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
+  tiles.drawOrRender(renderer, hintKey, hint, renderHint);
+  renderer.setRenderMode(GfxRenderer::BW);
+  renderer.clearScreen();
+  if (renders != 2 || !hintMatches) {
+    std::cout << "Tile cache: drawOrRender rendered " << renders << " times (expected 2), "
+              << (hintMatches ? "blit matches" : "blit differs") << "\n";
+    return false;
+  }
+
+  std::cout << "Tile cache: tiles redraw identically in every orientation (" << tiles.getTileCount() << " tiles, "
+            << peakBytes << " bytes vs " << GfxRenderer::getBufferSize() << " for a frame buffer copy)\n";
+  return true;
+}
+
+// Saves an anti-aliased text page the way EpubReaderActivity does before sleep, then shows it as on wake
+bool checkPageSnapshot(GfxRenderer& renderer, const fs::path& sdRoot) {
+  renderer.setOrientation(GfxRenderer::Portrait);
+  const auto renderPlane = [&](const GfxRenderer::RenderMode mode) {
+    renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+    renderer.setRenderMode(mode);
+    for (int line = 0; line < 24; line++) {
+      renderer.drawText(BOOKERLY_14_FONT_ID, 20, 30 + line * 30, "The quick brown fox jumps over the lazy dog.");
+    }
+    renderer.setRenderMode(GfxRenderer::BW);
+  };
+
+  if (!PAGE_SNAPSHOT.save(renderer, "/books/snapshot.epub", 3, 17, true, renderPlane)) {
+    std::cout << "Page snapshot: save failed\n";
+    return false;
+  }
+  const std::string expected = frameHash(renderer);
+  const auto fileSize = fs::file_size(sdRoot / ".crosspoint/page_snapshot.bin");
+
+  renderer.clearScreen();
+  if (PAGE_SNAPSHOT.show(renderer, "/books/other.epub") || fs::exists(sdRoot / ".crosspoint/page_snapshot.bin")) {
+    std::cout << "Page snapshot: shown for the wrong book or not discarded\n";
+    return false;
+  }
+  PAGE_SNAPSHOT.save(renderer, "/books/snapshot.epub", 3, 17, true, renderPlane);
+  renderer.clearScreen();
+  const bool shown = PAGE_SNAPSHOT.show(renderer, "/books/snapshot.epub");
+  const std::string actual = frameHash(renderer);
+  const bool matched = PAGE_SNAPSHOT.takeShown("/books/snapshot.epub", 3, 17);
+  renderer.clearScreen();
+  if (!shown || actual != expected || !matched || PAGE_SNAPSHOT.takeShown("/books/snapshot.epub", 3, 17)) {
+    std::cout << "Page snapshot: frame did not survive the round trip\n";
+    return false;
+  }
+  std::cout << "Page snapshot: 3 planes in " << fileSize << " bytes round-trip identically\n";
+  return true;
+}
+
+// A page turn against a panel with a 300 ms waveform and 200 ms of SD work for the next page. Blocking, the work waits
+// for the waveform; with displayBufferAsync() it runs during it and the next draw waits for what is left.
+bool checkAsyncDisplay(GfxRenderer& renderer) {
+  constexpr uint32_t kRefreshMs = 300;
+  constexpr auto kWork = std::chrono::milliseconds(200);
+  EInkDisplay::setRefreshLatency(EInkDisplay::FAST_REFRESH, kRefreshMs);
+  const auto elapsedMs = [](const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  renderer.clearScreen();
+  auto start = std::chrono::steady_clock::now();
+  renderer.displayBuffer();
+  std::this_thread::sleep_for(kWork);
+  renderer.clearScreen();
+  const auto blockingMs = elapsedMs(start);
+
+  start = std::chrono::steady_clock::now();
+  renderer.displayBufferAsync();
+  const bool busyAfterStart = renderer.isDisplayBusy();
+  std::this_thread::sleep_for(kWork);
+  renderer.clearScreen();
+  const auto asyncMs = elapsedMs(start);
+  const bool idleAfterDraw = !renderer.isDisplayBusy();
+
+  // A draw straight after the refresh started must not touch the frame buffer before the waveform is over
+  start = std::chrono::steady_clock::now();
+  renderer.displayBufferAsync();
+  renderer.clearScreen();
+  const auto drawWaitMs = elapsedMs(start);
+  EInkDisplay::setRefreshLatency(EInkDisplay::FAST_REFRESH, 0);
+
+  if (!busyAfterStart || !idleAfterDraw || drawWaitMs < kRefreshMs || asyncMs >= blockingMs - kWork.count() / 2) {
+    std::cout << "Async display: busy " << busyAfterStart << ", idle " << idleAfterDraw << ", draw waited "
+              << drawWaitMs << " ms, page turn " << asyncMs << " ms vs " << blockingMs << " ms blocking\n";
+    return false;
+  }
+  std::cout << "Async display: page turn with " << kWork.count() << " ms of SD work takes " << asyncMs << " ms vs "
+            << blockingMs << " ms blocking (" << kRefreshMs << " ms waveform)\n";
+  return true;
+}
+
+// The grayscale pass of renderContents() runs while the BW waveform is still going. Cached planes must come out like
+// the rendered ones, without drawing into the frame buffer the panel is still reading from.
+bool checkPageCacheDuringRefresh(GfxRenderer& renderer) {
+  constexpr uint32_t kRefreshMs = 100;
+  const GfxRenderer::RenderMode modes[] = {GfxRenderer::BW, GfxRenderer::GRAYSCALE_LSB, GfxRenderer::GRAYSCALE_MSB};
+  const auto renderPlane = [&](const GfxRenderer::RenderMode mode) {
+    renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+    renderer.setRenderMode(mode);
+    renderer.drawText(BOOKERLY_14_FONT_ID, 20, 60, "Cached while refreshing");
+    renderer.fillRectDither(20, 100, 300, 120, Color::LightGray);
+    renderer.setRenderMode(GfxRenderer::BW);
+  };
+  std::string expected[3];
+  for (int i = 0; i < 3; i++) {
+    renderPlane(modes[i]);
+    expected[i] = frameHash(renderer);
+  }
+
+  SectionPageCache frames;
+  const std::string path = "/refresh_page_cache.bin";
+  if (!frames.open(path, 1, 1, true) || !frames.store(renderer, 0, 0, renderPlane)) {
+    std::cout << "Page cache during refresh: could not store the page\n";
+    return false;
+  }
+
+  EInkDisplay::setRefreshLatency(EInkDisplay::FAST_REFRESH, kRefreshMs);
+  const uint32_t tornBefore = EInkDisplay::tornRefreshCount;
+  bool matched = true;
+  for (int i = 0; i < 3; i++) {
+    renderer.clearScreen(0x55);
+    renderer.displayBufferAsync();
+    matched = frames.drawPlane(renderer, 0, modes[i]) &&
+              frameHash(renderer) == expected[i] && matched;
+  }
+  renderer.waitForDisplay();
+  EInkDisplay::setRefreshLatency(EInkDisplay::FAST_REFRESH, 0);
+  const uint32_t torn = EInkDisplay::tornRefreshCount - tornBefore;
+  frames.close();
+  Storage.remove(path.c_str());
+  renderer.clearScreen();
+
+  if (!matched || torn != 0) {
+    std::cout << "Page cache during refresh: " << (matched ? "planes match" : "planes differ") << ", " << torn
+              << " of 3 refreshes drawn into\n";
+    return false;
+  }
+  std::cout << "Page cache during refresh: 3 cached planes match the rendered ones and wait for the panel\n";
+  return true;
+}
+
+// drawBitmap as it was before chunked reads: one readNextRow per source row, float placement and a drawPixel for every
+// source pixel. The baseline of the blit benchmark; unscaled draws must still match it exactly.
+void legacyDrawBitmap(const GfxRenderer& renderer, const Bitmap& bitmap, const int x, const int y, const int maxWidth,
+                      const int maxHeight) {
+  float scale = 1.0f;
+  bool isScaled = false;
+  if (maxWidth > 0 && bitmap.getWidth() > maxWidth) {
+    scale = static_cast<float>(maxWidth) / static_cast<float>(bitmap.getWidth());
+    isScaled = true;
+  }
+  if (maxHeight > 0 && bitmap.getHeight() > maxHeight) {
+    scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>(bitmap.getHeight()));
+    isScaled = true;
+  }
+  std::vector<uint8_t> outputRow((bitmap.getWidth() + 3) / 4);
+  std::vector<uint8_t> rowBytes(bitmap.getRowBytes());
+  const auto mode = renderer.getRenderMode();
+  for (int bmpY = 0; bmpY < bitmap.getHeight(); bmpY++) {
+    int screenY = bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY;
+    if (isScaled) {
+      screenY = std::floor(screenY * scale);
+    }
+    screenY += y;
+    if (screenY >= renderer.getScreenHeight() ||
+        bitmap.readNextRow(outputRow.data(), rowBytes.data()) != BmpReaderError::Ok || screenY < 0) {
+      continue;
+    }
+    for (int bmpX = 0; bmpX < bitmap.getWidth(); bmpX++) {
+      const int screenX = x + (isScaled ? static_cast<int>(std::floor(bmpX * scale)) : bmpX);
+      if (screenX >= renderer.getScreenWidth()) {
+        break;
+      }
+      if (screenX < 0) {
+        continue;
+      }
+      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
+      if ((bitmap.is1Bit() || mode == GfxRenderer::BW) && val < 3) {
+        renderer.drawPixel(screenX, screenY);
+      } else if (!bitmap.is1Bit() && mode == GfxRenderer::GRAYSCALE_MSB && (val == 1 || val == 2)) {
+        renderer.drawPixel(screenX, screenY, false);
+      } else if (!bitmap.is1Bit() && mode == GfxRenderer::GRAYSCALE_LSB && val == 1) {
+        renderer.drawPixel(screenX, screenY, false);
+      }
+    }
+  }
+}
+
+// The nearest-neighbour sampling drawBitmap promises, pixel by pixel through drawPixel: destination pixel d shows
+// source pixel (2d + 1) * source size / (2 * destination size), in 16.16 fixed point like the blit
+void referenceDrawBitmap(const GfxRenderer& renderer, const Bitmap& bitmap, const int x, const int y,
+                         const int maxWidth, const int maxHeight) {
+  const int width = bitmap.getWidth(), height = bitmap.getHeight();
+  float scale = 1.0f;
+  if (maxWidth > 0 && width > maxWidth) {
+    scale = static_cast<float>(maxWidth) / static_cast<float>(width);
+  }
+  if (maxHeight > 0 && height > maxHeight) {
+    scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>(height));
+  }
+  const int dstWidth = scale < 1.0f ? static_cast<int>(std::floor((width - 1) * scale)) + 1 : width;
+  const int dstHeight = scale < 1.0f ? static_cast<int>(std::floor((height - 1) * scale)) + 1 : height;
+  const uint32_t stepX = (static_cast<uint32_t>(width) << 16) / dstWidth;
+  const uint32_t stepY = (static_cast<uint32_t>(height) << 16) / dstHeight;
+
+  // Every row decoded, top-down (without dithering a row decodes the same whatever was decoded before it)
+  std::vector<std::vector<uint8_t>> rows(height, std::vector<uint8_t>((width + 3) / 4));
+  std::vector<uint8_t> raw(bitmap.getRowBytes());
+  for (int fileRow = 0; fileRow < height; fileRow++) {
+    bitmap.readRawRows(fileRow, 1, raw.data());
+    bitmap.decodeRow(raw.data(), rows[bitmap.isTopDown() ? fileRow : height - 1 - fileRow].data(), fileRow);
+  }
+  const auto mode = renderer.getRenderMode();
+  for (int dy = 0; dy < dstHeight; dy++) {
+    const int screenY = y + dy;
+    if (screenY < 0 || screenY >= renderer.getScreenHeight()) {
+      continue;
+    }
+    const auto& row = rows[std::min(height - 1, static_cast<int>((dy * stepY + stepY / 2) >> 16))];
+    for (int dx = 0; dx < dstWidth; dx++) {
+      const int screenX = x + dx;
+      if (screenX < 0 || screenX >= renderer.getScreenWidth()) {
+        continue;
+      }
+      const int src = std::min(width - 1, static_cast<int>((dx * stepX + stepX / 2) >> 16));
+      const uint8_t val = row[src / 4] >> (6 - (src % 4) * 2) & 0x3;
+      if ((bitmap.is1Bit() || mode == GfxRenderer::BW) && val < 3) {
+        renderer.drawPixel(screenX, screenY);
+      } else if (!bitmap.is1Bit() && mode == GfxRenderer::GRAYSCALE_MSB && (val == 1 || val == 2)) {
+        renderer.drawPixel(screenX, screenY, false);
+      } else if (!bitmap.is1Bit() && mode == GfxRenderer::GRAYSCALE_LSB && val == 1) {
+        renderer.drawPixel(screenX, screenY, false);
+      }
+    }
+  }
+}
+
+// drawBitmap against the per-pixel reference in every orientation and render mode, partly off screen, for the BMP
+// shapes the UI draws: full screen sleep images, large covers scaled to the screen, home screen thumbnails and 1-bit
+// images. Times the Portrait BW draw against the old row-at-a-time path.
+bool checkBitmapBlit(GfxRenderer& renderer, const fs::path& sdRoot) {
+  struct Case {
+    const char* name;
+    int width, height, bpp, maxWidth, maxHeight;
+  };
+  const Case cases[] = {
+      {"sleep 480x800 24-bit", 480, 800, 24, 480, 800},
+      {"cover 1200x1800 24-bit to 480x800", 1200, 1800, 24, 480, 800},
+      {"thumbnail 600x900 8-bit to 120x180", 600, 900, 8, 120, 180},
+      {"1-bit 480x800", 480, 800, 1, 480, 800},
+  };
+  const GfxRenderer::RenderMode modes[] = {GfxRenderer::BW, GfxRenderer::GRAYSCALE_LSB, GfxRenderer::GRAYSCALE_MSB};
+  const GfxRenderer::Orientation orientations[] = {GfxRenderer::Portrait, GfxRenderer::LandscapeClockwise,
+                                                   GfxRenderer::PortraitInverted,
+                                                   GfxRenderer::LandscapeCounterClockwise};
+  fs::create_directories(sdRoot / "bitmaps");
+  std::ostringstream report;
+  bool ok = true;
+
+  for (const auto& c : cases) {
+    const std::string path = std::string("/bitmaps/") + std::to_string(c.width) + "x" + std::to_string(c.height) +
+                             "_" + std::to_string(c.bpp) + ".bmp";
+    writeTestBmp(sdRoot / (path.c_str() + 1), c.width, c.height, c.bpp, c.bpp);
+    FsFile file;
+    if (!Storage.openFileForRead("TEST", path, file)) {
+      return false;
+    }
+    Bitmap bitmap(file);
+    if (bitmap.parseHeaders() != BmpReaderError::Ok) {
+      std::cerr << "Bitmap blit: could not parse " << path << "\n";
+      return false;
+    }
+    const bool scaled = c.width > c.maxWidth || c.height > c.maxHeight;
+
+    const auto draw = [&](const GfxRenderer::RenderMode mode, const int x, const int y, const auto& drawFn) {
+      renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+      renderer.setRenderMode(mode);
+      bitmap.rewindToData();
+      drawFn(x, y);
+      renderer.setRenderMode(GfxRenderer::BW);
+      return frameHash(renderer);
+    };
+    const auto blit = [&](const int x, const int y) { renderer.drawBitmap(bitmap, x, y, c.maxWidth, c.maxHeight); };
+    const auto reference = [&](const int x, const int y) {
+      referenceDrawBitmap(renderer, bitmap, x, y, c.maxWidth, c.maxHeight);
+    };
+    const auto legacy = [&](const int x, const int y) {
+      legacyDrawBitmap(renderer, bitmap, x, y, c.maxWidth, c.maxHeight);
+    };
+
+    for (const auto orientation : orientations) {
+      renderer.setOrientation(orientation);
+      for (const auto mode : modes) {
+        const std::string actual = draw(mode, -7, 13, blit);
+        if (draw(mode, -7, 13, blit) != draw(mode, -7, 13, reference)) {
+          std::cerr << "Bitmap blit: " << c.name << " differs from the reference in orientation " << orientation
+                    << ", mode " << mode << "\n";
+          ok = false;
+        }
+        // Unscaled draws that fit the screen must not change at all. The old loop stopped at the bottom screen edge, so
+        // a bottom-up file clipped there drew nothing.
+        const bool fits = c.width <= renderer.getScreenWidth() && c.height <= renderer.getScreenHeight();
+        if (!scaled && fits && draw(mode, 0, 0, blit) != draw(mode, 0, 0, legacy)) {
+          std::cerr << "Bitmap blit: " << c.name << " differs from the row by row draw in orientation " << orientation
+                    << ", mode " << mode << "\n";
+          ok = false;
+        }
+      }
+    }
+
+    renderer.setOrientation(GfxRenderer::Portrait);
+    constexpr int kRuns = 5;
+    const auto time = [&](const auto& drawFn) {
+      const auto start = std::chrono::steady_clock::now();
+      for (int run = 0; run < kRuns; run++) {
+        draw(GfxRenderer::BW, 0, 0, drawFn);
+      }
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / kRuns;
+    };
+    const double legacyMs = time(legacy);
+    const double blitMs = time(blit);
+    report << "\n  " << c.name << ": " << legacyMs << " ms row by row, " << blitMs << " ms blitted";
+    file.close();
+  }
+  renderer.clearScreen();
+  if (ok) {
+    std::cout << "Bitmap blit: matches the reference in 4 orientations x 3 modes; Portrait BW draw" << report.str()
+              << "\n";
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const Options options = parseArgs(argc, argv);
+  const fs::path buildDir = "build/render_regression";
+  const fs::path sdRoot = buildDir / "sd";
+  const fs::path snapshotDir = buildDir / "snapshots";
+
+  fs::remove_all(snapshotDir);
+  if (!resetSdRoot(sdRoot)) {
+    return 1;
+  }
+  fs::create_directories(sdRoot / "books");
+
+  struct Book {
+    std::string name;
+    bool golden;
+  };
+  std::vector<Book> books;
+  for (const auto& entry : fs::directory_iterator(kBookDir)) {
+    if (entry.path().extension() == ".epub") {
+      fs::copy_file(entry.path(), sdRoot / "books" / entry.path().filename());
+      books.push_back({entry.path().filename().string(), true});
+    }
+  }
+  for (const auto& extra : options.extraBooks) {
+    const fs::path p(extra);
+    fs::copy_file(p, sdRoot / "books" / p.filename(), fs::copy_options::overwrite_existing);
+    books.push_back({p.filename().string(), false});
+  }
+  std::sort(books.begin(), books.end(), [](const Book& a, const Book& b) { return a.name < b.name; });
+
+  HostRenderer host;
+  GfxRenderer& renderer = host.renderer;
+
+  const bool streamingOk = checkStreamingLayout(renderer);
+  const bool tilesOk = checkTileCache(renderer);
+  const bool snapshotOk = checkPageSnapshot(renderer, sdRoot);
+  const bool displayOk = checkAsyncDisplay(renderer) && checkPageCacheDuringRefresh(renderer);
+  const bool blitOk = checkBitmapBlit(renderer, sdRoot);
+  const bool checksOk = streamingOk && tilesOk && snapshotOk && displayOk && blitOk;
+
+  const auto expected = loadGoldens(kGoldenFile);
+  std::map<std::string, std::string> actual;
+  std::map<std::string, ModeStats> totals;
+  int mismatches = 0;
+  int missing = 0;
+  uint64_t sectionBytes = 0;
+  std::map<std::string, ModeStats> blitTotals;
+  uint64_t pageCacheBytes = 0;
+  uint32_t cachedPages = 0;
+  int pageCacheMismatches = 0;
+
+  for (const auto& book : books) {
+    auto epub = std::make_shared<Epub>("/books/" + book.name, "/.crosspoint");
+    if (!epub->load()) {
+      std::cerr << "Failed to load " << book.name << "\n";
+      return 1;
+    }
+    const std::string bookKey = fs::path(book.name).stem().string();
+
+    for (size_t orientationIndex = 0; orientationIndex < std::size(kOrientations); orientationIndex++) {
+      const auto& orientation = kOrientations[orientationIndex];
+      renderer.setOrientation(orientation.orientation);
+      int marginTop, marginRight, marginBottom, marginLeft;
+      renderer.getOrientedViewableTRBL(&marginTop, &marginRight, &marginBottom, &marginLeft);
+      marginTop += kScreenMargin;
+      marginRight += kScreenMargin;
+      marginBottom += kScreenMargin;
+      marginLeft += kScreenMargin;
+      const uint16_t viewportWidth = renderer.getScreenWidth() - marginLeft - marginRight;
+      const uint16_t viewportHeight = renderer.getScreenHeight() - marginTop - marginBottom;
+
+      for (int spine = 0; spine < epub->getSpineItemsCount(); spine++) {
+        Section section(epub, spine, renderer);
+        section.setWordTableEnabled(!options.plainSections);
+        section.setXhtmlTokenizerEnabled(options.tokenizer);
+        const unsigned long layoutStart = micros();
+        if (!section.createSectionFile(BOOKERLY_14_FONT_ID, kLineCompression, kExtraParagraphSpacing,
+                                       kParagraphAlignment, viewportWidth, viewportHeight, kHyphenation,
+                                       kEmbeddedStyle)) {
+          std::cerr << "Failed to build section " << spine << " of " << book.name << "\n";
+          return 1;
+        }
+        const unsigned long layoutMicros = micros() - layoutStart;
+        const auto sectionPath =
+            sdRoot / epub->getCachePath().substr(1) / "sections" / (std::to_string(spine) + ".bin");
+        sectionBytes += fs::file_size(sectionPath);
+
+        // The previous orientation left a cache with another key next to the section file, it has to start over
+        const std::string pageCachePath = SectionPageCache::pathFor(section.getFilePath());
+        SectionPageCache pageCache;
+        if (!pageCache.open(pageCachePath, orientationIndex, section.pageCount, true) ||
+            pageCache.nextMissing(0) != (section.pageCount > 0 ? 0 : -1)) {
+          std::cerr << "Failed to start the page cache of section " << spine << "\n";
+          return 1;
+        }
+
+        for (int pageIndex = 0; pageIndex < section.pageCount; pageIndex++) {
+          section.currentPage = pageIndex;
+          const auto page = section.loadPageFromSectionFile();
+          if (!page) {
+            std::cerr << "Failed to load page " << pageIndex << " of section " << spine << "\n";
+            return 1;
+          }
+
+          std::ostringstream line;
+          line << book.name << " " << orientation.name << " s" << spine << " p" << pageIndex;
+          if (pageIndex == 0) {
+            line << " layout=" << layoutMicros << "us";
+          }
+
+          for (const auto& mode : kModes) {
+            renderer.clearScreen(mode.clearColor);
+            renderer.setRenderMode(mode.mode);
+            renderer.resetDrawPixelCalls();
+            const unsigned long start = micros();
+            page->render(renderer, BOOKERLY_14_FONT_ID, marginLeft, marginTop);
+            const unsigned long elapsed = micros() - start;
+            renderer.setRenderMode(GfxRenderer::BW);
+
+            auto& stats = totals[mode.name];
+            stats.micros += elapsed;
+            stats.pixels += renderer.getDrawPixelCalls();
+            stats.pages++;
+            line << " " << mode.name << "=" << elapsed << "us/" << renderer.getDrawPixelCalls() << "px";
+
+            const std::string key = bookKey + "/" + orientation.name + "/s" + std::to_string(spine) + "/p" +
+                                    std::to_string(pageIndex) + "/" + mode.name;
+            const std::string hash = frameHash(renderer);
+            bool mismatch = false;
+            if (book.golden) {
+              actual[key] = hash;
+              const auto it = expected.find(key);
+              if (it == expected.end()) {
+                missing++;
+              } else if (it->second != hash) {
+                mismatch = true;
+                mismatches++;
+                std::cout << "MISMATCH " << key << " expected " << it->second << " got " << hash << "\n";
+              }
+            }
+            if (options.snapshots || (mismatch && !options.update)) {
+              writePbm(snapshotDir / (key + ".pbm"), renderer.getFrameBuffer());
+            }
+          }
+
+          // Compared with the frames the cache was filled from: image pages draw from their pixel cache from the
+          // second render on, which does not dither exactly like the first decode the goldens come from
+          std::map<GfxRenderer::RenderMode, std::string> storedHashes;
+          pageCache.store(renderer, pageIndex, page->hasImages() ? SectionPageCache::FLAG_HAS_IMAGES : 0,
+                          [&](const GfxRenderer::RenderMode mode) {
+                            renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+                            renderer.setRenderMode(mode);
+                            page->render(renderer, BOOKERLY_14_FONT_ID, marginLeft, marginTop);
+                            storedHashes[mode] = frameHash(renderer);
+                          });
+          for (const auto& mode : kModes) {
+            renderer.clearScreen(0x55);
+            const unsigned long start = micros();
+            const bool drawn = pageCache.drawPlane(renderer, pageIndex, mode.mode);
+            const unsigned long elapsed = micros() - start;
+            blitTotals[mode.name].micros += elapsed;
+            blitTotals[mode.name].pages++;
+            if (!drawn || frameHash(renderer) != storedHashes[mode.mode]) {
+              pageCacheMismatches++;
+              std::cout << "PAGE CACHE MISMATCH " << book.name << " " << orientation.name << " s" << spine << " p"
+                        << pageIndex << " " << mode.name << "\n";
+            }
+          }
+          std::cout << line.str() << "\n";
+        }
+
+        // Reopened with the same key, every page is still there
+        pageCache.close();
+        if (!pageCache.open(pageCachePath, orientationIndex, section.pageCount, true) ||
+            pageCache.nextMissing(0) != -1) {
+          pageCacheMismatches++;
+          std::cout << "PAGE CACHE lost pages of " << book.name << " " << orientation.name << " s" << spine << "\n";
+        }
+        pageCacheBytes += pageCache.getFileSize();
+        cachedPages += section.pageCount;
+      }
+    }
+  }
+
+  std::cout << "\nRender totals per mode:\n";
+  for (const auto& mode : kModes) {
+    const auto& stats = totals[mode.name];
+    const double perPage = stats.pages ? static_cast<double>(stats.micros) / stats.pages : 0.0;
+    std::cout << "  " << mode.name << ": " << stats.pages << " pages, " << stats.micros << "us total, " << perPage
+              << "us/page, " << stats.pixels << " drawPixel calls\n";
+  }
+  std::cout << "Page cache blits per mode (" << cachedPages << " pages, "
+            << (cachedPages ? pageCacheBytes / cachedPages : 0) << " bytes/page for 3 planes):\n";
+  for (const auto& mode : kModes) {
+    const auto& stats = blitTotals[mode.name];
+    const auto& raster = totals[mode.name];
+    std::cout << "  " << mode.name << ": " << (stats.pages ? static_cast<double>(stats.micros) / stats.pages : 0.0)
+              << "us/page vs " << (raster.pages ? static_cast<double>(raster.micros) / raster.pages : 0.0)
+              << "us/page rasterized\n";
+  }
+  std::cout << "Section files: " << sectionBytes << " bytes" << (options.plainSections ? " (plain)" : "")
+            << (options.tokenizer ? " (XhtmlTokenizer)" : "") << "\n";
+
+  if (options.update) {
+    if (!saveGoldens(kGoldenFile, actual)) {
+      std::cerr << "Failed to write " << kGoldenFile << "\n";
+      return 1;
+    }
+    std::cout << "\nWrote " << actual.size() << " golden hashes to " << kGoldenFile << "\n";
+    return checksOk ? 0 : 1;
+  }
+
+  int stale = 0;
+  for (const auto& [key, hash] : expected) {
+    if (actual.find(key) == actual.end()) {
+      stale++;
+    }
+  }
+
+  std::cout << "\n" << actual.size() << " frames checked, " << mismatches << " mismatched, " << missing
+            << " without golden, " << stale << " goldens not produced, " << pageCacheMismatches
+            << " page cache mismatches\n";
+  if (mismatches > 0) {
+    std::cout << "Mismatching frames were written to " << snapshotDir << "\n";
+  }
+  return checksOk && mismatches == 0 && missing == 0 && stale == 0 && pageCacheMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/binary_log/BinaryLogTest.cpp"
+)
+
+build_host_harness binary_log BinaryLogTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
+
+# The binary log records written by the harness must decode to the text logPrintf would have printed
+python3 scripts/binary_log.py table "$BUILD_DIR/log_table.json" test/binary_log >/dev/null
+python3 scripts/binary_log.py decode "$BUILD_DIR/log_table.json" "$BUILD_DIR/binlog.bin" |
+  diff -u "$BUILD_DIR/binlog.txt" -
+echo "Binary log: decoded records match"
@@ -0,0 +1,15 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/download_pipeline/DownloadPipelineTest.cpp"
+  "$ROOT_DIR/lib/miniz/miniz.c"
+  "$ROOT_DIR/src/network/DownloadPipeline.cpp"
+)
+
+build_host_harness download_pipeline DownloadPipelineTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
@@ -0,0 +1,34 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/epub_parsing/EpubParsingTest.cpp"
+  "$ROOT_DIR/test/host/HostHeap.cpp"
+  "$ROOT_DIR/lib/expat/xmlparse.c"
+  "$ROOT_DIR/lib/expat/xmlrole.c"
+  "$ROOT_DIR/lib/expat/xmltok.c"
+  "$ROOT_DIR/lib/miniz/miniz.c"
+  "$ROOT_DIR/lib/picojpeg/picojpeg.c"
+  "$ROOT_DIR/lib/Epub/Epub.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/BookMetadataCache.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/css/CssParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/htmlEntities.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/ContainerParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/ContentOpfParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/TocNavParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/TocNcxParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/XhtmlTokenizer.cpp"
+  "$ROOT_DIR/lib/FsHelpers/FsHelpers.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/BitmapHelpers.cpp"
+  "$ROOT_DIR/lib/JpegToBmpConverter/JpegToBmpConverter.cpp"
+  "$ROOT_DIR/lib/PngToBmpConverter/PngToBmpConverter.cpp"
+  "$ROOT_DIR/lib/Utf8/Utf8.cpp"
+  "$ROOT_DIR/lib/ZipFile/ZipFile.cpp"
+)
+
+build_host_harness epub_parsing EpubParsingTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
@@ -1,32 +1,18 @@
 #!/usr/bin/env bash
 set -euo pipefail
 
-ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
-BUILD_DIR="$ROOT_DIR/build/hyphenation_eval"
-BINARY="$BUILD_DIR/HyphenationEvaluationTest"
-
-mkdir -p "$BUILD_DIR"
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
 
 SOURCES=(
   "$ROOT_DIR/test/hyphenation_eval/HyphenationEvaluationTest.cpp"
   "$ROOT_DIR/lib/Epub/Epub/hyphenation/Hyphenator.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/HyphenationPack.cpp"
   "$ROOT_DIR/lib/Epub/Epub/hyphenation/LanguageRegistry.cpp"
   "$ROOT_DIR/lib/Epub/Epub/hyphenation/LiangHyphenation.cpp"
   "$ROOT_DIR/lib/Epub/Epub/hyphenation/HyphenationCommon.cpp"
   "$ROOT_DIR/lib/Utf8/Utf8.cpp"
 )
 
-CXXFLAGS=(
-  -std=c++20
-  -O2
-  -Wall
-  -Wextra
-  -pedantic
-  -I"$ROOT_DIR"
-  -I"$ROOT_DIR/lib"
-  -I"$ROOT_DIR/lib/Utf8"
-)
-
-c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" -o "$BINARY"
+build_host_harness hyphenation_eval HyphenationEvaluationTest "${SOURCES[@]}"
 
 "$BINARY" "$@"
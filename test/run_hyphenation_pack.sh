@@ -0,0 +1,22 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/hyphenation_pack/HyphenationPackTest.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/HyphenationCommon.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/HyphenationPack.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/Hyphenator.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/LanguageRegistry.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/LiangHyphenation.cpp"
+  "$ROOT_DIR/lib/Utf8/Utf8.cpp"
+)
+
+build_host_harness hyphenation_pack HyphenationPackTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+# Pattern pack made from the built-in English trie, checked against it by the harness
+python3 scripts/generate_hyphenation_trie.py --input lib/Epub/Epub/hyphenation/generated/hyph-en.trie.h \
+  --output "$BUILD_DIR/hyphenation/en.hyph" --min-prefix 3 --min-suffix 3 >/dev/null
+"$BINARY" "$@"
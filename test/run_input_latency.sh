@@ -0,0 +1,14 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/input_latency/InputLatencyTest.cpp"
+  "$ROOT_DIR/src/InputLatency.cpp"
+)
+
+build_host_harness input_latency InputLatencyTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
@@ -0,0 +1,15 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/koreader_sync/KOReaderSyncTest.cpp"
+  "$ROOT_DIR/lib/KOReaderSync/KOReaderDocumentId.cpp"
+  "$ROOT_DIR/lib/KOReaderSync/KOReaderProgressQueue.cpp"
+)
+
+build_host_harness koreader_sync KOReaderSyncTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
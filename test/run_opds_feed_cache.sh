@@ -0,0 +1,20 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/opds_feed_cache/OpdsFeedCacheTest.cpp"
+  "$ROOT_DIR/test/host/HostHeap.cpp"
+  "$ROOT_DIR/lib/expat/xmlparse.c"
+  "$ROOT_DIR/lib/expat/xmlrole.c"
+  "$ROOT_DIR/lib/expat/xmltok.c"
+  "$ROOT_DIR/lib/OpdsParser/OpdsFeedCache.cpp"
+  "$ROOT_DIR/lib/OpdsParser/OpdsParser.cpp"
+  "$ROOT_DIR/lib/OpdsParser/OpdsStream.cpp"
+)
+
+build_host_harness opds_feed_cache OpdsFeedCacheTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
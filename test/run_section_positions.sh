@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/section_positions/SectionPositionsTest.cpp"
+  "$ROOT_DIR/lib/expat/xmlparse.c"
+  "$ROOT_DIR/lib/expat/xmlrole.c"
+  "$ROOT_DIR/lib/expat/xmltok.c"
+  "$ROOT_DIR/lib/miniz/miniz.c"
+  "$ROOT_DIR/lib/picojpeg/picojpeg.c"
+  "$ROOT_DIR/lib/Epub/Epub.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/BookMetadataCache.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/Page.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/ParsedText.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/Section.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/SectionPositionTable.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/SectionWordTable.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/blocks/ImageBlock.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/blocks/TextBlock.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/converters/ImageDecoderFactory.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/converters/ImageToFramebufferDecoder.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/converters/JpegToFramebufferConverter.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/converters/PngToFramebufferConverter.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/css/CssParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/htmlEntities.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/HyphenationCommon.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/HyphenationPack.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/Hyphenator.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/LanguageRegistry.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/hyphenation/LiangHyphenation.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/ChapterHtmlSlimParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/ContainerParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/ContentOpfParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/TocNavParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/TocNcxParser.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/parsers/XhtmlTokenizer.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFont.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFontFamily.cpp"
+  "$ROOT_DIR/lib/FsHelpers/FsHelpers.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/Bitmap.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/BitmapHelpers.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/GfxRenderer.cpp"
+  "$ROOT_DIR/lib/JpegToBmpConverter/JpegToBmpConverter.cpp"
+  "$ROOT_DIR/lib/PngToBmpConverter/PngToBmpConverter.cpp"
+  "$ROOT_DIR/lib/Utf8/Utf8.cpp"
+  "$ROOT_DIR/lib/ZipFile/ZipFile.cpp"
+  "$ROOT_DIR/lib/hal/HalDisplay.cpp"
+  "$ROOT_DIR/lib/PackBits/PackBits.cpp"
+  "$ROOT_DIR/src/util/StringUtils.cpp"
+)
+
+build_host_harness section_positions SectionPositionsTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/serial_automation/SerialAutomationTest.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFont.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFontFamily.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/Bitmap.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/BitmapHelpers.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/GfxRenderer.cpp"
+  "$ROOT_DIR/lib/PackBits/PackBits.cpp"
+  "$ROOT_DIR/lib/Utf8/Utf8.cpp"
+  "$ROOT_DIR/lib/hal/HalDisplay.cpp"
+  "$ROOT_DIR/src/InputLatency.cpp"
+  "$ROOT_DIR/src/RenderTrace.cpp"
+  "$ROOT_DIR/src/SerialAutomation.cpp"
+)
+
+build_host_harness serial_automation SerialAutomationTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
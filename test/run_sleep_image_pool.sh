@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/sleep_image_pool/SleepImagePoolTest.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFont.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFontFamily.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/Bitmap.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/BitmapHelpers.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/GfxRenderer.cpp"
+  "$ROOT_DIR/lib/PackBits/PackBits.cpp"
+  "$ROOT_DIR/lib/Utf8/Utf8.cpp"
+  "$ROOT_DIR/lib/hal/HalDisplay.cpp"
+  "$ROOT_DIR/src/SectionPageCache.cpp"
+  "$ROOT_DIR/src/SleepImagePool.cpp"
+  "$ROOT_DIR/src/util/StringUtils.cpp"
+)
+
+build_host_harness sleep_image_pool SleepImagePoolTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
@@ -0,0 +1,15 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+source "$(dirname "${BASH_SOURCE[0]}")/host/harness.sh"
+
+SOURCES=(
+  "$ROOT_DIR/test/wifi_reconnect/WifiReconnectTest.cpp"
+  "$ROOT_DIR/src/WifiCredentialStore.cpp"
+  "$ROOT_DIR/src/network/WifiConnector.cpp"
+)
+
+build_host_harness wifi_reconnect WifiReconnectTest "${SOURCES[@]}"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
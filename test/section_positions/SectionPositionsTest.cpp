@@ -0,0 +1,316 @@
+// Host harness for the positions recorded in section files. A synthetic chapter must record the page of every TOC
+// anchor and element path and keep them through the section file, including one thinned out to fit the table. Every
+// page of the test EPUBs, in all four orientations, must map to an element path that leads back to it; how far off
+// that is against going to the chapter start, and the lookup cost, are reported.
+
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/Section.h>
+#include <Epub/SectionPositionTable.h>
+#include <Epub/parsers/ChapterHtmlSlimParser.h>
+#include <HalStorage.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test/host/HostHarness.h"
+#include "test/host/HostRenderer.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kBookDir = "test/epubs";
+
+// Lays a chapter out the way Section does, without writing pages, and returns the page count
+int layoutChapter(GfxRenderer& renderer, const fs::path& sdRoot, const std::string& markup,
+                  SectionPositionTable* positions) {
+  {
+    std::ofstream out(sdRoot / "positions.xhtml", std::ios::binary);
+    out << markup;
+  }
+  const std::string path = "/positions.xhtml";
+  int pages = 0;
+  ChapterHtmlSlimParser parser(
+      nullptr, path, renderer, BOOKERLY_14_FONT_ID, kLineCompression, kExtraParagraphSpacing, kParagraphAlignment, 460,
+      700, kHyphenation, [&pages](std::unique_ptr<Page>) { pages++; }, false, "", "/positions_img_");
+  parser.setPositionTable(positions);
+  return parser.parseAndBuildPages() ? pages : -1;
+}
+
+// Anchors of every kind must resolve to the page their element starts on, which is the last page of the chapter cut
+// off right after that element. Element paths must come back to the page they were taken from, also when written the
+// way KOReader does, and must survive the section file. Lookups are timed.
+bool checkSectionPositions(GfxRenderer& renderer, const fs::path& sdRoot) {
+  constexpr int kParts = 24;
+  constexpr int kParagraphs = 9;  // every element fits in the table
+  static const char* const vocabulary[] = {"anchor", "page",   "chapter", "position", "table",
+                                           "of",     "the",    "reader",  "sync",     "extraordinarily"};
+  const std::string head = "<?xml version=\"1.0\"?><html><head><title>Positions</title></head><body>";
+  const std::string tail = "</body></html>";
+
+  renderer.setOrientation(GfxRenderer::Portrait);
+  std::vector<std::string> anchorElements;
+  std::vector<std::string> parts;
+  uint32_t seed = 7;
+  for (int k = 0; k < kParts; k++) {
+    const std::string id = "part" + std::to_string(k);
+    const std::string title = "Part " + std::to_string(k);
+    if (k % 3 == 0) {
+      anchorElements.push_back("<h2 id=\"" + id + "\">" + title + "</h2>");
+    } else if (k % 3 == 1) {
+      anchorElements.push_back("<p><a id=\"" + id + "\"></a>" + title + " opens here.</p>");
+    } else {
+      anchorElements.push_back("<div id=\"" + id + "\"><p>" + title + "</p></div>");
+    }
+    // Ids the table of contents does not point at must not take up table entries
+    std::string body;
+    for (int i = 0; i < kParagraphs; i++) {
+      seed = seed * 1103515245u + 12345u;
+      const int words = 3 + static_cast<int>((seed >> 16) % 60);
+      body += "<p id=\"p" + std::to_string(k) + "_" + std::to_string(i) + "\">";
+      for (int w = 0; w < words; w++) {
+        seed = seed * 1103515245u + 12345u;
+        body += vocabulary[(seed >> 16) % std::size(vocabulary)];
+        body += ' ';
+      }
+      body += "</p>";
+    }
+    parts.push_back(body);
+  }
+
+  std::string chapter = head;
+  for (int k = 0; k < kParts; k++) {
+    chapter += anchorElements[k] + parts[k];
+  }
+  chapter += tail;
+
+  SectionPositionTable positions;
+  for (int k = 0; k < kParts; k++) {
+    positions.addAnchorTarget("part" + std::to_string(k));
+  }
+  positions.addAnchorTarget("missing");
+  const int pageCount = layoutChapter(renderer, sdRoot, chapter, &positions);
+  const int plainPageCount = layoutChapter(renderer, sdRoot, chapter, nullptr);
+  if (pageCount <= 1 || pageCount != plainPageCount) {
+    std::cout << "Section positions: tracking changed the layout (" << pageCount << " vs " << plainPageCount
+              << " pages)\n";
+    return false;
+  }
+
+  int failures = 0;
+  const auto fail = [&failures](const std::string& what) {
+    if (failures++ < 5) {
+      std::cout << "Section positions: " << what << "\n";
+    }
+  };
+  if (positions.anchorCount() != kParts || positions.getPageForAnchor("missing") != -1) {
+    fail("recorded " + std::to_string(positions.anchorCount()) + " anchors");
+  }
+  if (positions.pathCount() != kParts * (kParagraphs + 1)) {
+    fail("kept " + std::to_string(positions.pathCount()) + " element paths");
+  }
+
+  for (int k = 0; k < kParts; k++) {
+    std::string prefix = head;
+    for (int j = 0; j < k; j++) {
+      prefix += anchorElements[j] + parts[j];
+    }
+    const int expected = layoutChapter(renderer, sdRoot, prefix + anchorElements[k] + tail, nullptr) - 1;
+    const int anchorPage = positions.getPageForAnchor("part" + std::to_string(k));
+    if (anchorPage != expected) {
+      fail("part" + std::to_string(k) + " on page " + std::to_string(anchorPage) + ", expected " +
+           std::to_string(expected));
+    }
+    // The anchored element looked up by path, the way a KOReader position would point at it
+    const std::string element = k % 3 == 0 ? "/body/h2[" + std::to_string(k / 3 + 1) + "]"
+                                : k % 3 == 2 ? "/body[1]/div[" + std::to_string(k / 3 + 1) + "]/p/text().0"
+                                             : "";
+    if (!element.empty() && positions.getPageForPath(element) != expected) {
+      fail(element + " on page " + std::to_string(positions.getPageForPath(element)) + ", expected " +
+           std::to_string(expected));
+    }
+  }
+
+  const auto roundTrip = [&](const SectionPositionTable& table, const int pages) {
+    for (int page = 0; page < pages; page++) {
+      const std::string path = table.getPathForPage(page);
+      const int back = table.getPageForPath(path);
+      // Pages in between must all continue the same element
+      bool continued = back >= 0 && back <= page;
+      for (int between = back + 1; continued && between < page; between++) {
+        continued = table.getPathForPage(between) == path;
+      }
+      if (path.empty() || !continued || table.getPageForPath(path + "/text().3") != back) {
+        fail("page " + std::to_string(page) + " came back as " + std::to_string(back) + " via " + path);
+      }
+    }
+  };
+  roundTrip(positions, pageCount);
+
+  SectionPositionTable loaded;
+  {
+    FsFile file;
+    if (!Storage.openFileForWrite("TEST", "/positions.bin", file) || !positions.serialize(file)) {
+      fail("could not write the table");
+    }
+    file.close();
+    if (!Storage.openFileForRead("TEST", "/positions.bin", file) || !loaded.deserialize(file)) {
+      fail("could not read the table back");
+    }
+    file.close();
+  }
+  for (int k = 0; k < kParts; k++) {
+    const std::string id = "part" + std::to_string(k);
+    if (loaded.getPageForAnchor(id) != positions.getPageForAnchor(id)) {
+      fail(id + " changed in the file");
+    }
+  }
+  roundTrip(loaded, pageCount);
+
+  // A chapter with more elements than the table holds is thinned out; paragraphs that were dropped are found by order
+  constexpr int kLongParagraphs = 1500;
+  std::string longChapter = head;
+  for (int i = 0; i < kLongParagraphs; i++) {
+    longChapter += "<p>" + std::string(vocabulary[i % std::size(vocabulary)]) + " " + std::to_string(i) + "</p>";
+  }
+  SectionPositionTable thinned;
+  const int longPageCount = layoutChapter(renderer, sdRoot, longChapter + tail, &thinned);
+  if (thinned.pathCount() > SectionPositionTable::MAX_PATHS ||
+      thinned.pathCount() <= SectionPositionTable::MAX_PATHS / 4) {
+    fail("long chapter kept " + std::to_string(thinned.pathCount()) + " element paths");
+  }
+  roundTrip(thinned, longPageCount);
+
+  constexpr int kLookups = 20000;
+  std::vector<std::string> lookups;
+  for (int i = 0; i < 64; i++) {
+    lookups.push_back("/body/p[" + std::to_string(1 + i * kLongParagraphs / 64) + "]/text().12");
+  }
+  int lastPage = 0;
+  for (const auto& path : lookups) {
+    const int page = thinned.getPageForPath(path);
+    if (page < lastPage || page >= longPageCount) {
+      fail(path + " on page " + std::to_string(page) + " after page " + std::to_string(lastPage));
+    }
+    lastPage = std::max(lastPage, page);
+  }
+  int checksum = 0;
+  const unsigned long start = micros();
+  for (int i = 0; i < kLookups; i++) {
+    checksum += thinned.getPageForPath(lookups[i % lookups.size()]);
+    checksum += positions.getPageForAnchor("part" + std::to_string(i % kParts));
+  }
+  const double lookupMicros = static_cast<double>(micros() - start) / (2 * kLookups);
+
+  if (failures > 0) {
+    std::cout << "Section positions: " << failures << " failures\n";
+    return false;
+  }
+  std::cout << "Section positions: " << kParts << " anchors on the expected pages of " << pageCount << ", "
+            << positions.pathCount() << " element paths round-trip, " << kLongParagraphs << " paragraphs thinned to "
+            << thinned.pathCount() << ", " << lookupMicros << "us per lookup (" << checksum << ")\n";
+  return true;
+}
+
+struct PositionStats {
+  uint32_t pages = 0;
+  uint32_t exact = 0;
+  uint32_t continued = 0;
+  uint32_t unmapped = 0;
+  uint32_t failed = 0;
+  uint64_t pagesBack = 0;       // error of the recorded paths on pages that continue an element
+  uint64_t pagesFromStart = 0;  // error of going to the start of the chapter, as positions used to
+  uint64_t lookupMicros = 0;
+  uint32_t lookups = 0;
+};
+
+// Every page of a built section maps to an element path, which must lead back to the page that element starts on
+void checkSectionRoundTrip(Section& section, const std::string& label, PositionStats& stats) {
+  for (int page = 0; page < section.pageCount; page++) {
+    const unsigned long start = micros();
+    const std::string path = section.getElementPathForPage(page);
+    const int back = path.empty() ? -1 : section.getPageForElementPath(path);
+    stats.lookupMicros += micros() - start;
+    stats.lookups += path.empty() ? 1 : 2;
+    stats.pages++;
+    stats.pagesFromStart += page;
+    if (path.empty()) {
+      stats.unmapped++;
+      stats.pagesBack += page;
+    } else if (back == page) {
+      stats.exact++;
+    } else if (back >= 0 && back < page) {
+      stats.continued++;
+      stats.pagesBack += page - back;
+    } else {
+      stats.failed++;
+      std::cout << "POSITION MISMATCH " << label << " p" << page << " via " << path << " came back as " << back
+                << "\n";
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  const fs::path sdRoot = "build/section_positions/sd";
+  if (!resetSdRoot(sdRoot)) {
+    return 1;
+  }
+  fs::create_directories(sdRoot / "books");
+  HostRenderer host;
+  GfxRenderer& renderer = host.renderer;
+
+  const bool positionsOk = checkSectionPositions(renderer, sdRoot);
+
+  std::vector<std::string> books;
+  for (const auto& entry : fs::directory_iterator(kBookDir)) {
+    if (entry.path().extension() == ".epub") {
+      fs::copy_file(entry.path(), sdRoot / "books" / entry.path().filename());
+      books.push_back(entry.path().filename().string());
+    }
+  }
+  std::sort(books.begin(), books.end());
+
+  PositionStats stats;
+  for (const auto& book : books) {
+    auto epub = std::make_shared<Epub>("/books/" + book, "/.crosspoint");
+    if (!epub->load()) {
+      std::cerr << "Failed to load " << book << "\n";
+      return 1;
+    }
+    for (const auto& orientation : kOrientations) {
+      renderer.setOrientation(orientation.orientation);
+      int marginTop, marginRight, marginBottom, marginLeft;
+      renderer.getOrientedViewableTRBL(&marginTop, &marginRight, &marginBottom, &marginLeft);
+      const uint16_t viewportWidth = renderer.getScreenWidth() - marginLeft - marginRight - 2 * kScreenMargin;
+      const uint16_t viewportHeight = renderer.getScreenHeight() - marginTop - marginBottom - 2 * kScreenMargin;
+
+      for (int spine = 0; spine < epub->getSpineItemsCount(); spine++) {
+        Section section(epub, spine, renderer);
+        if (!section.createSectionFile(BOOKERLY_14_FONT_ID, kLineCompression, kExtraParagraphSpacing,
+                                       kParagraphAlignment, viewportWidth, viewportHeight, kHyphenation,
+                                       kEmbeddedStyle)) {
+          std::cerr << "Failed to build section " << spine << " of " << book << "\n";
+          return 1;
+        }
+        checkSectionRoundTrip(section, book + " " + orientation.name + " s" + std::to_string(spine), stats);
+      }
+    }
+  }
+
+  std::cout << "Section positions: " << stats.pages << " pages, " << stats.exact << " start an element, "
+            << stats.continued << " continue one, " << stats.unmapped << " unmapped, " << stats.failed << " failed; "
+            << (stats.pages ? static_cast<double>(stats.pagesBack) / stats.pages : 0.0) << " pages off on average vs "
+            << (stats.pages ? static_cast<double>(stats.pagesFromStart) / stats.pages : 0.0)
+            << " from the chapter start, "
+            << (stats.lookups ? static_cast<double>(stats.lookupMicros) / stats.lookups : 0.0)
+            << "us per lookup from the section file\n";
+  return positionsOk && stats.failed == 0 ? 0 : 1;
+}
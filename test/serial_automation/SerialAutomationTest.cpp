@@ -0,0 +1,95 @@
+// Host harness for SerialAutomation: a scripted page turn is replayed over the automation protocol against a stand-in
+// reader, and the replies, the IDLE timing report and the screenshot framing are checked.
+
+#include <HalDisplay.h>
+#include <HalGPIO.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/RenderTrace.h"
+#include "src/SerialAutomation.h"
+#include "test/host/HostHarness.h"
+#include "test/host/HostRenderer.h"
+
+namespace {
+
+// Replays a page turn over the automation protocol. RIGHT stands in for a reader: it requests a render that starts
+// 5 ms later, draws, refreshes a panel with a 30 ms waveform and saves progress.
+bool checkSerialAutomation(GfxRenderer& renderer, HalDisplay& display) {
+  ScriptedSerial serial;
+  std::vector<std::thread> renders;
+  const auto setButton = [&](const uint8_t button, const bool pressed) {
+    if (button != HalGPIO::BTN_RIGHT || !pressed) {
+      return;
+    }
+    RENDER_TRACE.onRequest();
+    renders.emplace_back([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      RENDER_TRACE.onRenderStart(micros());
+      renderer.clearScreen();
+      renderer.drawText(BOOKERLY_14_FONT_ID, 20, 40, "Page two");
+      renderer.displayBuffer();
+      RENDER_TRACE.addSaveTime(2000);
+      RENDER_TRACE.onRenderEnd(micros());
+    });
+  };
+  std::string opened;
+  SerialAutomation automation(serial, display, setButton, [&](const std::string& path) { opened = path; }, "1.2.3");
+
+  const auto run = [&](const std::string& commands, const std::string& until) {
+    serial.tx.clear();
+    serial.rx += commands;
+    const auto start = std::chrono::steady_clock::now();
+    while (serial.tx.find(until) == std::string::npos &&
+           std::chrono::steady_clock::now() - start < std::chrono::seconds(3)) {
+      automation.poll();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return serial.tx;
+  };
+
+  EInkDisplay::setRefreshLatency(EInkDisplay::FAST_REFRESH, 30);
+  run("CMD:WAIT_IDLE\n", "IDLE:");  // Starts the first step
+  const std::string replies = run("CMD:VERSION\nCMD:OPEN /books/a b.epub\nCMD:TAP NOPE\n", "ERR:");
+  const std::string turn = run("CMD:TAP RIGHT\nCMD:WAIT_IDLE 2000\n", "IDLE:");
+  const std::string quiet = run("CMD:WAIT_IDLE\n", "IDLE:");
+  const std::string screenshot = run("CMD:SCREENSHOT\n", "SCREENSHOT_END\n");
+  EInkDisplay::setRefreshLatency(EInkDisplay::FAST_REFRESH, 0);
+  for (auto& render : renders) {
+    render.join();
+  }
+
+  long inputToRender = 0;
+  unsigned renderUs = 0, displayUs = 0, saveUs = 0, renderCount = 0;
+  unsigned long waitedMs = 0;
+  const size_t idleAt = turn.find("IDLE:");
+  const bool parsed = idleAt != std::string::npos &&
+                      sscanf(turn.c_str() + idleAt, "IDLE:%ld,%u,%u,%u,%u,%lu", &inputToRender, &renderUs, &displayUs,
+                             &saveUs, &renderCount, &waitedMs) == 6;
+  const std::string screenshotHeader = "SCREENSHOT_START:" + std::to_string(HalDisplay::BUFFER_SIZE) + "\n";
+  const bool ok = replies == "VERSION:1.2.3\nOK:OPEN\nERR:Unknown button 'NOPE'\n" && opened == "/books/a b.epub" &&
+                  turn.compare(0, 7, "OK:TAP\n") == 0 && parsed && inputToRender >= 5000 && displayUs >= 30000 &&
+                  renderUs >= displayUs && saveUs == 2000 && renderCount == 1 &&
+                  quiet.rfind("IDLE:-1,0,0,0,0,", 0) == 0 && screenshot.rfind(screenshotHeader, 0) == 0 &&
+                  screenshot.size() == screenshotHeader.size() + HalDisplay::BUFFER_SIZE + strlen("SCREENSHOT_END\n");
+  if (!ok) {
+    std::cout << "Serial automation: unexpected replies\n" << replies << turn << quiet;
+    return false;
+  }
+  std::cout << "Serial automation: scripted page turn reports " << inputToRender << " us to render, " << renderUs
+            << " us render, " << displayUs << " us display, " << saveUs << " us save\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  HostRenderer host;
+  return checkSerialAutomation(host.renderer, host.display) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// Host harness for SleepImagePool: /sleep must be indexed once and answered from the index afterwards, changes to the
+// directory must be picked up, and a full screen sleep frame must blit back from its frame cache like it decoded.
+
+#include <Bitmap.h>
+#include <HalStorage.h>
+#include <SDCardManager.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include "src/SectionPageCache.h"
+#include "src/SleepImagePool.h"
+#include "test/host/HostHarness.h"
+#include "test/host/HostRenderer.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// SleepImagePool must index /sleep once and afterwards answer from the index without parsing or writing anything, pick
+// up added, removed and replaced images, and drop the frames of removed ones. A full screen sleep image is also drawn
+// the way SleepActivity does, three decodes, and blitted back from its frame cache.
+bool checkSleepImagePool(GfxRenderer& renderer, const fs::path& sdRoot) {
+  const fs::path sleepDir = sdRoot / "sleep";
+  fs::create_directories(sleepDir);
+  constexpr int kImages = 150;
+  for (int i = 0; i < kImages; i++) {
+    writeTestBmp(sleepDir / ("image" + std::to_string(i) + ".bmp"), 120, 160, i);
+  }
+  std::ofstream(sleepDir / "broken.bmp") << "not a bitmap";
+  std::ofstream(sleepDir / "notes.txt") << "not an image";
+  std::ofstream(sleepDir / ".hidden.bmp") << "hidden";
+
+  auto& writeStats = SDCardManager::getInstance().writeStats;
+  SleepImagePool pool;
+  auto timed = [&](double& ms) {
+    writeStats = {};
+    const auto start = std::chrono::steady_clock::now();
+    const bool loaded = pool.load();
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return loaded;
+  };
+  double coldMs = 0, warmMs = 0, changedMs = 0;
+  if (!timed(coldMs) || pool.getImages().size() != kImages) {
+    std::cerr << "Sleep image pool: indexed " << pool.getImages().size() << " images, expected " << kImages << "\n";
+    return false;
+  }
+  const SleepImagePool::Image removed = pool.getImages().front();
+  std::ofstream(sdRoot / (SleepImagePool::framePath(removed).c_str() + 1)) << "frame";
+
+  if (!timed(warmMs) || pool.getImages().size() != kImages || writeStats.bytes != 0) {
+    std::cerr << "Sleep image pool: unchanged directory gave " << pool.getImages().size() << " images and wrote "
+              << writeStats.bytes << " bytes\n";
+    return false;
+  }
+
+  // Same size, newer write time, no longer a bitmap: only the write time can tell
+  const fs::path replaced = sleepDir / "image7.bmp";
+  const auto replacedSize = fs::file_size(replaced);
+  std::ofstream(replaced, std::ios::binary) << std::string(replacedSize, 'x');
+  fs::last_write_time(replaced, fs::last_write_time(replaced) + std::chrono::seconds(10));
+  fs::remove(sleepDir / removed.name);
+  writeTestBmp(sleepDir / "added.bmp", 64, 64, 1);
+  if (!timed(changedMs)) {
+    return false;
+  }
+  std::set<std::string> names;
+  for (const auto& image : pool.getImages()) {
+    names.insert(image.name);
+  }
+  if (names.size() != kImages - 1 || !names.count("added.bmp") || names.count("image7.bmp") ||
+      names.count(removed.name) || fs::exists(sdRoot / (SleepImagePool::framePath(removed).c_str() + 1))) {
+    std::cerr << "Sleep image pool: directory changes were not picked up (" << names.size() << " images)\n";
+    return false;
+  }
+
+  // A portrait sleep screen sized image: three drawBitmap passes against three frame cache blits
+  renderer.setOrientation(GfxRenderer::Portrait);
+  const int width = renderer.getScreenWidth(), height = renderer.getScreenHeight();
+  writeTestBmp(sleepDir / "full.bmp", width, height, 3);
+  FsFile file;
+  if (!Storage.openFileForRead("TEST", "/sleep/full.bmp", file)) {
+    return false;
+  }
+  Bitmap bitmap(file, true);
+  if (bitmap.parseHeaders() != BmpReaderError::Ok) {
+    std::cerr << "Sleep image pool: could not parse the full screen BMP\n";
+    return false;
+  }
+  const GfxRenderer::RenderMode modes[] = {GfxRenderer::BW, GfxRenderer::GRAYSCALE_LSB, GfxRenderer::GRAYSCALE_MSB};
+  const auto renderPlane = [&](const GfxRenderer::RenderMode mode) {
+    bitmap.rewindToData();
+    renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+    renderer.setRenderMode(mode);
+    renderer.drawBitmap(bitmap, 0, 0, width, height);
+    renderer.setRenderMode(GfxRenderer::BW);
+  };
+  std::string expected[3];
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 3; i++) {
+    renderPlane(modes[i]);
+    expected[i] = frameHash(renderer);
+  }
+  const double decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  SectionPageCache frames;
+  const std::string framePath = SleepImagePool::framePath({"full.bmp"});
+  if (!frames.open(framePath, 1, 1, true) || !frames.store(renderer, 0, 0, renderPlane)) {
+    std::cerr << "Sleep image pool: could not store the sleep frame\n";
+    return false;
+  }
+  const auto frameBytes = frames.getFileSize();
+  frames.close();
+  start = std::chrono::steady_clock::now();
+  bool blitOk = frames.open(framePath, 1, 1, true);
+  for (int i = 0; i < 3 && blitOk; i++) {
+    blitOk = frames.drawPlane(renderer, 0, modes[i]) &&
+             frameHash(renderer) == expected[i];
+  }
+  const double blitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  file.close();
+  renderer.clearScreen();
+  if (!blitOk) {
+    std::cerr << "Sleep image pool: cached sleep frame does not match the decoded one\n";
+    return false;
+  }
+
+  std::cout << "Sleep image pool: " << kImages << " images indexed in " << coldMs << " ms, reused in " << warmMs
+            << " ms, updated in " << changedMs << " ms; full screen frame " << decodeMs << " ms decoded vs "
+            << blitMs << " ms from a " << frameBytes << " byte frame cache\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path sdRoot = "build/sleep_image_pool/sd";
+  if (!resetSdRoot(sdRoot)) {
+    return 1;
+  }
+  HostRenderer host;
+  return checkSleepImagePool(host.renderer, sdRoot) ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+// Host harness for WifiConnector and WifiCredentialStore: a remembered network must reconnect straight to its access
+// point, reuse its DHCP lease only while it is current and scan again once the access point moved. Links must
+// survive wifi.bin, and files written by older versions must still load.
+
+#include <HalStorage.h>
+#include <Serialization.h>
+
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "src/WifiCredentialStore.h"
+#include "src/network/WifiConnector.h"
+#include "test/host/HostHarness.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Radio stand-in for WifiConnector: one access point that answers on its own BSSID and channel only. A connect
+// without a link scans every channel and always finds it.
+struct FakeWifiDriver final : WifiDriver {
+  WifiLink accessPoint;
+  std::string password;
+  Status current = Status::Connecting;
+  int directedConnects = 0;
+  int scanningConnects = 0;
+  int leasesReused = 0;
+
+  void resetCounts() {
+    current = Status::Connecting;
+    directedConnects = scanningConnects = leasesReused = 0;
+  }
+  void connect(const char*, const char* pass, const WifiLink* link) override {
+    if (link) {
+      directedConnects++;
+      leasesReused += link->lease.ip != 0;
+    } else {
+      scanningConnects++;
+    }
+    if (link && !link->sameAccessPoint(accessPoint)) {
+      current = Status::NoNetwork;
+    } else {
+      current = password == pass ? Status::Connected : Status::Failed;
+    }
+  }
+  Status status() override { return current; }
+  void disconnect() override { current = Status::Connecting; }
+  bool getLink(WifiLink& link) override {
+    link = accessPoint;
+    return current == Status::Connected;
+  }
+};
+
+WifiConnector::Result connectUntilDone(WifiConnector& connector, const WifiLink& link, const std::string& password) {
+  connector.begin("Home", password, link);
+  for (int i = 0; i < 10; i++) {
+    const auto result = connector.update();
+    if (result != WifiConnector::Result::Pending) {
+      return result;
+    }
+  }
+  return WifiConnector::Result::Pending;
+}
+
+// A network reached before must reconnect straight to its access point, with its lease only while half of it is left,
+// fall back to scanning once that access point is gone, and the link must survive a round trip through wifi.bin (and
+// files from before it had links or lease times must load).
+bool checkWifiReconnect(const fs::path& sdRoot) {
+  FakeWifiDriver driver;
+  driver.password = "secret";
+  // 192.168.1.2 via 192.168.1.1, as IPAddress stores them, on a day-long lease granted a minute ago
+  const auto now = static_cast<uint32_t>(time(nullptr));
+  driver.accessPoint = WifiLink{{0x10, 0x20, 0x30, 0x40, 0x50, 0x60},
+                                6,
+                                {0x0201a8c0, 0x0101a8c0, 0x00ffffff, 0x0101a8c0, 86400, now - 60}};
+  WifiConnector connector(driver);
+
+  WIFI_STORE.clearAll();
+  WIFI_STORE.addCredential("Home", "secret");
+  const bool firstOk = connectUntilDone(connector, WIFI_STORE.findCredential("Home")->link, "secret") ==
+                           WifiConnector::Result::Connected &&
+                       driver.scanningConnects == 1 && driver.directedConnects == 0;
+  WIFI_STORE.setLink("Home", connector.getLink());
+
+  WIFI_STORE.loadFromFile();
+  const WifiLink remembered = WIFI_STORE.findCredential("Home")->link;
+  const bool storedOk = remembered.sameAccessPoint(driver.accessPoint) && remembered.lease.ip == 0x0201a8c0 &&
+                        remembered.lease.dns == 0x0101a8c0 && remembered.lease.seconds == 86400 &&
+                        remembered.lease.obtainedAt == now - 60;
+
+  driver.resetCounts();
+  const bool directedOk = connectUntilDone(connector, remembered, "secret") == WifiConnector::Result::Connected &&
+                          driver.directedConnects == 1 && driver.scanningConnects == 0 && driver.leasesReused == 1 &&
+                          !connector.isLinkStale();
+
+  // Past half the lease, or granted while the clock was not set: the address goes back to DHCP
+  WifiLink expired = remembered;
+  expired.lease.obtainedAt = now - 50000;
+  driver.resetCounts();
+  bool expiredOk = connectUntilDone(connector, expired, "secret") == WifiConnector::Result::Connected &&
+                   driver.directedConnects == 1 && driver.leasesReused == 0;
+  expired.lease.obtainedAt = 0;
+  driver.resetCounts();
+  expiredOk = expiredOk && connectUntilDone(connector, expired, "secret") == WifiConnector::Result::Connected &&
+              driver.directedConnects == 1 && driver.leasesReused == 0;
+
+  // The router moved to another channel
+  driver.resetCounts();
+  driver.accessPoint.channel = 11;
+  const bool movedOk = connectUntilDone(connector, remembered, "secret") == WifiConnector::Result::Connected &&
+                       driver.directedConnects == 1 && driver.scanningConnects == 1 && connector.isLinkStale() &&
+                       connector.getLink().channel == 11;
+
+  driver.resetCounts();
+  const bool wrongPasswordOk = connectUntilDone(connector, WifiLink{}, "wrong") == WifiConnector::Result::Failed &&
+                               driver.scanningConnects == 1;
+
+  // Version 2 file: last SSID, then SSID and obfuscated password per network
+  {
+    std::ofstream out(sdRoot / ".crosspoint/wifi.bin", std::ios::binary);
+    serialization::writePod(out, static_cast<uint8_t>(2));
+    serialization::writeString(out, "Home");
+    serialization::writePod(out, static_cast<uint8_t>(1));
+    serialization::writeString(out, "Home");
+    serialization::writeString(out, std::string("\x30\x17", 2));  // "se" XOR "Cr"
+  }
+  bool legacyOk = WIFI_STORE.loadFromFile() && WIFI_STORE.getCredentials().size() == 1 &&
+                  WIFI_STORE.findCredential("Home")->password == "se" &&
+                  !WIFI_STORE.findCredential("Home")->link.isKnown();
+
+  // Version 3 file: links with a lease of four addresses and no time, which must not be reused
+  {
+    std::ofstream out(sdRoot / ".crosspoint/wifi.bin", std::ios::binary);
+    serialization::writePod(out, static_cast<uint8_t>(3));
+    serialization::writeString(out, "Home");
+    serialization::writePod(out, static_cast<uint8_t>(1));
+    serialization::writeString(out, "Home");
+    serialization::writeString(out, std::string("\x30\x17", 2));
+    serialization::writePod(out, driver.accessPoint.bssid);
+    serialization::writePod(out, driver.accessPoint.channel);
+    const uint32_t addresses[4] = {0x0201a8c0, 0x0101a8c0, 0x00ffffff, 0x0101a8c0};
+    serialization::writePod(out, addresses);
+  }
+  legacyOk = legacyOk && WIFI_STORE.loadFromFile() &&
+             WIFI_STORE.findCredential("Home")->link.sameAccessPoint(driver.accessPoint) &&
+             WIFI_STORE.findCredential("Home")->link.lease.ip == 0;
+  WIFI_STORE.clearAll();
+
+  if (!firstOk || !storedOk || !directedOk || !expiredOk || !movedOk || !wrongPasswordOk || !legacyOk) {
+    std::cout << "WiFi reconnect: first " << firstOk << ", stored " << storedOk << ", directed " << directedOk
+              << ", expired lease " << expiredOk << ", moved " << movedOk << ", wrong password " << wrongPasswordOk
+              << ", version 2/3 files " << legacyOk << "\n";
+    return false;
+  }
+  std::cout << "WiFi reconnect: first connect scans, reconnect goes to the remembered access point with its lease "
+               "(0 scans) until half the lease is over, a moved access point falls back to 1 scan; links survive "
+               "wifi.bin, version 2/3 files load\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path sdRoot = "build/wifi_reconnect/sd";
+  if (!resetSdRoot(sdRoot)) {
+    return 1;
+  }
+  return checkWifiReconnect(sdRoot) ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+// Host harness for XtcParser: synthetic books of up to 60,000 pages show that the page table window keeps open and
+// fetch times flat, and PackBits and deflate compressed text pages, 1-bit and 2-bit, must decode to the original
+// bitmaps through loadPage and loadPageStreaming.
+
+#include <HalStorage.h>
+#include <Xtc/XtcParser.h>
+#include <miniz.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test/host/HostHarness.h"
+#include "test/host/HostRenderer.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Writes an XTC (XTCH when twoBit) whose pages carry the given payloads, stored with the given compression
+void writeXtc(const fs::path& path, const bool twoBit, const uint16_t width, const uint16_t height,
+              const uint8_t compression, const std::vector<std::vector<uint8_t>>& payloads) {
+  xtc::XtcHeader header{};
+  header.magic = twoBit ? xtc::XTCH_MAGIC : xtc::XTC_MAGIC;
+  header.versionMajor = 1;
+  header.pageCount = static_cast<uint16_t>(payloads.size());
+  header.pageTableOffset = sizeof(header);
+  header.dataOffset = header.pageTableOffset + payloads.size() * sizeof(xtc::PageTableEntry);
+
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  uint64_t offset = header.dataOffset;
+  for (const auto& payload : payloads) {
+    const auto pageSize = static_cast<uint32_t>(sizeof(xtc::XtgPageHeader) + payload.size());
+    const xtc::PageTableEntry entry{offset, pageSize, width, height};
+    out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    offset += pageSize;
+  }
+  for (const auto& payload : payloads) {
+    const xtc::XtgPageHeader page{twoBit ? xtc::XTH_MAGIC : xtc::XTG_MAGIC, width, height, 0, compression,
+                                  static_cast<uint32_t>(payload.size()), 0};
+    out.write(reinterpret_cast<const char*>(&page), sizeof(page));
+    out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+  }
+}
+
+// Writes an XTC with pageCount tiny XTG pages whose first two bitmap bytes hold the page index
+void writeSyntheticXtc(const fs::path& path, const uint16_t pageCount) {
+  std::vector<std::vector<uint8_t>> payloads(pageCount, std::vector<uint8_t>(8));
+  for (uint32_t i = 0; i < pageCount; i++) {
+    payloads[i][0] = static_cast<uint8_t>(i);
+    payloads[i][1] = static_cast<uint8_t>(i >> 8);
+  }
+  writeXtc(path, false, 16, 4, xtc::XTG_COMPRESSION_NONE, payloads);
+}
+
+// XtcParser only keeps a window of the page table, so opening must not get slower with the page count and every page
+// must still resolve to its own data, whether read in order, backwards or at random.
+bool checkXtcPageTable(const fs::path& sdRoot) {
+  using Clock = std::chrono::steady_clock;
+  const auto micros = [](const Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  };
+
+  fs::create_directories(sdRoot / "xtc");
+  std::ostringstream report;
+  for (const uint16_t pageCount : {2000, 20000, 60000}) {
+    const std::string path = "/xtc/pages_" + std::to_string(pageCount) + ".xtc";
+    writeSyntheticXtc(sdRoot / (path.c_str() + 1), pageCount);
+
+    constexpr int opens = 20;
+    xtc::XtcParser parser;
+    auto start = Clock::now();
+    for (int i = 0; i < opens && parser.open(path.c_str()) == xtc::XtcError::OK; i++) {
+    }
+    const double openMicros = micros(start) / opens;
+    if (!parser.isOpen() || parser.getPageCount() != pageCount || parser.getWidth() != 16) {
+      std::cout << "XTC page table: failed to open " << path << "\n";
+      return false;
+    }
+
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < pageCount; i++) order.push_back(i);
+    for (uint32_t i = pageCount; i-- > 0;) order.push_back(i);
+    std::mt19937 rng(pageCount);
+    for (int i = 0; i < 2000; i++) order.push_back(rng() % pageCount);
+
+    uint8_t bitmap[8];
+    start = Clock::now();
+    for (const uint32_t page : order) {
+      if (parser.loadPage(page, bitmap, sizeof(bitmap)) != sizeof(bitmap) || bitmap[0] != (page & 0xFF) ||
+          bitmap[1] != (page >> 8)) {
+        std::cout << "XTC page table: page " << page << " of " << path << " has the wrong data\n";
+        return false;
+      }
+    }
+    const double fetchMicros = micros(start) / order.size();
+
+    bool streamed = false;
+    parser.loadPageStreaming(pageCount - 1, [&](const uint8_t* data, size_t, size_t offset) {
+      streamed = offset == 0 && data[0] == ((pageCount - 1) & 0xFF) && data[1] == (pageCount - 1) >> 8;
+    });
+    xtc::PageInfo info{};
+    if (!streamed || !parser.getPageInfo(pageCount / 2, info) || info.width != 16 ||
+        parser.getPageInfo(pageCount, info)) {
+      std::cout << "XTC page table: page lookups of " << path << " are wrong\n";
+      return false;
+    }
+    report << (report.tellp() > 0 ? ", " : "") << pageCount << " pages open " << openMicros << "us fetch "
+           << fetchMicros << "us";
+  }
+  std::cout << "XTC page table: " << report.str() << "\n";
+  return true;
+}
+
+// Greedy PackBits: runs of three or more equal bytes become repeat runs, everything else literals
+std::vector<uint8_t> packBits(const std::vector<uint8_t>& data) {
+  std::vector<uint8_t> out;
+  size_t i = 0;
+  while (i < data.size()) {
+    size_t run = 1;
+    while (i + run < data.size() && run < 128 && data[i + run] == data[i]) run++;
+    if (run >= 3) {
+      out.push_back(static_cast<uint8_t>(257 - run));
+      out.push_back(data[i]);
+      i += run;
+      continue;
+    }
+    const size_t start = i;
+    while (i < data.size() && i - start < 128 &&
+           !(i + 2 < data.size() && data[i] == data[i + 1] && data[i] == data[i + 2])) {
+      i++;
+    }
+    out.push_back(static_cast<uint8_t>(i - start - 1));
+    out.insert(out.end(), data.begin() + start, data.begin() + i);
+  }
+  return out;
+}
+
+std::vector<uint8_t> rawDeflate(const std::vector<uint8_t>& data) {
+  std::vector<uint8_t> out(data.size() + 1024);
+  out.resize(tdefl_compress_mem_to_mem(out.data(), out.size(), data.data(), data.size(), TDEFL_DEFAULT_MAX_PROBES));
+  return out;
+}
+
+// PackBits and deflate pages must decode to the original bitmap through loadPage and loadPageStreaming, and a
+// truncated payload must fail instead of showing garbage. Pages are real text pages, 1-bit and 2-bit, so the stored
+// sizes and read-plus-decode times are what a typical book gets.
+bool checkXtcCompression(GfxRenderer& renderer, const fs::path& sdRoot) {
+  constexpr uint16_t width = 480, height = 800;
+  constexpr int pageCount = 8;
+  static const char* const words[] = {"The", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog,",
+                                      "and", "then", "it", "rests", "under", "an", "old", "oak", "tree."};
+
+  // Page p: 24 lines of text, plus a grey picture in the 2-bit version
+  std::vector<std::vector<uint8_t>> bitmaps[2];
+  renderer.setOrientation(GfxRenderer::Portrait);
+  for (int p = 0; p < pageCount; p++) {
+    renderer.clearScreen();
+    for (int line = 0; line < 24; line++) {
+      std::string text;
+      for (int w = 0; w < 8; w++) {
+        text += std::string(words[(p * 7 + line * 5 + w * 3) % std::size(words)]) + " ";
+      }
+      renderer.drawText(BOOKERLY_14_FONT_ID, 20, 40 + line * 30, text.c_str());
+    }
+    const uint8_t* frame = renderer.getFrameBuffer();
+    const auto black = [&](const int x, const int y) {
+      const int phyX = y, phyY = HalDisplay::DISPLAY_HEIGHT - 1 - x;
+      return !((frame[phyY * HalDisplay::DISPLAY_WIDTH_BYTES + phyX / 8] >> (7 - phyX % 8)) & 1);
+    };
+
+    std::vector<uint8_t> xtg((width + 7) / 8 * height, 0xFF);
+    const size_t planeSize = (static_cast<size_t>(width) * height + 7) / 8;
+    std::vector<uint8_t> xth(planeSize * 2, 0);
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        if (black(x, y)) {
+          xtg[y * ((width + 7) / 8) + x / 8] &= ~(0x80 >> (x % 8));
+        }
+        const bool inPicture = y >= 300 + p * 20 && y < 460 + p * 20 && x >= 60 && x < 420;
+        const uint8_t value = black(x, y) ? 3 : inPicture ? 1 + (x / 20 + y / 20) % 2 : 0;
+        const size_t byte = (width - 1 - x) * ((height + 7) / 8) + y / 8;
+        xth[byte] |= ((value >> 1) & 1) << (7 - y % 8);
+        xth[planeSize + byte] |= (value & 1) << (7 - y % 8);
+      }
+    }
+    bitmaps[0].push_back(std::move(xtg));
+    bitmaps[1].push_back(std::move(xth));
+  }
+  renderer.clearScreen();
+
+  struct Codec {
+    const char* name;
+    uint8_t compression;
+    std::vector<uint8_t> (*encode)(const std::vector<uint8_t>&);
+  };
+  static const Codec codecs[] = {{"none", xtc::XTG_COMPRESSION_NONE, [](const std::vector<uint8_t>& d) { return d; }},
+                                 {"packbits", xtc::XTG_COMPRESSION_PACKBITS, packBits},
+                                 {"deflate", xtc::XTG_COMPRESSION_DEFLATE, rawDeflate}};
+
+  fs::create_directories(sdRoot / "xtc");
+  std::ostringstream report;
+  for (int depth = 0; depth < 2; depth++) {
+    report << (depth == 0 ? "1-bit" : "; 2-bit") << " page " << bitmaps[depth][0].size() << " bytes";
+    for (const auto& codec : codecs) {
+      std::vector<std::vector<uint8_t>> payloads;
+      size_t stored = 0;
+      for (const auto& bitmap : bitmaps[depth]) {
+        payloads.push_back(codec.encode(bitmap));
+        stored += payloads.back().size();
+      }
+      const std::string path = std::string("/xtc/") + codec.name + (depth ? ".xtch" : ".xtc");
+      writeXtc(sdRoot / (path.c_str() + 1), depth == 1, width, height, codec.compression, payloads);
+
+      xtc::XtcParser parser;
+      if (parser.open(path.c_str()) != xtc::XtcError::OK) {
+        std::cout << "XTC compression: failed to open " << path << "\n";
+        return false;
+      }
+      std::vector<uint8_t> page(bitmaps[depth][0].size());
+      bool intact = true;
+      for (int p = 0; p < pageCount && intact; p++) {
+        std::vector<uint8_t> streamed;
+        parser.loadPageStreaming(p, [&](const uint8_t* data, const size_t size, const size_t offset) {
+          intact = intact && offset == streamed.size() && size <= 1000;
+          streamed.insert(streamed.end(), data, data + size);
+        }, 1000);
+        intact = intact && parser.loadPage(p, page.data(), page.size()) == page.size() && page == bitmaps[depth][p] &&
+                 streamed == bitmaps[depth][p];
+      }
+      if (!intact) {
+        std::cout << "XTC compression: " << path << " does not decode to the original pages\n";
+        return false;
+      }
+
+      constexpr int rounds = 10;
+      const auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < rounds * pageCount; i++) {
+        parser.loadPage(i % pageCount, page.data(), page.size());
+      }
+      const auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+      report << ", " << codec.name << " " << stored / pageCount << " B " << us.count() / (rounds * pageCount) << "us";
+
+      if (codec.compression != xtc::XTG_COMPRESSION_NONE) {
+        // Cut every payload short, the header still claims the full size
+        for (auto& payload : payloads) payload.resize(payload.size() / 2);
+        writeXtc(sdRoot / "xtc/truncated.xtc", depth == 1, width, height, codec.compression, payloads);
+        xtc::XtcParser truncated;
+        if (truncated.open("/xtc/truncated.xtc") != xtc::XtcError::OK ||
+            truncated.loadPage(0, page.data(), page.size()) != 0) {
+          std::cout << "XTC compression: truncated " << codec.name << " page was accepted\n";
+          return false;
+        }
+      }
+    }
+  }
+  std::cout << "XTC compression: pages round-trip; " << report.str() << " per page read and decoded\n";
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path sdRoot = "build/xtc/sd";
+  if (!resetSdRoot(sdRoot)) {
+    return 1;
+  }
+  HostRenderer host;
+  const bool pageTableOk = checkXtcPageTable(sdRoot);
+  const bool compressionOk = checkXtcCompression(host.renderer, sdRoot);
+  return pageTableOk && compressionOk ? 0 : 1;
+}